@@ -0,0 +1,778 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+* Accuracy regression harness of the library.
+* The solvers and decompositions are run with matrices of known condition number, spectrum and structure,
+* and their backward errors ( residual norms relative to the norms of the data ) are written to the standard output
+* together with the median time of a call, one line per routine, matrix, size and error.
+* Given the output of a previous run as a baseline, the program fails ( exit status 1 ) when an error
+* or a time grows past a factor of its baseline value; the regressions are listed in the standard error.
+*
+* usage: accuracy [baseline] [error_factor] [time_factor]
+* baseline output of a previous run to compare with.
+* error_factor an error may grow up to this factor ( 10 by default ).
+* time_factor a time may grow up to this factor ( 2 by default ).
+*/
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include "matrix.h"
+#include "vector.h"
+#include "linearsys.h"
+#include "lu.h"
+#include "qr.h"
+#include "eigen.h"
+#include "svd.h"
+#include "rng.h"
+#include "taskgraph.h"
+
+#define MAX_ERRORS 3 /* errors computed for a routine */
+#define CASE_TIME 0.1 /* seconds of samples for a routine and a matrix */
+#define MIN_SAMPLES 3
+#define MAX_SAMPLES 100
+#define DEFAULT_ERROR_FACTOR 10.0
+#define DEFAULT_TIME_FACTOR 2.0
+#define MIN_TIME 1E-5 /* seconds, shorter times are too noisy to be compared */
+#define STABLE_LIMIT 100.0 /* an error below STABLE_LIMIT * n * DBL_EPSILON is what a backward stable method gives */
+#define MAX_RESULTS 1024
+#define TEMPORARY_FILE "accuracy.tmp"
+
+/*
+* Kind type definition: a family of test matrices.
+*/
+typedef struct
+{
+const char* _name;
+int _symmetric; /* nonzero for symmetric matrices */
+double _condition; /* condition number ( or spread of the row scales for graded matrices ) */
+int _mask; /* bit of the kind in the mask of a case */
+}Kind;
+
+#define RANDOM_WELL 1
+#define RANDOM_ILL 2
+#define GRADED 4
+#define SPD 8
+#define CLUSTERED 16
+#define ALL_KINDS 31
+
+typedef int (*CheckFunction)(const Matrix* a, const Vector* b, double* error);
+typedef void (*RunFunction)(const Matrix* a, const Vector* b);
+
+/*
+* Case type definition: a routine and the errors measured on its result.
+*/
+typedef struct
+{
+const char* _name; /* routine */
+const char* _error[MAX_ERRORS]; /* names of the errors, NULL after the last one */
+CheckFunction _check; /* calls the routine once and computes its errors, returns 0 if the routine fails */
+RunFunction _run; /* calls the routine once and destroys the result */
+int _kinds; /* mask of the kinds of matrices to use */
+int _max; /* largest size */
+}Case;
+
+/*
+* Result type definition: a line of the output.
+*/
+typedef struct
+{
+char _routine[64];
+char _matrix[32];
+double _condition;
+int _n;
+char _error[32];
+double _value; /* the error, inf if the routine failed */
+double _time; /* median time of a call in nanoseconds */
+int _stable; /* nonzero if the error is below STABLE_LIMIT * n * DBL_EPSILON */
+}Result;
+
+static const Kind __kinds_[] =
+{
+{"random", 0, 1E2, RANDOM_WELL}, /* U*S*V' with random orthogonal U and V and geometric singular values */
+{"random", 0, 1E8, RANDOM_ILL},
+{"graded", 0, 1E4, GRADED}, /* well conditioned matrix with rows scaled from 1 down to 1/condition */
+{"spd", 1, 1E4, SPD}, /* Q*L*Q' with geometric positive eigenvalues */
+{"clustered", 1, 1E2, CLUSTERED} /* Q*L*Q' with one eigenvalue 1 and the others in a cluster of width 1E-8 around 1/condition */
+};
+
+#define KINDS ((int)(sizeof(__kinds_) / sizeof(Kind)))
+
+static const int __sizes_[] = {8, 16, 32, 64, 128, 256};
+
+#define SIZES ((int)(sizeof(__sizes_) / sizeof(int)))
+
+/*
+* Helper functions.
+*/
+
+static double __now_(void)
+{
+struct timespec t;
+clock_gettime(CLOCK_MONOTONIC, &t);
+return (double)t.tv_sec + 1E-9 * (double)t.tv_nsec;
+}
+
+static int __compare_(const void* a, const void* b)
+{
+double x = *(const double*)a;
+double y = *(const double*)b;
+return (x > y) - (x < y);
+}
+
+static double __norm_(const double* x, size_t count)
+{
+size_t i;
+double s = 0.0;
+for(i = 0; i < count; i++) s += x[i] * x[i];
+return sqrt(s);
+}
+
+/*
+* Fills an n x n array with a random orthogonal matrix ( Gram-Schmidt, twice, on gaussian columns ).
+*/
+static void __orthogonal_(double* q, int n, Random* rng)
+{
+int i, j, k, pass;
+double d;
+for(i = 0; i < n*n; i++) q[i] = gaussian_random(rng);
+for(j = 0; j < n; j++)
+{
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(k = 0; k < j; k++)
+		{
+			d = 0.0;
+			for(i = 0; i < n; i++) d += q[i*n+k] * q[i*n+j];
+			for(i = 0; i < n; i++) q[i*n+j] -= d * q[i*n+k];
+		}
+	}
+	d = 0.0;
+	for(i = 0; i < n; i++) d += q[i*n+j] * q[i*n+j];
+	d = sqrt(d);
+	for(i = 0; i < n; i++) q[i*n+j] /= d;
+}
+}
+
+/*
+* Builds a test matrix: u*diag(s)*v' where s has the singular values ( or eigenvalues, with v = u ).
+*/
+static Matrix* __create_test_(const Kind* kind, int n, Random* rng)
+{
+int i, j, k;
+double d;
+double* u = (double*)malloc((size_t)n*n * sizeof(double));
+double* v = (double*)malloc((size_t)n*n * sizeof(double));
+double* s = (double*)malloc(n * sizeof(double));
+Matrix* a = create_matrix(n, n);
+__orthogonal_(u, n, rng);
+if(kind->_symmetric) memcpy(v, u, (size_t)n*n * sizeof(double));
+else __orthogonal_(v, n, rng);
+for(i = 0; i < n; i++)
+{
+	if(strcmp(kind->_name, "graded") == 0) s[i] = 1.0 + (double)i / n; /* condition 2 before the scaling */
+	else if(strcmp(kind->_name, "clustered") == 0) s[i] = (i == 0) ? 1.0 : 1.0 / kind->_condition + 1E-8 * i / n;
+	else s[i] = pow(kind->_condition, -(double)i / (n-1));
+}
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		d = 0.0;
+		for(k = 0; k < n; k++) d += u[i*n+k] * s[k] * v[j*n+k];
+		a->_data[(size_t)i*n+j] = d;
+	}
+}
+if(kind->_symmetric)
+{
+	/* remove the rounding errors which make a slightly nonsymmetric */
+	for(i = 0; i < n; i++) for(j = 0; j < i; j++) a->_data[(size_t)j*n+i] = a->_data[(size_t)i*n+j];
+}
+if(strcmp(kind->_name, "graded") == 0)
+{
+	for(i = 0; i < n; i++)
+	{
+		d = pow(kind->_condition, -(double)i / (n-1));
+		for(j = 0; j < n; j++) a->_data[(size_t)i*n+j] *= d;
+	}
+}
+
+/* release previously allocated memory */
+free(u);
+free(v);
+free(s);
+
+return a;
+}
+
+/*
+* Normwise backward error of a solution x of a*x = b: ||b - a*x|| / ( ||a|| * ||x|| + ||b|| ).
+*/
+static double __backward_error_(const Matrix* a, const Vector* b, const Vector* x)
+{
+int i, j, n = rows_matrix(a);
+double d, r = 0.0;
+for(i = 0; i < n; i++)
+{
+	d = b->_data[i];
+	for(j = 0; j < n; j++) d -= a->_data[(size_t)i*n+j] * x->_data[j];
+	r += d * d;
+}
+return sqrt(r) / (__norm_(a->_data, (size_t)n*n) * __norm_(x->_data, n) + __norm_(b->_data, n));
+}
+
+/*
+* Loss of orthogonality of the columns of q: ||q'*q - I||.
+*/
+static double __orthogonality_(const Matrix* q)
+{
+int i, j, k, n = rows_matrix(q), c = columns_matrix(q);
+double d, r = 0.0;
+for(i = 0; i < c; i++)
+{
+	for(j = 0; j < c; j++)
+	{
+		d = (i == j) ? -1.0 : 0.0;
+		for(k = 0; k < n; k++) d += q->_data[(size_t)k*c+i] * q->_data[(size_t)k*c+j];
+		r += d * d;
+	}
+}
+return sqrt(r);
+}
+
+/*
+* Largest residual of the eigenpairs: ||a*x - lambda*x|| / ( ||a|| * ||x|| ).
+*/
+static double __eigen_residual_(const Matrix* a, const EigenSystem* e)
+{
+int i, j, k, n = rows_matrix(a);
+double d, r, worst = 0.0;
+const Vector* x = NULL;
+for(k = 0; k < size_eigensystem(e); k++)
+{
+	x = eigen_vector(e->_eigen[k]);
+	r = 0.0;
+	for(i = 0; i < n; i++)
+	{
+		d = -eigen_value(e->_eigen[k]) * x->_data[i];
+		for(j = 0; j < n; j++) d += a->_data[(size_t)i*n+j] * x->_data[j];
+		r += d * d;
+	}
+	r = sqrt(r) / (__norm_(a->_data, (size_t)n*n) * __norm_(x->_data, n));
+	if(r > worst) worst = r;
+}
+return worst;
+}
+
+/*
+* Loss of orthogonality of the eigenvectors, as columns of a matrix.
+*/
+static double __eigen_orthogonality_(const EigenSystem* e)
+{
+int i, j, n = size_vector(eigen_vector(e->_eigen[0]));
+double r;
+Matrix* q = create_matrix(n, size_eigensystem(e));
+for(j = 0; j < size_eigensystem(e); j++)
+{
+	for(i = 0; i < n; i++) q->_data[(size_t)i*columns_matrix(q)+j] = eigen_vector(e->_eigen[j])->_data[i];
+}
+r = __orthogonality_(q);
+destroy_matrix(q);
+return r;
+}
+
+/*
+* The cases: a check function computing the errors of a routine and a run function to time it.
+*/
+
+static int __check_mvgauss_(const Matrix* a, const Vector* b, double* error)
+{
+Vector* x = mvgauss_system_solver(a, b);
+if(x == NULL) return 0;
+error[0] = __backward_error_(a, b, x);
+destroy_vector(x);
+return 1;
+}
+
+static void __run_mvgauss_(const Matrix* a, const Vector* b)
+{
+destroy_vector(mvgauss_system_solver(a, b));
+}
+
+static int __check_lu_solver_(const Matrix* a, const Vector* b, double* error)
+{
+LU* lu = lu_decomposition(a);
+Vector* x = NULL;
+if(lu == NULL) return 0;
+x = lu_system_solver(lu, b);
+error[0] = __backward_error_(a, b, x);
+destroy_vector(x);
+destroy_lu(lu);
+return 1;
+}
+
+static void __run_lu_solver_(const Matrix* a, const Vector* b)
+{
+LU* lu = lu_decomposition(a);
+if(lu != NULL) destroy_vector(lu_system_solver(lu, b));
+destroy_lu(lu);
+}
+
+/*
+* ||P*a - L*U|| / ||a||, row i of P*a is row permutation[i] of a; lu is destroyed.
+*/
+static int __lu_error_(const Matrix* a, LU* lu, double* error)
+{
+int i, j, k, n = rows_matrix(a);
+double d, r = 0.0;
+if(lu == NULL) return 0;
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		d = a->_data[(size_t)lu_permutation(lu)[i]*n+j];
+		for(k = 0; k < n; k++) d -= lu_lower(lu)->_data[(size_t)i*n+k] * lu_upper(lu)->_data[(size_t)k*n+j];
+		r += d * d;
+	}
+}
+error[0] = sqrt(r) / __norm_(a->_data, (size_t)n*n);
+destroy_lu(lu);
+return 1;
+}
+
+static int __check_lu_(const Matrix* a, const Vector* b, double* error)
+{
+return __lu_error_(a, lu_decomposition(a), error);
+}
+
+static void __run_lu_(const Matrix* a, const Vector* b)
+{
+destroy_lu(lu_decomposition(a));
+}
+
+static int __check_lu_task_graph_(const Matrix* a, const Vector* b, double* error)
+{
+return __lu_error_(a, lu_task_graph(a, 0, 0, NULL), error);
+}
+
+static void __run_lu_task_graph_(const Matrix* a, const Vector* b)
+{
+destroy_lu(lu_task_graph(a, 0, 0, NULL));
+}
+
+static int __check_cholesky_task_graph_(const Matrix* a, const Vector* b, double* error)
+{
+int i, j, k, n = rows_matrix(a);
+double d, r = 0.0;
+Matrix* l = cholesky_task_graph(a, 0, 0, NULL);
+if(l == NULL) return 0;
+/* ||a - L*L'|| / ||a|| */
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		d = a->_data[(size_t)i*n+j];
+		for(k = 0; k <= i && k <= j; k++) d -= l->_data[(size_t)i*n+k] * l->_data[(size_t)j*n+k];
+		r += d * d;
+	}
+}
+error[0] = sqrt(r) / __norm_(a->_data, (size_t)n*n);
+destroy_matrix(l);
+return 1;
+}
+
+static void __run_cholesky_task_graph_(const Matrix* a, const Vector* b)
+{
+destroy_matrix(cholesky_task_graph(a, 0, 0, NULL));
+}
+
+/*
+* ||a - Q*R|| / ||a|| and the orthogonality of Q; qr is destroyed.
+*/
+static int __qr_error_(const Matrix* a, QR* qr, double* error)
+{
+int i, j, k, n = rows_matrix(a);
+double d, r = 0.0;
+if(qr == NULL) return 0;
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		d = a->_data[(size_t)i*n+j];
+		for(k = 0; k < n; k++) d -= qr_q(qr)->_data[(size_t)i*n+k] * qr_r(qr)->_data[(size_t)k*n+j];
+		r += d * d;
+	}
+}
+error[0] = sqrt(r) / __norm_(a->_data, (size_t)n*n);
+error[1] = __orthogonality_(qr_q(qr));
+destroy_qr(qr);
+return 1;
+}
+
+static int __check_qr_(const Matrix* a, const Vector* b, double* error)
+{
+return __qr_error_(a, qr_factorization(a), error);
+}
+
+static void __run_qr_(const Matrix* a, const Vector* b)
+{
+destroy_qr(qr_factorization(a));
+}
+
+static int __check_qr_task_graph_(const Matrix* a, const Vector* b, double* error)
+{
+return __qr_error_(a, qr_task_graph(a, 0, 0, NULL), error);
+}
+
+static void __run_qr_task_graph_(const Matrix* a, const Vector* b)
+{
+destroy_qr(qr_task_graph(a, 0, 0, NULL));
+}
+
+static int __check_qr_solver_(const Matrix* a, const Vector* b, double* error)
+{
+QR* qr = qr_factorization(a);
+Vector* x = NULL;
+if(qr == NULL) return 0;
+x = qr_system_solver(qr, b);
+error[0] = __backward_error_(a, b, x);
+destroy_vector(x);
+destroy_qr(qr);
+return 1;
+}
+
+static void __run_qr_solver_(const Matrix* a, const Vector* b)
+{
+QR* qr = qr_factorization(a);
+if(qr != NULL) destroy_vector(qr_system_solver(qr, b));
+destroy_qr(qr);
+}
+
+static int __check_inverse_(const Matrix* a, const Vector* b, double* error)
+{
+int i, j, k, n = rows_matrix(a);
+double d, r = 0.0;
+Matrix* x = inverse_matrix(a);
+if(x == NULL) return 0;
+/* ||a*x - I|| / ( ||a|| * ||x|| ) */
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		d = (i == j) ? -1.0 : 0.0;
+		for(k = 0; k < n; k++) d += a->_data[(size_t)i*n+k] * x->_data[(size_t)k*n+j];
+		r += d * d;
+	}
+}
+error[0] = sqrt(r) / (__norm_(a->_data, (size_t)n*n) * __norm_(x->_data, (size_t)n*n));
+destroy_matrix(x);
+return 1;
+}
+
+static void __run_inverse_(const Matrix* a, const Vector* b)
+{
+destroy_matrix(inverse_matrix(a));
+}
+
+static int __check_symmetric_eigen_(const Matrix* a, const Vector* b, double* error)
+{
+EigenSystem* e = symmetric_eigen_system(a);
+if(e == NULL) return 0;
+error[0] = __eigen_residual_(a, e);
+error[1] = __eigen_orthogonality_(e);
+destroy_eigensystem(e);
+return 1;
+}
+
+static void __run_symmetric_eigen_(const Matrix* a, const Vector* b)
+{
+destroy_eigensystem(symmetric_eigen_system(a));
+}
+
+static int __check_eigen_(const Matrix* a, const Vector* b, double* error)
+{
+EigenSystem* e = eigen_system(a);
+if(e == NULL) return 0;
+error[0] = __eigen_residual_(a, e);
+error[1] = __eigen_orthogonality_(e);
+destroy_eigensystem(e);
+return 1;
+}
+
+static void __run_eigen_(const Matrix* a, const Vector* b)
+{
+destroy_eigensystem(eigen_system(a));
+}
+
+static int __check_svd_(const Matrix* a, const Vector* b, double* error)
+{
+int i, j, k, n = rows_matrix(a);
+double d, r = 0.0;
+SVD* svd = svd_factorization(a);
+if(svd == NULL) return 0;
+/* ||a - U*S*V'|| / ||a|| */
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		d = a->_data[(size_t)i*n+j];
+		for(k = 0; k < n; k++) d -= svd_u(svd)->_data[(size_t)i*n+k] * svd_sigma(svd)->_data[(size_t)k*n+k] * svd_v(svd)->_data[(size_t)j*n+k];
+		r += d * d;
+	}
+}
+error[0] = sqrt(r) / __norm_(a->_data, (size_t)n*n);
+error[1] = __orthogonality_(svd_u(svd));
+error[2] = __orthogonality_(svd_v(svd));
+destroy_svd(svd);
+return 1;
+}
+
+static void __run_svd_(const Matrix* a, const Vector* b)
+{
+destroy_svd(svd_factorization(a));
+}
+
+static int __check_store_(const Matrix* a, const Vector* b, double* error)
+{
+size_t i, count = (size_t)rows_matrix(a) * columns_matrix(a);
+double d, worst = 0.0;
+Matrix* m = NULL;
+store_matrix(a, TEMPORARY_FILE);
+m = load_matrix(TEMPORARY_FILE);
+remove(TEMPORARY_FILE);
+if(m == NULL) return 0;
+/* largest relative error of an entry after a round trip through a text file */
+for(i = 0; i < count; i++)
+{
+	d = fabs(m->_data[i] - a->_data[i]) / ((a->_data[i] != 0.0) ? fabs(a->_data[i]) : 1.0);
+	if(d > worst) worst = d;
+}
+error[0] = worst;
+destroy_matrix(m);
+return 1;
+}
+
+static void __run_store_(const Matrix* a, const Vector* b)
+{
+Matrix* m = NULL;
+store_matrix(a, TEMPORARY_FILE);
+m = load_matrix(TEMPORARY_FILE);
+destroy_matrix(m);
+remove(TEMPORARY_FILE);
+}
+
+/*
+* The QR algorithm ( eigen_system, and svd_factorization which uses it ) has no shifts,
+* so it is only given matrices with well separated eigenvalues, where it converges.
+*/
+static const Case __cases_[] =
+{
+{"mvgauss_system_solver", {"backward", NULL}, __check_mvgauss_, __run_mvgauss_, ALL_KINDS, 256},
+{"lu_system_solver", {"backward", NULL}, __check_lu_solver_, __run_lu_solver_, ALL_KINDS, 256}, /* the time includes the factorization */
+{"lu_decomposition", {"factorization", NULL}, __check_lu_, __run_lu_, ALL_KINDS, 256},
+{"inverse_matrix", {"inverse", NULL}, __check_inverse_, __run_inverse_, ALL_KINDS, 128},
+{"qr_factorization", {"factorization", "orthogonality", NULL}, __check_qr_, __run_qr_, ALL_KINDS, 32},
+{"qr_system_solver", {"backward", NULL}, __check_qr_solver_, __run_qr_solver_, ALL_KINDS, 32}, /* the time includes the factorization */
+{"symmetric_eigen_system", {"residual", "orthogonality", NULL}, __check_symmetric_eigen_, __run_symmetric_eigen_, SPD | CLUSTERED, 128},
+{"eigen_system", {"residual", "orthogonality", NULL}, __check_eigen_, __run_eigen_, SPD, 16},
+{"svd_factorization", {"factorization", "orthogonality_u", "orthogonality_v"}, __check_svd_, __run_svd_, RANDOM_WELL | GRADED | SPD, 8},
+{"store_matrix", {"round_trip", NULL}, __check_store_, __run_store_, ALL_KINDS, 64},
+{"lu_task_graph", {"factorization", NULL}, __check_lu_task_graph_, __run_lu_task_graph_, ALL_KINDS, 256},
+{"cholesky_task_graph", {"factorization", NULL}, __check_cholesky_task_graph_, __run_cholesky_task_graph_, SPD | CLUSTERED, 256},
+{"qr_task_graph", {"factorization", "orthogonality", NULL}, __check_qr_task_graph_, __run_qr_task_graph_, ALL_KINDS, 256}
+};
+
+#define CASES ((int)(sizeof(__cases_) / sizeof(Case)))
+
+/*
+* Median time of a call in nanoseconds.
+*/
+static double __time_(const Case* c, const Matrix* a, const Vector* b)
+{
+int i, count;
+double t, median;
+double* samples = NULL;
+t = __now_();
+c->_run(a, b);
+t = __now_() - t;
+count = (t > 0.0) ? (int)(CASE_TIME / t) : MAX_SAMPLES;
+if(count < MIN_SAMPLES) count = MIN_SAMPLES;
+if(count > MAX_SAMPLES) count = MAX_SAMPLES;
+samples = (double*)malloc(count * sizeof(double));
+for(i = 0; i < count; i++)
+{
+	t = __now_();
+	c->_run(a, b);
+	samples[i] = __now_() - t;
+}
+qsort(samples, count, sizeof(double), __compare_);
+median = samples[count/2];
+free(samples);
+return 1E9 * median;
+}
+
+/*
+* Reads the results of a previous run.
+*
+* returns: the number of results read, or -1 if the file cannot be read.
+*/
+static int __read_results_(const char* filename, Result* results, int max)
+{
+int count = 0;
+char line[512];
+Result* r = NULL;
+FILE* file = fopen(filename, "r");
+if(file == NULL) return -1;
+while(count < max && fgets(line, sizeof(line), file) != NULL)
+{
+	if(line[0] == '#') continue;
+	r = &results[count];
+	if(sscanf(line, "%63s %31s %lf %d %31s %lf %lf %d", r->_routine, r->_matrix, &r->_condition, &r->_n,
+	r->_error, &r->_value, &r->_time, &r->_stable) == 8) count++;
+}
+fclose(file);
+return count;
+}
+
+static const Result* __find_result_(const Result* results, int count, const Result* r)
+{
+int i;
+for(i = 0; i < count; i++)
+{
+	if(results[i]._n != r->_n || results[i]._condition != r->_condition) continue;
+	if(strcmp(results[i]._routine, r->_routine) || strcmp(results[i]._matrix, r->_matrix) || strcmp(results[i]._error, r->_error)) continue;
+	return &results[i];
+}
+return NULL;
+}
+
+/*
+* Compares a result with its baseline.
+*
+* returns: 1 if the error or the time regressed, 0 otherwise.
+*/
+static int __regression_(const Result* r, const Result* base, double error_factor, double time_factor)
+{
+int failed = 0;
+double floor;
+if(base == NULL) return 0; /* a new case */
+/* errors below a few roundoffs are all as good */
+floor = r->_n * DBL_EPSILON;
+if(r->_value > error_factor * ((base->_value > floor) ? base->_value : floor))
+{
+	fprintf(stderr, "accuracy regression: %s %s %g %d %s %.4e ( baseline %.4e )\n",
+	r->_routine, r->_matrix, r->_condition, r->_n, r->_error, r->_value, base->_value);
+	failed = 1;
+}
+if(r->_time > 1E9 * MIN_TIME && r->_time > time_factor * base->_time)
+{
+	fprintf(stderr, "time regression: %s %s %g %d %.0f ns ( baseline %.0f ns )\n",
+	r->_routine, r->_matrix, r->_condition, r->_n, r->_time, base->_time);
+	failed = 1;
+}
+return failed;
+}
+
+/* end helper functions */
+
+int main(int argc, char** argv)
+{
+int i, j, k, s, ok, base_count = 0, failed = 0;
+double time;
+double error[MAX_ERRORS];
+double error_factor = DEFAULT_ERROR_FACTOR, time_factor = DEFAULT_TIME_FACTOR;
+Result r;
+Result* base = NULL;
+Random* rng = NULL;
+Matrix* a = NULL;
+Vector* b = NULL;
+if(argc > 2) error_factor = atof(argv[2]);
+if(argc > 3) time_factor = atof(argv[3]);
+if(error_factor <= 1.0) error_factor = DEFAULT_ERROR_FACTOR;
+if(time_factor <= 1.0) time_factor = DEFAULT_TIME_FACTOR;
+if(argc > 1)
+{
+	base = (Result*)malloc(MAX_RESULTS * sizeof(Result));
+	base_count = __read_results_(argv[1], base, MAX_RESULTS);
+	if(base_count < 0)
+	{
+		fprintf(stderr, "cannot read %s\n", argv[1]);
+		free(base);
+		return 1;
+	}
+}
+rng = create_random(DEFAULT_SEED);
+printf("# routine matrix condition n error value time_ns stable\n");
+for(s = 0; s < SIZES; s++)
+{
+	for(k = 0; k < KINDS; k++)
+	{
+		/* the same matrices on every run */
+		seed_random(rng, DEFAULT_SEED + (unsigned long long)s * KINDS + k);
+		a = __create_test_(&__kinds_[k], __sizes_[s], rng);
+		b = create_vector(__sizes_[s]);
+		for(i = 0; i < __sizes_[s]; i++) b->_data[i] = gaussian_random(rng);
+		for(i = 0; i < CASES; i++)
+		{
+			if(__sizes_[s] > __cases_[i]._max || !(__cases_[i]._kinds & __kinds_[k]._mask)) continue;
+			fprintf(stderr, "%s %s %g %d\n", __cases_[i]._name, __kinds_[k]._name, __kinds_[k]._condition, __sizes_[s]);
+			for(j = 0; j < MAX_ERRORS; j++) error[j] = INFINITY;
+			ok = __cases_[i]._check(a, b, error);
+			time = (ok) ? __time_(&__cases_[i], a, b) : 0.0;
+			for(j = 0; j < MAX_ERRORS && __cases_[i]._error[j] != NULL; j++)
+			{
+				memset(&r, 0, sizeof(Result));
+				strcpy(r._routine, __cases_[i]._name);
+				strcpy(r._matrix, __kinds_[k]._name);
+				strcpy(r._error, __cases_[i]._error[j]);
+				r._condition = __kinds_[k]._condition;
+				r._n = __sizes_[s];
+				r._value = error[j];
+				r._time = time;
+				r._stable = (error[j] <= STABLE_LIMIT * r._n * DBL_EPSILON);
+				printf("%s %s %g %d %s %.4e %.0f %d\n", r._routine, r._matrix, r._condition, r._n, r._error, r._value, r._time, r._stable);
+				fflush(stdout);
+				if(base != NULL) failed |= __regression_(&r, __find_result_(base, base_count, &r), error_factor, time_factor);
+			}
+		}
+		destroy_matrix(a);
+		destroy_vector(b);
+	}
+}
+
+/* release previously allocated memory */
+destroy_random(rng);
+free(base);
+
+if(base != NULL) fprintf(stderr, (failed) ? "regressions found\n" : "no regressions\n");
+return failed;
+}
+
+/* END */
@@ -0,0 +1,575 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+* Benchmark of the public routines of the library.
+* Each routine is timed for sizes 8, 16, 32, ... up to a maximum size,
+* and the results ( median and p99 time of a call, GFLOP/s and bytes allocated by a call )
+* are written to the standard output in JSON format.
+*
+* usage: bench [max_size] [budget] [filter]
+* max_size largest size to try ( 8192 by default ).
+* budget seconds a single call may take; a routine is not tried with a bigger size
+* when its next call is expected to take longer ( 1 second by default ).
+* filter only the routines having this text in their names are timed.
+*/
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "matrix.h"
+#include "vector.h"
+#include "linearsys.h"
+#include "lu.h"
+#include "qr.h"
+#include "eigen.h"
+#include "svd.h"
+#include "diagonalization.h"
+#include "rng.h"
+#include "threadpool.h"
+#include "taskgraph.h"
+
+#define MIN_SIZE 8
+#define MAX_SIZE 8192
+#define DEFAULT_BUDGET 1.0 /* seconds a single call may take */
+#define CASE_TIME 0.25 /* seconds of samples for a routine and a size */
+#define MIN_SAMPLES 5
+#define MAX_SAMPLES 1000
+#define FILE_SIZE 2048 /* largest size for the routines writing text files */
+#define QR_SIZE 64 /* largest size for the routines needing a QR factorization */
+#define EIGEN_SIZE 16 /* largest size for the routines needing a diagonalization */
+#define COFACTOR_SIZE 8 /* largest size for the routines using cofactor expansion, whose time grows as n! */
+#define TEMPORARY_FILE "bench.tmp"
+
+/*
+* Bytes allocated by the library, counted when the program is linked with
+* -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc and compiled with COUNT_ALLOCATIONS ( see the Makefile ).
+*/
+static size_t __allocated_ = 0;
+
+#ifdef COUNT_ALLOCATIONS
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* p, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+__sync_fetch_and_add(&__allocated_, size);
+return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+__sync_fetch_and_add(&__allocated_, count * size);
+return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* p, size_t size)
+{
+__sync_fetch_and_add(&__allocated_, size);
+return __real_realloc(p, size);
+}
+#endif
+
+/*
+* Input type definition: the arguments for the routines, built once for each size.
+*/
+typedef struct
+{
+int _n;
+Matrix* _a; /* general matrix, diagonally dominant */
+Matrix* _b; /* another general matrix */
+Matrix* _c; /* output of gemm_matrix and set_matrix */
+Matrix* _s; /* symmetric matrix with eigenvalues close to 1, 2, ... n */
+Matrix* _system; /* a with v as its last column */
+Vector* _v;
+Vector* _w;
+Vector* _v3; /* vectors of size 3 for cross_product_vector */
+Vector* _w3;
+LU* _lu;
+Eigen* _eigen;
+EigenSystem* _eigsys;
+Random* _rng;
+QR* _qr; /* the fields below are built on first use */
+PCA* _pca;
+Diagonalization* _diag;
+int _stored_matrix;
+int _stored_vector;
+}Input;
+
+typedef void (*BenchFunction)(Input* in);
+
+/*
+* Benchmark type definition.
+*/
+typedef struct
+{
+const char* _name; /* routine */
+const char* _header;
+BenchFunction _run; /* calls the routine once and destroys the result */
+int _order; /* the time of a call grows as n^order */
+int _max; /* largest size, 0 for no limit */
+double _coefficient; /* a call does coefficient * n^power floating point operations, 0 if it is not known */
+int _power;
+}Benchmark;
+
+static volatile double __sink_ = 0.0; /* keeps the results of routines returning a number */
+
+/*
+* Helper functions.
+*/
+
+static double __now_(void)
+{
+struct timespec t;
+clock_gettime(CLOCK_MONOTONIC, &t);
+return (double)t.tv_sec + 1E-9 * (double)t.tv_nsec;
+}
+
+static int __compare_(const void* a, const void* b)
+{
+double x = *(const double*)a;
+double y = *(const double*)b;
+return (x > y) - (x < y);
+}
+
+static Input* __create_input_(int n)
+{
+int i, j;
+double d;
+Input* in = (Input*)calloc(1, sizeof(Input));
+in->_n = n;
+in->_rng = create_random(DEFAULT_SEED);
+in->_a = create_matrix(n, n);
+in->_b = create_matrix(n, n);
+in->_c = create_matrix(n, n);
+in->_s = create_matrix(n, n);
+in->_v = create_vector(n);
+in->_w = create_vector(n);
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		in->_a->_data[(size_t)i*n+j] = uniform_random(in->_rng) - 0.5 + ((i == j) ? n : 0.0);
+		in->_b->_data[(size_t)i*n+j] = uniform_random(in->_rng) - 0.5;
+	}
+	for(j = 0; j <= i; j++)
+	{
+		d = 0.01 * (uniform_random(in->_rng) - 0.5) + ((i == j) ? i+1.0 : 0.0);
+		in->_s->_data[(size_t)i*n+j] = d;
+		in->_s->_data[(size_t)j*n+i] = d;
+	}
+	in->_v->_data[i] = uniform_random(in->_rng) - 0.5;
+	in->_w->_data[i] = uniform_random(in->_rng) - 0.5;
+}
+in->_system = create_matrix(n, n+1);
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++) in->_system->_data[(size_t)i*(n+1)+j] = in->_a->_data[(size_t)i*n+j];
+	in->_system->_data[(size_t)i*(n+1)+n] = in->_v->_data[i];
+}
+in->_v3 = create_vector(3);
+in->_w3 = create_vector(3);
+for(i = 0; i < 3; i++)
+{
+	in->_v3->_data[i] = i + 1.0;
+	in->_w3->_data[i] = 3.0 - i;
+}
+in->_lu = lu_decomposition(in->_a);
+in->_eigen = create_eigen(1.0, in->_v);
+in->_eigsys = create_eigensystem(n);
+for(i = 0; i < n; i++) in->_eigsys->_eigen[i] = create_eigen(i + 1.0, in->_v);
+return in;
+}
+
+static void __destroy_input_(Input* in)
+{
+destroy_matrix(in->_a);
+destroy_matrix(in->_b);
+destroy_matrix(in->_c);
+destroy_matrix(in->_s);
+destroy_matrix(in->_system);
+destroy_vector(in->_v);
+destroy_vector(in->_w);
+destroy_vector(in->_v3);
+destroy_vector(in->_w3);
+destroy_lu(in->_lu);
+destroy_eigen(in->_eigen);
+destroy_eigensystem(in->_eigsys);
+destroy_random(in->_rng);
+destroy_qr(in->_qr);
+destroy_pca(in->_pca);
+destroy_diagonalization(in->_diag);
+if(in->_stored_matrix || in->_stored_vector) remove(TEMPORARY_FILE);
+free(in);
+}
+
+static QR* __qr_(Input* in)
+{
+if(in->_qr == NULL) in->_qr = qr_factorization(in->_a);
+return in->_qr;
+}
+
+static PCA* __pca_(Input* in)
+{
+if(in->_pca == NULL) in->_pca = pca_factorization(in->_a, (in->_n < 16) ? in->_n/2 : 8, 5, 1, in->_rng);
+return in->_pca;
+}
+
+static Diagonalization* __diag_(Input* in)
+{
+if(in->_diag == NULL) in->_diag = diagonalize_matrix(in->_s);
+return in->_diag;
+}
+
+/*
+* The benchmarks: each one calls a routine once and destroys the result.
+*/
+#define BENCH(name) static void __bench_##name##_(Input* in)
+
+BENCH(create_matrix) { destroy_matrix(create_matrix(in->_n, in->_n)); }
+BENCH(clone_matrix) { destroy_matrix(clone_matrix(in->_a)); }
+BENCH(store_matrix)
+{
+store_matrix(in->_a, TEMPORARY_FILE);
+in->_stored_matrix = 1;
+in->_stored_vector = 0;
+}
+BENCH(load_matrix)
+{
+if(!in->_stored_matrix) __bench_store_matrix_(in);
+destroy_matrix(load_matrix(TEMPORARY_FILE));
+}
+BENCH(get_matrix)
+{
+int i, j;
+double s = 0.0;
+for(i = 0; i < in->_n; i++) for(j = 0; j < in->_n; j++) s += get_matrix(in->_a, i, j);
+__sink_ = s;
+}
+BENCH(set_matrix)
+{
+int i, j;
+for(i = 0; i < in->_n; i++) for(j = 0; j < in->_n; j++) set_matrix(in->_c, 1.0, i, j);
+}
+BENCH(get_matrix_chunk) { destroy_matrix(get_matrix_chunk(in->_a, in->_n/4, 3*in->_n/4-1, in->_n/4, 3*in->_n/4-1)); }
+BENCH(resize_matrix) { destroy_matrix(resize_matrix(in->_a, in->_n/2, in->_n/2)); }
+BENCH(resize_matrix_rows) { destroy_matrix(resize_matrix_rows(in->_a, in->_n/2)); }
+BENCH(resize_matrix_columns) { destroy_matrix(resize_matrix_columns(in->_a, in->_n/2)); }
+BENCH(add_matrix) { destroy_matrix(add_matrix(in->_a, in->_b)); }
+BENCH(sub_matrix) { destroy_matrix(sub_matrix(in->_a, in->_b)); }
+BENCH(mul_matrix) { destroy_matrix(mul_matrix(in->_a, in->_b)); }
+BENCH(gemm_matrix) { gemm_matrix(1.0, in->_a, 0, in->_b, 0, 0.0, in->_c); }
+BENCH(scale_matrix) { destroy_matrix(scale_matrix(in->_a, 2.0)); }
+BENCH(identity_matrix) { destroy_matrix(identity_matrix(in->_n)); }
+BENCH(transpose_matrix) { destroy_matrix(transpose_matrix(in->_a)); }
+BENCH(trace_matrix) { __sink_ = trace_matrix(in->_a); }
+BENCH(diag_matrix) { destroy_matrix(diag_matrix(in->_a)); }
+BENCH(inverse_matrix) { destroy_matrix(inverse_matrix(in->_a)); }
+BENCH(det_matrix) { __sink_ = det_matrix(in->_a); }
+BENCH(rotation_matrix) { destroy_matrix(rotation_matrix(1.0, 2.0, 3.0, 0.5)); }
+BENCH(get_row_matrix) { destroy_matrix(get_row_matrix(in->_a, in->_n/2)); }
+BENCH(get_column_matrix) { destroy_matrix(get_column_matrix(in->_a, in->_n/2)); }
+BENCH(get_row_vector) { destroy_vector(get_row_vector(in->_a, in->_n/2)); }
+BENCH(get_column_vector) { destroy_vector(get_column_vector(in->_a, in->_n/2)); }
+BENCH(set_row_matrix) { destroy_matrix(set_row_matrix(in->_a, in->_v, in->_n/2)); }
+BENCH(set_column_matrix) { destroy_matrix(set_column_matrix(in->_a, in->_v, in->_n/2)); }
+BENCH(pseudoinverse_matrix) { destroy_matrix(pseudoinverse_matrix(in->_a)); }
+BENCH(nearest_orthogonal_matrix) { destroy_matrix(nearest_orthogonal_matrix(in->_a)); }
+BENCH(forbinius_norm_matrix) { __sink_ = forbinius_norm_matrix(in->_a); }
+BENCH(minor) { __sink_ = minor(in->_a, 0, 0); }
+BENCH(minor_matrix) { destroy_matrix(minor_matrix(in->_a, 0, 0)); }
+BENCH(first_minor) { __sink_ = first_minor(in->_a, 0); }
+BENCH(first_minor_matrix) { destroy_matrix(first_minor_matrix(in->_a, 0)); }
+BENCH(cofactor_matrix) { destroy_matrix(cofactor_matrix(in->_a)); }
+BENCH(invert_matrix) { destroy_matrix(invert_matrix(in->_a)); }
+BENCH(determinant) { __sink_ = determinant(in->_a); }
+BENCH(is_symmetric) { __sink_ = is_symmetric(in->_s); }
+BENCH(rank_matrix) { __sink_ = rank_matrix(in->_a); }
+BENCH(fully_rank_matrix) { __sink_ = fully_rank_matrix(in->_a); }
+BENCH(to_row_matrix) { destroy_matrix(to_row_matrix(in->_v)); }
+BENCH(to_column_matrix) { destroy_matrix(to_column_matrix(in->_v)); }
+BENCH(pow_matrix) { destroy_matrix(pow_matrix(in->_a, 3)); }
+BENCH(div_matrix) { destroy_matrix(div_matrix(in->_a, in->_b)); }
+
+BENCH(create_vector) { destroy_vector(create_vector(in->_n)); }
+BENCH(clone_vector) { destroy_vector(clone_vector(in->_v)); }
+BENCH(resize_vector) { destroy_vector(resize_vector(in->_v, in->_n/2)); }
+BENCH(get_vector_chunk) { destroy_vector(get_vector_chunk(in->_v, in->_n/4, 3*in->_n/4-1)); }
+BENCH(store_vector)
+{
+store_vector(in->_v, TEMPORARY_FILE);
+in->_stored_vector = 1;
+in->_stored_matrix = 0;
+}
+BENCH(load_vector)
+{
+if(!in->_stored_vector) __bench_store_vector_(in);
+destroy_vector(load_vector(TEMPORARY_FILE));
+}
+BENCH(get_vector)
+{
+int i;
+double s = 0.0;
+for(i = 0; i < in->_n; i++) s += get_vector(in->_v, i);
+__sink_ = s;
+}
+BENCH(set_vector)
+{
+int i;
+for(i = 0; i < in->_n; i++) set_vector(in->_w, 1.0, i);
+}
+BENCH(add_vector) { destroy_vector(add_vector(in->_v, in->_w)); }
+BENCH(sub_vector) { destroy_vector(sub_vector(in->_v, in->_w)); }
+BENCH(scale_vector) { destroy_vector(scale_vector(in->_v, 2.0)); }
+BENCH(module_vector) { __sink_ = module_vector(in->_v); }
+BENCH(normalize_vector) { destroy_vector(normalize_vector(in->_v)); }
+BENCH(dot_product_vector) { __sink_ = dot_product_vector(in->_v, in->_w); }
+BENCH(cross_product_vector) { destroy_vector(cross_product_vector(in->_v3, in->_w3)); }
+
+BENCH(smcramer_system_solver) { destroy_vector(smcramer_system_solver(in->_system)); }
+BENCH(mvcramer_system_solver) { destroy_vector(mvcramer_system_solver(in->_a, in->_v)); }
+BENCH(smgauss_system_solver) { destroy_vector(smgauss_system_solver(in->_system)); }
+BENCH(mvgauss_system_solver) { destroy_vector(mvgauss_system_solver(in->_a, in->_v)); }
+BENCH(lu_system_solver) { destroy_vector(lu_system_solver(in->_lu, in->_v)); }
+BENCH(qr_system_solver) { destroy_vector(qr_system_solver(__qr_(in), in->_v)); }
+
+BENCH(lu_decomposition) { destroy_lu(lu_decomposition(in->_a)); }
+BENCH(qr_factorization) { destroy_qr(qr_factorization(in->_a)); }
+BENCH(qr_det) { __sink_ = qr_det(__qr_(in)); }
+
+BENCH(create_eigen) { destroy_eigen(create_eigen(1.0, in->_v)); }
+BENCH(clone_eigen) { destroy_eigen(clone_eigen(in->_eigen)); }
+BENCH(create_eigensystem) { destroy_eigensystem(create_eigensystem(in->_n)); }
+BENCH(clone_eigensystem) { destroy_eigensystem(clone_eigensystem(in->_eigsys)); }
+BENCH(max_eigen_power_method) { destroy_eigen(max_eigen_power_method(in->_s)); }
+BENCH(subspace_iteration) { destroy_eigensystem(subspace_iteration(in->_s, (in->_n < 16) ? in->_n/2 : 8, 0.0, 0, 0)); }
+BENCH(eigen_system) { destroy_eigensystem(eigen_system(in->_s)); }
+BENCH(inverse_iteration) { destroy_eigen(inverse_iteration(in->_s, 1.25, 0.0, 0)); }
+BENCH(rayleigh_quotient_iteration) { destroy_eigen(rayleigh_quotient_iteration(in->_s, NULL, 1.25, 0.0, 0)); }
+BENCH(symmetric_eigen_system) { destroy_eigensystem(symmetric_eigen_system(in->_s)); }
+
+BENCH(svd_factorization) { destroy_svd(svd_factorization(in->_a)); }
+BENCH(randomized_svd) { destroy_svd(randomized_svd(in->_a, (in->_n < 16) ? in->_n/2 : 8, 5, 1, in->_rng)); }
+BENCH(pca_factorization) { destroy_pca(pca_factorization(in->_a, (in->_n < 16) ? in->_n/2 : 8, 5, 1, in->_rng)); }
+BENCH(pca_transform) { destroy_matrix(pca_transform(__pca_(in), in->_a)); }
+
+BENCH(diagonalize_matrix) { destroy_diagonalization(diagonalize_matrix(in->_s)); }
+BENCH(clone_diagonalization) { destroy_diagonalization(clone_diagonalization(__diag_(in))); }
+BENCH(det_diagonalized_matrix) { __sink_ = det_diagonalized_matrix(__diag_(in)); }
+
+BENCH(lu_task_graph) { destroy_lu(lu_task_graph(in->_a, 0, 0, NULL)); }
+BENCH(cholesky_task_graph) { destroy_matrix(cholesky_task_graph(in->_s, 0, 0, NULL)); }
+BENCH(qr_task_graph) { destroy_qr(qr_task_graph(in->_a, 0, 0, NULL)); }
+
+#define ENTRY(name, header, order, max, coefficient, power) { #name, header, __bench_##name##_, order, max, coefficient, power }
+
+static const Benchmark __benchmarks_[] =
+{
+ENTRY(create_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(clone_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(store_matrix, "matrix.h", 2, FILE_SIZE, 0.0, 0),
+ENTRY(load_matrix, "matrix.h", 2, FILE_SIZE, 0.0, 0),
+ENTRY(get_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(set_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(get_matrix_chunk, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(resize_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(resize_matrix_rows, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(resize_matrix_columns, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(add_matrix, "matrix.h", 2, 0, 1.0, 2),
+ENTRY(sub_matrix, "matrix.h", 2, 0, 1.0, 2),
+ENTRY(mul_matrix, "matrix.h", 3, 0, 2.0, 3),
+ENTRY(gemm_matrix, "matrix.h", 3, 0, 2.0, 3),
+ENTRY(scale_matrix, "matrix.h", 2, 0, 1.0, 2),
+ENTRY(identity_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(transpose_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(trace_matrix, "matrix.h", 1, 0, 1.0, 1),
+ENTRY(diag_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(inverse_matrix, "matrix.h", 3, 0, 2.0, 3),
+ENTRY(det_matrix, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(rotation_matrix, "matrix.h", 0, MIN_SIZE, 0.0, 0),
+ENTRY(get_row_matrix, "matrix.h", 1, 0, 0.0, 0),
+ENTRY(get_column_matrix, "matrix.h", 1, 0, 0.0, 0),
+ENTRY(get_row_vector, "matrix.h", 1, 0, 0.0, 0),
+ENTRY(get_column_vector, "matrix.h", 1, 0, 0.0, 0),
+ENTRY(set_row_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(set_column_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(pseudoinverse_matrix, "matrix.h", 3, 0, 0.0, 0),
+ENTRY(nearest_orthogonal_matrix, "matrix.h", 3, 0, 0.0, 0),
+ENTRY(forbinius_norm_matrix, "matrix.h", 2, 0, 2.0, 2),
+ENTRY(minor, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(minor_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(first_minor, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(first_minor_matrix, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(cofactor_matrix, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(invert_matrix, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(determinant, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(is_symmetric, "matrix.h", 2, 0, 0.0, 0),
+ENTRY(rank_matrix, "matrix.h", 3, 0, 2.0/3.0, 3),
+ENTRY(fully_rank_matrix, "matrix.h", 3, 0, 2.0/3.0, 3),
+ENTRY(to_row_matrix, "matrix.h", 1, 0, 0.0, 0),
+ENTRY(to_column_matrix, "matrix.h", 1, 0, 0.0, 0),
+ENTRY(pow_matrix, "matrix.h", 3, 0, 4.0, 3),
+ENTRY(div_matrix, "matrix.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(create_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(clone_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(resize_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(get_vector_chunk, "vector.h", 1, 0, 0.0, 0),
+ENTRY(store_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(load_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(get_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(set_vector, "vector.h", 1, 0, 0.0, 0),
+ENTRY(add_vector, "vector.h", 1, 0, 1.0, 1),
+ENTRY(sub_vector, "vector.h", 1, 0, 1.0, 1),
+ENTRY(scale_vector, "vector.h", 1, 0, 1.0, 1),
+ENTRY(module_vector, "vector.h", 1, 0, 2.0, 1),
+ENTRY(normalize_vector, "vector.h", 1, 0, 3.0, 1),
+ENTRY(dot_product_vector, "vector.h", 1, 0, 2.0, 1),
+ENTRY(cross_product_vector, "vector.h", 0, MIN_SIZE, 0.0, 0),
+ENTRY(smcramer_system_solver, "linearsys.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(mvcramer_system_solver, "linearsys.h", 0, COFACTOR_SIZE, 0.0, 0),
+ENTRY(smgauss_system_solver, "linearsys.h", 3, 0, 2.0/3.0, 3),
+ENTRY(mvgauss_system_solver, "linearsys.h", 3, 0, 2.0/3.0, 3),
+ENTRY(lu_system_solver, "linearsys.h", 2, 0, 2.0, 2),
+ENTRY(qr_system_solver, "linearsys.h", 2, QR_SIZE, 3.0, 2),
+ENTRY(lu_decomposition, "lu.h", 3, 0, 2.0/3.0, 3),
+ENTRY(qr_factorization, "qr.h", 5, 0, 4.0/3.0, 3),
+ENTRY(qr_det, "qr.h", 2, QR_SIZE, 0.0, 0),
+ENTRY(create_eigen, "eigen.h", 1, 0, 0.0, 0),
+ENTRY(clone_eigen, "eigen.h", 1, 0, 0.0, 0),
+ENTRY(create_eigensystem, "eigen.h", 1, 0, 0.0, 0),
+ENTRY(clone_eigensystem, "eigen.h", 2, 0, 0.0, 0),
+ENTRY(max_eigen_power_method, "eigen.h", 3, 0, 0.0, 0),
+ENTRY(subspace_iteration, "eigen.h", 3, 0, 0.0, 0),
+ENTRY(eigen_system, "eigen.h", 6, 0, 0.0, 0),
+ENTRY(inverse_iteration, "eigen.h", 3, 0, 0.0, 0),
+ENTRY(rayleigh_quotient_iteration, "eigen.h", 3, 0, 0.0, 0),
+ENTRY(symmetric_eigen_system, "eigen.h", 3, 0, 0.0, 0),
+ENTRY(svd_factorization, "svd.h", 3, 0, 0.0, 0),
+ENTRY(randomized_svd, "svd.h", 2, 0, 0.0, 0),
+ENTRY(pca_factorization, "svd.h", 2, 0, 0.0, 0),
+ENTRY(pca_transform, "svd.h", 2, 0, 0.0, 0),
+ENTRY(diagonalize_matrix, "diagonalization.h", 6, 0, 0.0, 0),
+ENTRY(clone_diagonalization, "diagonalization.h", 2, EIGEN_SIZE, 0.0, 0),
+ENTRY(det_diagonalized_matrix, "diagonalization.h", 1, EIGEN_SIZE, 0.0, 0),
+ENTRY(lu_task_graph, "taskgraph.h", 3, 0, 2.0/3.0, 3),
+ENTRY(cholesky_task_graph, "taskgraph.h", 3, 0, 1.0/3.0, 3),
+ENTRY(qr_task_graph, "taskgraph.h", 3, 0, 4.0/3.0, 3)
+};
+
+#define BENCHMARKS ((int)(sizeof(__benchmarks_) / sizeof(__benchmarks_[0])))
+
+/*
+* Times a routine for a size and writes its JSON record.
+*
+* returns: the median time of a call in seconds.
+*/
+static double __measure_(const Benchmark* b, Input* in, int first)
+{
+int i, count;
+double t, median, p99, flops;
+double* samples = NULL;
+size_t allocated;
+/* the first call warms up the caches and builds the inputs made on first use */
+t = __now_();
+b->_run(in);
+t = __now_() - t;
+count = (t > 0.0) ? (int)(CASE_TIME / t) : MAX_SAMPLES;
+if(count < MIN_SAMPLES) count = MIN_SAMPLES;
+if(count > MAX_SAMPLES) count = MAX_SAMPLES;
+samples = (double*)malloc(count * sizeof(double));
+allocated = __allocated_;
+for(i = 0; i < count; i++)
+{
+	t = __now_();
+	b->_run(in);
+	samples[i] = __now_() - t;
+}
+allocated = __allocated_ - allocated;
+qsort(samples, count, sizeof(double), __compare_);
+median = samples[count/2];
+p99 = samples[(int)ceil(0.99 * count) - 1];
+flops = b->_coefficient * pow((double)in->_n, (double)b->_power);
+printf("%s\n{\"routine\": \"%s\", \"header\": \"%s\", \"size\": %d, \"samples\": %d, \"median_ns\": %.0f, \"p99_ns\": %.0f, ",
+(first) ? "" : ",", b->_name, b->_header, in->_n, count, 1E9 * median, 1E9 * p99);
+if(flops > 0.0 && median > 0.0) printf("\"gflops\": %.4g, ", 1E-9 * flops / median);
+else printf("\"gflops\": null, ");
+#ifdef COUNT_ALLOCATIONS
+printf("\"bytes_allocated\": %.0f}", (double)allocated / count);
+#else
+printf("\"bytes_allocated\": null}");
+#endif
+fflush(stdout);
+
+/* release previously allocated memory */
+free(samples);
+
+return median;
+}
+
+/* end helper functions */
+
+int main(int argc, char** argv)
+{
+int i, n, first = 1, max_size = MAX_SIZE;
+int* stopped = NULL;
+double budget = DEFAULT_BUDGET;
+double median;
+const char* filter = NULL;
+Input* in = NULL;
+if(argc > 1) max_size = atoi(argv[1]);
+if(argc > 2) budget = atof(argv[2]);
+if(argc > 3) filter = argv[3];
+if(max_size < MIN_SIZE) max_size = MIN_SIZE;
+if(budget <= 0.0) budget = DEFAULT_BUDGET;
+stopped = (int*)calloc(BENCHMARKS, sizeof(int));
+printf("{\"library\": \"linearsys\", \"threads\": %d, \"budget\": %g, \"results\": [", threads_threadpool(NULL), budget);
+for(n = MIN_SIZE; n <= max_size; n *= 2)
+{
+	in = __create_input_(n);
+	for(i = 0; i < BENCHMARKS; i++)
+	{
+		if(stopped[i] || (filter != NULL && strstr(__benchmarks_[i]._name, filter) == NULL)) continue;
+		if(__benchmarks_[i]._max > 0 && n > __benchmarks_[i]._max) continue;
+		fprintf(stderr, "%s %d\n", __benchmarks_[i]._name, n);
+		median = __measure_(&__benchmarks_[i], in, first);
+		first = 0;
+		/* do not try a size whose calls are expected to take longer than the budget */
+		if(median * pow(2.0, __benchmarks_[i]._order) > budget) stopped[i] = 1;
+	}
+	__destroy_input_(in);
+}
+printf("\n]}\n");
+
+/* release previously allocated memory */
+free(stopped);
+
+return 0;
+}
+
+/* END */
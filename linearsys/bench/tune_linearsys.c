@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+* Tuning program of the library.
+* It times the library's own kernels on this computer with different parameters and writes the best ones
+* to the per-host tuning file, which the library reads on first use ( see tuning.h ):
+*
+* - gemm_kc, gemm_nc and gemm_mc: block sizes of the matrix product, tried one after the other
+*   ( the best of each is kept for the next ) with a single thread.
+* - lu_block: panel width of the LU decomposition.
+* - parallel_gemm: the smallest matrix product ( m*n*k ) from which the parallel product is faster.
+* - parallel_parse: the shortest text from which parsing in parallel is faster.
+*
+* The time of a try is its fastest call. The tries are written to the standard output.
+*
+* usage: tune [size] [filename]
+* size order of the matrices used to choose the block sizes ( 512 by default ).
+* filename file to write, the per-host tuning file by default.
+*/
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "matrix.h"
+#include "lu.h"
+#include "kernel.h"
+#include "numio.h"
+#include "rng.h"
+#include "threadpool.h"
+#include "tuning.h"
+
+#define DEFAULT_SIZE 512
+#define MIN_SIZE 64
+#define TRY_TIME 0.2 /* seconds of calls for a try */
+#define MIN_CALLS 3
+#define SERIAL 1E300 /* a parallel threshold which is never reached */
+
+static const int __kc_[] = { 64, 128, 256, 384, 512 };
+static const int __nc_[] = { 256, 512, 1024, 2048, 4096 };
+static const int __mc_[] = { 16, 32, 64, 96, 128, 256 };
+static const int __lu_[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+static const size_t __gemm_sizes_[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+static const size_t __parse_sizes_[] = { 16384, 32768, 65536, 131072, 262144, 524288,
+1048576, 2097152, 4194304, 8388608, 16777216 };
+
+#define COUNT(array) ((int)(sizeof(array) / sizeof(array[0])))
+
+/*
+* Data shared by the tries.
+*/
+typedef struct
+{
+int _n; /* order of the matrices */
+double* _a;
+double* _b;
+double* _c;
+Matrix* _m; /* matrix to factorize */
+char* _text; /* numbers to parse */
+size_t _length;
+double* _values;
+int _count; /* numbers in the text */
+}Input;
+
+/*
+* Function type for a timed routine; size is the order of the matrices or the length of the text.
+*/
+typedef void (*Routine)(Input* in, size_t size);
+
+/*
+* Helper functions.
+*/
+
+static double __now_(void)
+{
+struct timespec t;
+clock_gettime(CLOCK_MONOTONIC, &t);
+return (double)t.tv_sec + 1E-9 * (double)t.tv_nsec;
+}
+
+/*
+* Calls a routine until TRY_TIME seconds pass ( at least MIN_CALLS times ) and returns its fastest call.
+*/
+static double __time_(Routine routine, Input* in, size_t size)
+{
+int calls = 0;
+double start, t, best = 0.0, total = 0.0;
+while(calls < MIN_CALLS || total < TRY_TIME)
+{
+	start = __now_();
+	routine(in, size);
+	t = __now_() - start;
+	if(calls == 0 || t < best) best = t;
+	total += t;
+	calls++;
+}
+return best;
+}
+
+static void __run_gemm_(Input* in, size_t size)
+{
+int n = (int)size;
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, n, n, n, 1.0, in->_a, n, in->_b, n, 0.0, in->_c, n);
+}
+
+static void __run_lu_(Input* in, size_t size)
+{
+destroy_lu(lu_decomposition(in->_m));
+}
+
+static void __run_parse_(Input* in, size_t size)
+{
+/* cut the text after a separator, so no number is cut */
+while(size < in->_length && in->_text[size-1] != ' ' && in->_text[size-1] != '\n') size++;
+parse_doubles(in->_text, size, in->_values, in->_count);
+}
+
+static Input* __create_input_(int n)
+{
+int i;
+size_t size = (size_t)n*n;
+Random* rng = create_random(DEFAULT_SEED);
+Input* in = (Input*)malloc(sizeof(Input));
+in->_n = n;
+in->_a = (double*)malloc(size * sizeof(double));
+in->_b = (double*)malloc(size * sizeof(double));
+in->_c = (double*)malloc(size * sizeof(double));
+in->_m = create_matrix(n, n);
+for(i = 0; i < (int)size; i++)
+{
+	in->_a[i] = uniform_random(rng) - 0.5;
+	in->_b[i] = uniform_random(rng) - 0.5;
+	in->_m->_data[i] = uniform_random(rng) - 0.5;
+}
+/* lines of 8 numbers, at least 8 characters each, filling the longest text */
+in->_count = (int)(__parse_sizes_[COUNT(__parse_sizes_)-1] / 8);
+in->_text = (char*)malloc((size_t)in->_count * (FORMAT_DOUBLE_SIZE+1));
+in->_values = (double*)malloc(in->_count * sizeof(double));
+in->_length = 0;
+for(i = 0; i < in->_count; i++)
+{
+	in->_length += format_double(uniform_random(rng), in->_text + in->_length);
+	in->_text[in->_length++] = (i % 8 == 7) ? '\n' : ' ';
+}
+destroy_random(rng);
+return in;
+}
+
+static void __destroy_input_(Input* in)
+{
+free(in->_a);
+free(in->_b);
+free(in->_c);
+destroy_matrix(in->_m);
+free(in->_text);
+free(in->_values);
+free(in);
+}
+
+/*
+* Tries the values of a parameter with the other ones fixed, and leaves the fastest one in *field.
+*/
+static void __sweep_(const char* name, int* field, const int* values, int count, Tuning* t, Routine routine, Input* in)
+{
+int i, best = *field;
+double time, best_time = 0.0;
+for(i = 0; i < count; i++)
+{
+	*field = values[i];
+	set_tuning(t);
+	time = __time_(routine, in, in->_n);
+	printf("%s %d %.6f\n", name, values[i], time);
+	if(i == 0 || time < best_time)
+	{
+		best_time = time;
+		best = values[i];
+	}
+}
+*field = best;
+set_tuning(t);
+}
+
+/*
+* Times a routine with the serial and the parallel Tuning for each size.
+*
+* returns: the index of the first size from which the parallel version is faster for all the bigger sizes,
+* or count if it is not faster for the biggest one.
+*/
+static int __crossover_(const char* name, const size_t* sizes, int count, const Tuning* serial, const Tuning* parallel,
+Routine routine, Input* in)
+{
+int i, first = count;
+double ts, tp;
+for(i = 0; i < count; i++)
+{
+	set_tuning(serial);
+	ts = __time_(routine, in, sizes[i]);
+	set_tuning(parallel);
+	tp = __time_(routine, in, sizes[i]);
+	printf("%s %lu serial %.6f parallel %.6f\n", name, (unsigned long)sizes[i], ts, tp);
+	if(tp >= ts) first = count;
+	else if(first == count) first = i;
+}
+return first;
+}
+
+/* end helper functions */
+
+int main(int argc, char** argv)
+{
+int i, sizes, n = DEFAULT_SIZE;
+int lu[COUNT(__lu_)+1];
+double size;
+char filename[FILENAME_MAX];
+const char* out = NULL;
+Tuning t, serial, parallel;
+Input* in = NULL;
+if(argc > 1) n = atoi(argv[1]);
+if(n < MIN_SIZE) n = MIN_SIZE;
+if(argc > 2) out = argv[2];
+else
+{
+	if(!filename_tuning(filename, FILENAME_MAX))
+	{
+		fprintf(stderr, "cannot find the name of the tuning file, give it as an argument\n");
+		return 1;
+	}
+	out = filename;
+}
+in = __create_input_(n);
+printf("# %d threads, size %d\n", threads_threadpool(NULL), n);
+/* start from the built-in values, whatever the current file says */
+default_tuning(&t);
+/* block sizes of the matrix product, in a single thread */
+t._parallel_gemm = SERIAL;
+__sweep_("gemm_kc", &t._gemm_kc, __kc_, COUNT(__kc_), &t, __run_gemm_, in);
+__sweep_("gemm_nc", &t._gemm_nc, __nc_, COUNT(__nc_), &t, __run_gemm_, in);
+__sweep_("gemm_mc", &t._gemm_mc, __mc_, COUNT(__mc_), &t, __run_gemm_, in);
+/* sizes from which the threads are used */
+if(threads_threadpool(NULL) > 1)
+{
+	serial = t;
+	parallel = t;
+	parallel._parallel_gemm = 0.0;
+	for(sizes = 0; sizes < COUNT(__gemm_sizes_) && __gemm_sizes_[sizes] <= (size_t)n; sizes++);
+	i = __crossover_("parallel_gemm", __gemm_sizes_, sizes, &serial, &parallel, __run_gemm_, in);
+	/* past the biggest size if the threads never paid off */
+	size = (i < sizes) ? (double)__gemm_sizes_[i] : 2.0 * __gemm_sizes_[sizes-1];
+	t._parallel_gemm = size*size*size;
+	serial._parallel_parse = (size_t)-1;
+	parallel._parallel_parse = 0;
+	i = __crossover_("parallel_parse", __parse_sizes_, COUNT(__parse_sizes_), &serial, &parallel, __run_parse_, in);
+	sizes = COUNT(__parse_sizes_);
+	t._parallel_parse = (i < sizes) ? __parse_sizes_[i] : 2 * __parse_sizes_[sizes-1];
+}
+else
+{
+	/* a single thread: the thresholds are not used */
+	default_tuning(&serial);
+	t._parallel_gemm = serial._parallel_gemm;
+}
+/* panel width of the LU decomposition, with the threshold found; n means not blocked */
+for(sizes = 0; sizes < COUNT(__lu_) && __lu_[sizes] < n; sizes++) lu[sizes] = __lu_[sizes];
+lu[sizes++] = n;
+__sweep_("lu_block", &t._lu_block, lu, sizes, &t, __run_lu_, in);
+__destroy_input_(in);
+if(!store_tuning(out, &t))
+{
+	fprintf(stderr, "cannot write %s\n", out);
+	return 1;
+}
+printf("# written to %s\n", out);
+return 0;
+}
+
+/* END */
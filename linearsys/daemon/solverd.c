@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+* Solver daemon of the library.
+* It keeps the LU decompositions of the matrices the processes of this computer solve against,
+* together with the matrices, which are found by a hash of their contents ( key_remote in remote.h )
+* and compared entry by entry, and solves systems with them for the clients,
+* which connect through a Unix domain socket and pass their matrices and right hand sides in shared memory.
+* The daemon reads and writes that memory with pread and pwrite rather than mapping it,
+* since a client can shrink it at any time and touching a mapping past its end would kill the daemon ( SIGBUS ).
+* A matrix is factorized once, by the first client using it, and the factorizations used last are kept;
+* the matrices given in the command line are factorized when the daemon starts and are never dropped.
+* Each client is served by its own thread, so the clients solve at the same time, up to a maximum of clients.
+* The socket can only be used by the user running the daemon.
+*
+* usage: solverd [-s socket] [-c capacity] [-m clients] [matrix_file ...]
+* socket path of the socket, the LINEARSYS_SOCKET environment variable or /tmp/linearsys.sock by default.
+* capacity number of factorizations kept besides those of the files ( 8 by default ).
+* clients number of clients served at the same time ( 64 by default ); other connections are closed at once.
+* matrix_file files with matrices to load ( as load_matrix ).
+*/
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L /* sigaction, pread */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "matrix.h"
+#include "vector.h"
+#include "lu.h"
+#include "linearsys.h"
+#include "remote.h"
+
+#define DEFAULT_CAPACITY 8
+#define DEFAULT_CLIENTS 64
+#define BACKLOG 16
+
+/*
+* Factorization type definition: a LU decomposition used by the cache and by the requests solving with it.
+*/
+typedef struct
+{
+LU* _lu;
+Matrix* _matrix; /* the matrix factorized, to compare with those of the clients */
+unsigned long long _id; /* unique while the daemon runs */
+int _references; /* the cache and each request using it */
+}Factorization;
+
+/*
+* Entry type definition: a slot of the cache.
+*/
+typedef struct
+{
+unsigned long long _key;
+Factorization* _f; /* NULL for an empty slot */
+int _permanent; /* loaded from a file, never dropped */
+unsigned long _used; /* time of the last use */
+}Entry;
+
+/*
+* The cache: the factorizations kept, protected by a lock.
+*/
+static pthread_mutex_t __lock_ = PTHREAD_MUTEX_INITIALIZER;
+static Entry* __cache_ = NULL;
+static int __slots_ = 0;
+static unsigned long __clock_ = 0;
+static unsigned long long __ids_ = 0; /* last id given to a factorization */
+static int __clients_ = 0; /* clients being served */
+static char __path_[sizeof(((struct sockaddr_un*)0)->sun_path)];
+
+/*
+* Helper functions.
+*/
+
+static void __release_(Factorization* f)
+{
+int references;
+if(f == NULL) return;
+pthread_mutex_lock(&__lock_);
+references = --f->_references;
+pthread_mutex_unlock(&__lock_);
+if(references > 0) return;
+/* release previously allocated memory */
+destroy_lu(f->_lu);
+destroy_matrix(f->_matrix);
+free(f);
+}
+
+/*
+* Checks whether a factorization is the one of the order x order matrix at data.
+*/
+static int __same_(const Factorization* f, const double* data, int order)
+{
+return rows_matrix(f->_matrix) == order && memcmp(f->_matrix->_data, data, (size_t)order*order*sizeof(double)) == 0;
+}
+
+/*
+* Looks for the factorization of the order x order matrix at data, whose key is key; the cache lock must be held.
+*
+* returns: its slot or -1 if it is not in the cache.
+*/
+static int __find_(unsigned long long key, const double* data, int order)
+{
+int i;
+for(i = 0; i < __slots_; i++)
+{
+	/* the key only selects the candidates, the entries decide */
+	if(__cache_[i]._f != NULL && __cache_[i]._key == key && __same_(__cache_[i]._f, data, order)) return i;
+}
+return -1;
+}
+
+/*
+* Gets the factorization id, or NULL if it is not in the cache; it must be released with __release_.
+*/
+static Factorization* __acquire_(unsigned long long id)
+{
+int i;
+Factorization* f = NULL;
+pthread_mutex_lock(&__lock_);
+for(i = 0; i < __slots_; i++)
+{
+	if(__cache_[i]._f == NULL || __cache_[i]._f->_id != id) continue;
+	f = __cache_[i]._f;
+	f->_references++;
+	__cache_[i]._used = ++__clock_;
+	break;
+}
+pthread_mutex_unlock(&__lock_);
+return f;
+}
+
+/*
+* Looks for the factorization of the order x order matrix at data.
+*
+* returns: its id, or 0 if it is not in the cache.
+*/
+static unsigned long long __lookup_(const double* data, int order)
+{
+Matrix m;
+unsigned long long key, id = 0;
+int slot;
+m._rows = order;
+m._columns = order;
+m._data = (double*)data;
+key = key_remote(&m);
+pthread_mutex_lock(&__lock_);
+slot = __find_(key, data, order);
+if(slot >= 0)
+{
+	id = __cache_[slot]._f->_id;
+	__cache_[slot]._used = ++__clock_;
+}
+pthread_mutex_unlock(&__lock_);
+return id;
+}
+
+/*
+* Adds a factorization to the cache, dropping the one used least recently if it is full.
+* It takes the matrix and the LU decomposition, which are released when another client already added the matrix.
+*
+* returns: the id of the factorization of the matrix, or 0 if it cannot be kept.
+*/
+static unsigned long long __insert_(Matrix* m, LU* lu, int permanent)
+{
+int i, slot = -1;
+unsigned long long key = key_remote(m), id;
+Factorization* dropped = NULL;
+Factorization* f = (Factorization*)malloc(sizeof(Factorization));
+f->_lu = lu;
+f->_matrix = m;
+f->_references = 1;
+pthread_mutex_lock(&__lock_);
+f->_id = ++__ids_;
+i = __find_(key, m->_data, rows_matrix(m));
+if(i >= 0)
+{
+	id = __cache_[i]._f->_id;
+	pthread_mutex_unlock(&__lock_);
+	__release_(f);
+	return id;
+}
+for(i = 0; i < __slots_; i++)
+{
+	/* an empty slot, else the one used least recently */
+	if(__cache_[i]._f == NULL)
+	{
+		if(slot < 0 || __cache_[slot]._f != NULL) slot = i;
+	}
+	else if(!__cache_[i]._permanent && (slot < 0 || (__cache_[slot]._f != NULL && __cache_[i]._used < __cache_[slot]._used))) slot = i;
+}
+if(slot < 0)
+{
+	/* only permanent factorizations: keep it out of the cache */
+	pthread_mutex_unlock(&__lock_);
+	__release_(f);
+	return 0;
+}
+dropped = __cache_[slot]._f;
+__cache_[slot]._key = key;
+__cache_[slot]._f = f;
+__cache_[slot]._permanent = permanent;
+__cache_[slot]._used = ++__clock_;
+id = f->_id;
+pthread_mutex_unlock(&__lock_);
+__release_(dropped);
+return id;
+}
+
+/*
+* Factorizes the order x order matrix at data and stores the id of its factorization.
+* The matrix is copied, since data is the buffer of the client and the cache keeps the matrix.
+*/
+static int __factorize_(const double* data, int order, unsigned long long* id)
+{
+LU* lu = NULL;
+Matrix* m = create_matrix(order, order);
+memcpy(m->_data, data, (size_t)order*order*sizeof(double));
+lu = lu_decomposition(m);
+if(lu == NULL)
+{
+	destroy_matrix(m);
+	return REMOTE_SINGULAR;
+}
+*id = __insert_(m, lu, 0);
+return (*id != 0) ? REMOTE_OK : REMOTE_ERROR;
+}
+
+/*
+* Solves count systems whose right hand sides are at data, writing the solutions over them.
+*/
+static int __solve_(double* data, int count, int order, unsigned long long id)
+{
+int k;
+Vector b;
+Vector* x = NULL;
+Factorization* f = __acquire_(id);
+if(f == NULL) return REMOTE_MISSING;
+if(rows_matrix(f->_matrix) != order)
+{
+	__release_(f);
+	return REMOTE_ERROR;
+}
+b._size = order;
+for(k = 0; k < count; k++)
+{
+	/* the solution goes over its right hand side */
+	b._data = data + (size_t)k*order;
+	x = lu_system_solver(f->_lu, &b);
+	memcpy(b._data, x->_data, (size_t)order*sizeof(double));
+	destroy_vector(x);
+}
+__release_(f);
+return REMOTE_OK;
+}
+
+/*
+* Checks whether rows x columns doubles fit in size bytes, without overflows.
+*/
+static int __fits_(int rows, int columns, size_t size)
+{
+return rows >= 1 && columns >= 1 && (size_t)rows <= size / sizeof(double) / (size_t)columns;
+}
+
+/*
+* Reads the first rows x columns doubles of the shared memory of a client into its buffer, which grows as needed.
+*
+* returns: the buffer, or NULL if the memory is shorter, since the client can shrink it at any time.
+*/
+static double* __read_shared_(int shared, int rows, int columns, double** buffer, size_t* capacity)
+{
+size_t size = (size_t)rows * columns * sizeof(double), done = 0;
+ssize_t n;
+double* p = NULL;
+if(size > *capacity)
+{
+	p = (double*)realloc(*buffer, size);
+	if(p == NULL) return NULL;
+	*buffer = p;
+	*capacity = size;
+}
+while(done < size)
+{
+	n = pread(shared, (char*)*buffer + done, size - done, (off_t)done);
+	if(n < 0 && errno == EINTR) continue;
+	if(n <= 0) return NULL;
+	done += (size_t)n;
+}
+return *buffer;
+}
+
+/*
+* Writes rows x columns doubles at the start of the shared memory of a client.
+*
+* returns: 1 on success or 0 on failure.
+*/
+static int __write_shared_(int shared, const double* data, int rows, int columns)
+{
+size_t size = (size_t)rows * columns * sizeof(double), done = 0;
+ssize_t n;
+while(done < size)
+{
+	n = pwrite(shared, (const char*)data + done, size - done, (off_t)done);
+	if(n < 0 && errno == EINTR) continue;
+	if(n <= 0) return 0;
+	done += (size_t)n;
+}
+return 1;
+}
+
+/*
+* Serves the requests of a client until it disconnects.
+*/
+static void* __client_(void* arg)
+{
+int s = (int)(intptr_t)arg;
+int fd, shared = -1;
+size_t size = 0, capacity = 0;
+double* buffer = NULL;
+double* data = NULL;
+struct stat st;
+RemoteRequest request;
+RemoteReply reply;
+while(receive_remote(s, &request, sizeof(RemoteRequest), &fd))
+{
+	reply._status = REMOTE_ERROR;
+	reply._id = 0;
+	switch(request._command)
+	{
+	case REMOTE_ATTACH:
+		/* the memory must be as big as the client says; the reads below still check it, as it can shrink later */
+		if(fd < 0 || request._size == 0 || request._size > SIZE_MAX || fstat(fd, &st) != 0) break;
+		if(st.st_size < 0 || (unsigned long long)st.st_size < request._size) break;
+		if(shared >= 0) close(shared);
+		/* the daemon keeps the descriptor */
+		shared = fd;
+		fd = -1;
+		size = (size_t)request._size;
+		reply._status = REMOTE_OK;
+		break;
+	case REMOTE_LOOKUP:
+		if(!__fits_(request._order, request._order, size)) break;
+		data = __read_shared_(shared, request._order, request._order, &buffer, &capacity);
+		if(data == NULL) break;
+		reply._id = __lookup_(data, request._order);
+		reply._status = (reply._id != 0) ? REMOTE_OK : REMOTE_MISSING;
+		break;
+	case REMOTE_FACTORIZE:
+		if(!__fits_(request._order, request._order, size)) break;
+		data = __read_shared_(shared, request._order, request._order, &buffer, &capacity);
+		if(data == NULL) break;
+		reply._status = __factorize_(data, request._order, &reply._id);
+		break;
+	case REMOTE_SOLVE:
+		if(!__fits_(request._count, request._order, size)) break;
+		data = __read_shared_(shared, request._count, request._order, &buffer, &capacity);
+		if(data == NULL) break;
+		reply._status = __solve_(data, request._count, request._order, request._id);
+		if(reply._status == REMOTE_OK && !__write_shared_(shared, data, request._count, request._order)) reply._status = REMOTE_ERROR;
+		reply._id = request._id;
+		break;
+	}
+	if(fd >= 0) close(fd);
+	if(!send_remote(s, &reply, sizeof(RemoteReply), -1)) break;
+}
+/* release previously allocated memory */
+if(shared >= 0) close(shared);
+free(buffer);
+close(s);
+pthread_mutex_lock(&__lock_);
+__clients_--;
+pthread_mutex_unlock(&__lock_);
+return NULL;
+}
+
+/*
+* Takes a place for a new client.
+*
+* returns: 1 if it can be served or 0 if there are already max clients.
+*/
+static int __admit_(int max)
+{
+int admitted;
+pthread_mutex_lock(&__lock_);
+admitted = (__clients_ < max);
+if(admitted) __clients_++;
+pthread_mutex_unlock(&__lock_);
+return admitted;
+}
+
+static void __stop_(int number)
+{
+(void)number;
+unlink(__path_);
+_exit(0);
+}
+
+/*
+* Loads a matrix file and keeps its factorization.
+*/
+static int __load_(const char* filename)
+{
+unsigned long long key;
+int order;
+LU* lu = NULL;
+Matrix* m = load_matrix(filename);
+if(m == NULL || rows_matrix(m) != columns_matrix(m))
+{
+	fprintf(stderr, "%s: cannot load a square matrix\n", filename);
+	destroy_matrix(m);
+	return 0;
+}
+key = key_remote(m);
+order = rows_matrix(m);
+lu = lu_decomposition(m);
+if(lu == NULL)
+{
+	fprintf(stderr, "%s: singular matrix\n", filename);
+	destroy_matrix(m);
+	return 0;
+}
+/* the cache keeps the matrix */
+__insert_(m, lu, 1);
+printf("%s: order %d, key %016llx\n", filename, order, key);
+return 1;
+}
+
+/* end helper functions */
+
+int main(int argc, char** argv)
+{
+int i, s, client, files = 0, capacity = DEFAULT_CAPACITY, clients = DEFAULT_CLIENTS;
+const char* path = getenv("LINEARSYS_SOCKET");
+struct sockaddr_un address;
+struct sigaction action;
+pthread_t thread;
+pthread_attr_t attributes;
+RemoteSolver* running = NULL;
+if(path == NULL) path = REMOTE_SOCKET;
+for(i = 1; i < argc; i++)
+{
+	if(strcmp(argv[i], "-s") == 0 && i+1 < argc) path = argv[++i];
+	else if(strcmp(argv[i], "-c") == 0 && i+1 < argc) capacity = atoi(argv[++i]);
+	else if(strcmp(argv[i], "-m") == 0 && i+1 < argc) clients = atoi(argv[++i]);
+	else files++;
+}
+if(capacity < 1) capacity = 1;
+if(clients < 1) clients = 1;
+if(strlen(path) >= sizeof(__path_))
+{
+	fprintf(stderr, "socket path too long: %s\n", path);
+	return 1;
+}
+strcpy(__path_, path);
+/* a socket a daemon answers on is not taken over */
+running = connect_remote(path);
+if(running != NULL)
+{
+	disconnect_remote(running);
+	fprintf(stderr, "a daemon is already running on %s\n", path);
+	return 1;
+}
+__slots_ = capacity + files;
+__cache_ = (Entry*)calloc(__slots_, sizeof(Entry));
+for(i = 1; i < argc; i++)
+{
+	if(strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "-m") == 0) i++;
+	else __load_(argv[i]);
+}
+s = socket(AF_UNIX, SOCK_STREAM, 0);
+memset(&address, 0, sizeof(struct sockaddr_un));
+address.sun_family = AF_UNIX;
+strcpy(address.sun_path, path);
+unlink(path);
+/* only the user running the daemon can connect; nobody can before listen */
+if(s < 0 || bind(s, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) != 0 || chmod(path, S_IRUSR | S_IWUSR) != 0 || listen(s, BACKLOG) != 0)
+{
+	perror(path);
+	return 1;
+}
+memset(&action, 0, sizeof(struct sigaction));
+action.sa_handler = __stop_;
+sigaction(SIGINT, &action, NULL);
+sigaction(SIGTERM, &action, NULL);
+action.sa_handler = SIG_IGN;
+sigaction(SIGPIPE, &action, NULL);
+pthread_attr_init(&attributes);
+pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+printf("listening on %s\n", path);
+fflush(stdout);
+while(1)
+{
+	client = accept(s, NULL, NULL);
+	if(client < 0) continue;
+	if(!__admit_(clients))
+	{
+		/* too many clients: the client sees the connection closed */
+		close(client);
+		continue;
+	}
+	if(pthread_create(&thread, &attributes, __client_, (void*)(intptr_t)client) != 0)
+	{
+		close(client);
+		pthread_mutex_lock(&__lock_);
+		__clients_--;
+		pthread_mutex_unlock(&__lock_);
+	}
+}
+return 0;
+}
+
+/* END */
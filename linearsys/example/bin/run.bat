@@ -2,3 +2,5 @@
 set path=..\..\lib;%path%
 prog > out.txt
 echo Output saved to out.txt
+tests > tests.txt
+echo Tests output saved to tests.txt, %errorlevel% failures
@@ -1,3 +1,5 @@
 export PATH=../../lib/:$PATH
 ./prog >& out.txt
 echo Output saved to out.txt
+./tests >& tests.txt
+echo Tests output saved to tests.txt, $? failures
@@ -0,0 +1,1644 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+* Behaviour tests of the decompositions, file formats and services of the library.
+* Every check prints its name followed by ok or FAILED and the program returns the number of failures.
+* The default thread pool has 4 threads unless the LINEARSYS_THREADS environment variable says otherwise.
+* The files used by the tests are written in the current folder and removed at the end.
+* The remote solver tests need a solver daemon ( the daemon folder ) listening on the socket
+* of the LINEARSYS_SOCKET environment variable or the default one; they are skipped if there is none.
+*/
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L /* shm_open, nanosleep */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#include "linearsys.h"
+#include "binio.h"
+#include "stream.h"
+#include "tiled.h"
+#include "allocator.h"
+#include "npyio.h"
+#include "mmio.h"
+#include "batch.h"
+#include "codec.h"
+#include "eigen.h"
+#include "checkpoint.h"
+#include "async.h"
+#include "remote.h"
+#include "svd.h"
+#include "krylov.h"
+#include "diagonalization.h"
+#include "rng.h"
+#include "numio.h"
+#include "tuning.h"
+#include "threadpool.h"
+
+#define PI 3.14159265358979323846
+
+static int failures = 0;
+
+/*
+* Helper functions.
+*/
+
+/*
+* Prints the result of a check and counts the failures.
+* param: name of the check.
+* param: ok nonzero if the check passed.
+*/
+static void __check_(const char* name, int ok)
+{
+printf("%s: %s\n", name, ok ? "ok" : "FAILED");
+if(!ok) failures++;
+}
+
+/*
+* Creates a Matrix with reproducible entries.
+* param: r number of rows.
+* param: c number of columns.
+* param: seed different seeds give different entries.
+*
+* returns: the new Matrix.
+*/
+static Matrix* __sample_(int r, int c, int seed)
+{
+Matrix* m = create_matrix(r, c);
+int i, j;
+for(i = 0; i < r; i++)
+for(j = 0; j < c; j++)
+m->_data[i*c+j] = sin(0.37*(i+1) + 1.13*(j+1) + seed) * (1.0 + (i+j) % 7);
+return m;
+}
+
+/*
+* Checks whether two matrices hold exactly the same entries.
+* param: a first Matrix, may be NULL.
+* param: b second Matrix, may be NULL.
+*
+* returns: 1 if both are not NULL and equal, 0 otherwise.
+*/
+static int __same_(const Matrix* a, const Matrix* b)
+{
+if(!a || !b) return 0;
+if(a->_rows != b->_rows || a->_columns != b->_columns) return 0;
+return memcmp(a->_data, b->_data, (size_t)a->_rows*a->_columns*sizeof(double)) == 0;
+}
+
+/*
+* Returns the size in bytes of a file or -1 if it cannot be opened.
+*/
+static long __size_(const char* filename)
+{
+FILE* f = fopen(filename, "rb");
+long size;
+if(!f) return -1;
+fseek(f, 0, SEEK_END);
+size = ftell(f);
+fclose(f);
+return size;
+}
+
+/*
+* Copies the first bytes of a file into another one, as a transfer cut short would leave it.
+* param: from name of the source file.
+* param: to name of the truncated copy.
+* param: size number of bytes to keep.
+*
+* returns: 1 on success or 0 on failure.
+*/
+static int __truncate_(const char* from, const char* to, long size)
+{
+FILE* in = fopen(from, "rb");
+FILE* out = fopen(to, "wb");
+int c, ok = in && out;
+while(ok && size-- > 0 && (c = fgetc(in)) != EOF) fputc(c, out);
+if(in) fclose(in);
+if(out) fclose(out);
+return ok;
+}
+
+/*
+* Overwrites a 64 bit field of a file in place, as a forged or damaged file would have it.
+* param: filename name of the file.
+* param: offset position of the field.
+* param: value new value of the field.
+*
+* returns: 1 on success or 0 on failure.
+*/
+static int __patch_(const char* filename, long offset, uint64_t value)
+{
+FILE* f = fopen(filename, "r+b");
+int ok;
+if(!f) return 0;
+ok = fseek(f, offset, SEEK_SET) == 0 && fwrite(&value, sizeof(value), 1, f) == 1;
+fclose(f);
+return ok;
+}
+
+/*
+* Flips the bits of one byte of a file in place.
+* param: filename name of the file.
+* param: offset position of the byte, negative values count from the end of the file.
+*
+* returns: 1 on success or 0 on failure.
+*/
+static int __corrupt_(const char* filename, long offset)
+{
+FILE* f = fopen(filename, "r+b");
+int c;
+if(!f) return 0;
+if(offset < 0) fseek(f, offset, SEEK_END);
+else fseek(f, offset, SEEK_SET);
+offset = ftell(f);
+c = fgetc(f);
+if(c == EOF) { fclose(f); return 0; }
+fseek(f, offset, SEEK_SET);
+fputc(c ^ 0xff, f);
+fclose(f);
+return 1;
+}
+
+/*
+* Reads a whole file with a RowReader and compares it with a Matrix.
+* param: filename name of the file.
+* param: block_rows number of rows in each block.
+* param: m expected entries.
+*
+* returns: 1 if every block was read and the rows are the ones of m,
+* 0 if they differ and -1 if read_row_block reported an error.
+*/
+static int __stream_(const char* filename, int block_rows, const Matrix* m)
+{
+RowReader* r = open_row_reader(filename, block_rows);
+Matrix* block = NULL;
+long long row = 0;
+int n, result = 1;
+if(!r) return -1;
+if(rows_row_reader(r) != m->_rows || columns_row_reader(r) != m->_columns) result = 0;
+block = create_matrix(block_rows, m->_columns);
+while(result == 1 && (n = read_row_block(r, block)) != 0)
+{
+if(n < 0) { result = -1; break; }
+if(row + n > m->_rows || memcmp(block->_data, m->_data + row*m->_columns, (size_t)n*m->_columns*sizeof(double))) result = 0;
+row += n;
+}
+if(result == 1 && row != m->_rows) result = 0;
+destroy_matrix(block);
+close_row_reader(r);
+return result;
+}
+
+/*
+* Relative residual of a linear system: max |A*x - b| / ( max |A| * max |x| ).
+* param: a matrix of the system.
+* param: x solution, may be NULL.
+* param: b right hand side.
+*
+* returns: the residual, or a huge value if there is no solution.
+*/
+static double __residual_(const Matrix* a, const Vector* x, const Vector* b)
+{
+double r = 0.0, na = 0.0, nx = 0.0, s;
+int i, j;
+if(!x || x->_size != a->_columns) return 1e300;
+for(i = 0; i < a->_rows * a->_columns; i++) if(fabs(a->_data[i]) > na) na = fabs(a->_data[i]);
+for(j = 0; j < x->_size; j++) if(fabs(x->_data[j]) > nx) nx = fabs(x->_data[j]);
+for(i = 0; i < a->_rows; i++)
+{
+for(s = -b->_data[i], j = 0; j < a->_columns; j++) s += a->_data[i*a->_columns+j] * x->_data[j];
+if(fabs(s) > r) r = fabs(s);
+}
+return na * nx > 0.0 ? r / (na * nx) : r;
+}
+
+/*
+* Largest difference between the entries of two matrices relative to the largest entry of the second one.
+*/
+static double __difference_(const Matrix* a, const Matrix* b)
+{
+double d = 0.0, n = 0.0;
+int i;
+if(!a || !b || a->_rows != b->_rows || a->_columns != b->_columns) return 1e300;
+for(i = 0; i < a->_rows * a->_columns; i++)
+{
+if(fabs(a->_data[i] - b->_data[i]) > d) d = fabs(a->_data[i] - b->_data[i]);
+if(fabs(b->_data[i]) > n) n = fabs(b->_data[i]);
+}
+return n > 0.0 ? d / n : d;
+}
+
+/*
+* Writes a text file.
+* param: filename name of the file.
+* param: text contents of the file.
+*/
+static void __write_text_(const char* filename, const char* text)
+{
+FILE* f = fopen(filename, "wb");
+if(!f) return;
+fputs(text, f);
+fclose(f);
+}
+
+/*
+* Writes a version 1 .npy file, as NumPy would do, with any header and data.
+* param: filename name of the file.
+* param: dict the header dictionary, for instance {'descr': '<f8', 'fortran_order': False, 'shape': (2, 3), }
+* param: data bytes of the array.
+* param: size number of bytes of data.
+*/
+static void __write_npy_(const char* filename, const char* dict, const void* data, size_t size)
+{
+FILE* f = fopen(filename, "wb");
+size_t length = strlen(dict), padding = 64 - (10 + length + 1) % 64;
+unsigned short total = (unsigned short)(length + padding + 1);
+if(!f) return;
+fwrite("\x93NUMPY\x01\x00", 1, 8, f);
+fputc(total & 0xff, f);
+fputc(total >> 8, f);
+fputs(dict, f);
+while(padding-- > 0) fputc(' ', f);
+fputc('\n', f);
+fwrite(data, 1, size, f);
+fclose(f);
+}
+
+/*
+* Largest difference between Q^t*Q and the identity, zero for orthonormal columns.
+*/
+static double __orthogonality_(const Matrix* q)
+{
+double d = 0.0, s;
+int i, j, k;
+for(i = 0; i < q->_columns; i++)
+for(j = 0; j < q->_columns; j++)
+{
+for(s = (i == j) ? -1.0 : 0.0, k = 0; k < q->_rows; k++) s += q->_data[k*q->_columns+i] * q->_data[k*q->_columns+j];
+if(fabs(s) > d) d = fabs(s);
+}
+return d;
+}
+
+/*
+* Relative difference between a Matrix and the product U*Sigma*V^t of its SVD.
+*/
+static double __svd_residual_(const Matrix* a, const SVD* svd)
+{
+Matrix* us = mul_matrix(svd_u(svd), svd_sigma(svd));
+Matrix* vt = transpose_matrix(svd_v(svd));
+Matrix* p = mul_matrix(us, vt);
+double d = __difference_(p, a);
+destroy_matrix(us);
+destroy_matrix(vt);
+destroy_matrix(p);
+return d;
+}
+
+/*
+* Relative residual of an eigenpair: max |A*x - value*x| / ( max |A| * max |x| ).
+*/
+static double __eigen_residual_(const Matrix* a, const Eigen* e)
+{
+Vector* b = scale_vector(eigen_vector(e), eigen_value(e));
+double d = __residual_(a, eigen_vector(e), b);
+destroy_vector(b);
+return d;
+}
+
+/*
+* Largest difference between V^t*V and the identity, where V has the eigenvectors of an EigenSystem as columns.
+*/
+static double __eigen_orthogonality_(const EigenSystem* s)
+{
+Matrix* v = create_matrix(eigen_vector(s->_eigen[0])->_size, s->_size);
+double d;
+int i, j;
+for(j = 0; j < s->_size; j++)
+for(i = 0; i < v->_rows; i++) v->_data[i*v->_columns+j] = eigen_vector(s->_eigen[j])->_data[i];
+d = __orthogonality_(v);
+destroy_matrix(v);
+return d;
+}
+
+/* end helper functions */
+
+/*
+* Truncated SVD and PCA ( svd.h ).
+* The randomized SVD of a rank 5 matrix is exact; the PCA of a file read in blocks matches the one of the whole matrix.
+*/
+static void test_svd()
+{
+Matrix* x = __sample_(40, 5, 7);
+Matrix* y = __sample_(5, 25, 8);
+Matrix* a = mul_matrix(x, y);
+Matrix* m = __sample_(300, 8, 9);
+SVD* svd = NULL;
+PCA* p = NULL;
+PCA* q = NULL;
+RowReader* r = NULL;
+double d;
+int i, j, ok;
+
+svd = randomized_svd(a, 5, 5, 2, NULL);
+__check_("svd randomized residual", svd != NULL && __svd_residual_(a, svd) < 1e-10);
+__check_("svd randomized orthogonal", svd != NULL && __orthogonality_(svd_u(svd)) < 1e-10 && __orthogonality_(svd_v(svd)) < 1e-10);
+for(i = 1, ok = svd != NULL; ok && i < 5; i++) ok = get_matrix(svd_sigma(svd), i, i) <= get_matrix(svd_sigma(svd), i-1, i-1);
+__check_("svd randomized decreasing", ok);
+if(svd) destroy_svd(svd);
+__check_("svd randomized rank out of range", randomized_svd(a, 26, 5, 2, NULL) == NULL);
+
+store_matrix_binary(m, "t_pca.bin");
+p = pca_factorization(m, 3, 8, 4, NULL);
+r = open_row_reader("t_pca.bin", 37);
+q = pca_row_reader(r, 3, 8, 4, NULL);
+close_row_reader(r);
+for(j = 0, ok = p != NULL && q != NULL; ok && j < 3; j++)
+{
+for(d = 0.0, i = 0; i < 8; i++) d += get_matrix(pca_components(p), i, j) * get_matrix(pca_components(q), i, j);
+ok = fabs(fabs(d) - 1.0) < 1e-9 && fabs(get_vector(pca_variance(q), j) - get_vector(pca_variance(p), j)) < 1e-9 * get_vector(pca_variance(p), 0);
+}
+__check_("svd pca row reader", ok);
+r = open_row_reader("t_pca.bin", 37);
+__check_("svd pca row reader rank out of range", pca_row_reader(r, 9, 8, 4, NULL) == NULL);
+close_row_reader(r);
+if(p) destroy_pca(p);
+if(q) destroy_pca(q);
+
+remove("t_pca.bin");
+destroy_matrix(x);
+destroy_matrix(y);
+destroy_matrix(a);
+destroy_matrix(m);
+}
+
+/*
+* Lanczos and Arnoldi eigensolvers ( krylov.h ).
+* The eigenvalues of the 1D Laplacian are 2 - 2*cos(k*pi/(n+1)); those of a triangular matrix are its diagonal.
+*/
+static void test_krylov()
+{
+Matrix* a = create_matrix(60, 60);
+Matrix* t = create_matrix(40, 40);
+LinearOperator* op = NULL;
+EigenSystem* s = NULL;
+int i, ok;
+
+for(i = 0; i < 60; i++)
+{
+a->_data[i*60+i] = 2.0;
+if(i > 0) a->_data[i*60+i-1] = a->_data[(i-1)*60+i] = -1.0;
+}
+op = matrix_linear_operator(a);
+s = lanczos_eigen(op, 4, EIGEN_LARGEST, 0.0, 0, 0.0, 0, NULL);
+for(i = 0, ok = s != NULL && s->_size == 4; ok && i < 4; i++)
+ok = fabs(eigen_value(s->_eigen[i]) - (2.0 - 2.0*cos((60-i)*PI/61))) < 1e-10 && __eigen_residual_(a, s->_eigen[i]) < 1e-8;
+__check_("krylov lanczos largest", ok);
+__check_("krylov lanczos orthogonal", s != NULL && __eigen_orthogonality_(s) < 1e-8);
+if(s) destroy_eigensystem(s);
+s = lanczos_eigen(op, 3, EIGEN_SMALLEST, 0.0, 0, 0.0, 0, NULL);
+for(i = 0, ok = s != NULL && s->_size == 3; ok && i < 3; i++)
+ok = fabs(eigen_value(s->_eigen[i]) - (2.0 - 2.0*cos((i+1)*PI/61))) < 1e-10 && __eigen_residual_(a, s->_eigen[i]) < 1e-8;
+__check_("krylov lanczos smallest", ok);
+if(s) destroy_eigensystem(s);
+destroy_linear_operator(op);
+
+for(i = 0; i < 40; i++)
+{
+t->_data[i*40+i] = i + 1.0;
+if(i > 0) t->_data[(i-1)*40+i] = 0.3;
+}
+op = matrix_linear_operator(t);
+s = arnoldi_eigen(op, 3, EIGEN_LARGEST, 0.0, 0, 0.0, 0, NULL);
+for(i = 0, ok = s != NULL && s->_size == 3; ok && i < 3; i++)
+ok = fabs(eigen_value(s->_eigen[i]) - (40.0 - i)) < 1e-9 && __eigen_residual_(t, s->_eigen[i]) < 1e-8;
+__check_("krylov arnoldi largest", ok);
+if(s) destroy_eigensystem(s);
+destroy_linear_operator(op);
+
+destroy_matrix(a);
+destroy_matrix(t);
+}
+
+/*
+* Eigenpairs ( eigen.h and diagonalization.h ).
+* Repeated eigenvalues must give independent eigenvectors.
+*/
+static void test_eigen()
+{
+Matrix* a = __sample_(6, 6, 10);
+Matrix* s = NULL;
+Matrix* t = NULL;
+Matrix* i3 = identity_matrix(3);
+Matrix* d = create_matrix(3, 3);
+Matrix* p = create_matrix(3, 3);
+EigenSystem* e = NULL;
+Eigen* x = NULL;
+Diagonalization* g = NULL;
+int i, ok;
+double tridiagonal[9] = {4.0, 1.0, 0.0, 1.0, 3.0, 1.0, 0.0, 1.0, 2.0};
+
+/* a symmetric matrix has real eigenvalues and orthogonal eigenvectors */
+t = transpose_matrix(a);
+s = add_matrix(a, t);
+e = eigen_system(s);
+for(i = 0, ok = e != NULL && e->_size == 6; ok && i < 6; i++) ok = __eigen_residual_(s, e->_eigen[i]) < 1e-10;
+__check_("eigen system residual", ok);
+__check_("eigen system orthogonal", e != NULL && __eigen_orthogonality_(e) < 1e-8);
+x = inverse_iteration(s, e ? eigen_value(e->_eigen[2]) + 0.01 : 0.0, 0.0, 0);
+__check_("eigen inverse iteration", x != NULL && e != NULL && fabs(eigen_value(x) - eigen_value(e->_eigen[2])) < 1e-10 && __eigen_residual_(s, x) < 1e-10);
+if(x) destroy_eigen(x);
+x = rayleigh_quotient_iteration(s, NULL, e ? eigen_value(e->_eigen[4]) + 0.01 : 0.0, 0.0, 0);
+__check_("eigen rayleigh quotient iteration", x != NULL && __eigen_residual_(s, x) < 1e-10);
+if(x) destroy_eigen(x);
+if(e) destroy_eigensystem(e);
+e = subspace_iteration(s, 2, 0.0, 0, 0);
+for(i = 0, ok = e != NULL && e->_size == 2; ok && i < 2; i++) ok = __eigen_residual_(s, e->_eigen[i]) < 1e-9;
+__check_("eigen subspace iteration", ok && __eigen_orthogonality_(e) < 1e-8);
+if(e) destroy_eigensystem(e);
+
+/* the eigenvalue estimate of the power method does not change between the first two iterations of this matrix */
+for(i = 0; i < 9; i++) p->_data[i] = tridiagonal[i];
+x = max_eigen_power_method(p);
+__check_("eigen power method", x != NULL && fabs(eigen_value(x) - (3.0 + sqrt(3.0))) < 1e-9 && __eigen_residual_(p, x) < 1e-9);
+if(x) destroy_eigen(x);
+
+e = eigen_system(i3);
+for(i = 0, ok = e != NULL && e->_size == 3; ok && i < 3; i++) ok = fabs(eigen_value(e->_eigen[i]) - 1.0) < 1e-12 && __eigen_residual_(i3, e->_eigen[i]) < 1e-12;
+__check_("eigen repeated eigenvalue", ok && __eigen_orthogonality_(e) < 1e-10);
+if(e) destroy_eigensystem(e);
+set_matrix(d, 2.0, 0, 0);
+set_matrix(d, 2.0, 1, 1);
+set_matrix(d, 1.0, 2, 2);
+g = diagonalize_matrix(d);
+__check_("eigen diagonalize repeated eigenvalue", g != NULL && fabs(det_diagonalized_matrix(g) - 4.0) < 1e-10 && __orthogonality_(diagonalization_p(g)) < 1e-10);
+if(g) destroy_diagonalization(g);
+/* a Jordan block has a single eigenvector */
+set_matrix(d, 1.0, 0, 1);
+set_matrix(d, 2.0, 2, 2);
+__check_("eigen diagonalize defective", diagonalize_matrix(d) == NULL);
+
+destroy_matrix(a);
+destroy_matrix(s);
+destroy_matrix(t);
+destroy_matrix(i3);
+destroy_matrix(d);
+destroy_matrix(p);
+}
+
+/*
+* Random generators ( rng.h ).
+* Stream i must be the seeded generator moved i times by jump_random; the same state must give the same results.
+*/
+static void test_rng()
+{
+Random* a = create_random(12345);
+Random* b = NULL;
+Random* c = NULL;
+Random r;
+Matrix* m = __sample_(30, 30, 11);
+Matrix* t = transpose_matrix(m);
+Matrix* s = add_matrix(m, t);
+LinearOperator* op = matrix_linear_operator(s);
+EigenSystem* e = NULL;
+EigenSystem* f = NULL;
+double sum = 0.0, squares = 0.0, u, low = 1.0, high = 0.0;
+int i, ok;
+
+b = clone_random(a);
+for(i = 0, ok = 1; i < 1000; i++) ok = ok && next_random(a) == next_random(b);
+__check_("rng clone", ok);
+seed_random(&r, 12345);
+for(i = 0; i < 1000; i++) next_random(&r);
+__check_("rng seed", next_random(&r) == next_random(a));
+seed_random(&r, 12346);
+__check_("rng other seed", next_random(&r) != next_random(b));
+destroy_random(b);
+
+b = stream_random(777, 3);
+seed_random(&r, 777);
+for(i = 0; i < 3; i++) jump_random(&r);
+for(i = 0, ok = b != NULL; ok && i < 100; i++) ok = next_random(b) == next_random(&r);
+__check_("rng stream jump", ok);
+c = stream_random(777, 2);
+for(i = 0, ok = 1; i < 100; i++) ok = ok && next_random(c) != next_random(b);
+__check_("rng streams differ", ok);
+__check_("rng negative stream", stream_random(777, -1) == NULL);
+destroy_random(b);
+destroy_random(c);
+
+for(i = 0; i < 100000; i++)
+{
+u = uniform_random(a);
+if(u < low) low = u;
+if(u > high) high = u;
+sum += u;
+}
+__check_("rng uniform", low > 0.0 && high < 1.0 && fabs(sum / 100000 - 0.5) < 0.01);
+for(i = 0, sum = 0.0; i < 100000; i++)
+{
+u = gaussian_random(a);
+sum += u;
+squares += u * u;
+}
+__check_("rng gaussian", fabs(sum / 100000) < 0.02 && fabs(squares / 100000 - 1.0) < 0.02);
+
+/* a solver taking a Random gives the same result for the same state */
+seed_random(&r, 99);
+e = lanczos_eigen(op, 3, EIGEN_LARGEST_MAGNITUDE, 0.0, 10, 0.0, 0, &r);
+seed_random(&r, 99);
+f = lanczos_eigen(op, 3, EIGEN_LARGEST_MAGNITUDE, 0.0, 10, 0.0, 0, &r);
+for(i = 0, ok = e != NULL && f != NULL; ok && i < 3; i++) ok = eigen_value(e->_eigen[i]) == eigen_value(f->_eigen[i]);
+__check_("rng reproducible solver", ok);
+if(e) destroy_eigensystem(e);
+if(f) destroy_eigensystem(f);
+
+destroy_linear_operator(op);
+destroy_random(a);
+destroy_matrix(m);
+destroy_matrix(t);
+destroy_matrix(s);
+}
+
+/*
+* Text files ( matrix.h and vector.h ).
+*/
+static void test_text()
+{
+Matrix* m = __sample_(9, 11, 2);
+Matrix* l = NULL;
+Vector* v = NULL;
+Vector* w = NULL;
+FILE* f = NULL;
+Tuning t;
+char* text = NULL;
+double* serial = NULL;
+double* parallel = NULL;
+char buffer[FORMAT_DOUBLE_SIZE];
+size_t length;
+long size;
+int i, n, ok = 1;
+/* shortest texts, including some which Grisu2 gets one digit too long and the ends of the range */
+double values[10] = {1e23, 0.1, 2.0/3.0, 5e-324, 1.7976931348623157e308, 2.2250738585072014e-308, 9007199254740993.0, 1e21, 1.5e-7, -0.0};
+const char* texts[10] = {"1e23", "0.1", "0.6666666666666666", "5e-324", "1.7976931348623157e308", "2.2250738585072014e-308", "9007199254740992", "1e21", "1.5e-7", "-0"};
+
+store_matrix(m, "t_text.dat");
+l = load_matrix("t_text.dat");
+for(i = 0; l && i < 9*11; i++) ok = ok && fabs(l->_data[i] - m->_data[i]) <= 1e-12 * fabs(m->_data[i]);
+__check_("text matrix round trip", l != NULL && ok);
+if(l) destroy_matrix(l);
+size = __size_("t_text.dat");
+__truncate_("t_text.dat", "t_text_cut.dat", size / 2);
+__check_("text matrix truncated", load_matrix("t_text_cut.dat") == NULL);
+f = fopen("t_text_cut.dat", "w");
+fprintf(f, "2 2\n1.0 2.0\n3.0 x\n");
+fclose(f);
+__check_("text matrix bad number", load_matrix("t_text_cut.dat") == NULL);
+f = fopen("t_text_cut.dat", "w");
+fprintf(f, "3\n1.0 2.0\n");
+fclose(f);
+__check_("text vector truncated", load_vector("t_text_cut.dat") == NULL);
+f = fopen("t_text_cut.dat", "w");
+fprintf(f, "3\n1.0 2.0 4.5\n");
+fclose(f);
+v = load_vector("t_text_cut.dat");
+__check_("text vector", v != NULL && v->_size == 3 && v->_data[2] == 4.5);
+if(v) destroy_vector(v);
+
+for(i = 0, ok = 1; i < 10; i++) ok = ok && format_double(values[i], buffer) == (int)strlen(texts[i]) && strcmp(buffer, texts[i]) == 0;
+__check_("text format shortest", ok);
+v = create_vector(3);
+v->_data[0] = 1e23;
+v->_data[1] = 0.1;
+v->_data[2] = -5e-324;
+store_vector(v, "t_text.dat");
+text = read_text_file("t_text.dat", &length);
+__check_("text format file", text != NULL && length == 19 && memcmp(text, "3\n1e23 0.1 -5e-324\n", 19) == 0);
+if(text) release_memory(text);
+destroy_vector(v);
+
+/* a vector file has all its values in a single line, which the parallel parser splits at the spaces */
+v = create_vector(200000);
+for(i = 0; i < 200000; i++) v->_data[i] = 1000.0 * sin(0.1 * i) / (1.0 + i % 13);
+store_vector(v, "t_text.dat");
+w = load_vector("t_text.dat");
+for(i = 0, ok = w != NULL && w->_size == 200000; ok && i < 200000; i++) ok = w->_data[i] == v->_data[i];
+__check_("text big vector", ok);
+if(w) destroy_vector(w);
+text = read_text_file("t_text.dat", &length);
+serial = (double*)malloc(200001 * sizeof(double));
+parallel = (double*)malloc(200001 * sizeof(double));
+t = *get_tuning();
+t._parallel_parse = (size_t)-1;
+set_tuning(&t);
+n = text ? parse_doubles(text, length, serial, 200001) : 0;
+t._parallel_parse = 0;
+set_tuning(&t);
+ok = text && n == 200001 && parse_doubles(text, length, parallel, 200001) == n && memcmp(serial, parallel, n * sizeof(double)) == 0;
+__check_("text parallel parse", ok && threads_threadpool(NULL) > 1);
+default_tuning(&t);
+set_tuning(&t);
+free(serial);
+free(parallel);
+if(text) release_memory(text);
+destroy_vector(v);
+remove("t_text.dat");
+remove("t_text_cut.dat");
+destroy_matrix(m);
+}
+
+/*
+* Binary files ( binio.h ).
+*/
+static void test_binio()
+{
+Matrix* m = __sample_(37, 53, 1);
+Matrix* l = NULL;
+const Matrix* mapped = NULL;
+BinaryHeader header;
+long size;
+
+__check_("binio store", store_matrix_binary(m, "t_binio.bin"));
+l = load_matrix_binary("t_binio.bin");
+__check_("binio load round trip", __same_(m, l));
+if(l) destroy_matrix(l);
+mapped = map_matrix("t_binio.bin", 1);
+__check_("binio map round trip", __same_(m, mapped));
+if(mapped) unmap_matrix(mapped);
+__check_("binio header", read_header_binary("t_binio.bin", &header) && valid_header_binary(&header) && header._rows == 37 && header._columns == 53 && header._offset % BINARY_ALIGNMENT == 0);
+__check_("binio checksum", header._checksum == checksum_binary(m->_data, 37*53));
+
+/* a file cut in the entries, in the header or empty */
+size = __size_("t_binio.bin");
+__truncate_("t_binio.bin", "t_binio_cut.bin", size - 8);
+__check_("binio truncated entries load", load_matrix_binary("t_binio_cut.bin") == NULL);
+__check_("binio truncated entries map", map_matrix("t_binio_cut.bin", 0) == NULL);
+__truncate_("t_binio.bin", "t_binio_cut.bin", 30);
+__check_("binio truncated header", load_matrix_binary("t_binio_cut.bin") == NULL && !read_header_binary("t_binio_cut.bin", &header));
+__truncate_("t_binio.bin", "t_binio_cut.bin", 0);
+__check_("binio empty file", load_matrix_binary("t_binio_cut.bin") == NULL);
+__check_("binio missing file", load_matrix_binary("t_missing.bin") == NULL && map_matrix("t_missing.bin", 0) == NULL);
+
+/* a damaged entry is caught by the checksum, unless the check is skipped on purpose */
+__corrupt_("t_binio.bin", -3);
+__check_("binio corrupt entry load", load_matrix_binary("t_binio.bin") == NULL);
+__check_("binio corrupt entry map verified", map_matrix("t_binio.bin", 1) == NULL);
+mapped = map_matrix("t_binio.bin", 0);
+__check_("binio corrupt entry map unverified", mapped != NULL && !__same_(m, mapped));
+if(mapped) unmap_matrix(mapped);
+
+/* a damaged header */
+store_matrix_binary(m, "t_binio.bin");
+__corrupt_("t_binio.bin", 0);
+__check_("binio bad magic", load_matrix_binary("t_binio.bin") == NULL && map_matrix("t_binio.bin", 0) == NULL);
+store_matrix_binary(m, "t_binio.bin");
+__corrupt_("t_binio.bin", 12);
+__check_("binio bad byte order", load_matrix_binary("t_binio.bin") == NULL);
+
+remove("t_binio.bin");
+remove("t_binio_cut.bin");
+destroy_matrix(m);
+}
+
+/*
+* Streaming readers and writers ( stream.h ).
+*/
+static void test_stream()
+{
+Matrix* m = __sample_(250, 7, 3);
+RowWriter* w = NULL;
+int i, ok;
+
+/* the writer gets the rows in blocks of 32, the last one shorter */
+w = open_row_writer("t_stream.bin", 250, 7, 1);
+for(i = 0, ok = w != NULL; ok && i < 250; i += 32)
+{
+Matrix* block = get_matrix_chunk(m, i, i + 31 < 250 ? i + 31 : 249, 0, 6);
+ok = write_row_block(w, block, block->_rows);
+destroy_matrix(block);
+}
+__check_("stream binary writer", ok && close_row_writer(w));
+__check_("stream binary writer and reader", __stream_("t_stream.bin", 40, m) == 1);
+__check_("stream binary reader one row blocks", __stream_("t_stream.bin", 1, m) == 1);
+__check_("stream binary reader single block", __stream_("t_stream.bin", 1000, m) == 1);
+store_matrix_binary(m, "t_stream.bin");
+__check_("stream binary file", __stream_("t_stream.bin", 64, m) == 1);
+store_matrix_compressed(m, "t_stream.cbin");
+__check_("stream compressed file", __stream_("t_stream.cbin", 64, m) == 1);
+
+w = open_row_writer("t_stream.txt", 250, 7, 0);
+ok = w != NULL && write_row_block(w, m, 250);
+__check_("stream text writer", ok && close_row_writer(w));
+__check_("stream text file", __stream_("t_stream.txt", 64, m) == 1);
+
+/* a writer closed before all the rows are written reports it */
+w = open_row_writer("t_stream_cut.bin", 250, 7, 1);
+ok = w != NULL && write_row_block(w, m, 100);
+__check_("stream writer missing rows", ok && !close_row_writer(w));
+
+__truncate_("t_stream.bin", "t_stream_cut.bin", __size_("t_stream.bin") - 100);
+__check_("stream truncated binary", __stream_("t_stream_cut.bin", 64, m) == -1);
+__truncate_("t_stream.txt", "t_stream_cut.txt", __size_("t_stream.txt") - 100);
+__check_("stream truncated text", __stream_("t_stream_cut.txt", 64, m) == -1);
+__truncate_("t_stream.cbin", "t_stream_cut.bin", __size_("t_stream.cbin") - 100);
+__check_("stream truncated compressed", __stream_("t_stream_cut.bin", 64, m) == -1);
+__corrupt_("t_stream.bin", -3);
+__check_("stream corrupt binary", __stream_("t_stream.bin", 64, m) == -1);
+__check_("stream missing file", open_row_reader("t_missing.bin", 64) == NULL);
+
+remove("t_stream.bin");
+remove("t_stream.cbin");
+remove("t_stream.txt");
+remove("t_stream_cut.bin");
+remove("t_stream_cut.txt");
+destroy_matrix(m);
+}
+
+/*
+* Out of core matrices ( tiled.h ).
+* Small tiles and a small cache make the tiles go in and out of the cache many times.
+*/
+static void test_tiled()
+{
+Matrix* a = __sample_(70, 50, 4);
+Matrix* b = __sample_(50, 45, 5);
+Matrix* p = mul_matrix(a, b);
+Matrix* s = __sample_(60, 60, 6);
+Matrix* l = NULL;
+Matrix* tile = NULL;
+TiledMatrix* ta = NULL;
+TiledMatrix* tb = NULL;
+TiledMatrix* tc = NULL;
+Vector* v = create_vector(60);
+Vector* x = NULL;
+int* permutation = NULL;
+int i, ok;
+
+store_matrix_binary(a, "t_tiled_a.bin");
+store_matrix_binary(b, "t_tiled_b.bin");
+ta = open_tiled_matrix("t_tiled_a.bin", 16, 4);
+tb = open_tiled_matrix("t_tiled_b.bin", 16, 4);
+tc = create_tiled_matrix("t_tiled_c.bin", 70, 45, 16, 4);
+__check_("tiled open", ta && tb && tc && rows_tiled_matrix(ta) == 70 && columns_tiled_matrix(ta) == 50 && tile_tiled_matrix(ta) == 16);
+ok = ta && tb && tc && gemm_tiled_matrix(1.0, ta, tb, 0.0, tc);
+ok = close_tiled_matrix(tc) && ok;
+l = load_matrix_binary("t_tiled_c.bin");
+__check_("tiled gemm", ok && __difference_(l, p) < 1e-13);
+if(l) destroy_matrix(l);
+/* C = 2*A*B - C = A*B */
+tc = open_tiled_matrix("t_tiled_c.bin", 16, 4);
+ok = tc && gemm_tiled_matrix(2.0, ta, tb, -1.0, tc);
+ok = close_tiled_matrix(tc) && ok;
+l = load_matrix_binary("t_tiled_c.bin");
+__check_("tiled gemm beta", ok && __difference_(l, p) < 1e-13);
+if(l) destroy_matrix(l);
+close_tiled_matrix(ta);
+close_tiled_matrix(tb);
+
+/* a changed tile is written back and the rest of the file is left as it was */
+ta = open_tiled_matrix("t_tiled_a.bin", 16, 4);
+tile = ta ? get_tile(ta, 4, 3) : NULL;
+ok = tile && tile->_rows == 70 - 64 && tile->_columns == 50 - 48;
+if(tile)
+{
+tile->_data[0] = 123.5;
+release_tile(ta, tile, 1);
+}
+ok = ta && close_tiled_matrix(ta) && ok;
+l = load_matrix_binary("t_tiled_a.bin");
+a->_data[64*50+48] = 123.5;
+__check_("tiled changed tile", ok && __same_(l, a));
+if(l) destroy_matrix(l);
+
+/* out of core LU, made diagonally dominant so that it is well conditioned */
+for(i = 0; i < 60; i++)
+{
+s->_data[i*60+i] += 60.0;
+v->_data[i] = cos(i);
+}
+store_matrix_binary(s, "t_tiled_s.bin");
+ta = open_tiled_matrix("t_tiled_s.bin", 16, 4);
+permutation = ta ? lu_tiled_matrix(ta) : NULL;
+x = permutation ? lu_tiled_solver(ta, permutation, v) : NULL;
+__check_("tiled lu residual", __residual_(s, x, v) < 1e-14);
+if(x) destroy_vector(x);
+if(permutation) release_memory(permutation);
+close_tiled_matrix(ta);
+
+/* with a zero diagonal every column needs a row swap, often with a row of another tile */
+for(i = 0; i < 60; i++) s->_data[i*60+i] = 0.0;
+store_matrix_binary(s, "t_tiled_s.bin");
+ta = open_tiled_matrix("t_tiled_s.bin", 16, 4);
+permutation = ta ? lu_tiled_matrix(ta) : NULL;
+x = permutation ? lu_tiled_solver(ta, permutation, v) : NULL;
+for(i = 0, ok = 0; permutation && i < 60; i++) if(permutation[i] / 16 != i / 16) ok = 1;
+__check_("tiled lu pivoting", ok && __residual_(s, x, v) < 1e-13);
+if(x) destroy_vector(x);
+if(permutation) release_memory(permutation);
+close_tiled_matrix(ta);
+
+/* files which cannot be used as tiled matrices */
+__truncate_("t_tiled_b.bin", "t_tiled_cut.bin", __size_("t_tiled_b.bin") - 8);
+__check_("tiled truncated file", open_tiled_matrix("t_tiled_cut.bin", 16, 4) == NULL);
+store_matrix_compressed(b, "t_tiled_cut.bin");
+__check_("tiled compressed file", open_tiled_matrix("t_tiled_cut.bin", 16, 4) == NULL);
+store_matrix_binary(b, "t_tiled_cut.bin");
+__corrupt_("t_tiled_cut.bin", 0);
+__check_("tiled bad magic", open_tiled_matrix("t_tiled_cut.bin", 16, 4) == NULL);
+ta = open_tiled_matrix("t_tiled_a.bin", 16, 4);
+tb = open_tiled_matrix("t_tiled_b.bin", 16, 4);
+tc = create_tiled_matrix("t_tiled_c.bin", 70, 40, 16, 4);
+__check_("tiled gemm wrong sizes", ta && tb && tc && !gemm_tiled_matrix(1.0, ta, tb, 0.0, tc));
+close_tiled_matrix(ta);
+close_tiled_matrix(tb);
+close_tiled_matrix(tc);
+
+remove("t_tiled_a.bin");
+remove("t_tiled_b.bin");
+remove("t_tiled_c.bin");
+remove("t_tiled_s.bin");
+remove("t_tiled_cut.bin");
+destroy_vector(v);
+destroy_matrix(a);
+destroy_matrix(b);
+destroy_matrix(p);
+destroy_matrix(s);
+}
+
+/*
+* NumPy files ( npyio.h ).
+*/
+static void test_npy()
+{
+Matrix* m = __sample_(13, 6, 7);
+Matrix* l = NULL;
+const Matrix* mapped = NULL;
+Vector* v = create_vector(5);
+Vector* w = NULL;
+float f[6] = { 1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f }; /* [[1 2 3] [4 5 6]] in Fortran order */
+unsigned char swapped[6*4];
+int i, k;
+
+__check_("npy store", store_matrix_npy(m, "t_npy.npy"));
+l = load_matrix_npy("t_npy.npy");
+__check_("npy load round trip", __same_(m, l));
+if(l) destroy_matrix(l);
+mapped = map_matrix_npy("t_npy.npy");
+__check_("npy map round trip", __same_(m, mapped));
+if(mapped) unmap_matrix(mapped);
+for(i = 0; i < 5; i++) v->_data[i] = 1.0 / (i + 1);
+store_vector_npy(v, "t_npy_v.npy");
+w = load_vector_npy("t_npy_v.npy");
+__check_("npy vector round trip", w && w->_size == 5 && memcmp(w->_data, v->_data, 5*sizeof(double)) == 0);
+if(w) destroy_vector(w);
+l = load_matrix_npy("t_npy_v.npy");
+__check_("npy vector as column", l && l->_rows == 5 && l->_columns == 1 && l->_data[4] == v->_data[4]);
+if(l) destroy_matrix(l);
+
+/* big endian float32 in Fortran order, converted on load and never mapped */
+for(i = 0; i < 6; i++)
+{
+unsigned char* p = (unsigned char*)&f[i];
+unsigned int one = 1;
+for(k = 0; k < 4; k++) swapped[i*4+k] = *(unsigned char*)&one ? p[3-k] : p[k];
+}
+__write_npy_("t_npy_f.npy", "{'descr': '>f4', 'fortran_order': True, 'shape': (2, 3), }", swapped, sizeof(swapped));
+l = load_matrix_npy("t_npy_f.npy");
+__check_("npy float32 big endian fortran", l && l->_rows == 2 && l->_columns == 3 && l->_data[1] == 2.0 && l->_data[3] == 4.0 && l->_data[5] == 6.0);
+if(l) destroy_matrix(l);
+__check_("npy map not float64", map_matrix_npy("t_npy_f.npy") == NULL);
+
+/* invalid files */
+__write_npy_("t_npy_f.npy", "{'descr': '<c16', 'fortran_order': False, 'shape': (1, 1), }", f, 16);
+__check_("npy complex not supported", load_matrix_npy("t_npy_f.npy") == NULL);
+__write_npy_("t_npy_f.npy", "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 2, 2), }", m->_data, 64);
+__check_("npy three dimensions", load_matrix_npy("t_npy_f.npy") == NULL);
+__write_npy_("t_npy_f.npy", "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 3 }", m->_data, 48);
+__check_("npy bad header", load_matrix_npy("t_npy_f.npy") == NULL);
+__truncate_("t_npy.npy", "t_npy_f.npy", __size_("t_npy.npy") - 8);
+__check_("npy truncated data", load_matrix_npy("t_npy_f.npy") == NULL && map_matrix_npy("t_npy_f.npy") == NULL);
+__truncate_("t_npy.npy", "t_npy_f.npy", 40);
+__check_("npy truncated header", load_matrix_npy("t_npy_f.npy") == NULL);
+__corrupt_("t_npy.npy", 1);
+__check_("npy bad magic", load_matrix_npy("t_npy.npy") == NULL);
+
+remove("t_npy.npy");
+remove("t_npy_v.npy");
+remove("t_npy_f.npy");
+destroy_vector(v);
+destroy_matrix(m);
+}
+
+/*
+* Matrix Market files ( mmio.h ).
+*/
+static void test_mtx()
+{
+Matrix* m = __sample_(8, 5, 8);
+Matrix* d = NULL;
+SparseMatrix* s = NULL;
+SparseMatrix* l = NULL;
+int i;
+
+for(i = 0; i < 8*5; i++) if(i % 3) m->_data[i] = 0.0;
+s = to_sparse_matrix(m);
+__check_("mtx store", store_sparse_matrix_market(s, "t_mtx.mtx"));
+l = load_sparse_matrix_market("t_mtx.mtx");
+d = l ? to_dense_matrix(l) : NULL;
+__check_("mtx round trip", l && l->_nonzeros == s->_nonzeros && __same_(m, d));
+if(d) destroy_matrix(d);
+if(l) destroy_sparse_matrix(l);
+
+/* symmetric pattern with a comment and a duplicated entry */
+__write_text_("t_mtx_x.mtx", "%%MatrixMarket matrix coordinate pattern symmetric\n% comment\n3 3 4\n1 1\n3 1\n2 2\n2 2\n");
+l = load_sparse_matrix_market("t_mtx_x.mtx");
+__check_("mtx symmetric pattern", l && get_sparse_matrix(l, 0, 2) == 1.0 && get_sparse_matrix(l, 2, 0) == 1.0 && get_sparse_matrix(l, 1, 1) == 2.0 && get_sparse_matrix(l, 2, 2) == 0.0);
+if(l) destroy_sparse_matrix(l);
+__write_text_("t_mtx_x.mtx", "%%MatrixMarket matrix coordinate real skew-symmetric\n3 3 1\n3 1 2.5\n");
+l = load_sparse_matrix_market("t_mtx_x.mtx");
+__check_("mtx skew-symmetric", l && get_sparse_matrix(l, 2, 0) == 2.5 && get_sparse_matrix(l, 0, 2) == -2.5);
+if(l) destroy_sparse_matrix(l);
+
+/* invalid files */
+__write_text_("t_mtx_x.mtx", "%%MatrixMarket matrix coordinate real general\n3 3 3\n1 1 1.0\n2 2 2.0\n");
+__check_("mtx missing entries", load_sparse_matrix_market("t_mtx_x.mtx") == NULL);
+__write_text_("t_mtx_x.mtx", "%%MatrixMarket matrix coordinate real general\n3 3 1\n4 1 1.0\n");
+__check_("mtx index out of range", load_sparse_matrix_market("t_mtx_x.mtx") == NULL);
+__write_text_("t_mtx_x.mtx", "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1.0 2.0\n");
+__check_("mtx complex not supported", load_sparse_matrix_market("t_mtx_x.mtx") == NULL);
+__write_text_("t_mtx_x.mtx", "%%MatrixMarket matrix array real general\n1 1\n1.0\n");
+__check_("mtx array not supported", load_sparse_matrix_market("t_mtx_x.mtx") == NULL);
+__write_text_("t_mtx_x.mtx", "3 3 1\n1 1 1.0\n");
+__check_("mtx missing banner", load_sparse_matrix_market("t_mtx_x.mtx") == NULL);
+__truncate_("t_mtx.mtx", "t_mtx_x.mtx", __size_("t_mtx.mtx") / 2);
+__check_("mtx truncated", load_sparse_matrix_market("t_mtx_x.mtx") == NULL);
+
+remove("t_mtx.mtx");
+remove("t_mtx_x.mtx");
+destroy_sparse_matrix(s);
+destroy_matrix(m);
+}
+
+/*
+* Batch files and the batch solver ( batch.h ).
+* There are more systems than fit in one group of the pipeline; two of them are singular.
+*/
+static void test_batch()
+{
+BatchWriter* w = open_batch_writer("t_batch.bat");
+Batch* b = NULL;
+Batch* s = NULL;
+Matrix* m = NULL;
+Vector* v = NULL;
+Vector* x = NULL;
+int i, j, n, ok = w != NULL, empty = 1, worst = 0;
+double residual = 0.0;
+
+for(i = 0; ok && i < 2500; i++)
+{
+n = 1 + i % 8;
+m = __sample_(n, n, i);
+v = create_vector(n);
+for(j = 0; j < n; j++)
+{
+m->_data[j*n+j] += 2.0 * n;
+v->_data[j] = j - 0.5 * i;
+}
+if(i == 7 || i == 2000) for(j = 0; j < n*n; j++) m->_data[j] = 0.0;
+ok = add_batch_matrix(w, m) && add_batch_vector(w, v);
+destroy_matrix(m);
+destroy_vector(v);
+}
+__check_("batch writer", ok && close_batch_writer(w));
+b = open_batch("t_batch.bat");
+__check_("batch records", b && count_batch(b) == 5000 && kind_batch(b, 4998) == BATCH_MATRIX && kind_batch(b, 4999) == BATCH_VECTOR && kind_batch(b, 5000) == -1);
+m = b ? read_batch_matrix(b, 2*13) : NULL;
+__check_("batch matrix record", m && m->_rows == 6 && m->_columns == 6 && m->_data[1] == 2.0 * sin(0.37 + 1.13*2 + 13));
+if(m) destroy_matrix(m);
+__check_("batch wrong kind", b && read_batch_vector(b, 0) == NULL && read_batch_matrix(b, 1) == NULL);
+close_batch(b);
+
+__check_("batch solve", solve_batch("t_batch.bat", "t_batch_x.bat", NULL) == 2498);
+b = open_batch("t_batch.bat");
+s = open_batch("t_batch_x.bat");
+ok = b && s && count_batch(s) == 2500;
+for(i = 0; ok && i < 2500; i++)
+{
+m = read_batch_matrix(b, 2*i);
+v = read_batch_vector(b, 2*i+1);
+if(i == 7 || i == 2000) empty = empty && kind_batch(s, i) == BATCH_EMPTY;
+else
+{
+x = read_batch_vector(s, i);
+if(__residual_(m, x, v) > residual) { residual = __residual_(m, x, v); worst = i; }
+if(x) destroy_vector(x);
+}
+destroy_matrix(m);
+destroy_vector(v);
+}
+close_batch(s);
+close_batch(b);
+__check_("batch solutions residual", ok && residual < 1e-13);
+if(residual >= 1e-13) printf("worst system %d residual %g\n", worst, residual);
+__check_("batch singular systems", ok && empty);
+
+/* invalid files */
+__truncate_("t_batch.bat", "t_batch_x.bat", __size_("t_batch.bat") - 8);
+__check_("batch truncated index", open_batch("t_batch_x.bat") == NULL && solve_batch("t_batch_x.bat", "t_batch_y.bat", NULL) == -1);
+__truncate_("t_batch.bat", "t_batch_x.bat", 20);
+__check_("batch truncated header", open_batch("t_batch_x.bat") == NULL);
+__corrupt_("t_batch.bat", 3);
+__check_("batch bad magic", open_batch("t_batch.bat") == NULL);
+w = open_batch_writer("t_batch.bat");
+m = __sample_(3, 3, 0);
+add_batch_matrix(w, m);
+close_batch_writer(w);
+__check_("batch system without vector", solve_batch("t_batch.bat", "t_batch_x.bat", NULL) == -1);
+destroy_matrix(m);
+
+remove("t_batch.bat");
+remove("t_batch_x.bat");
+remove("t_batch_y.bat");
+}
+
+/*
+* Compresses a buffer and decompresses it back; the buffers have the exact sizes,
+* so a memory checker catches any access out of them.
+* param: data bytes to compress.
+* param: n number of bytes.
+* param: compressed if not NULL, gets the size of the compressed data.
+*
+* returns: 1 if the data is the same after the round trip, 0 otherwise.
+*/
+static int __codec_round_trip_(const unsigned char* data, size_t n, size_t* compressed)
+{
+size_t capacity = bound_codec(n), size;
+unsigned char* out = (unsigned char*)malloc(capacity);
+unsigned char* back = (unsigned char*)malloc(n ? n : 1);
+int ok;
+size = compress_codec(data, n, out, capacity);
+ok = (size > 0 || n == 0) && decompress_codec(out, size, back, n) && memcmp(data, back, n) == 0;
+if(compressed) *compressed = size;
+free(out);
+free(back);
+return ok;
+}
+
+/*
+* Compression codec and compressed binary files ( codec.h and binio.h ).
+*/
+static void test_codec()
+{
+size_t n = 100000, i, size, capacity = bound_codec(100000), changed;
+unsigned char* data = (unsigned char*)malloc(n);
+unsigned char* shuffled = (unsigned char*)malloc(n);
+unsigned char* out = (unsigned char*)malloc(capacity);
+unsigned char* back = (unsigned char*)malloc(n);
+unsigned char* cut = NULL;
+double* smooth = (double*)data;
+Matrix* m = NULL;
+Matrix* l = NULL;
+RowReader* reader = NULL;
+BinaryHeader header;
+long table;
+int ok, detected;
+
+/* smooth doubles compress well once shuffled */
+for(i = 0; i < n / sizeof(double); i++) smooth[i] = 1.0 + (double)(i / 64);
+shuffle_codec(data, n / sizeof(double), sizeof(double), shuffled);
+unshuffle_codec(shuffled, n / sizeof(double), sizeof(double), back);
+__check_("codec shuffle round trip", memcmp(data, back, n) == 0);
+__check_("codec shuffled doubles", __codec_round_trip_(shuffled, n, &size) && size < n / 4);
+/* pseudo random bytes do not compress but must come back */
+for(i = 0; i < n; i++) data[i] = (unsigned char)((i * 2654435761u) >> 13);
+__check_("codec random bytes", __codec_round_trip_(data, n, &size) && size <= capacity);
+memset(data, 7, n);
+__check_("codec long run", __codec_round_trip_(data, n, &size) && size < 1000);
+__check_("codec tiny inputs", __codec_round_trip_(data, 0, NULL) && __codec_round_trip_(data, 1, NULL) && __codec_round_trip_((const unsigned char*)"abcdabcdabcd", 12, NULL));
+
+/* output too small and bad compressed data */
+memcpy(data, shuffled, n);
+size = compress_codec(data, n, out, capacity);
+__check_("codec output too small", compress_codec(data, n, out, size / 2) == 0);
+__check_("codec wrong size", !decompress_codec(out, size, back, n - 1));
+cut = (unsigned char*)malloc(size - 1);
+memcpy(cut, out, size - 1);
+__check_("codec truncated", !decompress_codec(cut, size - 1, back, n));
+free(cut);
+/* a damaged byte may be detected or give other data ( the checksum of the file finds it ), but it never makes the decoder go out of the buffers */
+for(i = 0, detected = 0; i < size; i += 1 + size / 500)
+{
+out[i] ^= 0x5a;
+if(!decompress_codec(out, size, back, n)) detected++;
+out[i] ^= 0x5a;
+}
+__check_("codec corrupt data", detected > 0 && decompress_codec(out, size, back, n) && memcmp(back, data, n) == 0);
+
+/* a compressed file with several chunks */
+m = create_matrix(300, 500);
+for(i = 0; i < 300*500; i++) m->_data[i] = (i % 500 < 250) ? 0.0 : floor(i / 1000.0) * 0.25;
+ok = store_matrix_compressed(m, "t_codec.bin");
+__check_("codec compressed file", ok && read_header_binary("t_codec.bin", &header) && (header._flags & BINARY_COMPRESSED) && __size_("t_codec.bin") < 300*500*8 / 4);
+l = load_matrix_binary("t_codec.bin");
+__check_("codec compressed file round trip", __same_(m, l));
+if(l) destroy_matrix(l);
+__check_("codec compressed file not mapped", map_matrix("t_codec.bin", 0) == NULL);
+__truncate_("t_codec.bin", "t_codec_cut.bin", __size_("t_codec.bin") - 16);
+__check_("codec truncated file", load_matrix_binary("t_codec_cut.bin") == NULL);
+changed = (size_t)__size_("t_codec.bin") - 40;
+__corrupt_("t_codec.bin", (long)changed);
+__check_("codec corrupt file", load_matrix_binary("t_codec.bin") == NULL);
+
+/* a chunk table pointing out of the file, inside the table or at chunks too big is refused before any allocation */
+table = (long)header._offset + (long)sizeof(ChunkHeader);
+store_matrix_compressed(m, "t_codec.bin");
+__patch_("t_codec.bin", table + 8, (uint64_t)1 << 45);
+reader = open_row_reader("t_codec.bin", 64);
+__check_("codec chunk past the end", load_matrix_binary("t_codec.bin") == NULL && reader == NULL);
+if(reader) close_row_reader(reader);
+store_matrix_compressed(m, "t_codec.bin");
+__patch_("t_codec.bin", table, 0);
+reader = open_row_reader("t_codec.bin", 64);
+__check_("codec chunk inside the table", load_matrix_binary("t_codec.bin") == NULL && reader == NULL);
+if(reader) close_row_reader(reader);
+store_matrix_compressed(m, "t_codec.bin");
+__patch_("t_codec.bin", (long)header._offset, 300);
+__patch_("t_codec.bin", (long)header._offset + 8, 1);
+reader = open_row_reader("t_codec.bin", 64);
+__check_("codec chunk too big", load_matrix_binary("t_codec.bin") == NULL && reader == NULL);
+if(reader) close_row_reader(reader);
+
+remove("t_codec.bin");
+remove("t_codec_cut.bin");
+destroy_matrix(m);
+free(data);
+free(shuffled);
+free(out);
+free(back);
+}
+
+/*
+* Snapshots of iterative computations ( checkpoint.h ).
+*/
+static void test_checkpoint()
+{
+double state[5] = { 1.5, -2.0, 3.25, 0.0, 1e-300 };
+double* loaded = NULL;
+Matrix* m = __sample_(12, 12, 9);
+Matrix* t = transpose_matrix(m);
+Matrix* s = add_matrix(m, t);
+Eigen* e = NULL;
+Eigen* r = NULL;
+EigenSystem* es = NULL;
+EigenSystem* rs = NULL;
+SnapshotHeader header;
+uint64_t source = checksum_binary(s->_data, 12*12);
+int i, ok;
+
+/* snapshots: round trip, the last one wins and the method and the input must match */
+__check_("checkpoint save", save_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 2, 77, 10, state, 4));
+state[0] = 9.0;
+__check_("checkpoint save again", save_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 3, 77, 20, state, 5));
+loaded = load_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 77, &header);
+__check_("checkpoint load round trip", loaded && header._phase == 3 && header._iteration == 20 && header._count == 5 && memcmp(loaded, state, sizeof(state)) == 0);
+if(loaded) release_memory(loaded);
+__check_("checkpoint other method", load_checkpoint("t_check.ck", CHECKPOINT_EIGEN_SYSTEM, 77, &header) == NULL);
+__check_("checkpoint other input", load_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 78, &header) == NULL);
+__truncate_("t_check.ck", "t_check_cut.ck", __size_("t_check.ck") - 8);
+__check_("checkpoint truncated", load_checkpoint("t_check_cut.ck", CHECKPOINT_POWER_METHOD, 77, &header) == NULL);
+__truncate_("t_check.ck", "t_check_cut.ck", 40);
+__check_("checkpoint truncated header", load_checkpoint("t_check_cut.ck", CHECKPOINT_POWER_METHOD, 77, &header) == NULL);
+__corrupt_("t_check.ck", -10);
+__check_("checkpoint corrupt state", load_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 77, &header) == NULL);
+remove_checkpoint("t_check.ck");
+__check_("checkpoint removed", __size_("t_check.ck") < 0);
+
+/* the power method gives the same result with snapshots, and resumes from a snapshot of the same matrix */
+e = max_eigen_power_method(s);
+r = max_eigen_power_method_checkpoint(s, "t_check.ck", 0);
+__check_("checkpoint power method", e && r && r->_value == e->_value && __size_("t_check.ck") < 0);
+if(r) destroy_eigen(r);
+loaded = (double*)malloc(13 * sizeof(double));
+for(i = 0; e && i < 12; i++) loaded[i] = e->_vector->_data[i];
+loaded[12] = e ? e->_value : 0.0;
+save_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 0, source, 5, loaded, 13);
+r = max_eigen_power_method_checkpoint(s, "t_check.ck", 0);
+__check_("checkpoint power method resumed", e && r && fabs(r->_value - e->_value) <= 1e-8 * fabs(e->_value) && __size_("t_check.ck") < 0);
+if(r) destroy_eigen(r);
+/* a snapshot of another matrix is ignored */
+for(i = 0; i < 12; i++) loaded[i] = (i == 3);
+save_checkpoint("t_check.ck", CHECKPOINT_POWER_METHOD, 0, source + 1, 5, loaded, 13);
+r = max_eigen_power_method_checkpoint(s, "t_check.ck", 0);
+__check_("checkpoint power method other matrix", e && r && r->_value == e->_value);
+if(r) destroy_eigen(r);
+free(loaded);
+
+es = eigen_system(s);
+rs = eigen_system_checkpoint(s, "t_check.ck", 0);
+ok = es && rs && es->_size == rs->_size;
+for(i = 0; ok && i < es->_size; i++) ok = fabs(es->_eigen[i]->_value - rs->_eigen[i]->_value) <= 1e-12 * fabs(es->_eigen[0]->_value);
+__check_("checkpoint eigen system", ok && __size_("t_check.ck") < 0);
+
+remove("t_check.ck");
+remove("t_check_cut.ck");
+if(es) destroy_eigensystem(es);
+if(rs) destroy_eigensystem(rs);
+if(e) destroy_eigen(e);
+destroy_matrix(m);
+destroy_matrix(t);
+destroy_matrix(s);
+}
+
+/*
+* Gate type definition: an operation of an AsyncQueue which runs until it is opened,
+* so the tests know which operations are running and which ones are waiting.
+*/
+typedef struct
+{
+pthread_mutex_t _lock;
+pthread_cond_t _changed;
+int _open;
+}Gate;
+
+static void* __gate_(void* argument)
+{
+Gate* g = (Gate*)argument;
+pthread_mutex_lock(&g->_lock);
+while(!g->_open) pthread_cond_wait(&g->_changed, &g->_lock);
+pthread_mutex_unlock(&g->_lock);
+return argument;
+}
+
+static void __open_gate_(Gate* g)
+{
+pthread_mutex_lock(&g->_lock);
+g->_open = 1;
+pthread_cond_broadcast(&g->_changed);
+pthread_mutex_unlock(&g->_lock);
+}
+
+/* opens a gate when a Future finishes */
+static void __open_callback_(Future* f, void* context)
+{
+(void)f;
+__open_gate_((Gate*)context);
+}
+
+/* an operation which fails */
+static void* __fail_(void* argument)
+{
+(void)argument;
+return NULL;
+}
+
+/* counts the calls of a callback or a release function */
+static int calls = 0;
+
+static void __count_callback_(Future* f, void* context)
+{
+(void)f;
+(*(int*)context)++;
+}
+
+static void __count_release_(void* result)
+{
+(void)result;
+calls++;
+}
+
+/*
+* Asynchronous operations ( async.h ).
+*/
+static void test_async()
+{
+Gate gate;
+AsyncQueue* q = create_async_queue(1, 2);
+Future* f[5] = { NULL, NULL, NULL, NULL, NULL };
+Future* g = NULL;
+Matrix* m = __sample_(40, 40, 10);
+Vector* v = create_vector(40);
+Vector* x = NULL;
+LU* lu = NULL;
+int i, cancelled = 0;
+
+pthread_mutex_init(&gate._lock, NULL);
+pthread_cond_init(&gate._changed, NULL);
+gate._open = 0;
+for(i = 0; i < 40; i++)
+{
+m->_data[i*40+i] += 40.0;
+v->_data[i] = sin(i);
+}
+
+/* one worker kept busy by the gate and room for two operations more */
+f[0] = q ? submit_async(q, __gate_, &gate, NULL, ASYNC_NO_WAIT) : NULL;
+while(f[0] && poll_future(f[0]) == FUTURE_PENDING) wait_future(f[0], 1);
+f[1] = submit_system_solver(q, NULL, m, v, ASYNC_NO_WAIT);
+f[2] = submit_async(q, __gate_, &gate, __count_release_, ASYNC_NO_WAIT);
+__check_("async running", f[0] && poll_future(f[0]) == FUTURE_RUNNING && wait_future(f[0], 10) == FUTURE_RUNNING);
+__check_("async pending", f[1] && f[2] && poll_future(f[1]) == FUTURE_PENDING && pending_async_queue(q) == 2);
+f[3] = submit_async(q, __gate_, &gate, NULL, ASYNC_NO_WAIT);
+f[4] = submit_async(q, __gate_, &gate, NULL, 20);
+__check_("async queue full", f[3] == NULL && f[4] == NULL);
+callback_future(f[2], __count_callback_, &cancelled);
+__check_("async cancel", cancel_future(f[2]) && poll_future(f[2]) == FUTURE_CANCELLED && cancelled == 1 && take_future(f[2]) == NULL);
+__check_("async cancel running", !cancel_future(f[0]));
+f[3] = submit_async(q, __fail_, NULL, NULL, ASYNC_NO_WAIT);
+__check_("async room after cancel", f[3] != NULL);
+
+__open_gate_(&gate);
+__check_("async done", wait_future(f[0], ASYNC_WAIT_FOREVER) == FUTURE_DONE && take_future(f[0]) == &gate && take_future(f[0]) == NULL);
+x = wait_future(f[1], ASYNC_WAIT_FOREVER) == FUTURE_DONE ? (Vector*)take_future(f[1]) : NULL;
+__check_("async system solver residual", __residual_(m, x, v) < 1e-14);
+if(x) destroy_vector(x);
+__check_("async failed", wait_future(f[3], ASYNC_WAIT_FOREVER) == FUTURE_FAILED && take_future(f[3]) == NULL);
+callback_future(f[3], __count_callback_, &cancelled);
+__check_("async callback after finish", cancelled == 2);
+__check_("async cancel finished", !cancel_future(f[3]));
+for(i = 0; i < 4; i++) destroy_future(f[i]);
+
+/* a result which is not taken is released with the Future, maybe by the worker ( checked when the queue is destroyed ) */
+f[0] = submit_async(q, __gate_, &gate, __count_release_, ASYNC_WAIT_FOREVER);
+wait_future(f[0], ASYNC_WAIT_FOREVER);
+destroy_future(f[0]);
+
+/* LU and solver chained, the second one waits in the queue for the first */
+g = submit_lu_decomposition(q, m, ASYNC_WAIT_FOREVER);
+lu = (g && wait_future(g, ASYNC_WAIT_FOREVER) == FUTURE_DONE) ? (LU*)take_future(g) : NULL;
+destroy_future(g);
+g = lu ? submit_lu_system_solver(q, lu, v, ASYNC_WAIT_FOREVER) : NULL;
+x = (g && wait_future(g, ASYNC_WAIT_FOREVER) == FUTURE_DONE) ? (Vector*)take_future(g) : NULL;
+destroy_future(g);
+__check_("async lu residual", __residual_(m, x, v) < 1e-14);
+if(x) destroy_vector(x);
+if(lu) destroy_lu(lu);
+
+/* destroying the queue cancels what is waiting, whose callback lets the running operation finish */
+gate._open = 0;
+f[0] = submit_async(q, __gate_, &gate, NULL, ASYNC_NO_WAIT);
+while(f[0] && poll_future(f[0]) == FUTURE_PENDING) wait_future(f[0], 1);
+f[1] = submit_async(q, __gate_, &gate, NULL, ASYNC_NO_WAIT);
+if(f[1]) callback_future(f[1], __open_callback_, &gate);
+destroy_async_queue(q);
+__check_("async release", calls == 1);
+__check_("async destroy queue", f[0] && f[1] && poll_future(f[0]) == FUTURE_DONE && poll_future(f[1]) == FUTURE_CANCELLED);
+destroy_future(f[0]);
+destroy_future(f[1]);
+
+pthread_mutex_destroy(&gate._lock);
+pthread_cond_destroy(&gate._changed);
+destroy_matrix(m);
+destroy_vector(v);
+}
+
+#ifndef _WIN32
+/*
+* Connects to the daemon with a socket of its own, to send requests which the client never sends.
+* returns: the socket or -1.
+*/
+static int __connect_(const char* path)
+{
+struct sockaddr_un address;
+int s = socket(AF_UNIX, SOCK_STREAM, 0);
+if(s < 0) return -1;
+memset(&address, 0, sizeof(struct sockaddr_un));
+address.sun_family = AF_UNIX;
+strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+if(connect(s, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) != 0)
+{
+	close(s);
+	return -1;
+}
+return s;
+}
+
+/*
+* Sends a request through a socket of __connect_.
+* returns: the status of the reply, or -1 if the connection was closed.
+*/
+static int __raw_request_(int s, int command, int order, int count, unsigned long long size, int fd)
+{
+RemoteRequest request;
+RemoteReply reply;
+memset(&request, 0, sizeof(RemoteRequest));
+request._command = command;
+request._order = order;
+request._count = count;
+request._size = size;
+if(!send_remote(s, &request, sizeof(RemoteRequest), fd) || !receive_remote(s, &reply, sizeof(RemoteReply), NULL)) return -1;
+return reply._status;
+}
+
+/*
+* Creates a block of shared memory of size bytes.
+* returns: its descriptor or -1.
+*/
+static int __shared_(size_t size)
+{
+char name[64];
+int fd;
+sprintf(name, "/linearsys-test-%ld", (long)getpid());
+fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+if(fd < 0) return -1;
+shm_unlink(name);
+if(ftruncate(fd, (off_t)size) != 0)
+{
+	close(fd);
+	return -1;
+}
+return fd;
+}
+
+static void __pause_(int milliseconds)
+{
+struct timespec t;
+t.tv_sec = milliseconds / 1000;
+t.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+nanosleep(&t, NULL);
+}
+#endif
+
+/*
+* Remote solver and solver daemon ( remote.h ).
+* The daemon of the tests is run with a capacity of 2 factorizations, so that they are dropped and made again.
+*/
+static void test_remote()
+{
+#ifndef _WIN32
+const char* path = getenv("LINEARSYS_SOCKET");
+RemoteSolver* r = connect_remote(NULL);
+RemoteSolver* other = NULL;
+RemoteLU* remote[4] = { NULL, NULL, NULL, NULL };
+RemoteLU* same = NULL;
+Matrix* m[4];
+LU* lu = NULL;
+Vector* v = create_vector(30);
+Vector* x = NULL;
+Vector* y = NULL;
+struct stat st;
+int i, k, s, fd, ok, sockets[200], count, refused;
+
+if(r == NULL)
+{
+	printf("remote: skipped, there is no daemon\n");
+	destroy_vector(v);
+	return;
+}
+if(path == NULL) path = REMOTE_SOCKET;
+__check_("remote socket only for its user", stat(path, &st) == 0 && (st.st_mode & 077) == 0);
+for(k = 0; k < 4; k++)
+{
+	m[k] = __sample_(30, 30, 11 + k);
+	for(i = 0; i < 30; i++) m[k]->_data[i*30+i] += 30.0;
+}
+for(i = 0; i < 30; i++) v->_data[i] = cos(i);
+
+/* the solutions are the ones of lu_system_solver */
+remote[0] = remote_lu_decomposition(r, m[0]);
+lu = lu_decomposition(m[0]);
+x = remote[0] ? remote_lu_system_solver(remote[0], v) : NULL;
+y = lu_system_solver(lu, v);
+__check_("remote solution", x && memcmp(x->_data, y->_data, 30*sizeof(double)) == 0 && __residual_(m[0], x, v) < 1e-14);
+if(x) destroy_vector(x);
+
+/* another connection gets the same factorization, a matrix differing in one entry gets another one */
+other = connect_remote(NULL);
+same = other ? remote_lu_decomposition(other, m[0]) : NULL;
+__check_("remote shared factorization", remote[0] && same && same->_id == remote[0]->_id);
+memcpy(m[1]->_data, m[0]->_data, 30*30*sizeof(double));
+m[1]->_data[899] += 1e-9;
+remote[1] = remote_lu_decomposition(r, m[1]);
+__check_("remote different matrix", remote[0] && remote[1] && remote[1]->_id != remote[0]->_id);
+
+/* more matrices than the daemon keeps: the first ones are dropped and made again when they are used */
+remote[2] = remote_lu_decomposition(r, m[2]);
+remote[3] = remote_lu_decomposition(other, m[3]);
+for(k = 0, ok = 1; k < 4; k++)
+{
+	x = remote[k] ? remote_lu_system_solver(remote[k], v) : NULL;
+	ok = ok && __residual_(m[k], x, v) < 1e-14;
+	if(x) destroy_vector(x);
+}
+__check_("remote dropped factorizations", ok);
+x = same ? remote_lu_system_solver(same, v) : NULL;
+__check_("remote dropped shared factorization", x && memcmp(x->_data, y->_data, 30*sizeof(double)) == 0);
+if(x) destroy_vector(x);
+x = create_vector(31);
+__check_("remote wrong size", remote[0] && remote_lu_system_solver(remote[0], x) == NULL);
+destroy_vector(x);
+destroy_matrix(m[3]);
+m[3] = create_matrix(30, 30);
+__check_("remote singular", remote_lu_decomposition(r, m[3]) == NULL);
+
+/* requests a client never sends: they are refused and the daemon goes on */
+s = __connect_(path);
+fd = __shared_(4096);
+__check_("remote attach smaller memory", s >= 0 && fd >= 0 && __raw_request_(s, REMOTE_ATTACH, 0, 0, 16 << 20, fd) == REMOTE_ERROR);
+__check_("remote factorize without memory", s >= 0 && __raw_request_(s, REMOTE_FACTORIZE, 1400, 0, 0, -1) == REMOTE_ERROR);
+__check_("remote attach", s >= 0 && fd >= 0 && __raw_request_(s, REMOTE_ATTACH, 0, 0, 4096, fd) == REMOTE_OK);
+__check_("remote order overflow", s >= 0 && __raw_request_(s, REMOTE_LOOKUP, 2147483647, 0, 0, -1) == REMOTE_ERROR && __raw_request_(s, REMOTE_SOLVE, 2147483647, 2147483647, 0, -1) == REMOTE_ERROR);
+__check_("remote order past the memory", s >= 0 && __raw_request_(s, REMOTE_FACTORIZE, 23, 0, 0, -1) == REMOTE_ERROR && __raw_request_(s, REMOTE_LOOKUP, 22, 0, 0, -1) == REMOTE_MISSING);
+__check_("remote unknown factorization", s >= 0 && __raw_request_(s, REMOTE_SOLVE, 10, 1, 0, -1) == REMOTE_MISSING);
+/* a client shrinking its memory after attaching it gets errors, the daemon never reads past the end of the memory */
+__check_("remote shrunk memory", s >= 0 && fd >= 0 && ftruncate(fd, 0) == 0 &&
+__raw_request_(s, REMOTE_LOOKUP, 22, 0, 0, -1) == REMOTE_ERROR && __raw_request_(s, REMOTE_FACTORIZE, 22, 0, 0, -1) == REMOTE_ERROR);
+if(fd >= 0) close(fd);
+if(s >= 0) close(s);
+x = remote[0] ? remote_lu_system_solver(remote[0], v) : NULL;
+__check_("remote daemon alive", x != NULL);
+if(x) destroy_vector(x);
+
+/* the daemon serves a bounded number of clients and closes the connections past it */
+for(count = 0, refused = 0; count < 200 && !refused; count++)
+{
+	sockets[count] = __connect_(path);
+	refused = sockets[count] < 0 || __raw_request_(sockets[count], REMOTE_SOLVE, 1, 1, 0, -1) != REMOTE_ERROR;
+}
+__check_("remote clients limit", refused);
+for(k = 0; k < count; k++) if(sockets[k] >= 0) close(sockets[k]);
+for(k = 0, ok = 0; k < 100 && !ok; k++)
+{
+	/* the daemon counts a client out when its thread sees the connection closed */
+	__pause_(10);
+	s = __connect_(path);
+	ok = s >= 0 && __raw_request_(s, REMOTE_SOLVE, 1, 1, 0, -1) == REMOTE_ERROR;
+	if(s >= 0) close(s);
+}
+__check_("remote clients served again", ok);
+
+for(k = 0; k < 4; k++)
+{
+	destroy_remote_lu(remote[k]);
+	destroy_matrix(m[k]);
+}
+destroy_remote_lu(same);
+destroy_vector(y);
+destroy_vector(v);
+destroy_lu(lu);
+disconnect_remote(other);
+disconnect_remote(r);
+#else
+printf("remote: skipped, only POSIX systems\n");
+#endif
+}
+
+int main()
+{
+#ifndef _WIN32
+setenv("LINEARSYS_THREADS", "4", 0); /* several threads even on a single processor, so the parallel code runs */
+#endif
+test_svd();
+test_krylov();
+test_eigen();
+test_rng();
+test_text();
+test_binio();
+test_stream();
+test_tiled();
+test_npy();
+test_mtx();
+test_batch();
+test_codec();
+test_checkpoint();
+test_async();
+test_remote();
+printf("%d failures\n", failures);
+return failures;
+}
+
+/* END */
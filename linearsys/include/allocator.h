@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___ALLOCATOR_H___
+#define ___ALLOCATOR_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+
+/*
+* This header has the memory allocator of the library.
+* All the memory used by the library is allocated and released through an Allocator, which is the one of
+* the C library ( malloc and free ) unless another one is set, for instance jemalloc, an arena,
+* huge pages or a NUMA aware allocator.
+* The entries of matrices and vectors are aligned to MEMORY_ALIGNMENT bytes.
+* An allocation trace can also be recorded: for each call site of the library, the number and size of its
+* allocations and the blocks it allocated which have not been released yet, which is how leaks are found.
+* The buffers of the instrumentation and of the task trace ( instrument.h, trace.h ) are the only ones
+* which keep using the C library, so that they do not show up in the allocation trace.
+*/
+
+#define MEMORY_ALIGNMENT 64 /* alignment of the entries of matrices and vectors, a cache line */
+
+/*
+* Function types of an Allocator; context is the user data of the Allocator.
+* A block returned by the aligned function is released with the free function, as aligned_alloc in C11.
+*/
+typedef void* (*MallocFunction)(size_t size, void* context);
+typedef void* (*AlignedAllocFunction)(size_t alignment, size_t size, void* context);
+typedef void (*FreeFunction)(void* p, void* context);
+
+/*
+* Allocator type definition.
+*/
+typedef struct
+{
+MallocFunction _malloc;
+FreeFunction _free;
+AlignedAllocFunction _aligned_alloc; /* NULL to carve aligned blocks out of bigger _malloc blocks */
+void* _context;
+}Allocator;
+
+/*
+* AllocationSite type definition: the allocations of a call site while an allocation trace was recorded.
+*/
+typedef struct
+{
+const char* _site; /* file:line */
+unsigned long long _allocations;
+unsigned long long _bytes; /* bytes allocated */
+long long _outstanding_blocks; /* blocks not released yet */
+long long _outstanding_bytes;
+}AllocationSite;
+
+/*
+* Sets the Allocator of the library.
+* It must be called before the library allocates anything ( or once all its blocks are released ),
+* and not while other threads are using the library.
+* param: a Allocator to use, it is copied; NULL restores the one of the C library.
+*/
+void set_allocator(const Allocator* a);
+
+/*
+* Gets the Allocator of the library.
+* param: a Allocator to fill.
+*/
+void get_allocator(Allocator* a);
+
+/*
+* Allocates memory with the Allocator of the library.
+* The library uses these functions through the macros below, which give the call site.
+* param: size bytes to allocate.
+* param: site name of the call site for the allocation trace ( a string literal ), or NULL.
+*
+* returns: A pointer to the block or NULL if it cannot be allocated.
+*/
+void* allocate_memory(size_t size, const char* site);
+
+/*
+* Allocates memory set to zero, as calloc.
+* param: count number of elements.
+* param: size bytes of an element.
+* param: site name of the call site, or NULL.
+*
+* returns: A pointer to the block or NULL if it cannot be allocated.
+*/
+void* allocate_zeroed_memory(size_t count, size_t size, const char* site);
+
+/*
+* Allocates memory aligned to a power of two; it must be released with release_aligned_memory.
+* param: alignment alignment in bytes, a power of two.
+* param: size bytes to allocate.
+* param: site name of the call site, or NULL.
+*
+* returns: A pointer to the block or NULL if it cannot be allocated.
+*/
+void* allocate_aligned_memory(size_t alignment, size_t size, const char* site);
+
+/*
+* Changes the size of a block from allocate_memory, keeping its contents, as realloc.
+* param: p block to change, or NULL.
+* param: old_size current size of the block.
+* param: size new size.
+* param: site name of the call site, or NULL.
+*
+* returns: A pointer to the new block, or NULL if it cannot be allocated ( p is not released then ).
+*/
+void* reallocate_memory(void* p, size_t old_size, size_t size, const char* site);
+
+/*
+* Releases a block from allocate_memory, allocate_zeroed_memory or reallocate_memory.
+* Buffers returned by the library to be released by the caller are released with this function.
+* param: p block to release, or NULL.
+*/
+void release_memory(void* p);
+
+/*
+* Releases a block from allocate_aligned_memory.
+* param: p block to release, or NULL.
+*/
+void release_aligned_memory(void* p);
+
+/*
+* Starts recording an allocation trace, forgetting a previous one.
+*
+* returns: 1 on success or 0 if there is no memory for the trace.
+*/
+int start_allocation_trace(void);
+
+/*
+* Stops recording allocations; the releases of the blocks already recorded are still counted.
+*/
+void stop_allocation_trace(void);
+
+/*
+* Gets the call sites of the allocation trace, sorted by outstanding bytes and then by bytes allocated.
+* param: sites array to fill, or NULL.
+* param: count size of the array.
+*
+* returns: the number of call sites in the trace ( it can be bigger than count ).
+*/
+int sites_allocation_trace(AllocationSite* sites, int count);
+
+/*
+* Writes the call sites of the allocation trace as a text table, with the totals at the end.
+* param: filename name of the file, NULL for the standard output.
+* param: outstanding nonzero to write only the sites having outstanding blocks ( the leaks ).
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int dump_allocation_trace(const char* filename, int outstanding);
+
+/*
+* Macros used by the library to allocate memory, giving the call site.
+*/
+#define __SITE_STRING_(x) #x
+#define __SITE_LINE_(x) __SITE_STRING_(x)
+#define ALLOCATION_SITE (__FILE__ ":" __SITE_LINE_(__LINE__))
+#define ALLOCATE(size) allocate_memory(size, ALLOCATION_SITE)
+#define ALLOCATE_ZEROED(count, size) allocate_zeroed_memory(count, size, ALLOCATION_SITE)
+#define ALLOCATE_ALIGNED(size) allocate_aligned_memory(MEMORY_ALIGNMENT, size, ALLOCATION_SITE)
+#define REALLOCATE(p, old_size, size) reallocate_memory(p, old_size, size, ALLOCATION_SITE)
+#define RELEASE(p) release_memory(p)
+#define RELEASE_ALIGNED(p) release_aligned_memory(p)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___ASYNC_H___
+#define ___ASYNC_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "matrix.h"
+#include "vector.h"
+#include "lu.h"
+#include "eigen.h"
+#include "svd.h"
+#include "batch.h"
+
+/*
+* This header runs operations of the library in background threads, so the calling thread does not block.
+* An operation is submitted to an AsyncQueue and a Future is returned at once;
+* the Future tells the state of the operation, waits for it, cancels it or calls a function when it finishes.
+* A queue keeps a bounded number of operations waiting to run: when it is full,
+* submitting waits for room up to a timeout and fails after it ( backpressure ).
+* The worker threads of a queue call the library as usual, so each operation still uses the ThreadPool for its loops.
+*/
+
+#define DEFAULT_ASYNC_DEPTH 64 /* operations waiting to run in a queue */
+
+/*
+* States of a Future.
+*/
+#define FUTURE_PENDING 0 /* waiting in the queue */
+#define FUTURE_RUNNING 1 /* running in a worker thread */
+#define FUTURE_DONE 2 /* finished with a result */
+#define FUTURE_FAILED 3 /* finished with no result ( the operation returned NULL ) */
+#define FUTURE_CANCELLED 4 /* cancelled before it ran */
+
+/*
+* Timeouts in milliseconds; these values can be used too.
+*/
+#define ASYNC_NO_WAIT 0
+#define ASYNC_WAIT_FOREVER -1
+
+/*
+* AsyncQueue and Future type declarations.
+* Their fields are private ( they depend on the thread library ), so they are only used through pointers.
+*/
+typedef struct AsyncQueue AsyncQueue;
+typedef struct Future Future;
+
+/*
+* Function type for an operation run by an AsyncQueue.
+* param: argument user data passed to submit_async.
+*
+* returns: the result of the operation, NULL if it failed.
+*/
+typedef void* (*AsyncFunction)(void* argument);
+
+/*
+* Function type to destroy a result which was not taken from its Future.
+*/
+typedef void (*ReleaseFunction)(void* result);
+
+/*
+* Function type for the function called when a Future finishes.
+* It runs in the worker thread which finished the operation, in the thread which cancelled it,
+* or in the thread calling callback_future if the Future had already finished.
+* param: f the Future.
+* param: context user data passed to callback_future.
+*/
+typedef void (*FutureCallback)(Future* f, void* context);
+
+/*
+* Creates an AsyncQueue.
+* param: threads number of worker threads; use 0 for the number of threads of the default ThreadPool.
+* param: depth maximum number of operations waiting to run; use 0 for DEFAULT_ASYNC_DEPTH.
+*
+* returns: A pointer to the newly created AsyncQueue or NULL if the threads cannot be created.
+*/
+AsyncQueue* create_async_queue(int threads, int depth);
+
+/*
+* Destroys an AsyncQueue. Operations waiting to run are cancelled and the running ones are waited for.
+* The Futures are still valid and must be destroyed by their owners.
+* param: q AsyncQueue to destroy.
+*/
+void destroy_async_queue(AsyncQueue* q);
+
+/*
+* Gets the AsyncQueue shared by the library.
+* It is created on first use with as many workers as the LINEARSYS_ASYNC_THREADS environment variable says,
+* or the number of threads of the default ThreadPool if it is not set, and it lives until the program ends.
+*
+* returns: the default AsyncQueue.
+*/
+AsyncQueue* default_async_queue(void);
+
+/*
+* Gets the number of operations waiting to run in an AsyncQueue.
+* param: q an AsyncQueue, NULL for the default one.
+*
+* returns: number of operations in the queue.
+*/
+int pending_async_queue(AsyncQueue* q);
+
+/*
+* Submits an operation to an AsyncQueue.
+* param: q an AsyncQueue, NULL for the default one.
+* param: run function running the operation.
+* param: argument user data passed to run; it must be valid until the Future finishes.
+* param: release function destroying the result if it is not taken from the Future, or NULL.
+* param: timeout milliseconds to wait for room when the queue is full, ASYNC_NO_WAIT or ASYNC_WAIT_FOREVER.
+*
+* returns: a Future for the operation, or NULL if the queue is still full after the timeout.
+*/
+Future* submit_async(AsyncQueue* q, AsyncFunction run, void* argument, ReleaseFunction release, int timeout);
+
+/*
+* Submits lu_decomposition. The matrix is copied, so it can be destroyed after the call.
+* The result of the Future is a LU*.
+* param: q an AsyncQueue, NULL for the default one.
+* param: m a square matrix.
+* param: timeout milliseconds to wait for room when the queue is full.
+*
+* returns: a Future for the operation, or NULL if the queue is still full after the timeout.
+*/
+Future* submit_lu_decomposition(AsyncQueue* q, const Matrix* m, int timeout);
+
+/*
+* Submits lu_system_solver. The vector is copied, but the LU is not, so it must be valid until the Future finishes.
+* The result of the Future is a Vector*.
+* param: q an AsyncQueue, NULL for the default one.
+* param: lu LU decomposition of the matrix of the system.
+* param: v right hand side of the system.
+* param: timeout milliseconds to wait for room when the queue is full.
+*
+* returns: a Future for the operation, or NULL if the queue is still full after the timeout.
+*/
+Future* submit_lu_system_solver(AsyncQueue* q, const LU* lu, const Vector* v, int timeout);
+
+/*
+* Submits a system solver. The matrix and the vector are copied.
+* The result of the Future is a Vector*.
+* param: q an AsyncQueue, NULL for the default one.
+* param: solver function solving the system ( see batch.h ), NULL for mvgauss_system_solver.
+* param: m matrix of the system.
+* param: v right hand side of the system.
+* param: timeout milliseconds to wait for room when the queue is full.
+*
+* returns: a Future for the operation, or NULL if the queue is still full after the timeout.
+*/
+Future* submit_system_solver(AsyncQueue* q, SystemSolver solver, const Matrix* m, const Vector* v, int timeout);
+
+/*
+* Submits eigen_system. The matrix is copied.
+* The result of the Future is an EigenSystem*.
+* param: q an AsyncQueue, NULL for the default one.
+* param: m a square matrix.
+* param: timeout milliseconds to wait for room when the queue is full.
+*
+* returns: a Future for the operation, or NULL if the queue is still full after the timeout.
+*/
+Future* submit_eigen_system(AsyncQueue* q, const Matrix* m, int timeout);
+
+/*
+* Submits svd_factorization. The matrix is copied.
+* The result of the Future is a SVD*.
+* param: q an AsyncQueue, NULL for the default one.
+* param: m a matrix.
+* param: timeout milliseconds to wait for room when the queue is full.
+*
+* returns: a Future for the operation, or NULL if the queue is still full after the timeout.
+*/
+Future* submit_svd_factorization(AsyncQueue* q, const Matrix* m, int timeout);
+
+/*
+* Gets the state of a Future without waiting.
+* param: f a Future.
+*
+* returns: FUTURE_PENDING, FUTURE_RUNNING, FUTURE_DONE, FUTURE_FAILED or FUTURE_CANCELLED.
+*/
+int poll_future(Future* f);
+
+/*
+* Waits for a Future to finish.
+* param: f a Future.
+* param: timeout milliseconds to wait, ASYNC_NO_WAIT or ASYNC_WAIT_FOREVER.
+*
+* returns: the state of the Future; FUTURE_PENDING or FUTURE_RUNNING if the timeout expired.
+*/
+int wait_future(Future* f, int timeout);
+
+/*
+* Cancels a Future which has not started to run yet; a running operation cannot be stopped.
+* param: f a Future.
+*
+* returns: 1 if the Future was cancelled or 0 if it is running or has finished.
+*/
+int cancel_future(Future* f);
+
+/*
+* Sets the function called when a Future finishes ( done, failed or cancelled ).
+* If the Future has already finished, the function is called at once.
+* param: f a Future.
+* param: callback function to call, NULL to remove it.
+* param: context user data passed to the function.
+*/
+void callback_future(Future* f, FutureCallback callback, void* context);
+
+/*
+* Takes the result of a finished Future; after that the caller owns it and destroy_future does not destroy it.
+* param: f a Future.
+*
+* returns: the result ( LU*, Vector*, EigenSystem* or SVD* for the submit functions above ),
+* or NULL if the Future has not finished, it failed or was cancelled, or the result was already taken.
+*/
+void* take_future(Future* f);
+
+/*
+* Destroys a Future. If it is waiting to run it is cancelled; if it is running, it is released when it finishes.
+* The result is destroyed unless it was taken.
+* param: f Future to destroy.
+*/
+void destroy_future(Future* f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___BATCH_H___
+#define ___BATCH_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stdint.h>
+#include "matrix.h"
+#include "vector.h"
+
+/*
+* This header has a container format holding many matrices and vectors in one binary file,
+* and a driver to solve many independent linear systems stored in such a file.
+*
+* The file starts with a 32 bytes header ( BatchHeader ) followed by the records; each record has
+* a 16 bytes header ( kind, rows, columns ) and the entries in row major order with the host byte order.
+* An index with the position of every record is written after the last one, so any record can be read directly.
+*/
+
+#define BATCH_MAGIC "LINSYSBT" /* first 8 bytes of the file */
+#define BATCH_VERSION 1
+
+/*
+* Kinds of record.
+*/
+#define BATCH_EMPTY 0 /* no data, for example a system which could not be solved */
+#define BATCH_MATRIX 1
+#define BATCH_VECTOR 2
+
+/*
+* BatchHeader type definition.
+*/
+typedef struct
+{
+char _magic[8]; /* BATCH_MAGIC */
+uint32_t _version; /* BATCH_VERSION */
+uint32_t _endian; /* BINARY_ENDIAN ( see binio.h ) */
+uint64_t _count; /* number of records */
+uint64_t _index; /* byte offset of the index: one uint64_t position per record */
+}BatchHeader;
+
+/*
+* Batch type definition: a batch file open to read.
+*/
+typedef struct Batch Batch;
+
+/*
+* BatchWriter type definition: a batch file open to write.
+*/
+typedef struct BatchWriter BatchWriter;
+
+/*
+* Function type for the solver of a linear system m*x = v, as mvgauss_system_solver.
+* It must return NULL if the system cannot be solved.
+*/
+typedef Vector* (*SystemSolver)(const Matrix* m, const Vector* v);
+
+/*
+* Creates a batch file to write records in it.
+* param: filename name of the file.
+*
+* returns: A pointer to the newly created BatchWriter or NULL if the file cannot be created.
+*/
+BatchWriter* open_batch_writer(const char* filename);
+
+/*
+* Adds a Matrix record at the end of a batch file.
+* param: w a BatchWriter.
+* param: m Matrix to add.
+*
+* returns: 1 on success or 0 if it cannot be written.
+*/
+int add_batch_matrix(BatchWriter* w, const Matrix* m);
+
+/*
+* Adds a Vector record at the end of a batch file.
+* param: w a BatchWriter.
+* param: v Vector to add; NULL adds a BATCH_EMPTY record.
+*
+* returns: 1 on success or 0 if it cannot be written.
+*/
+int add_batch_vector(BatchWriter* w, const Vector* v);
+
+/*
+* Writes the index and the header, closes the file and destroys a BatchWriter.
+* param: w BatchWriter to close.
+*
+* returns: 1 on success or 0 if some write failed.
+*/
+int close_batch_writer(BatchWriter* w);
+
+/*
+* Opens a batch file to read its records.
+* param: filename name of the file.
+*
+* returns: A pointer to the Batch or NULL if the file cannot be read or it is not valid.
+*/
+Batch* open_batch(const char* filename);
+
+/*
+* Closes a batch file and destroys a Batch.
+* param: b Batch to close.
+*/
+void close_batch(Batch* b);
+
+/*
+* Gets the number of records of a batch file.
+* param: b a Batch.
+*
+* returns: number of records.
+*/
+int count_batch(const Batch* b);
+
+/*
+* Gets the kind of a record.
+* param: b a Batch.
+* param: index index of the record.
+*
+* returns: BATCH_EMPTY, BATCH_MATRIX or BATCH_VECTOR, or -1 if the record cannot be read.
+*/
+int kind_batch(Batch* b, int index);
+
+/*
+* Reads a Matrix record.
+* param: b a Batch.
+* param: index index of the record.
+*
+* returns: A pointer to the Matrix or NULL if the record cannot be read or it is not a Matrix.
+*/
+Matrix* read_batch_matrix(Batch* b, int index);
+
+/*
+* Reads a Vector record.
+* param: b a Batch.
+* param: index index of the record.
+*
+* returns: A pointer to the Vector or NULL if the record cannot be read or it is not a Vector.
+*/
+Vector* read_batch_vector(Batch* b, int index);
+
+/*
+* Solves all the linear systems of a batch file and writes their solutions to another one.
+* The input holds pairs of records: the Matrix and the Vector of each system.
+* The output holds one Vector per system, in the same order; a system which cannot be solved gets a BATCH_EMPTY record.
+* The work is pipelined: a thread reads the next group of systems and another one writes the previous solutions
+* while the systems of the current group are solved in parallel by the thread pool ( see threadpool.h ).
+* param: input name of the batch file with the systems.
+* param: output name of the batch file for the solutions.
+* param: solver function solving each system; NULL uses mvgauss_system_solver.
+*
+* returns: number of systems solved, or -1 if the files cannot be read or written.
+*/
+int solve_batch(const char* input, const char* output, SystemSolver solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
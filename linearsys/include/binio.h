@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___BINIO_H___
+#define ___BINIO_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include "matrix.h"
+
+/*
+* Binary file format for matrices.
+* Text files need a conversion per element, so they are slow to load for big matrices;
+* a binary file holds the entries exactly as they are in memory, so it can be read in one go
+* or even mapped into memory and used in place.
+*
+* The file starts with a 64 bytes header ( BinaryHeader ) followed by the entries of the matrix
+* in row major order, starting at a byte offset multiple of the alignment stored in the header.
+* The header has the host byte order; a file written in a host with a different byte order is rejected.
+*/
+
+#define BINARY_MAGIC "LINSYSMX" /* first 8 bytes of the file */
+#define BINARY_VERSION 1
+#define BINARY_ENDIAN 0x01020304 /* reads as 0x04030201 with the wrong byte order */
+#define BINARY_FLOAT64 1 /* IEEE 754 double precision entries */
+#define BINARY_ROW_MAJOR 0
+#define BINARY_COLUMN_MAJOR 1
+#define BINARY_ALIGNMENT 64 /* data offset alignment ( a cache line ) */
+#define BINARY_UNCHECKED 1 /* flag: the checksum is not kept, as in a file updated in place ( see tiled.h ) */
+#define BINARY_COMPRESSED 2 /* flag: the entries are stored in compressed chunks, see store_matrix_compressed */
+#define COMPRESSED_CHUNK (1 << 20) /* bytes of entries in each compressed chunk */
+
+/*
+* BinaryHeader type definition.
+*/
+typedef struct
+{
+char _magic[8]; /* BINARY_MAGIC */
+uint32_t _version; /* BINARY_VERSION */
+uint32_t _endian; /* BINARY_ENDIAN */
+uint32_t _dtype; /* type of the entries, BINARY_FLOAT64 */
+uint32_t _layout; /* BINARY_ROW_MAJOR or BINARY_COLUMN_MAJOR */
+uint32_t _alignment; /* alignment of the data offset */
+uint32_t _flags; /* zero, BINARY_UNCHECKED or BINARY_COMPRESSED */
+uint64_t _rows;
+uint64_t _columns;
+uint64_t _offset; /* byte offset of the first entry */
+uint64_t _checksum; /* checksum of the entries, see checksum_binary */
+}BinaryHeader;
+
+/*
+* ChunkHeader type definition.
+* In a compressed file it is found at the data offset, followed by chunks+1 uint64_t values:
+* the byte offset in the file of each chunk and the end of the last one.
+* Chunk k holds rows k*chunk_rows .. (k+1)*chunk_rows-1; its bytes are shuffled ( see codec.h ) and compressed
+* or, if that does not make them smaller, stored as they are.
+* A chunk holds at most COMPRESSED_CHUNK bytes of entries, or a single row when a row is longer.
+*/
+typedef struct
+{
+uint64_t _chunk_rows; /* rows in each chunk, the last one may have less */
+uint64_t _chunks; /* number of chunks */
+}ChunkHeader;
+
+/*
+* Stores a Matrix in a binary file.
+* param: m Matrix to store.
+* param: filename name of the file.
+*
+* returns: 1 if the Matrix was stored or 0 if the file cannot be written.
+*/
+int store_matrix_binary(const Matrix* m, const char* filename);
+
+/*
+* Stores a Matrix in a compressed binary file.
+* The rows are split in chunks of about COMPRESSED_CHUNK bytes which are compressed in parallel ( see threadpool.h )
+* and can be decompressed independently, so a file is also decompressed in parallel
+* and it can be read by blocks of rows with a RowReader ( see stream.h ).
+* The checksum is computed from the entries, as in a file which is not compressed.
+* param: m Matrix to store.
+* param: filename name of the file.
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int store_matrix_compressed(const Matrix* m, const char* filename);
+
+/*
+* Decodes a chunk of a compressed file.
+* param: data the bytes of the chunk.
+* param: n number of bytes.
+* param: entries output array.
+* param: count number of entries in the chunk.
+*
+* returns: 1 on success or 0 if the chunk is corrupt.
+*/
+int decode_chunk_binary(const void* data, size_t n, double* entries, size_t count);
+
+/*
+* Reads the chunk header and the chunk positions of a compressed file and leaves the file at the first chunk.
+* Nothing read from the file is trusted: the chunk sizes must agree with the header, and every chunk
+* must lie between the end of the table and the end of the file and not be bigger than its entries.
+* param: file a compressed binary file positioned at its data offset.
+* param: header the header of the file, already verified.
+* param: chunks output ChunkHeader.
+*
+* returns: the chunks+1 positions ( to release with release_memory by the caller ), or NULL if the table is not valid,
+* the file cannot be read or there is not enough memory.
+*/
+uint64_t* read_chunk_table_binary(FILE* file, const BinaryHeader* header, ChunkHeader* chunks);
+
+/*
+* Loads a Matrix from a binary file into memory; a compressed file is decompressed in parallel.
+* The header and the checksum ( unless the file has the BINARY_UNCHECKED flag ) are verified.
+* param: filename name of the file.
+*
+* returns: A pointer to the loaded Matrix, or NULL if the file cannot be read or it is not valid.
+*/
+Matrix* load_matrix_binary(const char* filename);
+
+/*
+* Maps a binary file into memory and returns a read only Matrix using the mapped entries in place,
+* so nothing is parsed or copied; pages are read from disk as they are used.
+* The Matrix can be passed to any function taking a const Matrix*; writing its entries is an error.
+* It must be released with unmap_matrix, never with destroy_matrix.
+* param: filename name of the file.
+* param: verify nonzero to verify the checksum, which reads the whole file.
+*
+* returns: A read only Matrix, or NULL if the file cannot be mapped, it is not valid or it is compressed.
+*/
+const Matrix* map_matrix(const char* filename, int verify);
+
+/*
+* Maps into memory an array of doubles stored in row major order at some position of a file,
+* as the data of other binary formats ( see npyio.h ).
+* The entries must have the host byte order.
+* param: filename name of the file.
+* param: offset byte offset of the first entry, a multiple of sizeof(double).
+* param: rows number of rows.
+* param: columns number of columns.
+*
+* returns: A read only Matrix to release with unmap_matrix, or NULL if the file cannot be mapped or it is too short.
+*/
+const Matrix* map_array_matrix(const char* filename, uint64_t offset, int rows, int columns);
+
+/*
+* Releases a Matrix returned by map_matrix or map_array_matrix and its mapping.
+* param: m Matrix to release.
+*/
+void unmap_matrix(const Matrix* m);
+
+/*
+* Reads and validates the header of a binary file.
+* param: filename name of the file.
+* param: header BinaryHeader to fill.
+*
+* returns: 1 if the file has a valid header or 0 otherwise.
+*/
+int read_header_binary(const char* filename, BinaryHeader* header);
+
+/*
+* Fills a header for a row major Matrix.
+* param: header BinaryHeader to fill.
+* param: rows number of rows.
+* param: columns number of columns.
+* param: checksum checksum of the entries.
+*/
+void make_header_binary(BinaryHeader* header, uint64_t rows, uint64_t columns, uint64_t checksum);
+
+/*
+* Checks the fields of a header.
+* The number of entries is not limited here, so the header of a file bigger than a Matrix can hold
+* ( see stream.h ) is also valid.
+* param: header a BinaryHeader read from a file.
+*
+* returns: 1 if the header is valid or 0 otherwise.
+*/
+int valid_header_binary(const BinaryHeader* header);
+
+/*
+* Computes the checksum stored in the header of a binary file ( a 64 bits Fletcher like sum of the entries ).
+* param: data entries.
+* param: count number of entries.
+*
+* returns: checksum of the entries.
+*/
+uint64_t checksum_binary(const double* data, size_t count);
+
+/*
+* Checksum type definition.
+* Running sums to compute the checksum of a binary file piece by piece,
+* for entries which are not all in memory at once.
+*/
+typedef struct
+{
+uint64_t _a;
+uint64_t _b;
+}Checksum;
+
+/*
+* Starts a Checksum.
+* param: c Checksum to start.
+*/
+void start_checksum(Checksum* c);
+
+/*
+* Adds entries to a Checksum, in the same order they have in the file.
+* param: c a Checksum.
+* param: data entries.
+* param: count number of entries.
+*/
+void update_checksum(Checksum* c, const double* data, size_t count);
+
+/*
+* Gets the value of a Checksum.
+* param: c a Checksum.
+*
+* returns: checksum of all the entries added, the same value as checksum_binary.
+*/
+uint64_t value_checksum(const Checksum* c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___CHECKPOINT_H___
+#define ___CHECKPOINT_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "eigen.h"
+
+/*
+* This header saves and restores the state of long iterative computations ( snapshots ),
+* so that a job which is stopped can go on from its last snapshot instead of starting again.
+* A snapshot is a binary file with a 64 bytes header followed by an array of doubles with the state.
+* It is written to a temporary file which then replaces the previous snapshot,
+* so a job stopped while it writes a snapshot still finds the previous one.
+*/
+
+#define CHECKPOINT_MAGIC "LINSYSCK" /* first 8 bytes of the file */
+#define CHECKPOINT_VERSION 1
+#define DEFAULT_CHECKPOINT_INTERVAL 60 /* seconds between two snapshots */
+
+/*
+* Methods which write snapshots.
+*/
+#define CHECKPOINT_POWER_METHOD 1 /* max_eigen_power_method */
+#define CHECKPOINT_EIGEN_SYSTEM 2 /* eigen_system */
+
+/*
+* SnapshotHeader type definition.
+*/
+typedef struct
+{
+char _magic[8]; /* CHECKPOINT_MAGIC */
+uint32_t _version; /* CHECKPOINT_VERSION */
+uint32_t _endian; /* BINARY_ENDIAN ( see binio.h ) */
+uint32_t _method; /* method which wrote the snapshot */
+uint32_t _phase; /* step of the method, for methods made of several steps */
+uint64_t _source; /* checksum of the input of the method, so a snapshot is not used with another input */
+uint64_t _iteration; /* iterations done */
+uint64_t _count; /* number of doubles after the header */
+uint64_t _checksum; /* checksum of the doubles */
+}SnapshotHeader;
+
+/*
+* Writes a snapshot.
+* param: filename name of the snapshot file.
+* param: method method writing the snapshot.
+* param: phase step of the method.
+* param: source checksum of the input of the method ( see checksum_binary ).
+* param: iteration iterations done.
+* param: state array with the state.
+* param: count number of doubles in the state.
+*
+* returns: 1 on success or 0 if the file cannot be written, in which case the previous snapshot is kept.
+*/
+int save_checkpoint(const char* filename, uint32_t method, uint32_t phase, uint64_t source, uint64_t iteration, const double* state, size_t count);
+
+/*
+* Reads a snapshot.
+* param: filename name of the snapshot file.
+* param: method method reading the snapshot.
+* param: source checksum of the input of the method.
+* param: header the header of the snapshot is stored here.
+*
+* returns: the state ( an array of header->_count doubles to release with release_memory by the caller ), or NULL if there is no valid snapshot
+* of the method for that input.
+*/
+double* load_checkpoint(const char* filename, uint32_t method, uint64_t source, SnapshotHeader* header);
+
+/*
+* Removes a snapshot file, when the computation is over.
+* param: filename name of the snapshot file.
+*/
+void remove_checkpoint(const char* filename);
+
+/*
+* Computes the maximum Eigen as max_eigen_power_method, writing snapshots of the iterate
+* ( the current vector, its eigenvalue and the number of iterations ) while it runs.
+* If the file has a snapshot for the same matrix, the computation goes on from it,
+* so calling the function again after the job was stopped resumes it.
+* The file is removed when the computation is over.
+* param: m a square matrix.
+* param: filename name of the snapshot file; NULL writes no snapshots.
+* param: interval seconds between two snapshots; use 0 for DEFAULT_CHECKPOINT_INTERVAL.
+*
+* returns: Maximum eigen or NULL if the operation cannot be done.
+*/
+Eigen* max_eigen_power_method_checkpoint(const Matrix* m, const char* filename, int interval);
+
+/*
+* Computes the eigensystem as eigen_system, writing snapshots while it runs.
+* The snapshots have the matrix of the QR algorithm and the number of iterations
+* while the eigenvalues are computed, and then the eigenvalues and the eigenpairs already found by inverse iteration.
+* If the file has a snapshot for the same matrix, the computation goes on from it,
+* so calling the function again after the job was stopped resumes it.
+* The file is removed when the computation is over.
+* param: m a square matrix.
+* param: filename name of the snapshot file; NULL writes no snapshots.
+* param: interval seconds between two snapshots; use 0 for DEFAULT_CHECKPOINT_INTERVAL.
+*
+* returns: EigenSystem for the matrix passed as parameter.
+*/
+EigenSystem* eigen_system_checkpoint(const Matrix* m, const char* filename, int interval);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___CODEC_H___
+#define ___CODEC_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+
+/*
+* This header has the compression codec used by compressed binary matrix files ( see binio.h ).
+* It is a fast LZ77 codec: the data is a sequence of literal runs and back references to the previous 64 KB,
+* found with a hash table of four bytes sequences.
+* Doubles compress badly as they are, since their bytes vary a lot; shuffling their bytes first
+* ( all the first bytes, then all the second bytes, and so on ) puts the signs and exponents together,
+* which are repeated in smooth or sparse data, so the codec finds long matches.
+*/
+
+/*
+* Computes the largest size of the compressed data for an input of n bytes.
+* param: n size of the input in bytes.
+*
+* returns: size of the buffer needed by compress_codec.
+*/
+size_t bound_codec(size_t n);
+
+/*
+* Compresses a block of bytes.
+* param: in input bytes.
+* param: n size of the input.
+* param: out output buffer.
+* param: capacity size of the output buffer.
+*
+* returns: size of the compressed data or 0 if it does not fit in the output buffer.
+*/
+size_t compress_codec(const void* in, size_t n, void* out, size_t capacity);
+
+/*
+* Decompresses a block of bytes compressed by compress_codec.
+* The input is checked, so corrupt data never makes it read or write out of the buffers.
+* param: in compressed bytes.
+* param: n size of the compressed data.
+* param: out output buffer.
+* param: size size of the decompressed data.
+*
+* returns: 1 on success or 0 if the data is corrupt or its decompressed size is not the given one.
+*/
+int decompress_codec(const void* in, size_t n, void* out, size_t size);
+
+/*
+* Shuffles the bytes of an array of elements: byte b of element i goes to position b*count + i.
+* param: in input array.
+* param: count number of elements.
+* param: width size of each element in bytes.
+* param: out output array, different from the input one.
+*/
+void shuffle_codec(const void* in, size_t count, size_t width, void* out);
+
+/*
+* Undoes shuffle_codec.
+* param: in shuffled array.
+* param: count number of elements.
+* param: width size of each element in bytes.
+* param: out output array, different from the input one.
+*/
+void unshuffle_codec(const void* in, size_t count, size_t width, void* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -66,6 +66,7 @@ Diagonalization* clone_diagonalization(const Diagonalization* diag);
 
 /*
 * Performs the diagonalization of the matrix passed as parameter.
+* Repeated eigenvalues are allowed, but a defective matrix ( lacking independent eigenvectors ) cannot be diagonalized.
 * param: m
 * A square matrix to diagonalize.
 *
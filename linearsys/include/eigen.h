@@ -92,7 +92,7 @@ void print_eigen(const Eigen* eigen);
 EigenSystem* create_eigensystem(int size);
 
 /*
-* Destroys an EigenSystem.
+* Destroys an EigenSystem and all its Eigens.
 * param: eigsys An EigenSystem to destroy.
 *
 */
@@ -116,6 +116,9 @@ void print_eigensystem(const EigenSystem* eigsys);
 
 /*
 * Computes the maximum Eigen from a square matrix using the Power Method.
+* It stops when the residual |m*x - value*x| is below 1E-10 times the norm of m;
+* the eigenvector is scaled so that its largest component is 1.
+* See subspace_iteration to compute several eigenpairs of a symmetric matrix at once.
 * param: const Matrix* m A square matrix to compute its maximum eigen.
 *
 * returns: Maximum eigen or NULL if the operation cannot be done.
@@ -123,8 +126,30 @@ void print_eigensystem(const EigenSystem* eigsys);
 */
 Eigen* max_eigen_power_method(const Matrix* m);
 
+/*
+* Computes the p eigenpairs of largest magnitude of a symmetric matrix using block subspace iteration.
+* A block of p vectors ( plus a few guard vectors ) is multiplied by the matrix on each step,
+* followed by a Rayleigh-Ritz projection which gives the eigenpair approximations.
+* Optionally, a Chebyshev polynomial filter is applied instead of a single product,
+* which damps the unwanted eigenvalues much faster than the powers of the matrix.
+* All the workspace is allocated once, so the iterations do not allocate memory.
+* param: m a symmetric matrix.
+* param: p number of eigenpairs to compute.
+* param: tolerance relative tolerance for the residual |m*x - value*x| ( related to the norm of m ); use 0 for a default value.
+* param: max_iterations maximum number of iterations; use 0 for a default value.
+* param: degree degree of the Chebyshev filter; use 0 or 1 for plain subspace iteration.
+*
+* returns: EigenSystem with p eigenpairs sorted by decreasing magnitude ( normalized eigenvectors ),
+* or NULL if the operation cannot be done or it does not converge.
+*
+*/
+EigenSystem* subspace_iteration(const Matrix* m, int p, double tolerance, int max_iterations, int degree);
+
 /*
 * computes the EigenSystem for a square matrix using QR algorithm.
+* Each eigenvector is recovered by inverse iteration shifted by its eigenvalue,
+* which also refines the eigenvalue; eigenvectors are normalized.
+* The eigenvectors of a repeated eigenvalue are made orthogonal to each other.
 * param: m a square matrix.
 *
 * returns: EigenSystem for the matrix passed as parameter.
@@ -132,6 +157,52 @@ Eigen* max_eigen_power_method(const Matrix* m);
 */
 EigenSystem* eigen_system(const Matrix* m);
 
+/*
+* Computes the eigenpair whose eigenvalue is the closest to a given shift using inverse iteration.
+* The matrix m - shift*I is factorized once with lu_decomposition
+* and every step solves a linear system with that factorization.
+* Convergence is linear, faster as the shift gets closer to the eigenvalue.
+* param: m a square matrix.
+* param: shift target value.
+* param: tolerance relative tolerance for the residual |m*x - value*x| ( related to the norm of m ); use 0 for a default value.
+* param: max_iterations maximum number of iterations; use 0 for a default value.
+*
+* returns: Eigen closest to shift with a normalized eigenvector, or NULL if it does not converge.
+*
+*/
+Eigen* inverse_iteration(const Matrix* m, double shift, double tolerance, int max_iterations);
+
+/*
+* Computes an eigenpair using Rayleigh quotient iteration.
+* It works as inverse iteration but the shift is updated with the Rayleigh quotient on every step,
+* so the matrix is factorized on every step and convergence is cubic for symmetric matrices
+* ( quadratic otherwise ).
+* The eigenpair found is the one the start vector is closest to; when there is no start vector
+* a couple of inverse iteration steps with the given shift build one, so the eigenvalue closest to shift is usually found.
+* param: m a square matrix.
+* param: start initial approximation to the eigenvector, or NULL.
+* param: shift initial approximation to the eigenvalue.
+* param: tolerance relative tolerance for the residual |m*x - value*x| ( related to the norm of m ); use 0 for a default value.
+* param: max_iterations maximum number of iterations; use 0 for a default value.
+*
+* returns: Eigen with a normalized eigenvector, or NULL if it does not converge.
+*
+*/
+Eigen* rayleigh_quotient_iteration(const Matrix* m, const Vector* start, double shift, double tolerance, int max_iterations);
+
+/*
+* Computes the EigenSystem for a symmetric matrix using the Jacobi eigenvalue algorithm.
+* Rotations are applied until all the off diagonal entries vanish,
+* so the eigenvalues are accurate to working precision and the eigenvectors are orthonormal.
+* It is intended for small and medium sized matrices.
+* param: m a symmetric matrix; only its upper triangle is referenced.
+*
+* returns: EigenSystem for the matrix passed as parameter with the eigenvalues in decreasing order,
+* or NULL if the operation cannot be done.
+*
+*/
+EigenSystem* symmetric_eigen_system(const Matrix* m);
+
 
   /*
   * Macros to access an Eigen structure.
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___INSTRUMENT_H___
+#define ___INSTRUMENT_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+
+/*
+* This header counts how the library is used: calls, time and floating point operations of its main routines,
+* iterations of the iterative ones, and the memory held by matrices and vectors.
+* The counters are only compiled when the library is built with the LINEARSYS_INSTRUMENT macro defined
+* ( for instance, adding -DLINEARSYS_INSTRUMENT to FLAGS in the Makefile ); otherwise the routines
+* have no extra code and a snapshot has all the counters at zero.
+* The counters are updated with atomic operations, so they can be read while other threads use the library.
+* The time of a routine includes the time of the routines it calls, which are counted too.
+* On Linux, the hardware counters of the processor ( cycles, instructions, cache misses ) can be added
+* to the routines through perf_event_open, see enable_hardware_instrument below.
+* Calls rejected because of their arguments are not counted; calls which fail later ( a singular matrix, for instance ) are.
+*/
+
+/*
+* Instrumented routines.
+*/
+#define INSTRUMENT_MUL_MATRIX 0
+#define INSTRUMENT_GEMM_MATRIX 1
+#define INSTRUMENT_ADD_MATRIX 2
+#define INSTRUMENT_SUB_MATRIX 3
+#define INSTRUMENT_SCALE_MATRIX 4
+#define INSTRUMENT_TRANSPOSE_MATRIX 5
+#define INSTRUMENT_INVERSE_MATRIX 6
+#define INSTRUMENT_PSEUDOINVERSE_MATRIX 7
+#define INSTRUMENT_RANK_MATRIX 8
+#define INSTRUMENT_SMCRAMER_SYSTEM_SOLVER 9
+#define INSTRUMENT_MVCRAMER_SYSTEM_SOLVER 10
+#define INSTRUMENT_SMGAUSS_SYSTEM_SOLVER 11
+#define INSTRUMENT_MVGAUSS_SYSTEM_SOLVER 12
+#define INSTRUMENT_LU_SYSTEM_SOLVER 13
+#define INSTRUMENT_QR_SYSTEM_SOLVER 14
+#define INSTRUMENT_LU_DECOMPOSITION 15
+#define INSTRUMENT_QR_FACTORIZATION 16
+#define INSTRUMENT_MAX_EIGEN_POWER_METHOD 17
+#define INSTRUMENT_SUBSPACE_ITERATION 18
+#define INSTRUMENT_EIGEN_SYSTEM 19
+#define INSTRUMENT_INVERSE_ITERATION 20
+#define INSTRUMENT_RAYLEIGH_QUOTIENT_ITERATION 21
+#define INSTRUMENT_SYMMETRIC_EIGEN_SYSTEM 22
+#define INSTRUMENT_SVD_FACTORIZATION 23
+#define INSTRUMENT_RANDOMIZED_SVD 24
+#define INSTRUMENT_PCA_FACTORIZATION 25
+#define INSTRUMENT_LANCZOS_EIGEN 26
+#define INSTRUMENT_ARNOLDI_EIGEN 27
+#define INSTRUMENT_DIAGONALIZE_MATRIX 28
+#define INSTRUMENT_MUL_SPARSE_MATRIX_VECTOR 29
+#define INSTRUMENT_LU_TASK_GRAPH 30
+#define INSTRUMENT_CHOLESKY_TASK_GRAPH 31
+#define INSTRUMENT_QR_TASK_GRAPH 32
+#define INSTRUMENT_ROUTINES 33
+
+/*
+* Formats to dump a snapshot.
+*/
+#define INSTRUMENT_TEXT 0
+#define INSTRUMENT_JSON 1
+
+/*
+* Hardware events: cycles, instructions, L1 data cache read misses, last level cache misses and floating point operations.
+* There is no generic event for floating point operations, so that one is only counted when the LINEARSYS_FP_EVENT
+* environment variable has the raw event code of the processor ( for instance, 0x01c7 on recent Intel processors ).
+*/
+#define HARDWARE_CYCLES 0
+#define HARDWARE_INSTRUCTIONS 1
+#define HARDWARE_L1_MISSES 2
+#define HARDWARE_LLC_MISSES 3
+#define HARDWARE_FP_OPS 4
+#define HARDWARE_EVENTS 5
+
+/*
+* InstrumentCounter type definition: the counters of a routine.
+*/
+typedef struct
+{
+unsigned long long _calls;
+unsigned long long _time; /* total time of the calls in nanoseconds */
+unsigned long long _max_time; /* time of the longest call in nanoseconds */
+unsigned long long _flops; /* estimated floating point operations */
+unsigned long long _iterations; /* iterations ( or sweeps, or restarts ) of an iterative routine */
+unsigned long long _measured; /* calls measured with the hardware counters */
+unsigned long long _hardware[HARDWARE_EVENTS]; /* hardware events of the measured calls */
+}InstrumentCounter;
+
+/*
+* InstrumentSnapshot type definition: a copy of all the counters.
+*/
+typedef struct
+{
+int _enabled; /* nonzero if the library was built with LINEARSYS_INSTRUMENT */
+InstrumentCounter _counter[INSTRUMENT_ROUTINES];
+unsigned long long _bytes_allocated; /* bytes of the entries of the matrices and vectors created */
+unsigned long long _bytes_freed; /* bytes of the entries of the matrices and vectors destroyed */
+long long _live_matrices; /* matrices created and not destroyed yet */
+long long _peak_matrices; /* maximum number of live matrices */
+int _hardware; /* bit mask ( 1 << HARDWARE_ event ) of the hardware events counted by some thread */
+}InstrumentSnapshot;
+
+/*
+* InstrumentStart type definition: the clock and the hardware counters at the start of a call.
+*/
+typedef struct
+{
+unsigned long long _time;
+unsigned long long _hardware[HARDWARE_EVENTS];
+int _events; /* bit mask of the hardware events read, 0 if none */
+}InstrumentStart;
+
+/*
+* Gets the name of an instrumented routine.
+* param: routine one of the INSTRUMENT_ constants above.
+*
+* returns: the name of the routine, or NULL if routine is not valid.
+*/
+const char* name_instrument(int routine);
+
+/*
+* Copies the current value of the counters.
+* param: s an InstrumentSnapshot to fill.
+*/
+void snapshot_instrument(InstrumentSnapshot* s);
+
+/*
+* Turns on or off the hardware counters of the instrumented routines.
+* They are read with perf_event_open on Linux, once per thread, so they count the work of the calling thread only:
+* the work a routine gives to the threads of the pool is not included ( set LINEARSYS_THREADS=1 to count it all ).
+* Reading the counters takes a system call at the start and at the end of each call, so they are off by default.
+* When the counters cannot be opened ( other systems, no permission, no performance monitoring unit in a virtual machine )
+* the routines are timed as usual.
+* param: enable nonzero to turn the counters on, 0 to turn them off.
+*
+* returns: bit mask ( 1 << HARDWARE_ event ) of the events which can be counted in the calling thread,
+* 0 if there are none or the library was built without LINEARSYS_INSTRUMENT.
+*/
+int enable_hardware_instrument(int enable);
+
+/*
+* Gets the name of a hardware event.
+* param: event one of the HARDWARE_ constants above.
+*
+* returns: the name of the event, or NULL if event is not valid.
+*/
+const char* name_hardware_instrument(int event);
+
+/*
+* Sets all the counters to zero; the number of live matrices is kept.
+*/
+void reset_instrument(void);
+
+/*
+* Writes a snapshot as a text table or in JSON format.
+* Routines which were not called are not written in the text table.
+* param: s an InstrumentSnapshot.
+* param: filename name of the file to write, NULL for the standard output.
+* param: format INSTRUMENT_TEXT or INSTRUMENT_JSON.
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int dump_instrument(const InstrumentSnapshot* s, const char* filename, int format);
+
+/*
+* Functions used by the library to update the counters, through the macros below.
+*/
+unsigned long long clock_instrument(void);
+InstrumentStart begin_instrument(void);
+void record_instrument(int routine, const InstrumentStart* start, double flops);
+void iterations_instrument(int routine, unsigned long long count);
+void allocate_instrument(int matrix, size_t bytes);
+void free_instrument(int matrix, size_t bytes);
+
+/*
+* Macros to instrument a routine: INSTRUMENT_BEGIN is a declaration starting the clock ( and the hardware counters ),
+* INSTRUMENT_END counts a call of the routine with its time and floating point operations.
+* When the counters are not compiled, INSTRUMENT_ITERATIONS only evaluates its count ( no code is generated for it ),
+* so that variables kept for the counters are not reported as unused.
+*/
+#ifdef LINEARSYS_INSTRUMENT
+#define INSTRUMENT_BEGIN InstrumentStart __instrument_start_ = begin_instrument()
+#define INSTRUMENT_END(routine, flops) record_instrument(routine, &__instrument_start_, flops)
+#define INSTRUMENT_ITERATIONS(routine, count) iterations_instrument(routine, count)
+#define INSTRUMENT_ALLOCATE(matrix, bytes) allocate_instrument(matrix, bytes)
+#define INSTRUMENT_FREE(matrix, bytes) free_instrument(matrix, bytes)
+#else
+#define INSTRUMENT_BEGIN
+#define INSTRUMENT_END(routine, flops)
+#define INSTRUMENT_ITERATIONS(routine, count) ((void)(count))
+#define INSTRUMENT_ALLOCATE(matrix, bytes)
+#define INSTRUMENT_FREE(matrix, bytes)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___KERNEL_H___
+#define ___KERNEL_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+/*
+* This header has the low level kernels used by the library algorithms.
+* Kernels work on raw row major arrays of doubles, so they can operate on a whole Matrix
+* or on a block inside a bigger one.
+* The leading dimension ( ld ) of an array is the distance, in doubles, between two consecutive rows.
+*/
+
+/*
+* Constants to ask a kernel for an operand as it is or transposed.
+*/
+#define KERNEL_NO_TRANS 0
+#define KERNEL_TRANS 1
+
+/*
+* General matrix product.
+* Computes C = alpha*op(A)*op(B) + beta*C
+* where op(X) is X or X^t depending on the transa and transb parameters.
+* Its block sizes come from tuning.h, and products bigger than the parallel threshold there
+* are split in blocks of rows of C run by the threads of the default ThreadPool.
+* param: transa KERNEL_NO_TRANS or KERNEL_TRANS for A.
+* param: transb KERNEL_NO_TRANS or KERNEL_TRANS for B.
+* param: m number of rows of op(A) and C.
+* param: n number of columns of op(B) and C.
+* param: k number of columns of op(A) and rows of op(B).
+* param: alpha scalar to scale op(A)*op(B).
+* param: a array holding A.
+* param: lda leading dimension of A.
+* param: b array holding B.
+* param: ldb leading dimension of B.
+* param: beta scalar to scale C; if it is zero, C is not read.
+* param: c array holding C.
+* param: ldc leading dimension of C.
+*
+*/
+void kernel_gemm(int transa, int transb, int m, int n, int k, double alpha,
+const double* a, int lda, const double* b, int ldb, double beta, double* c, int ldc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___KRYLOV_H___
+#define ___KRYLOV_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "matrix.h"
+#include "sparse.h"
+#include "eigen.h"
+#include "rng.h"
+
+/*
+* This header has Krylov subspace solvers to compute a few eigenpairs of a big square matrix.
+* The matrix is only used through matrix vector products,
+* so it can be a dense Matrix, a SparseMatrix or any user function computing y = A*x.
+*/
+
+/*
+* Function type for a linear operator.
+* It must compute y = A*x where x and y are arrays of size n.
+* param: x input array.
+* param: y output array.
+* param: context user data passed when the operator was created.
+*/
+typedef void (*OperatorFunction)(const double* x, double* y, void* context);
+
+/*
+* LinearOperator type definition.
+*/
+typedef struct
+{
+int _size; /* order n of the operator */
+OperatorFunction _apply; /* function computing y = A*x */
+void* _context; /* user data for the function */
+}LinearOperator;
+
+/*
+* Criteria to choose which eigenpairs are wanted.
+*/
+#define EIGEN_LARGEST 0 /* algebraically largest ( largest real part ) */
+#define EIGEN_SMALLEST 1 /* algebraically smallest ( smallest real part ) */
+#define EIGEN_LARGEST_MAGNITUDE 2 /* largest absolute value */
+#define EIGEN_CLOSEST 3 /* closest to a given shift */
+
+/*
+* Creates a LinearOperator from a user function.
+* param: size order of the operator.
+* param: apply function computing y = A*x.
+* param: context user data passed to the function.
+*
+* returns: A pointer to the newly created LinearOperator or NULL if the operation cannot be done.
+*/
+LinearOperator* create_linear_operator(int size, OperatorFunction apply, void* context);
+
+/*
+* Creates a LinearOperator computing products with a square Matrix.
+* The Matrix is not copied, so it must not be destroyed while the operator is in use.
+* param: m a square Matrix.
+*
+* returns: A LinearOperator or NULL if the operation cannot be done.
+*/
+LinearOperator* matrix_linear_operator(const Matrix* m);
+
+/*
+* Creates a LinearOperator computing products with a square SparseMatrix.
+* The SparseMatrix is not copied, so it must not be destroyed while the operator is in use.
+* param: s a square SparseMatrix.
+*
+* returns: A LinearOperator or NULL if the operation cannot be done.
+*/
+LinearOperator* sparse_linear_operator(const SparseMatrix* s);
+
+/*
+* Destroys a LinearOperator.
+* param: op LinearOperator to destroy.
+*/
+void destroy_linear_operator(LinearOperator* op);
+
+/*
+* Computes k eigenpairs of a symmetric operator using the thick restarted Lanczos method.
+* Each cycle extends an orthonormal basis up to ncv vectors; then the wanted Ritz vectors
+* ( and a few more ) are kept and the basis is extended again from them.
+* Ritz pairs which have converged are locked, that is, they are decoupled from the rest of the basis.
+* Eigenvalues at the ends of the spectrum converge fast; EIGEN_CLOSEST with a shift inside a dense part of
+* the spectrum may need many restarts, an operator computing ( A - shift*I )^-1 * x works better in that case.
+* param: op a symmetric LinearOperator.
+* param: k number of eigenpairs to compute.
+* param: which EIGEN_LARGEST, EIGEN_SMALLEST, EIGEN_LARGEST_MAGNITUDE or EIGEN_CLOSEST.
+* param: shift target for EIGEN_CLOSEST, ignored otherwise.
+* param: ncv maximum size of the basis, it must be greater than k+1; use 0 for a default value.
+* param: tolerance relative tolerance for the residual of each eigenpair; use 0 for a default value.
+* param: max_restarts maximum number of restarts; use 0 for a default value.
+* param: rng Random generator for the start vector; NULL uses DEFAULT_SEED.
+*
+* returns: EigenSystem with the k wanted eigenpairs sorted by the criterion ( normalized eigenvectors ),
+* or NULL if the operation cannot be done or it does not converge.
+*/
+EigenSystem* lanczos_eigen(const LinearOperator* op, int k, int which, double shift, int ncv, double tolerance, int max_restarts, Random* rng);
+
+/*
+* Computes k eigenpairs of a nonsymmetric operator using the thick restarted Arnoldi method.
+* It works as lanczos_eigen but the projected matrix is a general one.
+* Since an Eigen has a real eigenvalue, only the real eigenpairs among the k wanted ones are returned;
+* complex conjugate pairs are used internally but they are not reported.
+* param: op a LinearOperator.
+* param: k number of eigenpairs to compute.
+* param: which EIGEN_LARGEST, EIGEN_SMALLEST, EIGEN_LARGEST_MAGNITUDE or EIGEN_CLOSEST.
+* param: shift target for EIGEN_CLOSEST, ignored otherwise.
+* param: ncv maximum size of the basis, it must be greater than k+2; use 0 for a default value.
+* param: tolerance relative tolerance for the residual of each eigenpair; use 0 for a default value.
+* param: max_restarts maximum number of restarts; use 0 for a default value.
+* param: rng Random generator for the start vector; NULL uses DEFAULT_SEED.
+*
+* returns: EigenSystem with the real eigenpairs among the k wanted ones sorted by the criterion,
+* or NULL if the operation cannot be done or it does not converge.
+*/
+EigenSystem* arnoldi_eigen(const LinearOperator* op, int k, int which, double shift, int ncv, double tolerance, int max_restarts, Random* rng);
+
+/*
+* Macro to get the order of a LinearOperator.
+*/
+#define size_linear_operator(op) ((op)->_size)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
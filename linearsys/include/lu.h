@@ -45,9 +45,14 @@ void destroy_lu(LU* lu);
 
 /*
 * Performs a LU decomposition of the matrix passed as parameter
+* using Gaussian elimination with partial pivoting, so that P*m = L*U
+* where row i of P*m is row permutation[i] of m.
+* Matrices bigger than the LU block size of tuning.h are factorized by panels of that many columns,
+* updating the rest of the matrix with a matrix product.
 * param: const Matrix* m => a pointer to a square Matrix.
 * returns:
 * A pointer to a LU of the Matrix passed as parameter
+* or NULL if the matrix is not square or it is singular.
 */
 LU* lu_decomposition(const Matrix* m);
 
@@ -41,6 +41,7 @@ double* _data;
 
 /*
 * Creates a nnew Matrix with all his components initialized to zero.
+* Large matrices are initialized by the threads of the default ThreadPool, according to the NUMA policy ( numa.h ).
 * param: int r => number of rows.
 * param: int c => number of columns.
 *
@@ -58,6 +59,7 @@ void destroy_matrix(Matrix* m);
 
 /*
 * Makes a clone of the Matrix passed as parameter.
+* Large matrices are copied by the threads of the default ThreadPool, according to the NUMA policy ( numa.h ).
 * param: const Matrix* m => pointer to a Matrix to clone.
 *
 * returns:
@@ -86,16 +88,21 @@ Matrix* clone_matrix(const Matrix* m);
 * m => r-1
 * n => c-1
 *
+* The file is read in big blocks and parsed in memory ( in parallel for big files ).
+*
 * param: const char* filename => file where the Matrix is stored.
 *
 * returns:
-* A pointer to the loaded Matrix.
+* A pointer to the loaded Matrix or NULL if the file cannot be read
+* or holds less entries than r*c ( a truncated file or a text which is not a number ).
 */
 Matrix* load_matrix(const char* filename);
 
 /*
 * Stores a Matrix in a file.
 * The format of the Matrix is the same as explained in the above function.
+* Each value is written with the shortest text which reads back to exactly the same value,
+* so storing and loading a Matrix gives the same Matrix.
 *
 * param: const Matrix m => Pointer to a Matrix to store.
 * param: const char* filename => name of the file to store the Matrix.
@@ -217,6 +224,22 @@ Matrix* sub_matrix(const Matrix* m1, const Matrix* m2);
 */
 Matrix* mul_matrix(const Matrix* m1, const Matrix* m2);
 
+/*
+* General matrix product computed in place, without allocating any memory.
+* Computes c = alpha*op(a)*op(b) + beta*c
+* where op(x) is x or its transpose depending on the transa and transb flags.
+* param: alpha scalar to scale op(a)*op(b).
+* param: a a Matrix.
+* param: transa 0 to use a as it is or 1 to use its transpose.
+* param: b a Matrix.
+* param: transb 0 to use b as it is or 1 to use its transpose.
+* param: beta scalar to scale c; if it is zero, the previous content of c is ignored.
+* param: c a Matrix with as many rows as op(a) and as many columns as op(b) to hold the result.
+*
+* returns: 1 if the product was computed or 0 if the dimensions do not agree.
+*/
+int gemm_matrix(double alpha, const Matrix* a, int transa, const Matrix* b, int transb, double beta, Matrix* c);
+
 /*
 * Scales a matrix by a scalar passed as second parameter.
 * param: const Matrix* m A matrix to be scaled.
@@ -275,7 +298,7 @@ Matrix* diag_matrix(const Matrix* m);
 * param: const Matrix* m => a pointer to a square matrix.
 *
 * returns:
-* inverse matrix.
+* inverse matrix, or NULL if the matrix is not square or it is singular.
 */
 Matrix* inverse_matrix(const Matrix* m);
 
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___MMIO_H___
+#define ___MMIO_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "sparse.h"
+
+/*
+* This header reads and writes sparse matrices in the Matrix Market exchange format ( .mtx files ).
+* A file starts with a banner line:
+* %%MatrixMarket matrix coordinate real general
+* followed by comment lines starting with %, a line with the number of rows, columns and entries,
+* and one line per entry with its row, its column ( both starting at 1 ) and its value.
+* The field can be real, integer or pattern ( no values, every entry is 1 )
+* and the symmetry general, symmetric or skew-symmetric ( only the lower triangle is stored ).
+* Complex matrices and the dense array format are not supported.
+*/
+
+/*
+* Loads a SparseMatrix from a Matrix Market file.
+* The entries are parsed in parallel ( see parse_doubles ); duplicated entries are added together.
+* param: filename name of the file.
+*
+* returns: A pointer to the loaded SparseMatrix or NULL if the file cannot be read or it is not valid.
+*/
+SparseMatrix* load_sparse_matrix_market(const char* filename);
+
+/*
+* Stores a SparseMatrix in a Matrix Market file as a real general coordinate matrix.
+* Values are written with the shortest text which reads back to the same double ( see format_double ).
+* param: s SparseMatrix to store.
+* param: filename name of the file.
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int store_sparse_matrix_market(const SparseMatrix* s, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
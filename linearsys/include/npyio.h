@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___NPYIO_H___
+#define ___NPYIO_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "matrix.h"
+#include "vector.h"
+
+/*
+* This header reads and writes the NumPy array format ( .npy files, versions 1, 2 and 3 ).
+* Arrays of float64, float32, int64 and int32 with any byte order and in C or Fortran order are read
+* and converted to doubles; a one dimensional array is read as a Matrix with one column.
+* Files are written as C ordered float64 arrays with the host byte order.
+*/
+
+/*
+* Loads a Matrix from a .npy file holding a one or two dimensional array.
+* param: filename name of the file.
+*
+* returns: A pointer to the loaded Matrix or NULL if the file cannot be read or the array is not supported.
+*/
+Matrix* load_matrix_npy(const char* filename);
+
+/*
+* Maps a .npy file into memory and returns a read only Matrix using its entries in place, with no copy.
+* Only C ordered float64 arrays with the host byte order can be mapped;
+* for any other array NULL is returned and load_matrix_npy must be used instead.
+* The Matrix must be released with unmap_matrix ( see binio.h ), never with destroy_matrix.
+* param: filename name of the file.
+*
+* returns: A read only Matrix or NULL if the file cannot be mapped.
+*/
+const Matrix* map_matrix_npy(const char* filename);
+
+/*
+* Stores a Matrix in a .npy file as a two dimensional array.
+* param: m Matrix to store.
+* param: filename name of the file.
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int store_matrix_npy(const Matrix* m, const char* filename);
+
+/*
+* Loads a Vector from a .npy file holding a one dimensional array,
+* or a two dimensional array having a single row or column.
+* param: filename name of the file.
+*
+* returns: A pointer to the loaded Vector or NULL if the file cannot be read or the array is not supported.
+*/
+Vector* load_vector_npy(const char* filename);
+
+/*
+* Stores a Vector in a .npy file as a one dimensional array.
+* param: v Vector to store.
+* param: filename name of the file.
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int store_vector_npy(const Vector* v, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
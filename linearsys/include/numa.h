@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___NUMA_H___
+#define ___NUMA_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+
+/*
+* This header has the NUMA policies of the library, for computers with several memory nodes ( sockets ),
+* where a thread reads the memory of another node at a fraction of the bandwidth of its own.
+* The operating system places each page of memory on the node of the thread which touches it first,
+* so the entries of large matrices are initialized by the threads of the default ThreadPool,
+* each one its own block of rows ( first touch ); the thread running rows of the same block later,
+* for instance the tasks of a TaskGraph writing its tiles, then finds them on its own node.
+* Alternatively the pages of large matrices can be interleaved among all the nodes,
+* which spreads the traffic when every thread reads the whole matrix.
+* The threads of a ThreadPool can be pinned to cores ( see pin_threadpool in threadpool.h ),
+* filling the cores of a node before going to the next one, so that the blocks of rows of
+* consecutive threads are on the same node.
+* The policy is read from the LINEARSYS_NUMA environment variable ( first_touch, interleave or off ) on first use.
+*/
+
+/*
+* NUMA policies.
+*/
+#define NUMA_FIRST_TOUCH 0 /* large matrices are initialized in parallel, each block of rows by its own thread */
+#define NUMA_INTERLEAVE 1 /* as NUMA_FIRST_TOUCH, and the pages of large matrices are spread round robin among the nodes */
+#define NUMA_OFF 2 /* matrices are initialized by the calling thread */
+
+#define NUMA_PARALLEL_SIZE 4194304 /* bytes of a matrix from which the policy applies */
+#define NUMA_MAX_NODES 64
+
+/*
+* Gets the number of memory nodes of the computer.
+*
+* returns: the number of online nodes, 1 if they are not known.
+*/
+int nodes_numa(void);
+
+/*
+* Gets the processors in which the threads of a ThreadPool are pinned, those of the first node first.
+* Only the processors the process is allowed to run on are given.
+* param: cpus array to fill, or NULL.
+* param: count size of the array.
+*
+* returns: the number of processors ( it can be bigger than count ), 0 if they are not known.
+*/
+int cpus_numa(int* cpus, int count);
+
+/*
+* Sets the NUMA policy.
+* It should not be called while other threads are creating matrices.
+* param: policy NUMA_FIRST_TOUCH, NUMA_INTERLEAVE or NUMA_OFF.
+*/
+void set_numa_policy(int policy);
+
+/*
+* Gets the NUMA policy.
+*
+* returns: the NUMA policy.
+*/
+int get_numa_policy(void);
+
+/*
+* Gets the thread which initializes a row of a matrix: thread i initializes the rows r with i = r * threads / rows.
+* param: row index of the row.
+* param: rows rows of the matrix.
+* param: threads number of threads.
+*
+* returns: index of the thread, from 0 to threads-1.
+*/
+int owner_numa(int row, int rows, int threads);
+
+/*
+* Initializes the entries of a newly allocated matrix, which must not have been written yet,
+* according to the NUMA policy.
+* param: data entries of the matrix, rows x columns.
+* param: source entries to copy, or NULL to set them to zero.
+* param: rows rows of the matrix.
+* param: columns columns of the matrix.
+*/
+void initialize_numa(double* data, const double* source, int rows, int columns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
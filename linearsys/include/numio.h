@@ -26,6 +26,7 @@ extern "C" {
 	#endif
 
 #include <stdio.h>
+#include <stddef.h>
 
 /*
 * Basic helper functions to read and write int and double values from and to a file.
@@ -70,11 +71,115 @@ void fread_double(FILE* pf, double* value);
 
 /*
 * Write a double value to a file.
+* The value is written with the shortest text that reads back to the same value ( see format_double ).
 * param: FILE* pf => pointer to a file.
 * param: double value => value to write.
 */
 void fwrite_double(FILE* pf, double value);
 
+/*
+* Size of a buffer big enough for any text made by format_double.
+*/
+#define FORMAT_DOUBLE_SIZE 32
+
+/*
+* Formats a double value with the shortest decimal text which parses back to exactly the same value,
+* using the Grisu3 algorithm; the few numbers for which it cannot prove its digits are the shortest ( about 0.5% )
+* are formatted with the C library instead, trying 1 to 17 significant digits.
+* Numbers from 1E-6 to 1E21 are written in plain decimal notation ( 0.001234, 1500, 3.25 ),
+* other ones in exponential notation ( 1.5e-7, 6.02e23 ); infinities and NaN are written as inf, -inf and nan.
+* param: value value to format.
+* param: buffer array of at least FORMAT_DOUBLE_SIZE characters.
+*
+* returns: number of characters written, not counting the terminating '\0'.
+*/
+int format_double(double value, char* buffer);
+
+/*
+* TextOutput type definition.
+* A TextOutput collects text in a big buffer which is written to its file in one call when it is full,
+* so that writing many numbers costs few system calls.
+*/
+typedef struct
+{
+FILE* _file;
+char* _buffer;
+size_t _length; /* characters in the buffer */
+int _error; /* nonzero if a write failed */
+}TextOutput;
+
+/*
+* Opens a file to write text through a TextOutput.
+* param: filename name of the file.
+*
+* returns: A pointer to the newly created TextOutput or NULL if the file cannot be opened.
+*/
+TextOutput* open_text_output(const char* filename);
+
+/*
+* Writes a double value ( see format_double ) to a TextOutput.
+* param: out a TextOutput.
+* param: value value to write.
+*/
+void write_text_double(TextOutput* out, double value);
+
+/*
+* Writes an int value to a TextOutput.
+* param: out a TextOutput.
+* param: value value to write.
+*/
+void write_text_int(TextOutput* out, int value);
+
+/*
+* Writes a character to a TextOutput.
+* param: out a TextOutput.
+* param: c character to write.
+*/
+void write_text_char(TextOutput* out, char c);
+
+/*
+* Writes the pending text, closes the file and destroys a TextOutput.
+* param: out a TextOutput.
+*
+* returns: 1 if all the text was written or 0 if some write failed.
+*/
+int close_text_output(TextOutput* out);
+
+/*
+* Reads a whole file into memory.
+* The file is read in big blocks and the text is terminated with a '\0'.
+* param: filename name of the file.
+* param: length if not NULL, gets the number of bytes read.
+*
+* returns: A buffer with the contents of the file ( release it with release_memory, see allocator.h ) or NULL if the file cannot be read.
+*/
+char* read_text_file(const char* filename, size_t* length);
+
+/*
+* Parses a double value, as strtod does.
+* Decimal numbers with up to 19 significant digits and small exponents, which are the usual case,
+* are converted exactly with a single floating point operation ( Clinger's fast path );
+* any other text is passed to strtod, so the result is always correctly rounded.
+* param: s text to parse; leading white space is skipped.
+* param: end if not NULL, gets a pointer to the character following the number ( s if there is no number ).
+*
+* returns: parsed value, or 0.0 if there is no number.
+*/
+double parse_double(const char* s, char** end);
+
+/*
+* Parses up to count white space separated double values from a text.
+* Texts longer than the parse threshold of tuning.h are split on line boundaries and parsed in parallel with the default ThreadPool.
+* Parsing stops at the first text which is not a number; the values after it are set to zero.
+* param: text text to parse.
+* param: length number of characters in the text ( the text must be followed by a '\0' ).
+* param: values array to store the values.
+* param: count maximum number of values to parse.
+*
+* returns: number of values parsed.
+*/
+int parse_doubles(const char* text, size_t length, double* values, int count);
+
 #ifdef __cplusplus
 }
 #endif
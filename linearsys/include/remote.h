@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___REMOTE_H___
+#define ___REMOTE_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+#include "matrix.h"
+#include "vector.h"
+
+/*
+* This header has the client of the solver daemon ( the daemon folder ), which keeps the LU decompositions
+* of the matrices the processes of a computer solve against, so that each matrix is factorized once.
+* A client passes its matrix to the daemon, which looks it up by a hash of its contents and compares the entries
+* with those of the matrix it keeps, so a matrix with the same hash never gets the factorization of another one;
+* the matrix is factorized only when the daemon does not have it yet. The daemon answers with an id which
+* names that factorization while it is kept, and the systems are solved with the id.
+* The client talks to the daemon through a Unix domain socket, which only carries short messages;
+* the matrices, the right hand sides and the solutions go through a block of shared memory of the client,
+* which the daemon reads and writes with pread and pwrite, so they are not copied through the socket
+* and a client shrinking its memory only gets errors.
+* Only POSIX systems are supported; on other systems connect_remote returns NULL.
+*/
+
+#define REMOTE_SOCKET "/tmp/linearsys.sock" /* default socket of the daemon */
+
+/*
+* Commands of the requests to the daemon.
+*/
+#define REMOTE_ATTACH 1 /* keeps the shared memory of the client, sent with the message, of size bytes */
+#define REMOTE_LOOKUP 2 /* looks for the factorization of the order x order matrix in the shared memory */
+#define REMOTE_FACTORIZE 3 /* factorizes the order x order matrix in the shared memory and keeps it */
+#define REMOTE_SOLVE 4 /* solves count right hand sides in the shared memory with the factorization id, writing the solutions over them */
+
+/*
+* Status of the replies of the daemon.
+*/
+#define REMOTE_OK 0
+#define REMOTE_MISSING 1 /* the daemon does not have the factorization ( it was never made or it was dropped ) */
+#define REMOTE_SINGULAR 2 /* the matrix cannot be factorized */
+#define REMOTE_ERROR 3 /* wrong request or no memory */
+
+/*
+* RemoteRequest type definition: a message to the daemon.
+*/
+typedef struct
+{
+int _command;
+int _order; /* order of the matrix */
+int _count; /* right hand sides */
+unsigned long long _id; /* factorization to solve with */
+unsigned long long _size; /* bytes of the shared memory */
+}RemoteRequest;
+
+/*
+* RemoteReply type definition: the answer of the daemon to a request.
+*/
+typedef struct
+{
+int _status;
+unsigned long long _id; /* factorization found or made by REMOTE_LOOKUP and REMOTE_FACTORIZE */
+}RemoteReply;
+
+/*
+* RemoteSolver type declaration: a connection to the daemon.
+* Its fields are private, so it is only used through pointers. A connection can be used by several threads,
+* one request at a time.
+*/
+typedef struct RemoteSolver RemoteSolver;
+
+/*
+* RemoteLU type definition: a LU decomposition kept by the daemon.
+* The matrix is kept too, so that it is factorized again if the daemon drops the factorization.
+*/
+typedef struct
+{
+RemoteSolver* _solver;
+unsigned long long _id; /* id of the factorization in the daemon */
+Matrix* _matrix;
+}RemoteLU;
+
+/*
+* Sends a message through a socket, used by the daemon and the client.
+* param: socket a connected socket.
+* param: data message to send.
+* param: size bytes of the message.
+* param: fd file descriptor to pass to the other process with the message, or -1.
+*
+* returns: 1 on success or 0 if the message cannot be sent.
+*/
+int send_remote(int socket, const void* data, size_t size, int fd);
+
+/*
+* Receives a message from a socket, used by the daemon and the client.
+* param: socket a connected socket.
+* param: data buffer to fill.
+* param: size bytes of the message.
+* param: fd file descriptor passed with the message, -1 if none; NULL to close it if there is one.
+*
+* returns: 1 on success or 0 if the message cannot be received or the socket was closed.
+*/
+int receive_remote(int socket, void* data, size_t size, int* fd);
+
+/*
+* Gets the key of a matrix: a 64 bits hash ( FNV-1a ) of its dimensions and entries.
+* It is not a cryptographic hash, so the daemon only uses it to find the candidates and compares the entries.
+* param: m a Matrix.
+*
+* returns: the key of the matrix.
+*/
+unsigned long long key_remote(const Matrix* m);
+
+/*
+* Connects to the daemon.
+* param: path socket of the daemon, NULL for the LINEARSYS_SOCKET environment variable or REMOTE_SOCKET if it is not set.
+*
+* returns: A pointer to the newly created RemoteSolver or NULL if the daemon cannot be reached.
+*/
+RemoteSolver* connect_remote(const char* path);
+
+/*
+* Closes a connection to the daemon. The factorizations stay in the daemon for other clients.
+* param: r RemoteSolver to close.
+*/
+void disconnect_remote(RemoteSolver* r);
+
+/*
+* Gets the LU decomposition of a matrix from the daemon, which factorizes it when it does not have it.
+* The matrix is copied, so it can be destroyed after the call.
+* param: r a RemoteSolver.
+* param: m a square Matrix.
+*
+* returns: A pointer to the newly created RemoteLU or NULL if the matrix is singular, not square or the daemon fails.
+*/
+RemoteLU* remote_lu_decomposition(RemoteSolver* r, const Matrix* m);
+
+/*
+* Destroys a RemoteLU; the factorization stays in the daemon.
+* param: lu RemoteLU to destroy.
+*/
+void destroy_remote_lu(RemoteLU* lu);
+
+/*
+* Solves a system of linear equations with a LU decomposition kept by the daemon, as lu_system_solver does.
+* The daemon keeps the factorizations used last; if it dropped this one, the matrix is sent again
+* and the RemoteLU gets the id of the new factorization.
+* param: lu a RemoteLU.
+* param: v right hand side.
+*
+* returns: A pointer to a Vector with the solution of the system, or NULL if the sizes do not match or the daemon fails.
+*/
+Vector* remote_lu_system_solver(RemoteLU* lu, const Vector* v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
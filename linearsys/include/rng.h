@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___RNG_H___
+#define ___RNG_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+/*
+* This header has a random number generator for the randomized algorithms of the library.
+* Its whole state lives in a Random object owned by the caller, so there is no global state:
+* the same seed always gives the same sequence and different threads can use different objects safely.
+* The generator is xoshiro256** seeded through splitmix64.
+*/
+
+/*
+* Random type definition.
+*/
+typedef struct
+{
+unsigned long long _state[4];
+}Random;
+
+/*
+* Creates a Random generator.
+* param: seed any value, the same seed gives the same sequence.
+*
+* returns: A pointer to the newly created Random.
+*/
+Random* create_random(unsigned long long seed);
+
+/*
+* Creates a Random generator for one of several independent streams sharing a seed.
+* Stream i starts 2^128 numbers after stream i-1, so the streams never overlap in practice;
+* it is intended to give each thread its own generator with reproducible results.
+* param: seed any value.
+* param: stream stream index ( 0, 1, 2 ... ).
+*
+* returns: A pointer to the newly created Random or NULL if stream is negative.
+*/
+Random* stream_random(unsigned long long seed, int stream);
+
+/*
+* Destroys a Random generator.
+* param: r Random to destroy.
+*/
+void destroy_random(Random* r);
+
+/*
+* Makes a clone of a Random generator; the clone gives the same sequence as the original.
+* param: r Random to clone.
+*
+* returns: cloned Random.
+*/
+Random* clone_random(const Random* r);
+
+/*
+* Sets the state of a Random generator from a seed.
+* It can be used to initialize a Random declared on the stack.
+* param: r a Random.
+* param: seed any value.
+*/
+void seed_random(Random* r, unsigned long long seed);
+
+/*
+* Advances a Random generator 2^128 numbers, that is, moves it to the next stream.
+* param: r a Random.
+*/
+void jump_random(Random* r);
+
+/*
+* Gets the next 64 bits random integer.
+* param: r a Random.
+*
+* returns: an integer uniformly distributed in [0, 2^64).
+*/
+unsigned long long next_random(Random* r);
+
+/*
+* Gets a uniformly distributed random number.
+* param: r a Random.
+*
+* returns: a number in the open interval (0, 1).
+*/
+double uniform_random(Random* r);
+
+/*
+* Gets a normally distributed random number.
+* param: r a Random.
+*
+* returns: a number from a Gaussian distribution with mean 0 and variance 1.
+*/
+double gaussian_random(Random* r);
+
+/*
+* Seed used by the library when a function taking a Random gets NULL.
+*/
+#define DEFAULT_SEED 0x2545F4914F6CDD1DULL
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___SPARSE_H___
+#define ___SPARSE_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "matrix.h"
+#include "vector.h"
+
+/*
+* SparseMatrix type definition.
+* A sparse matrix stores only its nonzero entries in compressed sparse row ( CSR ) format:
+* the entries of row i are data[row_start[i]] .. data[row_start[i+1]-1]
+* and their columns are column_index[row_start[i]] .. column_index[row_start[i+1]-1]
+* sorted in increasing order.
+*/
+typedef struct
+{
+int _rows;
+int _columns;
+int _nonzeros; /* number of stored entries */
+int* _row_start; /* rows+1 offsets into column_index and data */
+int* _column_index; /* column of each stored entry */
+double* _data; /* value of each stored entry */
+}SparseMatrix;
+
+/*
+* Creates a SparseMatrix with room for a number of nonzero entries.
+* All the row offsets are set to zero, so the matrix is empty until it is filled.
+* param: rows number of rows.
+* param: columns number of columns.
+* param: nonzeros number of entries to store.
+*
+* returns: A pointer to the newly created SparseMatrix.
+*/
+SparseMatrix* create_sparse_matrix(int rows, int columns, int nonzeros);
+
+/*
+* Destroys a SparseMatrix.
+* param: s SparseMatrix to destroy.
+*/
+void destroy_sparse_matrix(SparseMatrix* s);
+
+/*
+* Builds a SparseMatrix from a list of ( row, column, value ) triplets.
+* The triplets can be given in any order and duplicated entries are added together.
+* param: rows number of rows.
+* param: columns number of columns.
+* param: count number of triplets.
+* param: row_index row of each triplet.
+* param: column_index column of each triplet.
+* param: values value of each triplet.
+*
+* returns: A SparseMatrix or NULL if any triplet is out of range.
+*/
+SparseMatrix* triplets_sparse_matrix(int rows, int columns, int count, const int* row_index, const int* column_index, const double* values);
+
+/*
+* Builds a SparseMatrix from the nonzero entries of a Matrix.
+* param: m a Matrix.
+*
+* returns: A SparseMatrix or NULL if the parameter is NULL.
+*/
+SparseMatrix* to_sparse_matrix(const Matrix* m);
+
+/*
+* Builds a Matrix from a SparseMatrix.
+* param: s a SparseMatrix.
+*
+* returns: A Matrix having the entries of s and zeros elsewhere, or NULL if the parameter is NULL.
+*/
+Matrix* to_dense_matrix(const SparseMatrix* s);
+
+/*
+* Gets a value from a SparseMatrix.
+* param: s a SparseMatrix.
+* param: i row index.
+* param: j column index.
+*
+* returns: value in s(i, j), zero if it is not stored or NaN if the indices are out of range.
+*/
+double get_sparse_matrix(const SparseMatrix* s, int i, int j);
+
+/*
+* Sparse matrix vector product.
+* param: s a SparseMatrix.
+* param: v a Vector having as many components as columns in s.
+*
+* returns: A Vector = s * v or NULL if the operation cannot be done.
+*/
+Vector* mul_sparse_matrix_vector(const SparseMatrix* s, const Vector* v);
+
+/*
+* Prints a SparseMatrix to the console, one stored entry per line:
+* (i, j) value
+*
+* param: s SparseMatrix to print.
+*/
+void print_sparse_matrix(const SparseMatrix* s);
+
+/*
+* Macros to get the number of rows, columns and stored entries of a SparseMatrix.
+*/
+#define rows_sparse_matrix(s) ((s)->_rows)
+#define columns_sparse_matrix(s) ((s)->_columns)
+#define nonzeros_sparse_matrix(s) ((s)->_nonzeros)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
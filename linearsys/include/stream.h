@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___STREAM_H___
+#define ___STREAM_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "matrix.h"
+
+/*
+* This header has streaming readers and writers for matrices which do not fit in memory.
+* The rows of a file are processed in blocks of a fixed size, so a reduction like a Gram matrix,
+* the column means or the normal equations of a least squares problem can be computed in a single pass
+* keeping only one block in memory.
+* Both the text format ( see store_matrix ) and the row major binary format ( see binio.h ) are supported.
+*/
+
+/*
+* RowReader type definition.
+* A RowReader reads the next block of rows on a background thread
+* while the caller works with the current one.
+*/
+typedef struct RowReader RowReader;
+
+/*
+* RowWriter type definition.
+*/
+typedef struct RowWriter RowWriter;
+
+/*
+* Opens a matrix file to read its rows in blocks.
+* The format is detected from the first bytes of the file.
+* The number of rows in the file is not limited by the size of a Matrix.
+* param: filename name of a text or row major binary matrix file, which can be compressed.
+* param: block_rows number of rows in each block.
+*
+* returns: A pointer to the newly created RowReader or NULL if the file cannot be read.
+*/
+RowReader* open_row_reader(const char* filename, int block_rows);
+
+/*
+* Reads the next block of rows.
+* The rows are copied at the top of the block, so after the last block some rows may be left unchanged.
+* param: r a RowReader.
+* param: block a Matrix having at least block_rows rows and as many columns as the file.
+*
+* returns: number of rows read, 0 at the end of the file or -1 if the file is corrupt or the block does not fit.
+*/
+int read_row_block(RowReader* r, Matrix* block);
+
+/*
+* Stops the read ahead, closes the file and destroys a RowReader.
+* param: r RowReader to close.
+*/
+void close_row_reader(RowReader* r);
+
+/*
+* Gets the number of rows of the file read by a RowReader.
+* param: r a RowReader.
+*
+* returns: number of rows.
+*/
+long long rows_row_reader(const RowReader* r);
+
+/*
+* Gets the number of columns of the file read by a RowReader.
+* param: r a RowReader.
+*
+* returns: number of columns.
+*/
+int columns_row_reader(const RowReader* r);
+
+/*
+* Gets the number of rows of the blocks read by a RowReader.
+* param: r a RowReader.
+*
+* returns: number of rows in each block.
+*/
+int block_rows_row_reader(const RowReader* r);
+
+/*
+* Creates a matrix file to write its rows in blocks.
+* param: filename name of the file.
+* param: rows total number of rows to write.
+* param: columns number of columns.
+* param: binary 1 to write the binary format or 0 to write the text format.
+*
+* returns: A pointer to the newly created RowWriter or NULL if the file cannot be created.
+*/
+RowWriter* open_row_writer(const char* filename, long long rows, int columns, int binary);
+
+/*
+* Writes the first rows of a block.
+* param: w a RowWriter.
+* param: block a Matrix having as many columns as the file.
+* param: count number of rows of the block to write.
+*
+* returns: 1 on success or 0 if the rows cannot be written.
+*/
+int write_row_block(RowWriter* w, const Matrix* block, int count);
+
+/*
+* Completes the file, closes it and destroys a RowWriter.
+* The header of a binary file gets its checksum here.
+* param: w RowWriter to close.
+*
+* returns: 1 on success or 0 if some write failed or the number of rows written is not the one given when it was opened.
+*/
+int close_row_writer(RowWriter* w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,6 +26,8 @@ extern "C" {
 	#endif
 
 #include "matrix.h"
+#include "rng.h"
+#include "stream.h"
 
 /*
 * SVD type definition.
@@ -78,6 +80,108 @@ void print_svd(const SVD* svd);
 */
 SVD* svd_factorization(const Matrix* m);
 
+/*
+* Computes a truncated SVD with the k largest singular triplets of a MxN matrix
+* using a randomized range finder.
+* A Gaussian sketch of the range of m is built and orthonormalized,
+* optionally refined with power iterations, and the small projected matrix
+* is factorized exactly.
+* This is much cheaper than svd_factorization when k is small compared to M and N.
+* param: m Matrix to be factorized.
+* param: k number of singular triplets to compute.
+* param: oversampling number of extra sketch columns to improve accuracy ( 5 or 10 are good values ).
+* param: power_iterations number of power iterations; use 1 or 2 when the singular values decay slowly.
+* param: rng Random generator for the Gaussian sketch, the same state gives the same result; NULL uses DEFAULT_SEED.
+*
+* The result of this factorization is as follows:
+* U => a Mxk matrix with orthonormal columns having the k leading left singular vectors.
+* Sigma => a kxk diagonal matrix having the k largest singular values in decreasing order.
+* V => a Nxk matrix with orthonormal columns having the k leading right singular vectors.
+*
+* so that:
+* M ~ USigmaV^t
+*
+* returns: a truncated SVD for the matrix passed as parameter or NULL if the operation cannot be done.
+*/
+SVD* randomized_svd(const Matrix* m, int k, int oversampling, int power_iterations, Random* rng);
+
+/*
+* PCA type definition.
+*
+* A PCA ( Principal Component Analysis ) of a data matrix having one observation per row
+* and one variable per column.
+*
+*/
+typedef struct
+{
+	Vector* _mean; /* mean of each column of the data */
+	Matrix* _components; /* principal axes, one per column */
+	Vector* _variance; /* variance explained by each principal axis */
+}PCA;
+
+/*
+* Destroys a PCA.
+* param: pca PCA to be destroyed.
+*
+*/
+void destroy_pca(PCA* pca);
+
+/*
+* Prints a PCA to the console.
+* param: pca PCA to print.
+*
+*/
+void print_pca(const PCA* pca);
+
+/*
+* Computes the k leading principal components of a MxN data matrix
+* using the randomized SVD above.
+* The data are centered on the fly while they are multiplied,
+* so no centered copy of the matrix is made.
+* param: m data matrix, one observation per row.
+* param: k number of principal components to compute.
+* param: oversampling number of extra sketch columns ( see randomized_svd ).
+* param: power_iterations number of power iterations ( see randomized_svd ).
+* param: rng Random generator for the Gaussian sketch; NULL uses DEFAULT_SEED.
+*
+* returns: a PCA having:
+* mean => a N vector with the column means.
+* components => a Nxk matrix having the principal axes as columns.
+* variance => a k vector having the variance explained by each axis in decreasing order.
+* or NULL if the operation cannot be done.
+*/
+PCA* pca_factorization(const Matrix* m, int k, int oversampling, int power_iterations, Random* rng);
+
+/*
+* Computes the k leading principal components of a data file read in blocks of rows,
+* so the data do not need to fit in memory: only a block and k+oversampling rows of N values are kept.
+* The file is read once, as a RowReader cannot go back, so the passes of pca_factorization are not possible;
+* instead a rank k+oversampling summary Sigma*V^t of the rows read so far is kept and each block,
+* centered on its own mean, is stacked under it with a row correcting the difference of the means
+* and factorized with the randomized SVD, whose leading singular values and vectors are the new summary.
+* The covariance matrix is never formed, so its condition number is not squared.
+* The result is exact when k+oversampling is at least N; otherwise the directions dropped from a summary are lost,
+* which only matters when the trailing components are not much smaller than the k leading ones.
+* param: r a RowReader positioned at the first row; it is read to the end.
+* param: k number of principal components to compute.
+* param: oversampling number of extra directions kept in the summary and extra sketch columns ( see randomized_svd ).
+* param: power_iterations number of power iterations ( see randomized_svd ).
+* param: rng Random generator for the Gaussian sketches; NULL uses DEFAULT_SEED.
+*
+* returns: a PCA as pca_factorization does, or NULL if k is out of range, the file is empty or corrupt.
+*/
+PCA* pca_row_reader(RowReader* r, int k, int oversampling, int power_iterations, Random* rng);
+
+/*
+* Projects data onto the principal axes of a PCA.
+* param: pca a previously computed PCA.
+* param: m data matrix having as many columns as variables in the PCA.
+*
+* returns: a matrix with the coordinates ( scores ) of each row of m in the principal axes,
+* or NULL if the operation cannot be done.
+*/
+Matrix* pca_transform(const PCA* pca, const Matrix* m);
+
 /*
 * Macros to access SVD data members.
 */
@@ -85,6 +189,13 @@ SVD* svd_factorization(const Matrix* m);
 #define svd_sigma(svd) ((svd)->_sigma)
 #define svd_v(svd) ((svd)->_v)
 
+/*
+* Macros to access PCA data members.
+*/
+#define pca_mean(pca) ((pca)->_mean)
+#define pca_components(pca) ((pca)->_components)
+#define pca_variance(pca) ((pca)->_variance)
+
 #ifdef __cplusplus
 }
 #endif
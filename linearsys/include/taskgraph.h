@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___TASKGRAPH_H___
+#define ___TASKGRAPH_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+#include "matrix.h"
+#include "lu.h"
+#include "qr.h"
+#include "threadpool.h"
+
+/*
+* This header has a dataflow runtime for tile algorithms and the LU, Cholesky and QR factorizations built on it.
+* A matrix is split in square tiles and an algorithm is written as a sequence of tasks, each one a kernel
+* which reads or writes a few tiles. The runtime finds the dependencies between tasks from the tiles they use
+* ( a task waits for the last one writing a tile it reads, and for the ones reading a tile it writes ),
+* so the tasks form a directed acyclic graph ( DAG ) run by the threads of a ThreadPool as soon as their inputs are ready.
+* Each thread keeps the tasks it makes ready in its own queue ( or, on NUMA computers, the thread owning the rows
+* they write does ) and steals from the others when it runs out of work.
+* Critical tasks ( the panels and the updates of the next lookahead tile columns ) go to a shared queue
+* which the threads look at first, so the next panels are factorized while the rest of the matrix is updated.
+*/
+
+#define DEFAULT_LOOKAHEAD 1 /* tile columns updated ahead of the rest of the matrix */
+
+/*
+* Access modes of a task to a tile.
+*/
+#define ACCESS_READ 1
+#define ACCESS_WRITE 2
+#define ACCESS_READWRITE 3
+
+/*
+* TaskGraph type declaration.
+* Its fields are private, so it is only used through pointers.
+*/
+typedef struct TaskGraph TaskGraph;
+
+/*
+* Function type for the kernel of a task.
+* param: arguments copy of the arguments given to insert_task_graph.
+*/
+typedef void (*KernelFunction)(void* arguments);
+
+/*
+* Creates an empty TaskGraph.
+* param: tiles number of tiles ( data handles ) used by the tasks, numbered from 0 to tiles-1.
+*
+* returns: A pointer to the newly created TaskGraph or NULL if the operation cannot be done.
+*/
+TaskGraph* create_task_graph(int tiles);
+
+/*
+* Destroys a TaskGraph.
+* param: g TaskGraph to destroy.
+*/
+void destroy_task_graph(TaskGraph* g);
+
+/*
+* Adds a task to a TaskGraph, after all the tasks already added.
+* Its dependencies come from the tiles it uses and the tasks added before which use them.
+* param: g a TaskGraph.
+* param: kernel function run by the task.
+* param: arguments arguments of the kernel, copied into the task.
+* param: size size in bytes of the arguments.
+* param: critical 1 if the task is on the critical path and must run before the others which are ready, 0 otherwise.
+* param: count number of tiles used by the task.
+* param: tiles tiles used by the task, each one at most once.
+* param: access ACCESS_READ, ACCESS_WRITE or ACCESS_READWRITE for each tile.
+*
+* returns: the index of the task or -1 if the operation cannot be done.
+*/
+int insert_task_graph(TaskGraph* g, KernelFunction kernel, const void* arguments, size_t size, int critical, int count, const int* tiles, const int* access);
+
+/*
+* Gives the rows of a matrix written by a task. On computers with several NUMA nodes and the
+* NUMA_FIRST_TOUCH policy ( numa.h ), the task goes to the queue of the thread which initialized those rows,
+* so it finds them on its own node; the other threads still steal it when they run out of work.
+* The tile algorithms below give the first row of the tile each task writes.
+* param: g a TaskGraph.
+* param: task index of the task, from insert_task_graph.
+* param: row first row written by the task.
+* param: rows rows of the matrix.
+*/
+void affinity_task_graph(TaskGraph* g, int task, int row, int rows);
+
+/*
+* Runs all the tasks of a TaskGraph, returning when they are done.
+* A TaskGraph runs only once.
+* param: g a TaskGraph.
+* param: pool a ThreadPool, NULL for the default one.
+*
+* returns: 1 on success or 0 if the graph was already run.
+*/
+int run_task_graph(TaskGraph* g, ThreadPool* pool);
+
+/*
+* Gets the number of tasks of a TaskGraph.
+* param: g a TaskGraph.
+*
+* returns: number of tasks.
+*/
+int size_task_graph(const TaskGraph* g);
+
+/*
+* Performs a LU decomposition with partial pivoting as a DAG of tile tasks, so that P*m = L*U
+* where row i of P*m is row permutation[i] of m, as lu_decomposition does.
+* The panel of each step is a task factorizing its whole tile column; each tile column on its right
+* has a task swapping its rows and solving its tile of U, and each trailing tile is updated by its own task.
+* param: m a square Matrix.
+* param: tile order of the tiles; use 0 for the LU block size of tuning.h.
+* param: lookahead number of tile columns after a panel whose updates are critical; use 0 for DEFAULT_LOOKAHEAD.
+* param: pool a ThreadPool, NULL for the default one.
+*
+* returns: A pointer to a LU of the Matrix or NULL if the matrix is not square or it is singular.
+*/
+LU* lu_task_graph(const Matrix* m, int tile, int lookahead, ThreadPool* pool);
+
+/*
+* Performs a Cholesky decomposition m = L*L^t of a symmetric positive definite matrix as a DAG of tile tasks.
+* Only the lower triangle of m is read.
+* param: m a symmetric positive definite Matrix.
+* param: tile order of the tiles; use 0 for the LU block size of tuning.h.
+* param: lookahead number of tile columns after a panel whose updates are critical; use 0 for DEFAULT_LOOKAHEAD.
+* param: pool a ThreadPool, NULL for the default one.
+*
+* returns: the lower triangular Matrix L or NULL if m is not square or it is not positive definite.
+*/
+Matrix* cholesky_task_graph(const Matrix* m, int tile, int lookahead, ThreadPool* pool);
+
+/*
+* Performs a QR factorization with Householder reflections as a DAG of tile tasks ( tile QR ), so that m = Q*R.
+* The diagonal tile of each step is factorized, then the tiles below it are annihilated one at a time against it,
+* and the reflections are applied to the tiles on their right and to the tiles of Q.
+* The signs of the rows of R and the columns of Q may differ from the ones of qr_factorization.
+* param: m a square Matrix.
+* param: tile order of the tiles; use 0 for the LU block size of tuning.h.
+* param: lookahead number of tile columns after a panel whose updates are critical; use 0 for DEFAULT_LOOKAHEAD.
+* param: pool a ThreadPool, NULL for the default one.
+*
+* returns: a QR factorization for m or NULL if the operation cannot be done.
+*/
+QR* qr_task_graph(const Matrix* m, int tile, int lookahead, ThreadPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___THREADPOOL_H___
+#define ___THREADPOOL_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+/*
+* A pool of worker threads to run loops in parallel.
+* The threads are created once and wait for work, so a parallel loop only costs a wake up.
+*/
+
+/*
+* ThreadPool type declaration.
+* Its fields are private ( they depend on the thread library ), so it is only used through pointers.
+*/
+typedef struct ThreadPool ThreadPool;
+
+/*
+* Function type for the body of a parallel loop.
+* param: index iteration index, from 0 to count-1.
+* param: context user data passed to parallel_for.
+*/
+typedef void (*TaskFunction)(int index, void* context);
+
+/*
+* Creates a ThreadPool.
+* param: threads total number of threads running a loop, counting the calling thread;
+* use 0 for the number of processors.
+*
+* returns: A pointer to the newly created ThreadPool or NULL if the threads cannot be created.
+*/
+ThreadPool* create_threadpool(int threads);
+
+/*
+* Destroys a ThreadPool, waiting for its threads to finish.
+* param: pool ThreadPool to destroy.
+*/
+void destroy_threadpool(ThreadPool* pool);
+
+/*
+* Gets the ThreadPool shared by the library.
+* It is created on first use with as many threads as the LINEARSYS_THREADS environment variable says,
+* or the number of processors if it is not set, and it lives until the program ends.
+* Its workers are pinned to cores ( see pin_threadpool ) when the LINEARSYS_PIN environment variable is set to 1.
+*
+* returns: the default ThreadPool.
+*/
+ThreadPool* default_threadpool(void);
+
+/*
+* Gets the number of threads running a loop in a ThreadPool ( at least 1 ).
+* param: pool a ThreadPool, NULL for the default one.
+*
+* returns: number of threads.
+*/
+int threads_threadpool(ThreadPool* pool);
+
+/*
+* Runs task(i, context) for i = 0 .. count-1 using the threads of a pool and the calling thread,
+* returning when all the iterations are done. Iterations can run in any order.
+* When the pool is already running a loop ( for instance, parallel_for is called from a task )
+* the iterations run sequentially in the calling thread.
+* param: pool a ThreadPool, NULL for the default one.
+* param: count number of iterations.
+* param: task body of the loop.
+* param: context user data passed to task.
+*/
+void parallel_for(ThreadPool* pool, int count, TaskFunction task, void* context);
+
+/*
+* Runs task(i, context) once in each thread of a pool, i being the index of the thread:
+* 0 for the calling thread and 1 .. threads-1 for the workers, always the same ones.
+* It is used when the work of an index must stay in the same thread, for instance to touch
+* the memory that thread works on later. When the pool is already running a loop
+* all the indices run sequentially in the calling thread.
+* param: pool a ThreadPool, NULL for the default one.
+* param: task function to run.
+* param: context user data passed to task.
+*/
+void parallel_threads(ThreadPool* pool, TaskFunction task, void* context);
+
+/*
+* Pins the workers of a pool to cores: worker i runs only on the processor i of cpus_numa ( numa.h ),
+* wrapping around when there are more threads than processors, so consecutive threads share a node.
+* The calling thread is not changed. Only Linux is supported.
+* param: pool a ThreadPool, NULL for the default one.
+*
+* returns: the number of workers pinned; 0 if they cannot be pinned or the pool is running a loop,
+* in which case it can be called again later.
+*/
+int pin_threadpool(ThreadPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___TILED_H___
+#define ___TILED_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include "matrix.h"
+#include "vector.h"
+
+/*
+* This header has out of core matrices: a TiledMatrix lives in a row major binary file ( see binio.h )
+* and it is used through square tiles which are read into a cache of fixed size only when they are needed.
+* A background thread reads the tiles requested with prefetch_tile, so the algorithms below
+* ask for the next tiles before working with the current ones and the disk works while the cpu does.
+* Changed tiles are written back to the file when they leave the cache or when the matrix is closed;
+* the checksum of the file is not kept after a change, so the header gets the BINARY_UNCHECKED flag.
+*/
+
+/*
+* TiledMatrix type definition.
+*/
+typedef struct TiledMatrix TiledMatrix;
+
+#define DEFAULT_TILE 512 /* tile order used when 0 is given */
+#define DEFAULT_CACHE_TILES 64 /* tiles kept in memory when 0 is given */
+
+/*
+* Creates a binary matrix file filled with zeros and opens it as a TiledMatrix.
+* param: filename name of the file.
+* param: rows number of rows.
+* param: columns number of columns.
+* param: tile order of the tiles, 0 for DEFAULT_TILE.
+* param: cache_tiles number of tiles kept in memory ( at least 4 ), 0 for DEFAULT_CACHE_TILES.
+*
+* returns: A pointer to the newly created TiledMatrix or NULL if the file cannot be created.
+*/
+TiledMatrix* create_tiled_matrix(const char* filename, int rows, int columns, int tile, int cache_tiles);
+
+/*
+* Opens a row major binary matrix file, which is not compressed, as a TiledMatrix.
+* param: filename name of the file, written by store_matrix_binary, a RowWriter or create_tiled_matrix.
+* param: tile order of the tiles, 0 for DEFAULT_TILE.
+* param: cache_tiles number of tiles kept in memory ( at least 4 ), 0 for DEFAULT_CACHE_TILES.
+*
+* returns: A pointer to the TiledMatrix or NULL if the file cannot be opened or it is not valid.
+*/
+TiledMatrix* open_tiled_matrix(const char* filename, int tile, int cache_tiles);
+
+/*
+* Writes the changed tiles to the file.
+* param: t a TiledMatrix.
+*
+* returns: 1 on success or 0 if some write failed.
+*/
+int flush_tiled_matrix(TiledMatrix* t);
+
+/*
+* Writes the changed tiles, closes the file and destroys a TiledMatrix.
+* param: t TiledMatrix to close.
+*
+* returns: 1 on success or 0 if some read or write failed while it was open.
+*/
+int close_tiled_matrix(TiledMatrix* t);
+
+/*
+* Gets a tile, reading it from the file if it is not in the cache.
+* The tile stays in the cache until it is released; tiles in the last row or column may be smaller.
+* param: t a TiledMatrix.
+* param: i tile row index.
+* param: j tile column index.
+*
+* returns: A Matrix owned by the cache or NULL if the tile cannot be read or all the cache is in use.
+*/
+Matrix* get_tile(TiledMatrix* t, int i, int j);
+
+/*
+* Releases a tile got with get_tile.
+* param: t a TiledMatrix.
+* param: tile the tile.
+* param: modified nonzero if the tile was changed and it must be written back.
+*/
+void release_tile(TiledMatrix* t, Matrix* tile, int modified);
+
+/*
+* Asks the background thread to read a tile into the cache.
+* It returns at once; the request is ignored if the tile is already there or there is no room.
+* param: t a TiledMatrix.
+* param: i tile row index.
+* param: j tile column index.
+*/
+void prefetch_tile(TiledMatrix* t, int i, int j);
+
+/*
+* Gets the number of rows of a TiledMatrix.
+* param: t a TiledMatrix.
+*
+* returns: number of rows.
+*/
+int rows_tiled_matrix(const TiledMatrix* t);
+
+/*
+* Gets the number of columns of a TiledMatrix.
+* param: t a TiledMatrix.
+*
+* returns: number of columns.
+*/
+int columns_tiled_matrix(const TiledMatrix* t);
+
+/*
+* Gets the order of the tiles of a TiledMatrix.
+* param: t a TiledMatrix.
+*
+* returns: order of the tiles.
+*/
+int tile_tiled_matrix(const TiledMatrix* t);
+
+/*
+* Out of core matrix product.
+* Computes C = alpha*A*B + beta*C tile by tile with kernel_gemm, reading the next tiles in background.
+* param: alpha scalar to scale A*B.
+* param: a TiledMatrix A.
+* param: b TiledMatrix B, it can be the same as A.
+* param: beta scalar to scale C; if it is zero, C is not read.
+* param: c TiledMatrix C, different from A and B.
+*
+* All of them must have the same tile order.
+*
+* returns: 1 on success or 0 if the operation cannot be done.
+*/
+int gemm_tiled_matrix(double alpha, TiledMatrix* a, TiledMatrix* b, double beta, TiledMatrix* c);
+
+/*
+* Out of core LU decomposition with partial pivoting, left looking by columns of tiles.
+* Each column of tiles is read once into memory, updated with all the columns on its left
+* ( which are read one after another while the next one is prefetched ) and factored;
+* so only two columns of tiles are kept in memory besides the cache.
+* The matrix is overwritten by L ( below the diagonal, unit diagonal not stored ) and U,
+* so that P*A = L*U where row i of P*A is row permutation[i] of A ( as in lu_decomposition ).
+* param: a a square TiledMatrix.
+*
+* returns: the permutation ( an array of rows_tiled_matrix(a) ints to release with release_memory by the caller )
+* or NULL if the matrix is not square, it is singular or some read or write failed.
+*/
+int* lu_tiled_matrix(TiledMatrix* a);
+
+/*
+* Solves a linear system using a TiledMatrix overwritten by lu_tiled_matrix.
+* param: lu the factored TiledMatrix.
+* param: permutation the permutation returned by lu_tiled_matrix.
+* param: b right hand side Vector.
+*
+* returns: A Vector x such that A*x = b or NULL if the operation cannot be done.
+*/
+Vector* lu_tiled_solver(TiledMatrix* lu, const int* permutation, const Vector* b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___TRACE_H___
+#define ___TRACE_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+/*
+* This header records an execution trace of the library: the tasks run by the threads ( blocks of a matrix product,
+* panels and updates of the LU decomposition, tiles of the out of core routines, chunks of parsing and compression,
+* systems of a batch, jobs of the asynchronous queue ) with their thread, begin and end time and tile coordinates.
+* The trace is written in the Chrome trace event format ( JSON ), which chrome://tracing and Perfetto show
+* as a timeline per thread, where idle time and load imbalance are easy to see.
+* The tracer is only compiled when the library is built with the LINEARSYS_TRACE macro defined
+* ( for instance, adding -DLINEARSYS_TRACE to FLAGS in the Makefile ); otherwise the routines have no extra code.
+* Each thread writes its events to its own ring buffer with no locks; when a buffer is full the oldest events are overwritten.
+*/
+
+#define DEFAULT_TRACE_EVENTS 65536 /* events kept per thread when 0 is given */
+
+/*
+* Starts recording a trace, dropping the events of a previous one.
+* param: capacity number of events kept per thread ( rounded up to a power of two ), 0 for DEFAULT_TRACE_EVENTS.
+*
+* returns: 1 on success or 0 if the library was built without LINEARSYS_TRACE.
+*/
+int start_trace(int capacity);
+
+/*
+* Stops recording a trace; the events recorded are kept until the next start_trace.
+*/
+void stop_trace(void);
+
+/*
+* Writes the trace recorded in the Chrome trace event format.
+* It must be called after stop_trace, once the traced routines have returned.
+* Each task is a complete event ( "ph": "X" ) named after its kernel, with its tile coordinates in args;
+* threads are numbered in the order they recorded their first event.
+* param: filename name of the file.
+*
+* returns: 1 on success or 0 if the file cannot be written.
+*/
+int export_trace(const char* filename);
+
+/*
+* Functions used by the library to record the events, through the macros below.
+* begin_trace returns the clock ( see clock_instrument ) or 0 if no trace is being recorded;
+* the name given to end_trace must be a string literal, since only the pointer is kept.
+*/
+unsigned long long begin_trace(void);
+void end_trace(const char* name, unsigned long long begin, int i, int j);
+
+/*
+* Macros to record a task between TRACE_BEGIN and TRACE_END in the same block;
+* i and j are the coordinates of the tile or block, -1 if they do not apply.
+*/
+#ifdef LINEARSYS_TRACE
+#define TRACE_BEGIN unsigned long long __trace_begin_ = begin_trace()
+#define TRACE_END(name, i, j) end_trace(name, __trace_begin_, i, j)
+#else
+#define TRACE_BEGIN
+#define TRACE_END(name, i, j)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ___TUNING_H___
+#define ___TUNING_H___
+
+#ifdef __cplusplus
+extern "C" {
+	#endif
+
+#include <stddef.h>
+
+/*
+* This header has the parameters of the library which depend on the computer it runs on:
+* the block sizes of the matrix product and the LU decomposition, and the sizes from which
+* a routine is worth running in parallel.
+* The library starts with built-in values and, on first use, reads the values found
+* for the computer by the tuning program ( make tune in the parent folder ) from its per-host file.
+* A file which does not exist, or a missing key, leaves the built-in value.
+*/
+
+#define MAX_TUNING_BLOCK 65536 /* larger block sizes are clamped to this value */
+
+/*
+* Tuning type definition.
+*/
+typedef struct
+{
+int _gemm_mc; /* rows of A sharing a panel of B in the matrix product */
+int _gemm_kc; /* rows of a panel of B */
+int _gemm_nc; /* columns of a panel of B */
+int _lu_block; /* columns of a panel in the LU decomposition; matrices up to this order are not blocked */
+double _parallel_gemm; /* matrix products with fewer multiply-adds ( m*n*k ) run in the calling thread */
+size_t _parallel_parse; /* texts shorter than this ( bytes ) are parsed by the calling thread */
+}Tuning;
+
+/*
+* Fills a Tuning with the built-in values.
+* param: t Tuning to fill.
+*/
+void default_tuning(Tuning* t);
+
+/*
+* Gets the Tuning used by the library.
+* On first use it takes the built-in values and reads the file given by filename_tuning.
+*
+* returns: the Tuning in use; it must not be modified, use set_tuning instead.
+* The routines of the library read it without a lock, so its values only change with set_tuning
+* called before other threads use the library.
+*/
+const Tuning* get_tuning(void);
+
+/*
+* Changes the Tuning used by the library.
+* The values are written in place without a lock, so it must be called at start up,
+* before other threads use the library; calling it while they run gives them torn values.
+* Values out of range ( a block size less than 1 or a negative size ) are ignored
+* and block sizes larger than MAX_TUNING_BLOCK are clamped.
+* param: t new values.
+*/
+void set_tuning(const Tuning* t);
+
+/*
+* Reads a Tuning from a text file having a key and a value per line, as written by store_tuning.
+* Lines starting with # are comments; unknown keys and values out of range are ignored,
+* so the fields which are not in the file keep their values; block sizes larger than MAX_TUNING_BLOCK are clamped.
+* param: filename name of the file.
+* param: t Tuning to update.
+*
+* returns: 1 if the file was read or 0 if it cannot be opened.
+*/
+int load_tuning(const char* filename, Tuning* t);
+
+/*
+* Writes a Tuning to a text file.
+* param: filename name of the file.
+* param: t Tuning to write.
+*
+* returns: 1 if the file was written or 0 if the operation cannot be done.
+*/
+int store_tuning(const char* filename, const Tuning* t);
+
+/*
+* Gets the name of the tuning file of this computer.
+* It is the value of the LINEARSYS_TUNING environment variable if it is set;
+* otherwise .linearsys-<host>.tune in the home folder, where host is the name of the computer.
+* param: buffer array to write the name to.
+* param: size size of the array.
+*
+* returns: 1 if the name was written or 0 if it cannot be found or it does not fit.
+*/
+int filename_tuning(char* buffer, int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
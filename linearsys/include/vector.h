@@ -86,7 +86,8 @@ Vector* get_vector_chunk(const Vector* v, int from_index, int to_index);
 * Loads a Vector from a file.
 * param: const char* filename => name of the file.
 * returns:
-* A pointer to a Vector loaded from the file passed as parameter.
+* A pointer to a Vector loaded from the file passed as parameter or NULL if the file cannot be read
+* or holds less components than n ( a truncated file or a text which is not a number ).
 *
 * Format of the file:
 *
@@ -104,6 +105,7 @@ Vector* load_vector(const char* filename);
 * param: const char* filename => the name of the file to store the vector.
 *
 * The format of the file is the same as above in the load_vector function.
+* Each value is written with the shortest text which reads back to exactly the same value.
 */
 void store_vector(const Vector* v, const char* filename);
 
@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* posix_memalign */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "allocator.h"
+
+#define MAX_SITES 4096
+#define MIN_BLOCKS 1024 /* initial size of the table of blocks */
+#define LINE_SIZE 512
+#define UNKNOWN_SITE "unknown"
+
+/*
+* Block type definition: a block allocated while the trace was recorded.
+*/
+typedef struct
+{
+void* _p; /* NULL for an empty entry */
+size_t _size;
+int _site;
+}Block;
+
+/*
+* The trace: a table of call sites and a hash table of the blocks not released yet ( open addressing ),
+* protected by a lock. Its own memory comes from the C library, so it is not traced.
+*/
+static pthread_mutex_t __lock_ = PTHREAD_MUTEX_INITIALIZER;
+static int __tracing_ = 0;
+static int __tracked_ = 0; /* blocks in the table, read without the lock to skip it when there are none */
+static AllocationSite __sites_[MAX_SITES];
+static int __site_count_ = 0;
+static Block* __blocks_ = NULL;
+static size_t __capacity_ = 0; /* size of the table of blocks, a power of two */
+
+/*
+* Helper functions.
+*/
+
+static void* __default_malloc_(size_t size, void* context)
+{
+(void)context;
+return malloc(size);
+}
+
+static void __default_free_(void* p, void* context)
+{
+(void)context;
+free(p);
+}
+
+#ifdef _WIN32
+/* _aligned_malloc blocks need _aligned_free, so aligned blocks are carved out of malloc blocks */
+#define __default_aligned_alloc_ NULL
+#else
+static void* __default_aligned_alloc_(size_t alignment, size_t size, void* context)
+{
+void* p = NULL;
+(void)context;
+if(posix_memalign(&p, alignment, size) != 0) return NULL;
+return p;
+}
+#endif
+
+static Allocator __allocator_ = { __default_malloc_, __default_free_, __default_aligned_alloc_, NULL };
+
+static size_t __hash_(const void* p, size_t capacity)
+{
+uint64_t h = (uint64_t)(uintptr_t)p;
+h ^= h >> 33;
+h *= 0xFF51AFD7ED558CCDULL;
+h ^= h >> 33;
+return (size_t)h & (capacity - 1);
+}
+
+/*
+* Finds the entry of a call site, adding it if there is room; the lock must be held.
+*/
+static int __site_(const char* site)
+{
+int i;
+if(site == NULL) site = UNKNOWN_SITE;
+/* call sites are string literals, compared by address first */
+for(i = 0; i < __site_count_; i++) if(__sites_[i]._site == site) return i;
+for(i = 0; i < __site_count_; i++) if(strcmp(__sites_[i]._site, site) == 0) return i;
+if(__site_count_ == MAX_SITES) return -1;
+memset(&__sites_[__site_count_], 0, sizeof(AllocationSite));
+__sites_[__site_count_]._site = site;
+return __site_count_++;
+}
+
+/*
+* Adds a block to the table, doubling it when it is half full; the lock must be held.
+*/
+static void __insert_(void* p, size_t size, int site)
+{
+size_t i, k, capacity;
+Block* blocks = NULL;
+if(2 * (size_t)(__tracked_ + 1) > __capacity_)
+{
+	capacity = (__capacity_ > 0) ? 2 * __capacity_ : MIN_BLOCKS;
+	blocks = (Block*)calloc(capacity, sizeof(Block));
+	if(blocks == NULL) return;
+	for(k = 0; k < __capacity_; k++)
+	{
+		if(__blocks_[k]._p == NULL) continue;
+		for(i = __hash_(__blocks_[k]._p, capacity); blocks[i]._p != NULL; i = (i + 1) & (capacity - 1));
+		blocks[i] = __blocks_[k];
+	}
+	free(__blocks_);
+	__blocks_ = blocks;
+	__capacity_ = capacity;
+}
+for(i = __hash_(p, __capacity_); __blocks_[i]._p != NULL; i = (i + 1) & (__capacity_ - 1));
+__blocks_[i]._p = p;
+__blocks_[i]._size = size;
+__blocks_[i]._site = site;
+__atomic_store_n(&__tracked_, __tracked_ + 1, __ATOMIC_RELAXED);
+}
+
+/*
+* Removes a block from the table, moving back the entries after it ( linear probing ); the lock must be held.
+* Returns 0 if the block was not in the table.
+*/
+static int __remove_(void* p, Block* removed)
+{
+size_t i, j, k;
+if(__capacity_ == 0) return 0;
+for(i = __hash_(p, __capacity_); __blocks_[i]._p != p; i = (i + 1) & (__capacity_ - 1))
+{
+	if(__blocks_[i]._p == NULL) return 0;
+}
+*removed = __blocks_[i];
+__blocks_[i]._p = NULL;
+for(j = (i + 1) & (__capacity_ - 1); __blocks_[j]._p != NULL; j = (j + 1) & (__capacity_ - 1))
+{
+	k = __hash_(__blocks_[j]._p, __capacity_);
+	/* the entry stays if its home is cyclically in ( i, j ] */
+	if((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) continue;
+	__blocks_[i] = __blocks_[j];
+	__blocks_[j]._p = NULL;
+	i = j;
+}
+__atomic_store_n(&__tracked_, __tracked_ - 1, __ATOMIC_RELAXED);
+return 1;
+}
+
+static void __record_(void* p, size_t size, const char* site)
+{
+int s;
+if(p == NULL || !__atomic_load_n(&__tracing_, __ATOMIC_RELAXED)) return;
+pthread_mutex_lock(&__lock_);
+s = __site_(site);
+if(s >= 0)
+{
+	__sites_[s]._allocations++;
+	__sites_[s]._bytes += size;
+	__sites_[s]._outstanding_blocks++;
+	__sites_[s]._outstanding_bytes += (long long)size;
+	__insert_(p, size, s);
+}
+pthread_mutex_unlock(&__lock_);
+}
+
+static void __forget_(void* p)
+{
+Block b;
+if(__atomic_load_n(&__tracked_, __ATOMIC_RELAXED) == 0) return;
+pthread_mutex_lock(&__lock_);
+if(__remove_(p, &b))
+{
+	__sites_[b._site]._outstanding_blocks--;
+	__sites_[b._site]._outstanding_bytes -= (long long)b._size;
+}
+pthread_mutex_unlock(&__lock_);
+}
+
+static int __compare_sites_(const void* a, const void* b)
+{
+const AllocationSite* x = (const AllocationSite*)a;
+const AllocationSite* y = (const AllocationSite*)b;
+if(x->_outstanding_bytes != y->_outstanding_bytes) return (x->_outstanding_bytes < y->_outstanding_bytes) ? 1 : -1;
+if(x->_bytes != y->_bytes) return (x->_bytes < y->_bytes) ? 1 : -1;
+return strcmp(x->_site, y->_site);
+}
+
+/*
+* Writes a line to a file, or to the standard output through printf when it is NULL.
+*/
+static void __print_(FILE* file, const char* line)
+{
+if(file != NULL) fputs(line, file);
+else printf("%s", line);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+void set_allocator(const Allocator* a)
+{
+if(a == NULL || a->_malloc == NULL || a->_free == NULL)
+{
+	__allocator_._malloc = __default_malloc_;
+	__allocator_._free = __default_free_;
+	__allocator_._aligned_alloc = __default_aligned_alloc_;
+	__allocator_._context = NULL;
+	return;
+}
+__allocator_ = *a;
+}
+
+void get_allocator(Allocator* a)
+{
+if(a != NULL) *a = __allocator_;
+}
+
+void* allocate_memory(size_t size, const char* site)
+{
+void* p = __allocator_._malloc((size > 0) ? size : 1, __allocator_._context);
+__record_(p, size, site);
+return p;
+}
+
+void* allocate_zeroed_memory(size_t count, size_t size, const char* site)
+{
+void* p = NULL;
+if(size > 0 && count > (size_t)-1 / size) return NULL;
+p = allocate_memory(count * size, site);
+if(p != NULL) memset(p, 0, count * size);
+return p;
+}
+
+void* allocate_aligned_memory(size_t alignment, size_t size, const char* site)
+{
+void* p = NULL;
+char* base = NULL;
+uintptr_t address;
+if(alignment < sizeof(void*)) alignment = sizeof(void*);
+if(size == 0) size = 1;
+if(__allocator_._aligned_alloc != NULL)
+{
+	/* C11 aligned_alloc wants a multiple of the alignment */
+	p = __allocator_._aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1), __allocator_._context);
+}
+else
+{
+	/* room to align the block and to keep the address of the whole block just before it */
+	base = (char*)__allocator_._malloc(size + alignment + sizeof(void*), __allocator_._context);
+	if(base == NULL) return NULL;
+	address = ((uintptr_t)(base + sizeof(void*)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	p = (void*)address;
+	((void**)p)[-1] = base;
+}
+__record_(p, size, site);
+return p;
+}
+
+void* reallocate_memory(void* p, size_t old_size, size_t size, const char* site)
+{
+void* q = NULL;
+if(p == NULL) return allocate_memory(size, site);
+q = allocate_memory(size, site);
+if(q == NULL) return NULL;
+memcpy(q, p, (old_size < size) ? old_size : size);
+release_memory(p);
+return q;
+}
+
+void release_memory(void* p)
+{
+if(p == NULL) return;
+__forget_(p);
+__allocator_._free(p, __allocator_._context);
+}
+
+void release_aligned_memory(void* p)
+{
+if(p == NULL) return;
+__forget_(p);
+if(__allocator_._aligned_alloc != NULL) __allocator_._free(p, __allocator_._context);
+else __allocator_._free(((void**)p)[-1], __allocator_._context);
+}
+
+int start_allocation_trace(void)
+{
+pthread_mutex_lock(&__lock_);
+__site_count_ = 0;
+free(__blocks_);
+__capacity_ = MIN_BLOCKS;
+__blocks_ = (Block*)calloc(__capacity_, sizeof(Block));
+if(__blocks_ == NULL) __capacity_ = 0;
+__atomic_store_n(&__tracked_, 0, __ATOMIC_RELAXED);
+__atomic_store_n(&__tracing_, (__blocks_ != NULL) ? 1 : 0, __ATOMIC_RELAXED);
+pthread_mutex_unlock(&__lock_);
+return (__blocks_ != NULL);
+}
+
+void stop_allocation_trace(void)
+{
+__atomic_store_n(&__tracing_, 0, __ATOMIC_RELAXED);
+}
+
+int sites_allocation_trace(AllocationSite* sites, int count)
+{
+int n;
+AllocationSite* copy = NULL;
+pthread_mutex_lock(&__lock_);
+n = __site_count_;
+if(sites != NULL && count > 0 && n > 0)
+{
+	copy = (AllocationSite*)malloc(n * sizeof(AllocationSite));
+	if(copy != NULL)
+	{
+		memcpy(copy, __sites_, n * sizeof(AllocationSite));
+		qsort(copy, n, sizeof(AllocationSite), __compare_sites_);
+		memcpy(sites, copy, ((count < n) ? count : n) * sizeof(AllocationSite));
+		free(copy);
+	}
+}
+pthread_mutex_unlock(&__lock_);
+return n;
+}
+
+int dump_allocation_trace(const char* filename, int outstanding)
+{
+int i, n, ok = 1;
+char line[LINE_SIZE];
+unsigned long long allocations = 0, bytes = 0;
+long long blocks = 0, live = 0;
+AllocationSite* sites = NULL;
+FILE* file = NULL;
+n = sites_allocation_trace(NULL, 0);
+if(n > 0)
+{
+	sites = (AllocationSite*)malloc(n * sizeof(AllocationSite));
+	if(sites == NULL) return 0;
+	n = sites_allocation_trace(sites, n);
+}
+if(filename != NULL)
+{
+	file = fopen(filename, "w");
+	if(file == NULL)
+	{
+		free(sites);
+		return 0;
+	}
+}
+snprintf(line, LINE_SIZE, "%-40s %12s %16s %12s %16s\n", "site", "allocations", "bytes", "outstanding", "outstanding_bytes");
+__print_(file, line);
+for(i = 0; i < n; i++)
+{
+	allocations += sites[i]._allocations;
+	bytes += sites[i]._bytes;
+	blocks += sites[i]._outstanding_blocks;
+	live += sites[i]._outstanding_bytes;
+	if(outstanding && sites[i]._outstanding_blocks == 0) continue;
+	snprintf(line, LINE_SIZE, "%-40s %12llu %16llu %12lld %16lld\n", sites[i]._site, sites[i]._allocations,
+	sites[i]._bytes, sites[i]._outstanding_blocks, sites[i]._outstanding_bytes);
+	__print_(file, line);
+}
+snprintf(line, LINE_SIZE, "%-40s %12llu %16llu %12lld %16lld\n", "total", allocations, bytes, blocks, live);
+__print_(file, line);
+free(sites);
+if(file != NULL)
+{
+	if(ferror(file)) ok = 0;
+	if(fclose(file) != 0) ok = 0;
+}
+return ok;
+}
+
+/* END */
@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#endif
+#endif
+
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "async.h"
+#include "allocator.h"
+#include "linearsys.h"
+#include "threadpool.h"
+#include "trace.h"
+
+#define MAX_ASYNC_THREADS 256
+
+/*
+* Kinds of the operations submitted by the functions of this header.
+*/
+#define OPERATION_LU 0
+#define OPERATION_LU_SOLVER 1
+#define OPERATION_SOLVER 2
+#define OPERATION_EIGEN 3
+#define OPERATION_SVD 4
+
+/*
+* AsyncQueue type definition.
+* Waiting operations are kept in a linked list of Futures.
+*/
+struct AsyncQueue
+{
+int _threads;
+pthread_t* _workers;
+pthread_mutex_t _lock; /* protects the fields below and the links of the Futures */
+pthread_cond_t _work; /* signaled when an operation is added or the queue stops */
+pthread_cond_t _room; /* signaled when an operation leaves the list */
+Future* _head;
+Future* _tail;
+int _count; /* operations in the list */
+int _depth; /* maximum number of operations in the list */
+int _stop;
+};
+
+/*
+* Future type definition.
+* A Future is referenced by its owner and, until it finishes, by its queue;
+* it is freed when both references are released.
+*/
+struct Future
+{
+pthread_mutex_t _lock; /* protects the fields below */
+pthread_cond_t _finished; /* signaled when the Future finishes */
+AsyncQueue* _queue;
+Future* _next; /* next in the list of the queue */
+AsyncFunction _run;
+void* _argument;
+ReleaseFunction _cleanup; /* destroys the argument when the operation is over, or NULL */
+ReleaseFunction _release; /* destroys a result which was not taken, or NULL */
+void* _result;
+int _state;
+int _taken;
+int _references;
+FutureCallback _callback;
+void* _context;
+};
+
+/*
+* Operation type definition: copies of the arguments of an operation submitted by this header.
+*/
+typedef struct
+{
+int _kind;
+Matrix* _m;
+Vector* _v;
+const LU* _lu;
+SystemSolver _solver;
+}Operation;
+
+static AsyncQueue* __default_ = NULL;
+static pthread_once_t __default_once_ = PTHREAD_ONCE_INIT;
+
+/*
+* Helper functions.
+*/
+
+static void __deadline_(struct timespec* t, int timeout)
+{
+clock_gettime(CLOCK_REALTIME, t);
+t->tv_sec += timeout / 1000;
+t->tv_nsec += (long)(timeout % 1000) * 1000000L;
+if(t->tv_nsec >= 1000000000L)
+{
+	t->tv_sec++;
+	t->tv_nsec -= 1000000000L;
+}
+}
+
+/*
+* Releases a reference to a Future, freeing it with the last one.
+*/
+static void __release_(Future* f)
+{
+int references;
+pthread_mutex_lock(&f->_lock);
+references = --f->_references;
+pthread_mutex_unlock(&f->_lock);
+if(references > 0) return;
+if(!f->_taken && f->_result != NULL && f->_release != NULL) f->_release(f->_result);
+pthread_mutex_destroy(&f->_lock);
+pthread_cond_destroy(&f->_finished);
+RELEASE(f);
+}
+
+/*
+* Finishes a Future: stores the result, wakes the waiting threads, calls the callback
+* and releases the reference of the queue.
+*/
+static void __finish_(Future* f, int state, void* result)
+{
+FutureCallback callback;
+void* context;
+pthread_mutex_lock(&f->_lock);
+f->_state = state;
+f->_result = result;
+callback = f->_callback;
+context = f->_context;
+pthread_cond_broadcast(&f->_finished);
+pthread_mutex_unlock(&f->_lock);
+if(f->_cleanup != NULL) f->_cleanup(f->_argument);
+f->_argument = NULL;
+if(callback != NULL) callback(f, context);
+__release_(f);
+}
+
+static void* __worker_(void* arg)
+{
+AsyncQueue* q = (AsyncQueue*)arg;
+Future* f = NULL;
+void* result;
+while(1)
+{
+	pthread_mutex_lock(&q->_lock);
+	while(q->_head == NULL && !q->_stop) pthread_cond_wait(&q->_work, &q->_lock);
+	if(q->_head == NULL)
+	{
+		pthread_mutex_unlock(&q->_lock);
+		break;
+	}
+	f = q->_head;
+	q->_head = f->_next;
+	if(q->_head == NULL) q->_tail = NULL;
+	q->_count--;
+	pthread_cond_signal(&q->_room);
+	/* the state changes with the queue locked, so cancel_future sees either a listed or a running Future */
+	pthread_mutex_lock(&f->_lock);
+	f->_state = FUTURE_RUNNING;
+	pthread_mutex_unlock(&f->_lock);
+	pthread_mutex_unlock(&q->_lock);
+	TRACE_BEGIN;
+	result = f->_run(f->_argument);
+	TRACE_END("async_job", -1, -1);
+	__finish_(f, (result != NULL) ? FUTURE_DONE : FUTURE_FAILED, result);
+}
+return NULL;
+}
+
+static void __create_default_(void)
+{
+int threads = 0;
+const char* env = getenv("LINEARSYS_ASYNC_THREADS");
+if(env != NULL) threads = atoi(env);
+__default_ = create_async_queue(threads, 0);
+if(__default_ == NULL) __default_ = create_async_queue(1, 0);
+}
+
+/*
+* Adds an operation to a queue, waiting for room up to timeout milliseconds.
+* If it cannot be added, the argument is destroyed with cleanup.
+*/
+static Future* __submit_(AsyncQueue* q, AsyncFunction run, void* argument, ReleaseFunction release, ReleaseFunction cleanup, int timeout)
+{
+int status = 0;
+struct timespec deadline;
+Future* f = NULL;
+if(q == NULL) q = default_async_queue();
+if(q == NULL || run == NULL)
+{
+	if(cleanup != NULL) cleanup(argument);
+	return NULL;
+}
+if(timeout > 0) __deadline_(&deadline, timeout);
+pthread_mutex_lock(&q->_lock);
+while(q->_count >= q->_depth && !q->_stop && status == 0)
+{
+	if(timeout == 0) status = ETIMEDOUT;
+	else if(timeout < 0) pthread_cond_wait(&q->_room, &q->_lock);
+	else status = pthread_cond_timedwait(&q->_room, &q->_lock, &deadline);
+}
+if(q->_count >= q->_depth || q->_stop)
+{
+	/* backpressure: the queue is still full */
+	pthread_mutex_unlock(&q->_lock);
+	if(cleanup != NULL) cleanup(argument);
+	return NULL;
+}
+f = (Future*)ALLOCATE(sizeof(Future));
+pthread_mutex_init(&f->_lock, NULL);
+pthread_cond_init(&f->_finished, NULL);
+f->_queue = q;
+f->_next = NULL;
+f->_run = run;
+f->_argument = argument;
+f->_cleanup = cleanup;
+f->_release = release;
+f->_result = NULL;
+f->_state = FUTURE_PENDING;
+f->_taken = 0;
+f->_references = 2; /* the owner and the queue */
+f->_callback = NULL;
+f->_context = NULL;
+if(q->_tail != NULL) q->_tail->_next = f;
+else q->_head = f;
+q->_tail = f;
+q->_count++;
+pthread_cond_signal(&q->_work);
+pthread_mutex_unlock(&q->_lock);
+return f;
+}
+
+static void* __run_operation_(void* argument)
+{
+Operation* op = (Operation*)argument;
+switch(op->_kind)
+{
+	case OPERATION_LU: return lu_decomposition(op->_m);
+	case OPERATION_LU_SOLVER: return lu_system_solver(op->_lu, op->_v);
+	case OPERATION_SOLVER: return op->_solver(op->_m, op->_v);
+	case OPERATION_EIGEN: return eigen_system(op->_m);
+	case OPERATION_SVD: return svd_factorization(op->_m);
+}
+return NULL;
+}
+
+static void __destroy_operation_(void* argument)
+{
+Operation* op = (Operation*)argument;
+if(op == NULL) return;
+destroy_matrix(op->_m);
+destroy_vector(op->_v);
+RELEASE(op);
+}
+
+static Operation* __create_operation_(int kind, const Matrix* m, const Vector* v)
+{
+Operation* op = (Operation*)ALLOCATE(sizeof(Operation));
+op->_kind = kind;
+op->_m = (m != NULL) ? clone_matrix(m) : NULL;
+op->_v = (v != NULL) ? clone_vector(v) : NULL;
+op->_lu = NULL;
+op->_solver = NULL;
+return op;
+}
+
+static void __release_lu_(void* result)
+{
+destroy_lu((LU*)result);
+}
+
+static void __release_vector_(void* result)
+{
+destroy_vector((Vector*)result);
+}
+
+static void __release_eigensystem_(void* result)
+{
+destroy_eigensystem((EigenSystem*)result);
+}
+
+static void __release_svd_(void* result)
+{
+destroy_svd((SVD*)result);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+AsyncQueue* create_async_queue(int threads, int depth)
+{
+int i;
+AsyncQueue* q = NULL;
+if(threads <= 0) threads = threads_threadpool(NULL);
+if(threads > MAX_ASYNC_THREADS) threads = MAX_ASYNC_THREADS;
+if(depth <= 0) depth = DEFAULT_ASYNC_DEPTH;
+q = (AsyncQueue*)ALLOCATE(sizeof(AsyncQueue));
+q->_workers = (pthread_t*)ALLOCATE(threads * sizeof(pthread_t));
+pthread_mutex_init(&q->_lock, NULL);
+pthread_cond_init(&q->_work, NULL);
+pthread_cond_init(&q->_room, NULL);
+q->_head = NULL;
+q->_tail = NULL;
+q->_count = 0;
+q->_depth = depth;
+q->_stop = 0;
+q->_threads = 0;
+for(i = 0; i < threads; i++)
+{
+	/* keep the threads already running */
+	if(pthread_create(&q->_workers[i], NULL, __worker_, q) != 0) break;
+	q->_threads++;
+}
+if(q->_threads == 0)
+{
+	destroy_async_queue(q);
+	return NULL;
+}
+return q;
+}
+
+void destroy_async_queue(AsyncQueue* q)
+{
+int i;
+Future* f = NULL;
+Future* cancelled = NULL;
+if(q == NULL) return;
+pthread_mutex_lock(&q->_lock);
+q->_stop = 1;
+cancelled = q->_head;
+for(f = q->_head; f != NULL; f = f->_next)
+{
+	pthread_mutex_lock(&f->_lock);
+	f->_state = FUTURE_CANCELLED;
+	pthread_mutex_unlock(&f->_lock);
+}
+q->_head = NULL;
+q->_tail = NULL;
+q->_count = 0;
+pthread_cond_broadcast(&q->_work);
+pthread_cond_broadcast(&q->_room);
+pthread_mutex_unlock(&q->_lock);
+while(cancelled != NULL)
+{
+	f = cancelled;
+	cancelled = f->_next;
+	__finish_(f, FUTURE_CANCELLED, NULL);
+}
+for(i = 0; i < q->_threads; i++) pthread_join(q->_workers[i], NULL);
+pthread_mutex_destroy(&q->_lock);
+pthread_cond_destroy(&q->_work);
+pthread_cond_destroy(&q->_room);
+RELEASE(q->_workers);
+if(q == __default_) __default_ = NULL;
+RELEASE(q);
+q = NULL;
+}
+
+AsyncQueue* default_async_queue(void)
+{
+pthread_once(&__default_once_, __create_default_);
+return __default_;
+}
+
+int pending_async_queue(AsyncQueue* q)
+{
+int count;
+if(q == NULL) q = default_async_queue();
+pthread_mutex_lock(&q->_lock);
+count = q->_count;
+pthread_mutex_unlock(&q->_lock);
+return count;
+}
+
+Future* submit_async(AsyncQueue* q, AsyncFunction run, void* argument, ReleaseFunction release, int timeout)
+{
+return __submit_(q, run, argument, release, NULL, timeout);
+}
+
+Future* submit_lu_decomposition(AsyncQueue* q, const Matrix* m, int timeout)
+{
+if(m == NULL) return NULL;
+return __submit_(q, __run_operation_, __create_operation_(OPERATION_LU, m, NULL), __release_lu_, __destroy_operation_, timeout);
+}
+
+Future* submit_lu_system_solver(AsyncQueue* q, const LU* lu, const Vector* v, int timeout)
+{
+Operation* op = NULL;
+if(lu == NULL || v == NULL) return NULL;
+op = __create_operation_(OPERATION_LU_SOLVER, NULL, v);
+op->_lu = lu;
+return __submit_(q, __run_operation_, op, __release_vector_, __destroy_operation_, timeout);
+}
+
+Future* submit_system_solver(AsyncQueue* q, SystemSolver solver, const Matrix* m, const Vector* v, int timeout)
+{
+Operation* op = NULL;
+if(m == NULL || v == NULL) return NULL;
+op = __create_operation_(OPERATION_SOLVER, m, v);
+op->_solver = (solver != NULL) ? solver : mvgauss_system_solver;
+return __submit_(q, __run_operation_, op, __release_vector_, __destroy_operation_, timeout);
+}
+
+Future* submit_eigen_system(AsyncQueue* q, const Matrix* m, int timeout)
+{
+if(m == NULL) return NULL;
+return __submit_(q, __run_operation_, __create_operation_(OPERATION_EIGEN, m, NULL), __release_eigensystem_, __destroy_operation_, timeout);
+}
+
+Future* submit_svd_factorization(AsyncQueue* q, const Matrix* m, int timeout)
+{
+if(m == NULL) return NULL;
+return __submit_(q, __run_operation_, __create_operation_(OPERATION_SVD, m, NULL), __release_svd_, __destroy_operation_, timeout);
+}
+
+int poll_future(Future* f)
+{
+int state;
+pthread_mutex_lock(&f->_lock);
+state = f->_state;
+pthread_mutex_unlock(&f->_lock);
+return state;
+}
+
+int wait_future(Future* f, int timeout)
+{
+int state, status = 0;
+struct timespec deadline;
+if(timeout > 0) __deadline_(&deadline, timeout);
+pthread_mutex_lock(&f->_lock);
+while(f->_state < FUTURE_DONE && timeout != 0 && status == 0)
+{
+	if(timeout < 0) pthread_cond_wait(&f->_finished, &f->_lock);
+	else status = pthread_cond_timedwait(&f->_finished, &f->_lock, &deadline);
+}
+state = f->_state;
+pthread_mutex_unlock(&f->_lock);
+return state;
+}
+
+int cancel_future(Future* f)
+{
+int found = 0;
+AsyncQueue* q = f->_queue;
+Future* p = NULL;
+if(poll_future(f) != FUTURE_PENDING) return 0;
+pthread_mutex_lock(&q->_lock);
+/* the Future may have been taken by a worker meanwhile */
+if(poll_future(f) == FUTURE_PENDING)
+{
+	if(q->_head == f)
+	{
+		q->_head = f->_next;
+		found = 1;
+	}
+	else
+	{
+		for(p = q->_head; p != NULL && p->_next != f; p = p->_next);
+		if(p != NULL)
+		{
+			p->_next = f->_next;
+			found = 1;
+		}
+	}
+	if(found)
+	{
+		if(q->_tail == f) q->_tail = p;
+		q->_count--;
+		pthread_cond_signal(&q->_room);
+		pthread_mutex_lock(&f->_lock);
+		f->_state = FUTURE_CANCELLED;
+		pthread_mutex_unlock(&f->_lock);
+	}
+}
+pthread_mutex_unlock(&q->_lock);
+if(found) __finish_(f, FUTURE_CANCELLED, NULL);
+return found;
+}
+
+void callback_future(Future* f, FutureCallback callback, void* context)
+{
+int finished;
+pthread_mutex_lock(&f->_lock);
+finished = (f->_state >= FUTURE_DONE);
+if(!finished)
+{
+	f->_callback = callback;
+	f->_context = context;
+}
+pthread_mutex_unlock(&f->_lock);
+if(finished && callback != NULL) callback(f, context);
+}
+
+void* take_future(Future* f)
+{
+void* result = NULL;
+pthread_mutex_lock(&f->_lock);
+if(f->_state == FUTURE_DONE && !f->_taken)
+{
+	result = f->_result;
+	f->_taken = 1;
+}
+pthread_mutex_unlock(&f->_lock);
+return result;
+}
+
+void destroy_future(Future* f)
+{
+if(f == NULL) return;
+cancel_future(f);
+__release_(f);
+}
+
+/* END */
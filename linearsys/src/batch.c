@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* fseeko */
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64 /* files bigger than 2 GB in 32 bits systems */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "batch.h"
+#include "allocator.h"
+#include "binio.h"
+#include "linearsys.h"
+#include "threadpool.h"
+#include "trace.h"
+
+#define BATCH_GROUP 1024 /* systems read, solved and written together by solve_batch */
+#define BATCH_SLOTS 3 /* groups in flight: one read, one solved and one written */
+
+/*
+* States of a group of systems in solve_batch.
+*/
+#define GROUP_FREE 0
+#define GROUP_READ 1
+#define GROUP_SOLVED 2
+
+/*
+* RecordHeader type definition: the 16 bytes before the entries of a record.
+*/
+typedef struct
+{
+uint32_t _kind;
+int32_t _rows;
+int32_t _columns;
+uint32_t _reserved;
+}RecordHeader;
+
+struct Batch
+{
+FILE* _file;
+uint64_t* _positions; /* byte offset of each record */
+int _count;
+};
+
+struct BatchWriter
+{
+FILE* _file;
+uint64_t* _positions;
+int _count;
+int _capacity;
+uint64_t _position; /* byte offset of the next record */
+int _error;
+};
+
+/*
+* A group of systems.
+*/
+typedef struct
+{
+Matrix** _m;
+Vector** _v;
+Vector** _x;
+int _count;
+int _state;
+}Group;
+
+/*
+* Pipeline type definition: the state shared by the threads of solve_batch.
+*/
+typedef struct
+{
+Group _groups[BATCH_SLOTS];
+Batch* _input;
+BatchWriter* _output;
+SystemSolver _solver;
+int _systems;
+int _stop; /* a read or a write failed */
+pthread_mutex_t _lock;
+pthread_cond_t _changed;
+Group* _current; /* group being solved */
+}Pipeline;
+
+/*
+* Helper functions.
+*/
+
+static int __seek_(FILE* file, uint64_t position)
+{
+#ifdef _WIN32
+return _fseeki64(file, (__int64)position, SEEK_SET) == 0;
+#else
+return fseeko(file, (off_t)position, SEEK_SET) == 0;
+#endif
+}
+
+/*
+* Appends a record to a batch file.
+*/
+static int __write_record_(BatchWriter* w, uint32_t kind, int rows, int columns, const double* data)
+{
+RecordHeader h;
+size_t count = (kind == BATCH_EMPTY) ? 0 : (size_t)rows * columns;
+if(w == NULL || w->_error) return 0;
+if(w->_count == w->_capacity)
+{
+	w->_capacity = (w->_capacity > 0) ? 2 * w->_capacity : 1024;
+	w->_positions = (uint64_t*)REALLOCATE(w->_positions, w->_count * sizeof(uint64_t), w->_capacity * sizeof(uint64_t));
+}
+h._kind = kind;
+h._rows = rows;
+h._columns = columns;
+h._reserved = 0;
+if(fwrite(&h, sizeof(h), 1, w->_file) != 1 || (count > 0 && fwrite(data, sizeof(double), count, w->_file) != count))
+{
+	w->_error = 1;
+	return 0;
+}
+w->_positions[w->_count++] = w->_position;
+w->_position += sizeof(h) + count * sizeof(double);
+return 1;
+}
+
+/*
+* Reads a record at the current position of a file.
+* returns: the Matrix or Vector read ( as a Matrix with one column for a Vector ), through m or v,
+* and the kind of the record, or -1 if it cannot be read.
+*/
+static int __read_record_(FILE* file, Matrix** m, Vector** v)
+{
+RecordHeader h;
+size_t count;
+*m = NULL;
+*v = NULL;
+if(fread(&h, sizeof(h), 1, file) != 1) return -1;
+if(h._kind == BATCH_EMPTY) return BATCH_EMPTY;
+if(h._rows < 1 || h._columns < 1 || (h._kind != BATCH_MATRIX && h._kind != BATCH_VECTOR)) return -1;
+if(h._kind == BATCH_VECTOR && h._columns != 1) return -1;
+count = (size_t)h._rows * h._columns;
+if(h._kind == BATCH_MATRIX)
+{
+	*m = create_matrix(h._rows, h._columns);
+	if(fread((*m)->_data, sizeof(double), count, file) == count) return BATCH_MATRIX;
+	destroy_matrix(*m);
+	*m = NULL;
+}
+else
+{
+	*v = create_vector(h._rows);
+	if(fread((*v)->_data, sizeof(double), count, file) == count) return BATCH_VECTOR;
+	destroy_vector(*v);
+	*v = NULL;
+}
+return -1;
+}
+
+/*
+* Waits until a group gets a state; returns 0 if the pipeline was stopped.
+*/
+static int __wait_group_(Pipeline* p, Group* g, int state)
+{
+int ok;
+pthread_mutex_lock(&p->_lock);
+while(g->_state != state && !p->_stop) pthread_cond_wait(&p->_changed, &p->_lock);
+ok = !p->_stop;
+pthread_mutex_unlock(&p->_lock);
+return ok;
+}
+
+static void __set_group_(Pipeline* p, Group* g, int state)
+{
+pthread_mutex_lock(&p->_lock);
+g->_state = state;
+pthread_cond_broadcast(&p->_changed);
+pthread_mutex_unlock(&p->_lock);
+}
+
+static void __stop_(Pipeline* p)
+{
+pthread_mutex_lock(&p->_lock);
+p->_stop = 1;
+pthread_cond_broadcast(&p->_changed);
+pthread_mutex_unlock(&p->_lock);
+}
+
+/*
+* Reader thread: reads the systems group by group, in file order.
+*/
+static void* __reader_(void* arg)
+{
+int k, n, first;
+Matrix* m = NULL;
+Vector* v = NULL;
+Group* g = NULL;
+Pipeline* p = (Pipeline*)arg;
+for(first = 0, n = 0; first < p->_systems; first += BATCH_GROUP, n++)
+{
+	g = p->_groups + n % BATCH_SLOTS;
+	if(!__wait_group_(p, g, GROUP_FREE)) break;
+	g->_count = (p->_systems - first < BATCH_GROUP) ? p->_systems - first : BATCH_GROUP;
+	for(k = 0; k < g->_count; k++)
+	{
+		if(__read_record_(p->_input->_file, &g->_m[k], &v) != BATCH_MATRIX || __read_record_(p->_input->_file, &m, &g->_v[k]) != BATCH_VECTOR ||
+		rows_matrix(g->_m[k]) != size_vector(g->_v[k]))
+		{
+			/* release previously allocated memory */
+			destroy_vector(v);
+			destroy_matrix(m);
+			g->_count = k + 1;
+			__stop_(p);
+			return NULL;
+		}
+	}
+	__set_group_(p, g, GROUP_READ);
+}
+return NULL;
+}
+
+/*
+* Writer thread: writes the solutions group by group, in order.
+*/
+static void* __writer_(void* arg)
+{
+int k, n, first;
+Group* g = NULL;
+Pipeline* p = (Pipeline*)arg;
+for(first = 0, n = 0; first < p->_systems; first += BATCH_GROUP, n++)
+{
+	g = p->_groups + n % BATCH_SLOTS;
+	if(!__wait_group_(p, g, GROUP_SOLVED)) break;
+	for(k = 0; k < g->_count; k++)
+	{
+		if(!add_batch_vector(p->_output, g->_x[k])) __stop_(p);
+		destroy_vector(g->_x[k]);
+		g->_x[k] = NULL;
+	}
+	g->_count = 0;
+	__set_group_(p, g, GROUP_FREE);
+}
+return NULL;
+}
+
+/*
+* Solves system k of the current group.
+*/
+static void __solve_task_(int k, void* context)
+{
+Pipeline* p = (Pipeline*)context;
+Group* g = p->_current;
+TRACE_BEGIN;
+g->_x[k] = p->_solver(g->_m[k], g->_v[k]);
+destroy_matrix(g->_m[k]);
+destroy_vector(g->_v[k]);
+g->_m[k] = NULL;
+g->_v[k] = NULL;
+TRACE_END("batch_solve", k, -1);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+BatchWriter* open_batch_writer(const char* filename)
+{
+BatchHeader h;
+BatchWriter* w = NULL;
+if(filename == NULL) return NULL;
+w = (BatchWriter*)ALLOCATE(sizeof(BatchWriter));
+memset(w, 0, sizeof(BatchWriter));
+w->_file = fopen(filename, "wb");
+if(w->_file == NULL)
+{
+	RELEASE(w);
+	return NULL;
+}
+/* the header is written again with the count and the index when the file is closed */
+memset(&h, 0, sizeof(h));
+if(fwrite(&h, sizeof(h), 1, w->_file) != 1) w->_error = 1;
+w->_position = sizeof(h);
+return w;
+}
+
+int add_batch_matrix(BatchWriter* w, const Matrix* m)
+{
+if(m == NULL) return 0;
+return __write_record_(w, BATCH_MATRIX, rows_matrix(m), columns_matrix(m), m->_data);
+}
+
+int add_batch_vector(BatchWriter* w, const Vector* v)
+{
+if(v == NULL) return __write_record_(w, BATCH_EMPTY, 0, 0, NULL);
+return __write_record_(w, BATCH_VECTOR, size_vector(v), 1, v->_data);
+}
+
+int close_batch_writer(BatchWriter* w)
+{
+BatchHeader h;
+int ok;
+if(w == NULL) return 0;
+memcpy(h._magic, BATCH_MAGIC, 8);
+h._version = BATCH_VERSION;
+h._endian = BINARY_ENDIAN;
+h._count = (uint64_t)w->_count;
+h._index = w->_position;
+ok = !w->_error;
+if(ok && w->_count > 0) ok = (fwrite(w->_positions, sizeof(uint64_t), w->_count, w->_file) == (size_t)w->_count);
+if(ok) ok = __seek_(w->_file, 0) && fwrite(&h, sizeof(h), 1, w->_file) == 1;
+if(fclose(w->_file) != 0) ok = 0;
+
+/* release previously allocated memory */
+if(w->_positions != NULL) RELEASE(w->_positions);
+RELEASE(w);
+
+return ok;
+}
+
+Batch* open_batch(const char* filename)
+{
+BatchHeader h;
+Batch* b = NULL;
+FILE* file = NULL;
+int ok;
+if(filename == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+ok = fread(&h, sizeof(h), 1, file) == 1 && memcmp(h._magic, BATCH_MAGIC, 8) == 0 &&
+h._version == BATCH_VERSION && h._endian == BINARY_ENDIAN && h._count <= INT32_MAX;
+b = (Batch*)ALLOCATE(sizeof(Batch));
+b->_file = file;
+b->_count = ok ? (int)h._count : 0;
+b->_positions = (uint64_t*)ALLOCATE(((b->_count > 0) ? b->_count : 1) * sizeof(uint64_t));
+if(ok && b->_count > 0) ok = __seek_(file, h._index) && fread(b->_positions, sizeof(uint64_t), b->_count, file) == (size_t)b->_count;
+/* leave the file at the first record, where solve_batch starts reading */
+if(ok) ok = __seek_(file, sizeof(h));
+if(!ok)
+{
+	close_batch(b);
+	return NULL;
+}
+return b;
+}
+
+void close_batch(Batch* b)
+{
+if(b == NULL) return;
+fclose(b->_file);
+RELEASE(b->_positions);
+RELEASE(b);
+}
+
+int count_batch(const Batch* b)
+{
+return b->_count;
+}
+
+int kind_batch(Batch* b, int index)
+{
+RecordHeader h;
+if(b == NULL || index < 0 || index >= b->_count) return -1;
+if(!__seek_(b->_file, b->_positions[index]) || fread(&h, sizeof(h), 1, b->_file) != 1) return -1;
+return (int)h._kind;
+}
+
+Matrix* read_batch_matrix(Batch* b, int index)
+{
+Matrix* m = NULL;
+Vector* v = NULL;
+if(b == NULL || index < 0 || index >= b->_count || !__seek_(b->_file, b->_positions[index])) return NULL;
+if(__read_record_(b->_file, &m, &v) != BATCH_MATRIX) destroy_vector(v);
+return m;
+}
+
+Vector* read_batch_vector(Batch* b, int index)
+{
+Matrix* m = NULL;
+Vector* v = NULL;
+if(b == NULL || index < 0 || index >= b->_count || !__seek_(b->_file, b->_positions[index])) return NULL;
+if(__read_record_(b->_file, &m, &v) != BATCH_VECTOR) destroy_matrix(m);
+return v;
+}
+
+int solve_batch(const char* input, const char* output, SystemSolver solver)
+{
+int s, k, n, first, solved, ok;
+pthread_t reader, writer;
+Group* g = NULL;
+Pipeline p;
+memset(&p, 0, sizeof(p));
+p._input = open_batch(input);
+if(p._input == NULL) return -1;
+if(count_batch(p._input) % 2 != 0)
+{
+	close_batch(p._input);
+	return -1;
+}
+p._output = open_batch_writer(output);
+if(p._output == NULL)
+{
+	close_batch(p._input);
+	return -1;
+}
+p._solver = (solver != NULL) ? solver : mvgauss_system_solver;
+p._systems = count_batch(p._input) / 2;
+for(s = 0; s < BATCH_SLOTS; s++)
+{
+	p._groups[s]._m = (Matrix**)ALLOCATE_ZEROED(BATCH_GROUP, sizeof(Matrix*));
+	p._groups[s]._v = (Vector**)ALLOCATE_ZEROED(BATCH_GROUP, sizeof(Vector*));
+	p._groups[s]._x = (Vector**)ALLOCATE_ZEROED(BATCH_GROUP, sizeof(Vector*));
+}
+pthread_mutex_init(&p._lock, NULL);
+pthread_cond_init(&p._changed, NULL);
+ok = (pthread_create(&reader, NULL, __reader_, &p) == 0);
+if(ok && pthread_create(&writer, NULL, __writer_, &p) != 0)
+{
+	__stop_(&p);
+	pthread_join(reader, NULL);
+	ok = 0;
+}
+solved = 0;
+for(first = 0, n = 0; ok && first < p._systems; first += BATCH_GROUP, n++)
+{
+	g = p._groups + n % BATCH_SLOTS;
+	if(!__wait_group_(&p, g, GROUP_READ)) break;
+	p._current = g;
+	parallel_for(NULL, g->_count, __solve_task_, &p);
+	for(k = 0; k < g->_count; k++) if(g->_x[k] != NULL) solved++;
+	__set_group_(&p, g, GROUP_SOLVED);
+}
+if(ok)
+{
+	pthread_join(reader, NULL);
+	pthread_join(writer, NULL);
+}
+if(!ok || p._stop) solved = -1;
+if(!close_batch_writer(p._output)) solved = -1;
+
+/* release previously allocated memory */
+for(s = 0; s < BATCH_SLOTS; s++)
+{
+	for(k = 0; k < BATCH_GROUP; k++)
+	{
+		destroy_matrix(p._groups[s]._m[k]);
+		destroy_vector(p._groups[s]._v[k]);
+		destroy_vector(p._groups[s]._x[k]);
+	}
+	RELEASE(p._groups[s]._m);
+	RELEASE(p._groups[s]._v);
+	RELEASE(p._groups[s]._x);
+}
+pthread_mutex_destroy(&p._lock);
+pthread_cond_destroy(&p._changed);
+close_batch(p._input);
+
+return solved;
+}
+
+/* END */
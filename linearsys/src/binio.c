@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* mmap, fstat */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "binio.h"
+#include "allocator.h"
+#include "codec.h"
+#include "threadpool.h"
+#include "trace.h"
+
+/*
+* A mapped Matrix keeps the mapping along with the Matrix,
+* which is the first member so that a Matrix* can be converted back to a MappedMatrix*.
+*/
+typedef struct
+{
+Matrix _matrix;
+void* _address;
+size_t _length;
+}MappedMatrix;
+
+/*
+* Chunks compressed or decompressed by one task.
+*/
+typedef struct
+{
+double* _entries;
+int _rows;
+int _columns;
+int _chunk_rows;
+unsigned char** _data; /* compressed bytes of each chunk */
+size_t* _sizes;
+const uint64_t* _positions; /* decompression: positions of the chunks in the file */
+int _error;
+}ChunkJob;
+
+/*
+* Helper functions.
+*/
+
+/*
+* Checks the fields of a header.
+* param: h header read from a file.
+* param: size size of the file in bytes, or 0 if it is unknown.
+*
+* returns: 1 if the header is valid.
+*/
+static int __valid_header_(const BinaryHeader* h, uint64_t size)
+{
+if(!valid_header_binary(h)) return 0;
+if(h->_rows * h->_columns > INT_MAX) return 0; /* the Matrix type counts its entries with an int */
+if(h->_flags & BINARY_COMPRESSED) return 1; /* the size is checked with the chunk offsets */
+if(size > 0 && size < h->_offset + h->_rows * h->_columns * sizeof(double)) return 0; /* truncated file */
+return 1;
+}
+
+/*
+* Maps a whole file into memory for reading.
+* param: filename name of the file.
+* param: length set to the size of the file.
+*
+* returns: address of the mapping or NULL if the file cannot be mapped.
+*/
+static void* __map_file_(const char* filename, size_t* length)
+{
+void* address = NULL;
+#ifdef _WIN32
+HANDLE file, mapping;
+LARGE_INTEGER size;
+if(filename == NULL) return NULL;
+file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+if(file == INVALID_HANDLE_VALUE) return NULL;
+if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+{
+	CloseHandle(file);
+	return NULL;
+}
+*length = (size_t)size.QuadPart;
+mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+CloseHandle(file);
+if(mapping == NULL) return NULL;
+/* the view keeps the mapping alive after its handle is closed */
+address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+CloseHandle(mapping);
+#else
+int fd;
+struct stat st;
+if(filename == NULL) return NULL;
+fd = open(filename, O_RDONLY);
+if(fd < 0) return NULL;
+if(fstat(fd, &st) != 0 || st.st_size == 0)
+{
+	close(fd);
+	return NULL;
+}
+*length = (size_t)st.st_size;
+address = mmap(NULL, *length, PROT_READ, MAP_SHARED, fd, 0);
+/* the mapping stays valid after the file is closed */
+close(fd);
+if(address == MAP_FAILED) address = NULL;
+#endif
+return address;
+}
+
+static void __unmap_file_(void* address, size_t length)
+{
+#ifdef _WIN32
+UnmapViewOfFile(address);
+#else
+munmap(address, length);
+#endif
+}
+
+/*
+* Builds a MappedMatrix whose entries start at a byte offset of a mapping.
+*/
+static const Matrix* __mapped_matrix_(void* address, size_t length, uint64_t offset, int rows, int columns)
+{
+MappedMatrix* mm = (MappedMatrix*)ALLOCATE(sizeof(MappedMatrix));
+mm->_matrix._rows = rows;
+mm->_matrix._columns = columns;
+mm->_matrix._data = (double*)((char*)address + offset);
+mm->_address = address;
+mm->_length = length;
+return &mm->_matrix;
+}
+
+/*
+* Number of entries of chunk k.
+*/
+static size_t __chunk_count_(const ChunkJob* job, int k)
+{
+int rows = job->_rows - k*job->_chunk_rows;
+if(rows > job->_chunk_rows) rows = job->_chunk_rows;
+return (size_t)rows * job->_columns;
+}
+
+static void __compress_task_(int k, void* context)
+{
+ChunkJob* job = (ChunkJob*)context;
+size_t count = __chunk_count_(job, k), bytes = count * sizeof(double), size;
+const double* entries = job->_entries + (size_t)k*job->_chunk_rows*job->_columns;
+unsigned char* shuffled = (unsigned char*)ALLOCATE(bytes);
+TRACE_BEGIN;
+job->_data[k] = (unsigned char*)ALLOCATE(bound_codec(bytes));
+shuffle_codec(entries, count, sizeof(double), shuffled);
+/* a chunk which does not get smaller is stored as it is */
+size = compress_codec(shuffled, bytes, job->_data[k], bytes - 1);
+if(size == 0)
+{
+	memcpy(job->_data[k], entries, bytes);
+	size = bytes;
+}
+job->_sizes[k] = size;
+RELEASE(shuffled);
+TRACE_END("compress_chunk", k, -1);
+}
+
+static void __decompress_task_(int k, void* context)
+{
+ChunkJob* job = (ChunkJob*)context;
+const unsigned char* data = job->_data[0] + (job->_positions[k] - job->_positions[0]);
+TRACE_BEGIN;
+if(!decode_chunk_binary(data, (size_t)(job->_positions[k+1] - job->_positions[k]),
+job->_entries + (size_t)k*job->_chunk_rows*job->_columns, __chunk_count_(job, k))) job->_error = 1;
+TRACE_END("decompress_chunk", k, -1);
+}
+
+/*
+* Reads the entries of a compressed file, at its data offset, decompressing its chunks in parallel.
+*/
+static int __read_compressed_(FILE* file, const BinaryHeader* h, double* entries)
+{
+ChunkHeader ch;
+ChunkJob job;
+uint64_t length;
+int ok;
+unsigned char* data = NULL;
+uint64_t* positions = NULL;
+positions = read_chunk_table_binary(file, h, &ch);
+if(positions == NULL) return 0;
+/* the table is verified, so the chunks are no bigger than the entries they hold */
+length = positions[ch._chunks] - positions[0];
+data = (unsigned char*)ALLOCATE((size_t)((length > 0) ? length : 1));
+ok = (data != NULL && fread(data, 1, (size_t)length, file) == length);
+if(ok)
+{
+	memset(&job, 0, sizeof(job));
+	job._entries = entries;
+	job._rows = (int)h->_rows;
+	job._columns = (int)h->_columns;
+	job._chunk_rows = (int)ch._chunk_rows;
+	job._data = &data;
+	job._positions = positions;
+	parallel_for(NULL, (int)ch._chunks, __decompress_task_, &job);
+	ok = !job._error;
+}
+
+/* release previously allocated memory */
+if(data != NULL) RELEASE(data);
+RELEASE(positions);
+
+return ok;
+}
+
+/* end helper functions */
+
+/* implementation */
+
+void make_header_binary(BinaryHeader* header, uint64_t rows, uint64_t columns, uint64_t checksum)
+{
+memset(header, 0, sizeof(BinaryHeader));
+memcpy(header->_magic, BINARY_MAGIC, 8);
+header->_version = BINARY_VERSION;
+header->_endian = BINARY_ENDIAN;
+header->_dtype = BINARY_FLOAT64;
+header->_layout = BINARY_ROW_MAJOR;
+header->_alignment = BINARY_ALIGNMENT;
+header->_rows = rows;
+header->_columns = columns;
+/* the header is 64 bytes, so the entries start right after it */
+header->_offset = ((sizeof(BinaryHeader) + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT) * BINARY_ALIGNMENT;
+header->_checksum = checksum;
+}
+
+int valid_header_binary(const BinaryHeader* h)
+{
+if(memcmp(h->_magic, BINARY_MAGIC, 8) != 0) return 0;
+if(h->_version != BINARY_VERSION || h->_endian != BINARY_ENDIAN) return 0;
+if(h->_dtype != BINARY_FLOAT64) return 0;
+if(h->_layout != BINARY_ROW_MAJOR && h->_layout != BINARY_COLUMN_MAJOR) return 0;
+if(h->_alignment == 0 || h->_offset < sizeof(BinaryHeader) || h->_offset % h->_alignment != 0) return 0;
+if(h->_rows < 1 || h->_columns < 1 || h->_rows > INT_MAX || h->_columns > INT_MAX) return 0;
+return 1;
+}
+
+uint64_t checksum_binary(const double* data, size_t count)
+{
+Checksum c;
+start_checksum(&c);
+update_checksum(&c, data, count);
+return value_checksum(&c);
+}
+
+void start_checksum(Checksum* c)
+{
+c->_a = 1;
+c->_b = 0;
+}
+
+void update_checksum(Checksum* c, const double* data, size_t count)
+{
+size_t i;
+uint64_t w, a = c->_a, b = c->_b;
+for(i = 0; i < count; i++)
+{
+	memcpy(&w, data + i, sizeof(w));
+	a += w;
+	b += a;
+}
+c->_a = a;
+c->_b = b;
+}
+
+uint64_t value_checksum(const Checksum* c)
+{
+return c->_a ^ ((c->_b << 32) | (c->_b >> 32));
+}
+
+int store_matrix_binary(const Matrix* m, const char* filename)
+{
+size_t count;
+int ok;
+BinaryHeader header;
+FILE* file = NULL;
+if(m == NULL || filename == NULL) return 0;
+count = (size_t)rows_matrix(m) * columns_matrix(m);
+make_header_binary(&header, rows_matrix(m), columns_matrix(m), checksum_binary(m->_data, count));
+file = fopen(filename, "wb");
+if(file == NULL) return 0;
+ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+/* padding up to the data offset */
+if(ok && header._offset > sizeof(header))
+{
+	char zero[BINARY_ALIGNMENT] = { 0 };
+	ok = (fwrite(zero, (size_t)header._offset - sizeof(header), 1, file) == 1);
+}
+if(ok) ok = (fwrite(m->_data, sizeof(double), count, file) == count);
+if(fclose(file) != 0) ok = 0;
+return ok;
+}
+
+int store_matrix_compressed(const Matrix* m, const char* filename)
+{
+int k, ok;
+uint64_t position;
+BinaryHeader header;
+ChunkHeader ch;
+ChunkJob job;
+uint64_t* positions = NULL;
+FILE* file = NULL;
+if(m == NULL || filename == NULL) return 0;
+make_header_binary(&header, rows_matrix(m), columns_matrix(m), checksum_binary(m->_data, (size_t)dimension_matrix(m)));
+header._flags = BINARY_COMPRESSED;
+ch._chunk_rows = COMPRESSED_CHUNK / ((uint64_t)columns_matrix(m) * sizeof(double));
+if(ch._chunk_rows < 1) ch._chunk_rows = 1;
+if(ch._chunk_rows > (uint64_t)rows_matrix(m)) ch._chunk_rows = rows_matrix(m);
+ch._chunks = (rows_matrix(m) + ch._chunk_rows - 1) / ch._chunk_rows;
+memset(&job, 0, sizeof(job));
+job._entries = m->_data;
+job._rows = rows_matrix(m);
+job._columns = columns_matrix(m);
+job._chunk_rows = (int)ch._chunk_rows;
+job._data = (unsigned char**)ALLOCATE((size_t)ch._chunks * sizeof(unsigned char*));
+job._sizes = (size_t*)ALLOCATE((size_t)ch._chunks * sizeof(size_t));
+parallel_for(NULL, (int)ch._chunks, __compress_task_, &job);
+/* chunk table after the chunk header */
+positions = (uint64_t*)ALLOCATE((size_t)(ch._chunks + 1) * sizeof(uint64_t));
+position = header._offset + sizeof(ch) + (ch._chunks + 1) * sizeof(uint64_t);
+for(k = 0; k < (int)ch._chunks; k++)
+{
+	positions[k] = position;
+	position += job._sizes[k];
+}
+positions[ch._chunks] = position;
+file = fopen(filename, "wb");
+ok = (file != NULL);
+if(ok) ok = (fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(&ch, sizeof(ch), 1, file) == 1 &&
+fwrite(positions, sizeof(uint64_t), (size_t)ch._chunks + 1, file) == ch._chunks + 1);
+for(k = 0; ok && k < (int)ch._chunks; k++) ok = (fwrite(job._data[k], 1, job._sizes[k], file) == job._sizes[k]);
+if(file != NULL && fclose(file) != 0) ok = 0;
+
+/* release previously allocated memory */
+for(k = 0; k < (int)ch._chunks; k++) RELEASE(job._data[k]);
+RELEASE(job._data);
+RELEASE(job._sizes);
+RELEASE(positions);
+
+return ok;
+}
+
+int decode_chunk_binary(const void* data, size_t n, double* entries, size_t count)
+{
+int ok;
+unsigned char* shuffled = NULL;
+/* a chunk which did not get smaller was stored as it is */
+if(n == count * sizeof(double))
+{
+	memcpy(entries, data, n);
+	return 1;
+}
+shuffled = (unsigned char*)ALLOCATE(count * sizeof(double));
+if(shuffled == NULL) return 0;
+ok = decompress_codec(data, n, shuffled, count * sizeof(double));
+if(ok) unshuffle_codec(shuffled, count, sizeof(double), entries);
+RELEASE(shuffled);
+return ok;
+}
+
+uint64_t* read_chunk_table_binary(FILE* file, const BinaryHeader* header, ChunkHeader* chunks)
+{
+uint64_t k, rows, table, size;
+long here, end;
+uint64_t* positions = NULL;
+if(fread(chunks, sizeof(ChunkHeader), 1, file) != 1) return NULL;
+/* as store_matrix_compressed makes them, so a chunk is never bigger than COMPRESSED_CHUNK bytes or a row */
+if(chunks->_chunk_rows < 1 || chunks->_chunk_rows > header->_rows ||
+(chunks->_chunk_rows > 1 && chunks->_chunk_rows > COMPRESSED_CHUNK / (header->_columns * sizeof(double))) ||
+chunks->_chunks != (header->_rows + chunks->_chunk_rows - 1) / chunks->_chunk_rows) return NULL;
+/* the size of the file bounds the table and the chunks */
+here = ftell(file);
+if(here < 0 || fseek(file, 0, SEEK_END) != 0) return NULL;
+end = ftell(file);
+size = (end < 0) ? 0 : (uint64_t)end;
+table = (uint64_t)here + (chunks->_chunks + 1) * sizeof(uint64_t);
+if(table > size || fseek(file, here, SEEK_SET) != 0) return NULL;
+positions = (uint64_t*)ALLOCATE((size_t)(chunks->_chunks + 1) * sizeof(uint64_t));
+if(positions == NULL) return NULL;
+if(fread(positions, sizeof(uint64_t), (size_t)chunks->_chunks + 1, file) != chunks->_chunks + 1 ||
+positions[0] < table || positions[chunks->_chunks] > size)
+{
+	RELEASE(positions);
+	return NULL;
+}
+for(k = 0; k < chunks->_chunks; k++)
+{
+	rows = header->_rows - k * chunks->_chunk_rows;
+	if(rows > chunks->_chunk_rows) rows = chunks->_chunk_rows;
+	if(positions[k+1] < positions[k] || positions[k+1] - positions[k] > rows * header->_columns * sizeof(double))
+	{
+		RELEASE(positions);
+		return NULL;
+	}
+}
+if(fseek(file, (long)positions[0], SEEK_SET) != 0)
+{
+	RELEASE(positions);
+	return NULL;
+}
+return positions;
+}
+
+int read_header_binary(const char* filename, BinaryHeader* header)
+{
+int ok;
+FILE* file = NULL;
+if(filename == NULL || header == NULL) return 0;
+file = fopen(filename, "rb");
+if(file == NULL) return 0;
+ok = (fread(header, sizeof(BinaryHeader), 1, file) == 1) && __valid_header_(header, 0);
+fclose(file);
+return ok;
+}
+
+Matrix* load_matrix_binary(const char* filename)
+{
+int i, j, r, c;
+size_t count;
+BinaryHeader header;
+Matrix* m = NULL;
+Matrix* t = NULL;
+FILE* file = NULL;
+if(filename == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+if(fread(&header, sizeof(header), 1, file) != 1 || !__valid_header_(&header, 0) ||
+fseek(file, (long)header._offset, SEEK_SET) != 0)
+{
+	fclose(file);
+	return NULL;
+}
+r = (int)header._rows;
+c = (int)header._columns;
+count = (size_t)r * c;
+m = (header._layout == BINARY_ROW_MAJOR) ? create_matrix(r, c) : create_matrix(c, r);
+if(((header._flags & BINARY_COMPRESSED) ? !__read_compressed_(file, &header, m->_data) : fread(m->_data, sizeof(double), count, file) != count) ||
+(!(header._flags & BINARY_UNCHECKED) && checksum_binary(m->_data, count) != header._checksum))
+{
+	/* release previously allocated memory */
+	destroy_matrix(m);
+	fclose(file);
+	return NULL;
+}
+fclose(file);
+if(header._layout == BINARY_COLUMN_MAJOR)
+{
+	/* the entries were read as the transpose */
+	t = create_matrix(r, c);
+	for(i = 0; i < r; i++)
+	{
+		for(j = 0; j < c; j++) t->_data[(size_t)i*c+j] = m->_data[(size_t)j*r+i];
+	}
+	destroy_matrix(m);
+	m = t;
+}
+return m;
+}
+
+const Matrix* map_matrix(const char* filename, int verify)
+{
+void* address = NULL;
+size_t length;
+const BinaryHeader* header = NULL;
+address = __map_file_(filename, &length);
+if(address == NULL) return NULL;
+header = (const BinaryHeader*)address;
+if(length < sizeof(BinaryHeader) || !__valid_header_(header, length) || header->_layout != BINARY_ROW_MAJOR || (header->_flags & BINARY_COMPRESSED) ||
+(verify && !(header->_flags & BINARY_UNCHECKED) && checksum_binary((const double*)((const char*)address + header->_offset), (size_t)(header->_rows * header->_columns)) != header->_checksum))
+{
+	/* release previously allocated memory */
+	__unmap_file_(address, length);
+	return NULL;
+}
+return __mapped_matrix_(address, length, header->_offset, (int)header->_rows, (int)header->_columns);
+}
+
+const Matrix* map_array_matrix(const char* filename, uint64_t offset, int rows, int columns)
+{
+void* address = NULL;
+size_t length;
+if(rows < 1 || columns < 1 || offset % sizeof(double) != 0) return NULL;
+address = __map_file_(filename, &length);
+if(address == NULL) return NULL;
+if((uint64_t)length < offset + (uint64_t)rows * columns * sizeof(double))
+{
+	__unmap_file_(address, length);
+	return NULL;
+}
+return __mapped_matrix_(address, length, offset, rows, columns);
+}
+
+void unmap_matrix(const Matrix* m)
+{
+MappedMatrix* mm = (MappedMatrix*)m;
+if(mm == NULL) return;
+__unmap_file_(mm->_address, mm->_length);
+RELEASE(mm);
+mm = NULL;
+}
+
+/* END */
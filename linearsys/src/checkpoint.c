@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checkpoint.h"
+#include "allocator.h"
+#include "binio.h"
+
+#define TEMPORARY_SUFFIX ".tmp"
+
+/* implementation */
+
+int save_checkpoint(const char* filename, uint32_t method, uint32_t phase, uint64_t source, uint64_t iteration, const double* state, size_t count)
+{
+int ok;
+SnapshotHeader h;
+char* temporary = NULL;
+FILE* file = NULL;
+if(filename == NULL || (state == NULL && count > 0)) return 0;
+memset(&h, 0, sizeof(h));
+memcpy(h._magic, CHECKPOINT_MAGIC, 8);
+h._version = CHECKPOINT_VERSION;
+h._endian = BINARY_ENDIAN;
+h._method = method;
+h._phase = phase;
+h._source = source;
+h._iteration = iteration;
+h._count = (uint64_t)count;
+h._checksum = checksum_binary(state, count);
+temporary = (char*)ALLOCATE(strlen(filename) + strlen(TEMPORARY_SUFFIX) + 1);
+strcpy(temporary, filename);
+strcat(temporary, TEMPORARY_SUFFIX);
+file = fopen(temporary, "wb");
+ok = (file != NULL);
+if(ok) ok = (fwrite(&h, sizeof(h), 1, file) == 1 && (count == 0 || fwrite(state, sizeof(double), count, file) == count));
+if(file != NULL && fclose(file) != 0) ok = 0;
+/* the complete snapshot replaces the previous one */
+if(ok)
+{
+	#ifdef _WIN32
+	remove(filename); /* rename does not replace a file in Windows */
+	#endif
+	ok = (rename(temporary, filename) == 0);
+}
+if(!ok) remove(temporary);
+RELEASE(temporary);
+return ok;
+}
+
+double* load_checkpoint(const char* filename, uint32_t method, uint64_t source, SnapshotHeader* header)
+{
+int ok;
+double* state = NULL;
+FILE* file = NULL;
+if(filename == NULL || header == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+ok = (fread(header, sizeof(SnapshotHeader), 1, file) == 1 && memcmp(header->_magic, CHECKPOINT_MAGIC, 8) == 0 &&
+header->_version == CHECKPOINT_VERSION && header->_endian == BINARY_ENDIAN && header->_method == method &&
+header->_source == source && header->_count < ((uint64_t)1 << 40));
+if(ok)
+{
+	state = (double*)ALLOCATE((size_t)((header->_count > 0) ? header->_count : 1) * sizeof(double));
+	ok = (fread(state, sizeof(double), (size_t)header->_count, file) == header->_count &&
+	checksum_binary(state, (size_t)header->_count) == header->_checksum);
+	if(!ok)
+	{
+		RELEASE(state);
+		state = NULL;
+	}
+}
+fclose(file);
+return state;
+}
+
+void remove_checkpoint(const char* filename)
+{
+if(filename != NULL) remove(filename);
+}
+
+/* END */
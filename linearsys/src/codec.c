@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "codec.h"
+#include "allocator.h"
+
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+#define HASH_BITS 14
+#define LAST_LITERALS 8 /* no match starts in the last bytes, so the hashed reads stay in the input */
+#define SKIP_BITS 8 /* the search step grows by one every 256 bytes without a match */
+
+/*
+* Every sequence starts with a token byte: the number of literals in its upper half and the length of the match
+* minus MIN_MATCH in its lower half; a 15 means that more bytes follow, each one adding up to 255.
+* Then come the literals, the offset of the match ( two bytes, little endian ) and the rest of its length.
+* The last sequence has only literals.
+*/
+
+/*
+* Helper functions.
+*/
+
+static uint32_t __read32_(const unsigned char* p)
+{
+uint32_t v;
+memcpy(&v, p, 4);
+return v;
+}
+
+static uint32_t __hash_(uint32_t v)
+{
+return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/*
+* Writes the extra bytes of a length.
+*/
+static unsigned char* __write_length_(unsigned char* op, size_t length)
+{
+while(length >= 255)
+{
+	*op++ = 255;
+	length -= 255;
+}
+*op++ = (unsigned char)length;
+return op;
+}
+
+/*
+* Reads the extra bytes of a length.
+* returns: 0 if the input ends before the length does.
+*/
+static int __read_length_(const unsigned char** ip, const unsigned char* end, size_t* length)
+{
+unsigned char c;
+do
+{
+	if(*ip >= end) return 0;
+	c = *(*ip)++;
+	*length += c;
+}
+while(c == 255);
+return 1;
+}
+
+/*
+* Writes a sequence; match is 0 for the last one.
+* returns: the new output position or NULL if it does not fit.
+*/
+static unsigned char* __sequence_(unsigned char* op, unsigned char* end, const unsigned char* literals, size_t count, size_t offset, size_t match)
+{
+unsigned char* token = op;
+if((size_t)(end - op) < 1 + count + count/255 + 1 + 2 + match/255 + 1) return NULL;
+op++;
+*token = (unsigned char)(((count < 15) ? count : 15) << 4);
+if(count >= 15) op = __write_length_(op, count - 15);
+memcpy(op, literals, count);
+op += count;
+if(match == 0) return op;
+*op++ = (unsigned char)(offset & 0xFF);
+*op++ = (unsigned char)(offset >> 8);
+match -= MIN_MATCH;
+*token |= (unsigned char)((match < 15) ? match : 15);
+if(match >= 15) op = __write_length_(op, match - 15);
+return op;
+}
+
+/* end helper functions */
+
+/* implementation */
+
+size_t bound_codec(size_t n)
+{
+return n + n / 255 + 16;
+}
+
+size_t compress_codec(const void* in, size_t n, void* out, size_t capacity)
+{
+const unsigned char* src = (const unsigned char*)in;
+unsigned char* op = (unsigned char*)out;
+unsigned char* end = op + capacity;
+size_t ip, anchor, ref, length, limit;
+uint32_t h;
+uint32_t* table = (uint32_t*)ALLOCATE(((size_t)1 << HASH_BITS) * sizeof(uint32_t));
+/* positions are stored plus one, so zero means empty */
+memset(table, 0, ((size_t)1 << HASH_BITS) * sizeof(uint32_t));
+ip = 0;
+anchor = 0;
+limit = (n > LAST_LITERALS + MIN_MATCH) ? n - LAST_LITERALS - MIN_MATCH : 0;
+while(op != NULL && ip < limit)
+{
+	h = __hash_(__read32_(src + ip));
+	ref = table[h];
+	table[h] = (uint32_t)(ip + 1);
+	if(ref == 0 || ip + 1 - ref > MAX_OFFSET || __read32_(src + ref - 1) != __read32_(src + ip))
+	{
+		/* the step grows along data which does not compress */
+		ip += 1 + ((ip - anchor) >> SKIP_BITS);
+		continue;
+	}
+	ref--;
+	length = MIN_MATCH;
+	while(ip + length < n - LAST_LITERALS && src[ref + length] == src[ip + length]) length++;
+	op = __sequence_(op, end, src + anchor, ip - anchor, ip - ref, length);
+	ip += length;
+	anchor = ip;
+}
+if(op != NULL) op = __sequence_(op, end, src + anchor, n - anchor, 0, 0);
+RELEASE(table);
+return (op == NULL) ? 0 : (size_t)(op - (unsigned char*)out);
+}
+
+int decompress_codec(const void* in, size_t n, void* out, size_t size)
+{
+const unsigned char* ip = (const unsigned char*)in;
+const unsigned char* end = ip + n;
+unsigned char* dst = (unsigned char*)out;
+size_t op = 0, count, offset, match;
+unsigned char token;
+while(ip < end)
+{
+	token = *ip++;
+	count = token >> 4;
+	if(count == 15 && !__read_length_(&ip, end, &count)) return 0;
+	if(count > (size_t)(end - ip) || count > size - op) return 0;
+	/* short runs are copied as 16 bytes when there is room, which is faster than a copy of variable size */
+	if(count <= 16 && end - ip >= 16 && size - op >= 16) memcpy(dst + op, ip, 16);
+	else memcpy(dst + op, ip, count);
+	ip += count;
+	op += count;
+	/* the last sequence has no match */
+	if(ip == end) break;
+	if(end - ip < 2) return 0;
+	offset = ip[0] | ((size_t)ip[1] << 8);
+	ip += 2;
+	match = token & 15;
+	if(match == 15 && !__read_length_(&ip, end, &match)) return 0;
+	match += MIN_MATCH;
+	if(offset == 0 || offset > op || match > size - op) return 0;
+	if(offset >= 16 && match <= 16 && size - op >= 16) memcpy(dst + op, dst + op - offset, 16);
+	else if(offset >= match) memcpy(dst + op, dst + op - offset, match);
+	else
+	{
+		/* the match overlaps the bytes it produces, so it is copied in pieces of offset bytes */
+		for(; match > offset; match -= offset, op += offset) memcpy(dst + op, dst + op - offset, offset);
+		memcpy(dst + op, dst + op - offset, match);
+	}
+	op += match;
+}
+return op == size;
+}
+
+void shuffle_codec(const void* in, size_t count, size_t width, void* out)
+{
+size_t i, b;
+const unsigned char* src = (const unsigned char*)in;
+unsigned char* dst = (unsigned char*)out;
+for(i = 0; i < count; i++)
+{
+	for(b = 0; b < width; b++) dst[b*count + i] = src[i*width + b];
+}
+}
+
+void unshuffle_codec(const void* in, size_t count, size_t width, void* out)
+{
+size_t i, b;
+const unsigned char* src = (const unsigned char*)in;
+unsigned char* dst = (unsigned char*)out;
+for(i = 0; i < count; i++)
+{
+	for(b = 0; b < width; b++) dst[i*width + b] = src[b*count + i];
+}
+}
+
+/* END */
@@ -20,30 +20,48 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include "eigen.h"
 #include "diagonalization.h"
+#include "allocator.h"
+#include "instrument.h"
+
+#define DEFECTIVE_TOLERANCE 1E-8 /* relative residual of an eigenpair above which the matrix is taken as defective */
 
 /*
-* Helper private function to check for eigen value multiplicity.
+* Helper private function to check for a defective matrix.
+* eigen_system gives orthogonal eigenvectors for a repeated eigenvalue, so a matrix with fewer independent
+* eigenvectors than the multiplicity of an eigenvalue shows up as an eigenpair with a large residual m*v - value*v,
+* or, when rounding splits the repeated eigenvalue, as two parallel eigenvectors.
 */
-static int multiplicity(const double* v, int n)
+static int defective(const Matrix* m, const EigenSystem* eigsys)
+{
+int i, j, k, n;
+double scale, r, s;
+const double* v = NULL;
+const double* w = NULL;
+n = rows_matrix(m);
+scale = 0.0;
+for(i = 0; i < n*n; i++) if(fabs(m->_data[i]) > scale) scale = fabs(m->_data[i]);
+for(k = 0; k < size_eigensystem(eigsys); k++)
 {
-int i, j, retval;
-double current;
-retval = 0;
-for(i = 0; i < n-1; i++)
+v = eigen_vector(eigen_eigensystem(eigsys)[k])->_data;
+r = 0.0;
+for(i = 0; i < n; i++)
 {
-current = v[i];
-for(j = i+1; j < n; j++)
+	s = -eigen_value(eigen_eigensystem(eigsys)[k]) * v[i];
+	for(j = 0; j < n; j++) s += m->_data[i*n+j] * v[j];
+	if(fabs(s) > r) r = fabs(s);
+}
+if(r > DEFECTIVE_TOLERANCE * scale) return 1;
+for(j = 0; j < k; j++)
 {
-	if(v[j] == current)
-	{
-		retval = 1;
-		break;
-	}
+	w = eigen_vector(eigen_eigensystem(eigsys)[j])->_data;
+	for(s = 0.0, i = 0; i < n; i++) s += v[i] * w[i];
+	if(fabs(s) > 1.0 - DEFECTIVE_TOLERANCE) return 1;
 }
 }
-return retval;
+return 0;
 }
 
 /* End helper functions */
@@ -56,13 +74,13 @@ if(diag == NULL) return;
 if(diagonalization_p(diag) != NULL) destroy_matrix(diagonalization_p(diag));
 if(diagonalization_d(diag) != NULL) destroy_matrix(diagonalization_d(diag));
 if(diagonalization_pt(diag) != NULL) destroy_matrix(diagonalization_pt(diag));
-free(diag);
+RELEASE(diag);
 diag = NULL;
 }
 
 Diagonalization* clone_diagonalization(const Diagonalization* diag)
 {
-Diagonalization* out = (Diagonalization*)malloc(sizeof(Diagonalization));
+Diagonalization* out = (Diagonalization*)ALLOCATE(sizeof(Diagonalization));
 diagonalization_p(out) = clone_matrix(diagonalization_p(diag));
 diagonalization_d(out) = clone_matrix(diagonalization_d(diag));
 diagonalization_pt(out) = clone_matrix(diagonalization_pt(diag));
@@ -75,36 +93,52 @@ int i, n;
 double* x = NULL;
 Matrix* p = NULL;
 Matrix* d = NULL;
+Matrix* t = NULL;
+Vector* v = NULL;
 EigenSystem* eigsys = NULL;
 Diagonalization* diag = NULL;
 if(m == NULL) return NULL;
 n = rows_matrix(m);
 if(n != columns_matrix(m)) return NULL; /* m must be square */
+INSTRUMENT_BEGIN;
 eigsys = eigen_system(m);
-if(eigsys == NULL) return NULL; /* fat chance */
+if(eigsys == NULL)
+{
+INSTRUMENT_END(INSTRUMENT_DIAGONALIZE_MATRIX, 0.0);
+return NULL; /* fat chance */
+}
 n = size_eigensystem(eigsys);
-x = (double*)malloc(n * sizeof(double));
+x = (double*)ALLOCATE(n * sizeof(double));
 for(i = 0; i < n; i++) x[i] = eigen_value(eigen_eigensystem(eigsys)[i]);
-if(multiplicity(x, n)) return NULL;
+if(defective(m, eigsys))
+{
+RELEASE(x);
+destroy_eigensystem(eigsys);
+INSTRUMENT_END(INSTRUMENT_DIAGONALIZE_MATRIX, 0.0);
+return NULL;
+}
 p = create_matrix(n, n);
 d = create_matrix(n, n);
 for(i = 0; i < n; i++)
 {
 set_matrix(d, x[i], i, i);
-p = set_column_matrix(p, normalize_vector(eigen_vector(eigen_eigensystem(eigsys)[i])), i);
+v = normalize_vector(eigen_vector(eigen_eigensystem(eigsys)[i]));
+t = set_column_matrix(p, v, i);
+destroy_vector(v);
+destroy_matrix(p);
+p = t;
 }
 /* create and build diagonalization */
-diag = (Diagonalization*)malloc(sizeof(Diagonalization));
-diagonalization_p(diag) = clone_matrix(p);
-diagonalization_d(diag) = clone_matrix(d);
+diag = (Diagonalization*)ALLOCATE(sizeof(Diagonalization));
+diagonalization_p(diag) = p;
+diagonalization_d(diag) = d;
 diagonalization_pt(diag) = transpose_matrix(p);
 
 /* release previously allocated memory */
-free(x);
-destroy_matrix(p);
-destroy_matrix(d);
+RELEASE(x);
 destroy_eigensystem(eigsys);
 
+INSTRUMENT_END(INSTRUMENT_DIAGONALIZE_MATRIX, 0.0);
 return diag; /* done */
 }
 
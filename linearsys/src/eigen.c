@@ -20,31 +20,35 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <time.h>
 #include "qr.h"
+#include "lu.h"
+#include "linearsys.h"
+#include "kernel.h"
 #include "eigen.h"
+#include "allocator.h"
+#include "binio.h"
+#include "checkpoint.h"
+#include "instrument.h"
 
 
-#define THRESHOLD 1E-3
 #define MAX_ITERATIONS 50000
+#define JACOBI_MAX_SWEEPS 100
+#define EPSILON 2.220446049250313E-16 /* double precision machine epsilon */
+#define INVERSE_TOLERANCE 1E-12 /* default relative residual for inverse iteration */
+#define INVERSE_MAX_ITERATIONS 100
+#define EIGENVECTOR_ITERATIONS 10 /* inverse iteration steps to recover an eigenvector in eigen_system */
+#define CLUSTER_TOLERANCE 1E-8 /* relative distance of eigenvalues whose eigenvectors are kept orthogonal in eigen_system */
+#define SHIFT_TRIES 12
+#define POWER_TOLERANCE 1E-10 /* residual |m*x - value*x| ( related to the norm of m ) to stop the power method */
+#define SUBSPACE_TOLERANCE 1E-10 /* default relative residual for subspace iteration */
+#define SUBSPACE_MAX_ITERATIONS 10000
+#define SUBSPACE_RETRIES 10
 
 /*
 * helper functions.
 */
-static void randomize()
-{
-/* Use the system's time as a seed */
-srand((unsigned)time(NULL));
-}
-
-static int random(int min, int max)
-{
-	int result, range;
-	if(min >= max) return 0;
-	range = (max - min) + 1;
-	return (rand() % range) + min;
-}
-
 static double abs_value(double x)
 {
 return (x < 0.0) ? -x : x;
@@ -61,71 +65,308 @@ for(i = 0; i < rows_matrix(m); i++)
 return ret;
 }
 
-static Matrix* upper_triangular(const Matrix* m)
+/*
+* Computes the infinity norm of a matrix ( maximum absolute row sum ),
+* used to turn relative tolerances into absolute ones.
+*/
+static double norm_matrix(const Matrix* m)
 {
-int n, row;
-int i, j, k;
-double pivot, tmp, remove, t;
-Matrix* upper = NULL;
-if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
-upper = clone_matrix(m);
-n = rows_matrix(upper);
-i = 0;
-while(i < n)
+int i, j, n;
+double sum, norm = 0.0;
+n = columns_matrix(m);
+for(i = 0; i < rows_matrix(m); i++)
+{
+	sum = 0.0;
+	for(j = 0; j < n; j++) sum += abs_value(m->_data[i*n+j]);
+	if(sum > norm) norm = sum;
+}
+return (norm > 0.0) ? norm : 1.0;
+}
+
+/*
+* Fills a vector with a fixed start vector for inverse iteration.
+* Its entries do not follow any pattern, so it is not orthogonal to an eigenvector in practice.
+*/
+static void start_vector(Vector* x)
+{
+int i;
+for(i = 0; i < x->_size; i++) x->_data[i] = 1.0 + 0.5 * sin(1.0 + i);
+}
+
+/*
+* Scales a vector to unit length with its largest component positive.
+*/
+static void normalize(Vector* x)
 {
-pivot = abs_value(upper->_data[i*n+i]);
-row = i;
-for(k = i+1; k < n; k++)
+int i, major = 0;
+double norm = 0.0;
+for(i = 0; i < x->_size; i++)
 {
-if(abs_value(upper->_data[k*n]) > pivot)
+	norm += x->_data[i] * x->_data[i];
+	if(abs_value(x->_data[i]) > abs_value(x->_data[major])) major = i;
+}
+norm = sqrt(norm);
+if(norm == 0.0) return;
+if(x->_data[major] < 0.0) norm = -norm;
+for(i = 0; i < x->_size; i++) x->_data[i] /= norm;
+}
+
+/*
+* Computes the Rayleigh quotient x'*m*x of a unit vector x
+* and the norm of the residual m*x - value*x.
+*/
+static double rayleigh_quotient(const Matrix* m, const Vector* x, double* residual)
+{
+int i, j, n;
+double value, r;
+double* y = NULL;
+n = x->_size;
+y = (double*)ALLOCATE(n * sizeof(double));
+value = 0.0;
+for(i = 0; i < n; i++)
 {
-	pivot = abs_value(upper->_data[k*n]);
-	row = k;
+	y[i] = 0.0;
+	for(j = 0; j < n; j++) y[i] += m->_data[i*n+j] * x->_data[j];
+	value += x->_data[i] * y[i];
 }
+r = 0.0;
+for(i = 0; i < n; i++) r += (y[i] - value*x->_data[i]) * (y[i] - value*x->_data[i]);
+*residual = sqrt(r);
+RELEASE(y);
+return value;
 }
-if(i != row)
+
+/*
+* Computes the LU decomposition of m - shift*I.
+* When the shift is an eigenvalue to working precision the matrix is singular,
+* so the shift is moved away by a small amount ( growing on each try ) until it can be factorized;
+* inverse iteration still converges fast since the shift remains very close to the eigenvalue.
+*/
+static LU* shifted_lu(const Matrix* m, double shift, double scale)
 {
-for(j = 0; j < n; j++)
+int i, k, n;
+double delta = 0.0;
+Matrix* a = NULL;
+LU* lu = NULL;
+n = rows_matrix(m);
+for(k = 0; k <= SHIFT_TRIES; k++)
+{
+	a = clone_matrix(m);
+	for(i = 0; i < n; i++) a->_data[i*n+i] -= shift + delta;
+	lu = lu_decomposition(a);
+	destroy_matrix(a);
+	if(lu != NULL) break;
+	delta = (delta == 0.0) ? 1E-10 * scale : 10.0 * delta;
+}
+return lu;
+}
+
+/*
+* Gram-Schmidt: removes from x the eigenvectors in found whose eigenvalues are within cluster of shift.
+* When x is almost in their span, what is left after a pass is mostly rounding error, so a second pass is done.
+*/
+static void orthogonalize(Vector* x, Eigen** found, int count, double shift, double cluster)
+{
+int i, j, pass;
+double d;
+Vector* q = NULL;
+for(pass = 0; pass < 2; pass++)
+for(j = 0; j < count; j++)
+{
+	if(abs_value(eigen_value(found[j]) - shift) > cluster) continue;
+	q = eigen_vector(found[j]);
+	for(d = 0.0, i = 0; i < x->_size; i++) d += q->_data[i] * x->_data[i];
+	for(i = 0; i < x->_size; i++) x->_data[i] -= d * q->_data[i];
+}
+}
+
+/*
+* Performs inverse iteration steps x = (m - shift*I)^-1 * x with a factorized shifted matrix.
+* The vector x is updated in place ( normalized ) and value gets its Rayleigh quotient.
+* The eigenvectors in found whose eigenvalues are within cluster of the shift are removed from x
+* before and after every step, otherwise a repeated eigenvalue would give the same eigenvector again and again.
+*
+* returns: the number of steps done if the residual goes below tolerance within max_iterations steps, 0 otherwise.
+*/
+static int inverse_steps(const Matrix* m, const LU* lu, Vector* x, double* value, double tolerance, int max_iterations, Eigen** found, int count, double cluster)
 {
-	tmp = upper->_data[i*n+j];
-	upper->_data[i*n+j] = upper->_data[row*n+j];
-	upper->_data[row*n+j] = tmp;
+int i, k;
+double residual, shift;
+Vector* y = NULL;
+shift = *value;
+for(k = 0; k < max_iterations; k++)
+{
+	orthogonalize(x, found, count, shift, cluster);
+	y = lu_system_solver(lu, x);
+	for(i = 0; i < x->_size; i++) x->_data[i] = y->_data[i];
+	destroy_vector(y);
+	orthogonalize(x, found, count, shift, cluster);
+	normalize(x);
+	*value = rayleigh_quotient(m, x, &residual);
+	if(residual <= tolerance) return k+1; /* done */
 }
+return 0;
 }
-for(j = i+1; j < n; j++)
+
+/*
+* Applies a Jacobi rotation in the plane (p, q) to a symmetric matrix a ( both sides )
+* and to the columns of the accumulated eigenvectors v, so that a(p, q) becomes zero.
+*/
+static void jacobi_rotate(double* a, double* v, int n, int p, int q)
+{
+int k;
+double theta, t, c, s, x, y;
+theta = (a[q*n+q] - a[p*n+p]) / (2.0 * a[p*n+q]);
+t = ((theta >= 0.0) ? 1.0 : -1.0) / (abs_value(theta) + sqrt(theta*theta + 1.0));
+c = 1.0 / sqrt(t*t + 1.0);
+s = t * c;
+for(k = 0; k < n; k++)
 {
-remove = -(upper->_data[j*n+i]) / upper->_data[i*n+i];
+	x = a[k*n+p];
+	y = a[k*n+q];
+	a[k*n+p] = c*x - s*y;
+	a[k*n+q] = s*x + c*y;
+}
 for(k = 0; k < n; k++)
 {
-t = upper->_data[j*n+k]+remove*upper->_data[i*n+k];
-upper->_data[j*n+k] = t;
+	x = a[p*n+k];
+	y = a[q*n+k];
+	a[p*n+k] = c*x - s*y;
+	a[q*n+k] = s*x + c*y;
 }
+a[p*n+q] = 0.0;
+a[q*n+p] = 0.0;
+for(k = 0; k < n; k++)
+{
+	x = v[k*n+p];
+	y = v[k*n+q];
+	v[k*n+p] = c*x - s*y;
+	v[k*n+q] = s*x + c*y;
 }
-i++;
 }
-set_matrix(upper, 1.0, n-1, n-1);
-return upper;
+
+/*
+* Diagonalizes a symmetric n x n array in place using cyclic Jacobi sweeps.
+* The rotations are accumulated into the columns of v, which must be the identity on entry.
+*
+* returns: the number of sweeps done.
+*/
+static int jacobi_sweeps(double* a, double* v, int n)
+{
+int i, j, p, q, sweep;
+double off, diag;
+for(sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++)
+{
+	off = 0.0;
+	diag = 0.0;
+	for(i = 0; i < n; i++)
+	{
+		diag += a[i*n+i] * a[i*n+i];
+		for(j = i+1; j < n; j++) off += a[i*n+j] * a[i*n+j];
+	}
+	if(off == 0.0 || off <= EPSILON * EPSILON * diag) break; /* done */
+	for(p = 0; p < n-1; p++)
+	{
+		for(q = p+1; q < n; q++)
+		{
+			if(a[p*n+q] == 0.0) continue;
+			/* skip entries which are negligible against both diagonal entries */
+			if(abs_value(a[p*n+q]) <= EPSILON * abs_value(a[p*n+p]) &&
+			abs_value(a[p*n+q]) <= EPSILON * abs_value(a[q*n+q]))
+			{
+				a[p*n+q] = 0.0;
+				a[q*n+p] = 0.0;
+				continue;
+			}
+			jacobi_rotate(a, v, n, p, q);
+		}
+	}
+}
+return sweep;
 }
 
 /*
-* Function to solve upper system.
+* Fills the rows of a b x n block with start vectors for subspace iteration.
 */
-static Vector* upper_system_solver(const Matrix* m, const Vector* v)
+static void start_block(double* v, int b, int n)
 {
-int i,j;
-Vector* x = create_vector(v->_size);
-int n = rows_matrix(m);
-x->_data[n-1] = v->_data[n-1] / m->_data[(n-1)*m->_columns+(n-1)];
-for(i = n-2; i >= 0; i--)
+int i, j;
+for(i = 0; i < b; i++)
+{
+	for(j = 0; j < n; j++) v[(size_t)i*n+j] = sin(1.0 + j + (double)i*n);
+}
+}
+
+/*
+* Orthonormalizes the rows of a b x n block in place using modified Gram-Schmidt twice.
+* A row which becomes linearly dependent on the previous ones is replaced by a start vector.
+*/
+static void orthonormalize_block(double* v, int b, int n)
 {
-x->_data[i] = v->_data[i];
-for(j = i+1; j < n; j++)
+int i, j, k, pass, retry = 0;
+double d, norm, before;
+double* vi = NULL;
+for(i = 0; i < b; i++)
 {
-x->_data[i] -= m->_data[i*m->_columns+j] * x->_data[j];
+	vi = v + (size_t)i*n;
+	before = 0.0;
+	for(k = 0; k < n; k++) before += vi[k] * vi[k];
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(j = 0; j < i; j++)
+		{
+			d = 0.0;
+			for(k = 0; k < n; k++) d += vi[k] * v[(size_t)j*n+k];
+			for(k = 0; k < n; k++) vi[k] -= d * v[(size_t)j*n+k];
+		}
+	}
+	norm = 0.0;
+	for(k = 0; k < n; k++) norm += vi[k] * vi[k];
+	if((norm <= EPSILON * before || norm == 0.0) && retry < SUBSPACE_RETRIES)
+	{
+		/* restart this row, it is almost in the span of the previous ones */
+		retry++;
+		for(k = 0; k < n; k++) vi[k] = sin(1.0 + k * (i + 2.0 + retry) + b);
+		i--;
+		continue;
+	}
+	retry = 0;
+	norm = sqrt(norm);
+	if(norm == 0.0) continue;
+	for(k = 0; k < n; k++) vi[k] /= norm;
 }
-x->_data[i] /= m->_data[i*m->_columns+i];
 }
-return x;
+
+/*
+* Applies a Chebyshev polynomial filter of a given degree to the rows of a b x n block v,
+* damping the eigenvalues of the symmetric matrix m in [-cut, cut]
+* and amplifying those outside, scaled to be 1 at bound.
+* The three-term recurrence uses y and t as work blocks; the filtered block is left in v.
+*/
+static void chebyshev_filter(const Matrix* m, double* v, double* y, double* t, int b, int n, int degree, double cut, double bound)
+{
+int i, k;
+size_t size = (size_t)b*n;
+double sigma, sigma1, sigma2;
+double* x = v;
+double* swap = NULL;
+sigma1 = cut / bound;
+sigma = sigma1;
+/* y = A*x / cut */
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, b, n, n, sigma1 / cut, x, n, m->_data, n, 0.0, y, n);
+for(k = 2; k <= degree; k++)
+{
+	sigma2 = 1.0 / (2.0/sigma1 - sigma);
+	/* t = 2*A*y / cut - x, scaled */
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, b, n, n, 2.0 * sigma2 / cut, y, n, m->_data, n, 0.0, t, n);
+	for(i = 0; i < (int)size; i++) t[i] -= sigma * sigma2 * x[i];
+	swap = x;
+	x = y;
+	y = t;
+	t = swap;
+	sigma = sigma2;
+}
+if(y != v) for(i = 0; i < (int)size; i++) v[i] = y[i];
 }
 
 /* end helper functions */
@@ -134,7 +375,7 @@ return x;
 
 Eigen* create_eigen(double value, const Vector* vector)
 {
-Eigen* eigen = (Eigen*)malloc(sizeof(Eigen));
+Eigen* eigen = (Eigen*)ALLOCATE(sizeof(Eigen));
 eigen_value(eigen) = value;
 eigen_vector(eigen) = clone_vector(vector);
 return eigen;
@@ -144,8 +385,8 @@ void destroy_eigen(Eigen* eigen)
 {
 if(eigen == NULL) return;
 eigen_value(eigen) = 0.0;
-if(eigen_vector(eigen) != NULL) free(eigen_vector(eigen));
-if(eigen != NULL) free(eigen);
+if(eigen_vector(eigen) != NULL) destroy_vector(eigen_vector(eigen));
+if(eigen != NULL) RELEASE(eigen);
 }
 
 Eigen* clone_eigen(const Eigen* eigen)
@@ -169,18 +410,23 @@ print_vector(eigen_vector(eigen));
 EigenSystem* create_eigensystem(int size)
 {
 	int i;
-EigenSystem* eigsys = (EigenSystem*)malloc(sizeof(EigenSystem));
+EigenSystem* eigsys = (EigenSystem*)ALLOCATE(sizeof(EigenSystem));
 eigsys->_size = size;
-eigsys->_eigen = (Eigen**)malloc(size*sizeof(Eigen*));
+eigsys->_eigen = (Eigen**)ALLOCATE(size*sizeof(Eigen*));
 for(i = 0; i < size; i++) eigsys->_eigen[i] = NULL;
 return eigsys;
 }
 
 void destroy_eigensystem(EigenSystem* eigsys)
 {
+	int i;
 if(eigsys == NULL) return;
-if(eigsys->_eigen != NULL) free(eigsys->_eigen);
-free(eigsys);
+if(eigsys->_eigen != NULL)
+{
+	for(i = 0; i < size_eigensystem(eigsys); i++) destroy_eigen(eigsys->_eigen[i]);
+	RELEASE(eigsys->_eigen);
+}
+RELEASE(eigsys);
 eigsys = NULL;
 }
 
@@ -210,110 +456,496 @@ for(i = 0; i < size_eigensystem(eigsys); i++)
 }
 
 Eigen* max_eigen_power_method(const Matrix* m)
+{
+return max_eigen_power_method_checkpoint(m, NULL, 0);
+}
+
+EigenSystem* eigen_system(const Matrix* m)
+{
+return eigen_system_checkpoint(m, NULL, 0);
+}
+
+Eigen* max_eigen_power_method_checkpoint(const Matrix* m, const char* filename, int interval)
 {
 	Eigen* eigen = NULL;
-	Matrix* a = NULL;
-	Matrix* b = NULL;
-Matrix* aux = NULL;
 Vector* eigenvector = NULL;
+SnapshotHeader h;
+double* x = NULL;
+double* y = NULL;
+double* state = NULL;
 double value = 0.0;
-double ant, lim;
-int i, j, n, major;
+double residual, scale;
+int i, j, k, n, major;
+uint64_t source = 0;
+time_t last;
 if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
-a = clone_matrix(m);
-n = columns_matrix(a);
-aux = create_matrix(n, 1);
-for(i = 0; i < n; i++) aux->_data[i] = 1.0;
+INSTRUMENT_BEGIN;
+n = columns_matrix(m);
+if(interval <= 0) interval = DEFAULT_CHECKPOINT_INTERVAL;
+scale = norm_matrix(m);
+/* both iterates are allocated once and reused on every iteration */
+x = (double*)ALLOCATE((n+1) * sizeof(double)); /* x[n] keeps the eigenvalue in the snapshots */
+y = (double*)ALLOCATE(n * sizeof(double));
+for(i = 0; i < n; i++) x[i] = 1.0;
 i = 1;
+if(filename != NULL)
+{
+	source = checksum_binary(m->_data, (size_t)n*n);
+	state = load_checkpoint(filename, CHECKPOINT_POWER_METHOD, source, &h);
+	if(state != NULL && h._count == (uint64_t)(n+1) && h._iteration < MAX_ITERATIONS)
+	{
+		/* go on from the snapshot */
+		for(j = 0; j < n; j++) x[j] = state[j];
+		value = state[n];
+		i = (int)h._iteration;
+	}
+	RELEASE(state);
+}
+last = time(NULL);
 do
 {
-ant = value;
-b = mul_matrix(a, aux);
-major = 0;
 for(j = 0; j < n; j++)
 {
-if(abs_value(b->_data[major]) < abs_value(b->_data[j])) major = j;
+	y[j] = 0.0;
+	for(k = 0; k < n; k++) y[j] += m->_data[j*n+k] * x[k];
 }
-value = b->_data[major];
+major = 0;
 for(j = 0; j < n; j++)
 {
-	b->_data[j] /= value;
+if(abs_value(y[major]) < abs_value(y[j])) major = j;
+}
+value = y[major];
+if(value == 0.0)
+{
+	i = MAX_ITERATIONS; /* x is in the null space of m */
+	break;
 }
-lim = abs_value(value - ant);
-if(lim < THRESHOLD) break; /* done */
+/*
+* x has its largest component equal to 1, so value is the eigenvalue estimate for x
+* and y - value*x is its residual; a small change of value alone does not mean convergence.
+*/
+residual = 0.0;
 for(j = 0; j < n; j++)
 {
-aux->_data[j] = b->_data[j];
+	if(abs_value(y[j] - value * x[j]) > residual) residual = abs_value(y[j] - value * x[j]);
+	x[j] = y[j] / value;
 }
+if(residual <= POWER_TOLERANCE * scale) break; /* done */
 i++;
-}while(i < MAX_ITERATIONS);
-if(i >= MAX_ITERATIONS)
+if(filename != NULL && difftime(time(NULL), last) >= interval)
 {
-destroy_matrix(a);
-destroy_matrix(b);
-destroy_matrix(aux);
-return NULL;
+	x[n] = value;
+	save_checkpoint(filename, CHECKPOINT_POWER_METHOD, 0, source, (uint64_t)i, x, (size_t)n+1);
+	last = time(NULL);
 }
+}while(i < MAX_ITERATIONS);
+if(i < MAX_ITERATIONS)
+{
 eigenvector = create_vector(n);
-for(i = 0; i < n; i++) set_vector(eigenvector, get_matrix(b, i, 0), i);
+for(j = 0; j < n; j++) eigenvector->_data[j] = x[j];
 eigen = create_eigen(value, eigenvector);
-
-destroy_matrix(a);
-destroy_matrix(b);
-destroy_matrix(aux);
 destroy_vector(eigenvector);
+}
+if(filename != NULL) remove_checkpoint(filename);
 
+/* release previously allocated memory */
+RELEASE(x);
+RELEASE(y);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_MAX_EIGEN_POWER_METHOD, i);
+INSTRUMENT_END(INSTRUMENT_MAX_EIGEN_POWER_METHOD, 2.0*n*n*i);
 return eigen;
 }
 
-EigenSystem* eigen_system(const Matrix* m)
+EigenSystem* eigen_system_checkpoint(const Matrix* m, const char* filename, int interval)
 {
-	double param;
-int i, j, k, n;
-Matrix* upper = NULL;
-Matrix* aux = NULL;
+	double value, scale;
+int i, j, k, n, start, known;
+SnapshotHeader h;
+Matrix* a = NULL;
 Matrix* lambda = NULL;
 Vector* v = NULL;
 EigenSystem* eigensys = NULL;
 QR* qr = NULL;
+LU* lu = NULL;
+double* state = NULL;
+double* values = NULL;
+uint64_t source = 0;
+time_t last;
 if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
-randomize(); /* init random to get param */
+INSTRUMENT_BEGIN;
 n = rows_matrix(m);
+if(interval <= 0) interval = DEFAULT_CHECKPOINT_INTERVAL;
 eigensys = create_eigensystem(n);
-qr = qr_factorization(m); /* get QR factorization of m */
-/* Compute eigenvalues */
+values = (double*)ALLOCATE((size_t)n*(n+2) * sizeof(double));
 k = 0;
-while(1)
+start = 0;
+known = 0; /* nonzero when the eigenvalues come from the snapshot */
+if(filename != NULL)
 {
-	qr = qr_factorization(mul_matrix(qr_r(qr), qr_q(qr)));
+	source = checksum_binary(m->_data, (size_t)n*n);
+	state = load_checkpoint(filename, CHECKPOINT_EIGEN_SYSTEM, source, &h);
+	if(state != NULL && h._phase == 0 && h._count == (uint64_t)n*n)
+	{
+		/* the snapshot has the matrix of the QR algorithm */
+		a = create_matrix(n, n);
+		for(i = 0; i < n*n; i++) a->_data[i] = state[i];
+		k = (int)h._iteration;
+	}
+	else if(state != NULL && h._phase == 1 && h._iteration <= (uint64_t)n && h._count == (uint64_t)n + h._iteration*(n+1))
+	{
+		/* the snapshot has the eigenvalues and the first eigenpairs */
+		start = (int)h._iteration;
+		known = 1;
+		for(i = 0; i < (int)h._count; i++) values[i] = state[i];
+	}
+	RELEASE(state);
+}
+last = time(NULL);
+if(!known)
+{
+	/* Compute eigenvalues */
+	if(a == NULL) a = clone_matrix(m);
+	qr = qr_factorization(a); /* get QR factorization of the matrix */
+	while(1)
+	{
+		destroy_matrix(a);
+		a = mul_matrix(qr_r(qr), qr_q(qr));
+		destroy_qr(qr);
+		qr = qr_factorization(a);
 		if(done(qr_q(qr)) || k > MAX_ITERATIONS) break;
 		k++;
+		if(filename != NULL && difftime(time(NULL), last) >= interval)
+		{
+			save_checkpoint(filename, CHECKPOINT_EIGEN_SYSTEM, 0, source, (uint64_t)k, a->_data, (size_t)n*n);
+			last = time(NULL);
+		}
+	}
+	/* eigenvalues are listed in the diagonal of lambda */
+	lambda = mul_matrix(qr_q(qr), qr_r(qr));
+	for(i = 0; i < n; i++) values[i] = get_matrix(lambda, i, i);
+	if(filename != NULL)
+	{
+		save_checkpoint(filename, CHECKPOINT_EIGEN_SYSTEM, 1, source, 0, values, (size_t)n);
+		last = time(NULL);
+	}
 }
-/* eigenvalues are listed in the diagonal of lambda */
-lambda = mul_matrix(qr_q(qr), qr_r(qr));
-aux = create_matrix(n, n);
+scale = norm_matrix(m);
 	v = create_vector(n);
-/* compute eigenvectors and build eigensystem */
-for(i = 0; i < n; i++)
+/* eigenpairs restored from the snapshot, stored as the eigenvalue followed by the eigenvector */
+for(i = 0; i < start; i++)
 {
-	for(j = 0; j < n; j++)
-	{
-	set_matrix(aux, get_matrix(lambda, i, i), j, j);
-}
-upper = upper_triangular(sub_matrix(m, aux));
-param = 1.0 / (double)random(1, 10);
-set_vector(v, param, n-1);
-eigensys->_eigen[i] = create_eigen(get_matrix(lambda, i, i),upper_system_solver(upper, v));
+	for(j = 0; j < n; j++) v->_data[j] = values[n + (size_t)i*(n+1) + 1 + j];
+	eigensys->_eigen[i] = create_eigen(values[n + (size_t)i*(n+1)], v);
 }
+/* compute eigenvectors by inverse iteration shifted by each eigenvalue and build eigensystem */
+for(i = start; i < n; i++)
+{
+	value = values[i];
+	lu = shifted_lu(m, value, scale);
+	start_vector(v);
+	if(lu != NULL)
+	{
+		/* the Rayleigh quotient refines the eigenvalue given by the QR algorithm */
+		inverse_steps(m, lu, v, &value, INVERSE_TOLERANCE * scale, EIGENVECTOR_ITERATIONS, eigensys->_eigen, i, CLUSTER_TOLERANCE * scale);
+		destroy_lu(lu);
+	}
+eigensys->_eigen[i] = create_eigen(value, v);
+	if(filename != NULL)
+	{
+		values[n + (size_t)i*(n+1)] = value;
+		for(j = 0; j < n; j++) values[n + (size_t)i*(n+1) + 1 + j] = v->_data[j];
+		if(i < n-1 && difftime(time(NULL), last) >= interval)
+		{
+			save_checkpoint(filename, CHECKPOINT_EIGEN_SYSTEM, 1, source, (uint64_t)i+1, values, (size_t)n + (size_t)(i+1)*(n+1));
+			last = time(NULL);
+		}
+	}
+}
+if(filename != NULL) remove_checkpoint(filename);
 /* release previously allocated memory */
-destroy_matrix(upper);
+RELEASE(values);
 destroy_matrix(lambda);
-destroy_matrix(aux);
+destroy_matrix(a);
 destroy_vector(v);
 destroy_qr(qr);
 
+INSTRUMENT_ITERATIONS(INSTRUMENT_EIGEN_SYSTEM, k);
+INSTRUMENT_END(INSTRUMENT_EIGEN_SYSTEM, 0.0);
+return eigensys;
+}
+
+Eigen* inverse_iteration(const Matrix* m, double shift, double tolerance, int max_iterations)
+{
+int k, n;
+double value, scale;
+Vector* x = NULL;
+Eigen* eigen = NULL;
+LU* lu = NULL;
+if(m == NULL) return NULL;
+if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
+INSTRUMENT_BEGIN;
+if(tolerance <= 0.0) tolerance = INVERSE_TOLERANCE;
+if(max_iterations <= 0) max_iterations = INVERSE_MAX_ITERATIONS;
+n = rows_matrix(m);
+scale = norm_matrix(m);
+/* factorize once, every step reuses the same LU */
+lu = shifted_lu(m, shift, scale);
+if(lu == NULL)
+{
+	INSTRUMENT_END(INSTRUMENT_INVERSE_ITERATION, 0.0);
+	return NULL;
+}
+x = create_vector(n);
+start_vector(x);
+value = shift;
+k = inverse_steps(m, lu, x, &value, tolerance * scale, max_iterations, NULL, 0, 0.0);
+if(k) eigen = create_eigen(value, x);
+else k = max_iterations;
+
+/* release previously allocated memory */
+destroy_lu(lu);
+destroy_vector(x);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_INVERSE_ITERATION, k);
+INSTRUMENT_END(INSTRUMENT_INVERSE_ITERATION, 2.0/3.0*n*n*n + 4.0*n*n*k);
+return eigen;
+}
+
+Eigen* rayleigh_quotient_iteration(const Matrix* m, const Vector* start, double shift, double tolerance, int max_iterations)
+{
+int k, n;
+double value, scale;
+Vector* x = NULL;
+Eigen* eigen = NULL;
+LU* lu = NULL;
+if(m == NULL) return NULL;
+if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
+n = rows_matrix(m);
+if(start != NULL && start->_size != n) return NULL;
+INSTRUMENT_BEGIN;
+if(tolerance <= 0.0) tolerance = INVERSE_TOLERANCE;
+if(max_iterations <= 0) max_iterations = INVERSE_MAX_ITERATIONS;
+scale = norm_matrix(m);
+value = shift;
+if(start != NULL)
+{
+	x = clone_vector(start);
+	normalize(x);
+}
+else
+{
+	/* steer the start vector towards the eigenvector closest to shift */
+	x = create_vector(n);
+	start_vector(x);
+	lu = shifted_lu(m, shift, scale);
+	if(lu == NULL)
+	{
+		destroy_vector(x);
+		INSTRUMENT_END(INSTRUMENT_RAYLEIGH_QUOTIENT_ITERATION, 0.0);
+		return NULL;
+	}
+	inverse_steps(m, lu, x, &value, tolerance * scale, 2, NULL, 0, 0.0);
+	destroy_lu(lu);
+}
+for(k = 0; k < max_iterations && eigen == NULL; k++)
+{
+	/* the shift is the current Rayleigh quotient, so the matrix is factorized on every step */
+	lu = shifted_lu(m, value, scale);
+	if(lu == NULL) break;
+	if(inverse_steps(m, lu, x, &value, tolerance * scale, 1, NULL, 0, 0.0)) eigen = create_eigen(value, x);
+	destroy_lu(lu);
+}
+
+/* release previously allocated memory */
+destroy_vector(x);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_RAYLEIGH_QUOTIENT_ITERATION, k);
+INSTRUMENT_END(INSTRUMENT_RAYLEIGH_QUOTIENT_ITERATION, (2.0/3.0*n*n*n + 4.0*n*n)*k);
+return eigen;
+}
+
+EigenSystem* subspace_iteration(const Matrix* m, int p, double tolerance, int max_iterations, int degree)
+{
+int i, j, k, n, b, best, converged;
+double scale, cut, r, d;
+double* work = NULL;
+double* v = NULL;
+double* w = NULL;
+double* t = NULL;
+double* h = NULL;
+double* q = NULL;
+double* theta = NULL;
+double* swap = NULL;
+int* order = NULL;
+Vector* x = NULL;
+EigenSystem* eigensys = NULL;
+if(m == NULL) return NULL;
+if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
+n = rows_matrix(m);
+if(p < 1 || p > n) return NULL;
+INSTRUMENT_BEGIN;
+if(tolerance <= 0.0) tolerance = SUBSPACE_TOLERANCE;
+if(max_iterations <= 0) max_iterations = SUBSPACE_MAX_ITERATIONS;
+/* a few guard vectors speed up convergence of the last wanted eigenpairs */
+b = p + ((p/2 > 2) ? p/2 : 2);
+if(b > n) b = n;
+scale = norm_matrix(m);
+/* all the workspace is allocated once: three n x b blocks ( vectors stored as rows ), two b x b matrices and the Ritz values */
+work = (double*)ALLOCATE((3*(size_t)b*n + 2*(size_t)b*b + b) * sizeof(double));
+order = (int*)ALLOCATE(b * sizeof(int));
+v = work;
+w = v + (size_t)b*n;
+t = w + (size_t)b*n;
+h = t + (size_t)b*n;
+q = h + (size_t)b*b;
+theta = q + (size_t)b*b;
+start_block(v, b, n);
+orthonormalize_block(v, b, n);
+for(k = 0; k < max_iterations; k++)
+{
+	/* w = v*A, that is A times each vector since A is symmetric */
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, b, n, n, 1.0, v, n, m->_data, n, 0.0, w, n);
+	/* Rayleigh-Ritz: h = v*A*v' projected matrix, diagonalized by Jacobi */
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_TRANS, b, b, n, 1.0, v, n, w, n, 0.0, h, b);
+	for(i = 0; i < b; i++)
+	{
+		for(j = i+1; j < b; j++)
+		{
+			d = 0.5 * (h[i*b+j] + h[j*b+i]);
+			h[i*b+j] = d;
+			h[j*b+i] = d;
+		}
+		for(j = 0; j < b; j++) t[i*b+j] = (i == j) ? 1.0 : 0.0;
+	}
+	jacobi_sweeps(h, t, b);
+	/* sort the Ritz values by decreasing magnitude */
+	for(i = 0; i < b; i++) order[i] = i;
+	for(i = 0; i < b; i++)
+	{
+		best = i;
+		for(j = i+1; j < b; j++) if(abs_value(h[order[j]*b+order[j]]) > abs_value(h[order[best]*b+order[best]])) best = j;
+		j = order[i];
+		order[i] = order[best];
+		order[best] = j;
+	}
+	/* q has the sorted Ritz coefficients as rows */
+	for(i = 0; i < b; i++)
+	{
+		theta[i] = h[order[i]*b+order[i]];
+		for(j = 0; j < b; j++) q[i*b+j] = t[j*b+order[i]];
+	}
+	/* Ritz vectors v = q*v and their images w = q*w */
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, b, n, b, 1.0, q, b, v, n, 0.0, t, n);
+	swap = v;
+	v = t;
+	t = swap;
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, b, n, b, 1.0, q, b, w, n, 0.0, t, n);
+	swap = w;
+	w = t;
+	t = swap;
+	/* count the leading Ritz pairs with a small residual |A*x - theta*x| */
+	for(converged = 0; converged < p; converged++)
+	{
+		r = 0.0;
+		for(j = 0; j < n; j++)
+		{
+			d = w[(size_t)converged*n+j] - theta[converged] * v[(size_t)converged*n+j];
+			r += d * d;
+		}
+		if(sqrt(r) > tolerance * scale) break;
+	}
+	if(converged == p) break; /* done */
+	cut = abs_value(theta[b-1]);
+	if(degree > 1 && cut > 0.0 && cut < scale)
+	{
+		/* damp the unwanted part of the spectrum, that is |lambda| <= |theta[b-1]| */
+		chebyshev_filter(m, v, w, t, b, n, degree, cut, scale);
+	}
+	else
+	{
+		/* plain block power step, w already has A times the Ritz vectors */
+		swap = v;
+		v = w;
+		w = swap;
+	}
+	orthonormalize_block(v, b, n);
+}
+if(k < max_iterations)
+{
+	eigensys = create_eigensystem(p);
+	x = create_vector(n);
+	for(i = 0; i < p; i++)
+	{
+		for(j = 0; j < n; j++) x->_data[j] = v[(size_t)i*n+j];
+		normalize(x);
+		eigensys->_eigen[i] = create_eigen(theta[i], x);
+	}
+	destroy_vector(x);
+}
+
+/* release previously allocated memory */
+RELEASE(work);
+RELEASE(order);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_SUBSPACE_ITERATION, (k < max_iterations) ? k+1 : k);
+INSTRUMENT_END(INSTRUMENT_SUBSPACE_ITERATION, (2.0*b*n*n + 6.0*b*b*n)*((k < max_iterations) ? k+1 : k));
 return eigensys;
 }
 
+EigenSystem* symmetric_eigen_system(const Matrix* m)
+{
+int i, j, n, best, sweeps;
+int* order = NULL;
+Matrix* a = NULL;
+Matrix* v = NULL;
+Vector* x = NULL;
+EigenSystem* eigensys = NULL;
+if(m == NULL) return NULL;
+if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
+INSTRUMENT_BEGIN;
+n = rows_matrix(m);
+/* work on a symmetric copy built from the upper triangle */
+a = create_matrix(n, n);
+for(i = 0; i < n; i++)
+{
+	for(j = i; j < n; j++)
+	{
+		a->_data[i*n+j] = m->_data[i*n+j];
+		a->_data[j*n+i] = m->_data[i*n+j];
+	}
+}
+v = identity_matrix(n);
+sweeps = jacobi_sweeps(a->_data, v->_data, n);
+/* sort the eigenvalues in decreasing order */
+order = (int*)ALLOCATE(n * sizeof(int));
+for(i = 0; i < n; i++) order[i] = i;
+for(i = 0; i < n; i++)
+{
+	best = i;
+	for(j = i+1; j < n; j++) if(a->_data[order[j]*n+order[j]] > a->_data[order[best]*n+order[best]]) best = j;
+	j = order[i];
+	order[i] = order[best];
+	order[best] = j;
+}
+/* build eigensystem, the eigenvectors are the columns of v */
+eigensys = create_eigensystem(n);
+x = create_vector(n);
+for(i = 0; i < n; i++)
+{
+	for(j = 0; j < n; j++) x->_data[j] = v->_data[j*n+order[i]];
+	eigensys->_eigen[i] = create_eigen(a->_data[order[i]*n+order[i]], x);
+}
+
+/* release previously allocated memory */
+RELEASE(order);
+destroy_vector(x);
+destroy_matrix(a);
+destroy_matrix(v);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_SYMMETRIC_EIGEN_SYSTEM, sweeps);
+INSTRUMENT_END(INSTRUMENT_SYMMETRIC_EIGEN_SYSTEM, 9.0*n*n*n*sweeps);
+return eigensys;
+}
 
 /* END */
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#endif
+#endif
+
+#if defined(__linux__) && defined(LINEARSYS_INSTRUMENT)
+#define __perf_events_ /* hardware counters through perf_event_open */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE /* syscall */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#ifdef __perf_events_
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "instrument.h"
+
+/*
+* The counters, updated with the atomic builtins of the compiler.
+*/
+static InstrumentCounter __counter_[INSTRUMENT_ROUTINES];
+static unsigned long long __bytes_allocated_ = 0;
+static unsigned long long __bytes_freed_ = 0;
+static long long __live_matrices_ = 0;
+static long long __peak_matrices_ = 0;
+static int __hardware_events_ = 0; /* events counted by some thread */
+
+static const char* __names_[INSTRUMENT_ROUTINES] =
+{
+"mul_matrix", "gemm_matrix", "add_matrix", "sub_matrix", "scale_matrix", "transpose_matrix",
+"inverse_matrix", "pseudoinverse_matrix", "rank_matrix",
+"smcramer_system_solver", "mvcramer_system_solver", "smgauss_system_solver", "mvgauss_system_solver",
+"lu_system_solver", "qr_system_solver", "lu_decomposition", "qr_factorization",
+"max_eigen_power_method", "subspace_iteration", "eigen_system", "inverse_iteration",
+"rayleigh_quotient_iteration", "symmetric_eigen_system",
+"svd_factorization", "randomized_svd", "pca_factorization",
+"lanczos_eigen", "arnoldi_eigen", "diagonalize_matrix", "mul_sparse_matrix_vector",
+"lu_task_graph", "cholesky_task_graph", "qr_task_graph"
+};
+
+static const char* __hardware_names_[HARDWARE_EVENTS] =
+{
+"cycles", "instructions", "l1_misses", "llc_misses", "fp_ops"
+};
+
+#ifdef __perf_events_
+/*
+* PerfGroup type definition: the hardware counters of a thread, opened as a group so that they are read all at once.
+*/
+typedef struct
+{
+int _leader; /* file descriptor of the group leader, -1 if no event could be opened */
+int _fd[HARDWARE_EVENTS]; /* file descriptor of each event, -1 if it is not counted */
+int _slot[HARDWARE_EVENTS]; /* position of each event in the values read from the group */
+int _count; /* number of events in the group */
+int _events; /* bit mask of the events in the group */
+}PerfGroup;
+
+static int __hardware_enabled_ = 0;
+static pthread_key_t __perf_key_;
+static pthread_once_t __perf_once_ = PTHREAD_ONCE_INIT;
+#endif
+
+/*
+* Helper functions.
+*/
+
+#define __load_(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define __add_(x, v) __atomic_fetch_add(&(x), (v), __ATOMIC_RELAXED)
+
+/*
+* Raises a maximum to value.
+*/
+static void __maximum_(unsigned long long* maximum, unsigned long long value)
+{
+unsigned long long current = __atomic_load_n(maximum, __ATOMIC_RELAXED);
+while(current < value && !__atomic_compare_exchange_n(maximum, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+static void __peak_(long long value)
+{
+long long current = __atomic_load_n(&__peak_matrices_, __ATOMIC_RELAXED);
+while(current < value && !__atomic_compare_exchange_n(&__peak_matrices_, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/*
+* Writes formatted text to a file, or to the standard output if file is NULL.
+*/
+static void __print_(FILE* file, const char* format, ...)
+{
+char line[512]; /* the longest line written is about 250 characters */
+va_list args;
+va_start(args, format);
+if(file != NULL) vfprintf(file, format, args);
+else
+{
+	vsnprintf(line, sizeof(line), format, args);
+	printf("%s", line);
+}
+va_end(args);
+}
+
+#ifdef __perf_events_
+/*
+* Closes the hardware counters of a thread when it exits.
+*/
+static void __close_perf_(void* p)
+{
+int i;
+PerfGroup* g = (PerfGroup*)p;
+for(i = 0; i < HARDWARE_EVENTS; i++) if(g->_fd[i] >= 0) close(g->_fd[i]);
+free(g);
+}
+
+static void __create_perf_key_(void)
+{
+pthread_key_create(&__perf_key_, __close_perf_);
+}
+
+/*
+* Opens a hardware event counting the calling thread in user space ( allowed with the default perf_event_paranoid ).
+*
+* returns: the file descriptor of the event, or -1 if it cannot be opened.
+*/
+static int __open_event_(uint32_t type, uint64_t config, int leader)
+{
+struct perf_event_attr attr;
+memset(&attr, 0, sizeof(attr));
+attr.size = sizeof(attr);
+attr.type = type;
+attr.config = config;
+attr.exclude_kernel = 1;
+attr.exclude_hv = 1;
+attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+return (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+/*
+* Gets the hardware counters of the calling thread, opening them on the first call.
+*/
+static PerfGroup* __perf_group_(void)
+{
+int i, fd;
+const char* env = NULL;
+PerfGroup* g = NULL;
+uint32_t type[HARDWARE_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW};
+uint64_t config[HARDWARE_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+PERF_COUNT_HW_CACHE_MISSES, 0};
+pthread_once(&__perf_once_, __create_perf_key_);
+g = (PerfGroup*)pthread_getspecific(__perf_key_);
+if(g != NULL) return g;
+g = (PerfGroup*)malloc(sizeof(PerfGroup));
+g->_leader = -1;
+g->_count = 0;
+g->_events = 0;
+env = getenv("LINEARSYS_FP_EVENT");
+if(env != NULL) config[HARDWARE_FP_OPS] = strtoull(env, NULL, 0);
+for(i = 0; i < HARDWARE_EVENTS; i++)
+{
+	g->_fd[i] = -1;
+	g->_slot[i] = -1;
+	if(i == HARDWARE_FP_OPS && config[i] == 0) continue; /* no raw event code given */
+	fd = __open_event_(type[i], config[i], g->_leader);
+	if(fd < 0) continue; /* event not available, the others are still counted */
+	if(g->_leader < 0) g->_leader = fd;
+	g->_fd[i] = fd;
+	g->_slot[i] = g->_count++;
+	g->_events |= 1 << i;
+}
+__atomic_fetch_or(&__hardware_events_, g->_events, __ATOMIC_RELAXED);
+pthread_setspecific(__perf_key_, g);
+return g;
+}
+
+/*
+* Reads the hardware counters of a thread, scaled up when the kernel had to multiplex them.
+*
+* returns: the bit mask of the events read, 0 if they cannot be read.
+*/
+static int __read_perf_(const PerfGroup* g, unsigned long long* value)
+{
+int i;
+double scale;
+uint64_t buffer[3 + HARDWARE_EVENTS]; /* number of events, time enabled, time running and the values */
+if(g->_leader < 0) return 0;
+if(read(g->_leader, buffer, sizeof(buffer)) < (ssize_t)((3 + g->_count) * sizeof(uint64_t))) return 0;
+scale = (buffer[2] > 0 && buffer[2] < buffer[1]) ? (double)buffer[1] / (double)buffer[2] : 1.0;
+for(i = 0; i < HARDWARE_EVENTS; i++)
+{
+	value[i] = (g->_slot[i] >= 0) ? (unsigned long long)(scale * (double)buffer[3 + g->_slot[i]]) : 0;
+}
+return g->_events;
+}
+#endif
+
+/* end helper functions */
+
+/* implementation */
+
+const char* name_instrument(int routine)
+{
+if(routine < 0 || routine >= INSTRUMENT_ROUTINES) return NULL;
+return __names_[routine];
+}
+
+const char* name_hardware_instrument(int event)
+{
+if(event < 0 || event >= HARDWARE_EVENTS) return NULL;
+return __hardware_names_[event];
+}
+
+int enable_hardware_instrument(int enable)
+{
+#ifdef __perf_events_
+__atomic_store_n(&__hardware_enabled_, (enable) ? 1 : 0, __ATOMIC_RELAXED);
+return __perf_group_()->_events;
+#else
+(void)enable;
+return 0;
+#endif
+}
+
+void snapshot_instrument(InstrumentSnapshot* s)
+{
+int i, j;
+if(s == NULL) return;
+memset(s, 0, sizeof(InstrumentSnapshot));
+#ifdef LINEARSYS_INSTRUMENT
+s->_enabled = 1;
+#endif
+for(i = 0; i < INSTRUMENT_ROUTINES; i++)
+{
+	s->_counter[i]._calls = __load_(__counter_[i]._calls);
+	s->_counter[i]._time = __load_(__counter_[i]._time);
+	s->_counter[i]._max_time = __load_(__counter_[i]._max_time);
+	s->_counter[i]._flops = __load_(__counter_[i]._flops);
+	s->_counter[i]._iterations = __load_(__counter_[i]._iterations);
+	s->_counter[i]._measured = __load_(__counter_[i]._measured);
+	for(j = 0; j < HARDWARE_EVENTS; j++) s->_counter[i]._hardware[j] = __load_(__counter_[i]._hardware[j]);
+}
+s->_bytes_allocated = __load_(__bytes_allocated_);
+s->_bytes_freed = __load_(__bytes_freed_);
+s->_live_matrices = __load_(__live_matrices_);
+s->_peak_matrices = __load_(__peak_matrices_);
+s->_hardware = __load_(__hardware_events_);
+}
+
+void reset_instrument(void)
+{
+int i, j;
+for(i = 0; i < INSTRUMENT_ROUTINES; i++)
+{
+	__atomic_store_n(&__counter_[i]._calls, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&__counter_[i]._time, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&__counter_[i]._max_time, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&__counter_[i]._flops, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&__counter_[i]._iterations, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&__counter_[i]._measured, 0, __ATOMIC_RELAXED);
+	for(j = 0; j < HARDWARE_EVENTS; j++) __atomic_store_n(&__counter_[i]._hardware[j], 0, __ATOMIC_RELAXED);
+}
+__atomic_store_n(&__bytes_allocated_, 0, __ATOMIC_RELAXED);
+__atomic_store_n(&__bytes_freed_, 0, __ATOMIC_RELAXED);
+__atomic_store_n(&__peak_matrices_, __load_(__live_matrices_), __ATOMIC_RELAXED);
+}
+
+int dump_instrument(const InstrumentSnapshot* s, const char* filename, int format)
+{
+int i, j, first = 1, ok;
+double d;
+const InstrumentCounter* c = NULL;
+FILE* file = NULL;
+if(s == NULL) return 0;
+if(filename != NULL)
+{
+	file = fopen(filename, "w");
+	if(file == NULL) return 0;
+}
+if(format == INSTRUMENT_JSON)
+{
+	__print_(file, "{\"enabled\": %s, \"bytes_allocated\": %llu, \"bytes_freed\": %llu, \"live_matrices\": %lld, \"peak_matrices\": %lld, \"hardware_events\": [",
+	(s->_enabled) ? "true" : "false", s->_bytes_allocated, s->_bytes_freed, s->_live_matrices, s->_peak_matrices);
+	for(j = 0; j < HARDWARE_EVENTS; j++)
+	{
+		if(!(s->_hardware & (1 << j))) continue;
+		__print_(file, "%s\"%s\"", (first) ? "" : ", ", __hardware_names_[j]);
+		first = 0;
+	}
+	__print_(file, "], \"routines\": [");
+	first = 1;
+	for(i = 0; i < INSTRUMENT_ROUTINES; i++)
+	{
+		c = &s->_counter[i];
+		__print_(file, "%s\n{\"routine\": \"%s\", \"calls\": %llu, \"time_ns\": %llu, \"max_time_ns\": %llu, \"flops\": %llu, \"iterations\": %llu",
+		(first) ? "" : ",", __names_[i], c->_calls, c->_time, c->_max_time, c->_flops, c->_iterations);
+		__print_(file, ", \"measured\": %llu", c->_measured);
+		for(j = 0; j < HARDWARE_EVENTS; j++) __print_(file, ", \"%s\": %llu", __hardware_names_[j], c->_hardware[j]);
+		__print_(file, "}");
+		first = 0;
+	}
+	__print_(file, "\n]}\n");
+}
+else
+{
+	if(!s->_enabled) __print_(file, "instrumentation disabled ( build with LINEARSYS_INSTRUMENT )\n");
+	__print_(file, "%-28s %12s %14s %14s %10s %14s\n", "routine", "calls", "time ms", "max ms", "GFLOP/s", "iterations");
+	for(i = 0; i < INSTRUMENT_ROUTINES; i++)
+	{
+		c = &s->_counter[i];
+		if(c->_calls == 0) continue;
+		__print_(file, "%-28s %12llu %14.3f %14.3f %10.3f %14llu\n", __names_[i], c->_calls, 1E-6 * c->_time, 1E-6 * c->_max_time,
+		(c->_time > 0) ? (double)c->_flops / c->_time : 0.0, c->_iterations);
+	}
+	__print_(file, "bytes allocated %llu, bytes freed %llu, live matrices %lld, peak matrices %lld\n",
+	s->_bytes_allocated, s->_bytes_freed, s->_live_matrices, s->_peak_matrices);
+	if(s->_hardware)
+	{
+		/* misses per thousand instructions */
+		__print_(file, "%-28s %12s %16s %16s %8s %10s %10s %16s\n", "routine", "measured", "cycles", "instructions", "IPC", "L1 MPKI", "LLC MPKI", "fp ops");
+		for(i = 0; i < INSTRUMENT_ROUTINES; i++)
+		{
+			c = &s->_counter[i];
+			if(c->_measured == 0) continue;
+			d = (double)c->_hardware[HARDWARE_INSTRUCTIONS];
+			__print_(file, "%-28s %12llu %16llu %16llu %8.3f %10.3f %10.3f %16llu\n", __names_[i], c->_measured,
+			c->_hardware[HARDWARE_CYCLES], c->_hardware[HARDWARE_INSTRUCTIONS],
+			(c->_hardware[HARDWARE_CYCLES] > 0) ? d / c->_hardware[HARDWARE_CYCLES] : 0.0,
+			(d > 0.0) ? 1000.0 * c->_hardware[HARDWARE_L1_MISSES] / d : 0.0,
+			(d > 0.0) ? 1000.0 * c->_hardware[HARDWARE_LLC_MISSES] / d : 0.0,
+			c->_hardware[HARDWARE_FP_OPS]);
+		}
+	}
+}
+ok = 1;
+if(file != NULL)
+{
+	if(ferror(file)) ok = 0;
+	if(fclose(file) != 0) ok = 0;
+}
+return ok;
+}
+
+unsigned long long clock_instrument(void)
+{
+#ifdef _WIN32
+LARGE_INTEGER counter, frequency;
+QueryPerformanceCounter(&counter);
+QueryPerformanceFrequency(&frequency);
+return (unsigned long long)((double)counter.QuadPart * 1E9 / (double)frequency.QuadPart);
+#else
+struct timespec t;
+clock_gettime(CLOCK_MONOTONIC, &t);
+return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+#endif
+}
+
+InstrumentStart begin_instrument(void)
+{
+InstrumentStart start;
+start._events = 0;
+#ifdef __perf_events_
+/* the counters are read before the clock starts, so that the system call is not timed */
+if(__atomic_load_n(&__hardware_enabled_, __ATOMIC_RELAXED)) start._events = __read_perf_(__perf_group_(), start._hardware);
+#endif
+start._time = clock_instrument();
+return start;
+}
+
+void record_instrument(int routine, const InstrumentStart* start, double flops)
+{
+unsigned long long elapsed = clock_instrument() - start->_time;
+#ifdef __perf_events_
+int i;
+unsigned long long value[HARDWARE_EVENTS];
+#endif
+if(routine < 0 || routine >= INSTRUMENT_ROUTINES) return;
+__add_(__counter_[routine]._calls, 1);
+__add_(__counter_[routine]._time, elapsed);
+__add_(__counter_[routine]._flops, (unsigned long long)((flops > 0.0) ? flops : 0.0));
+__maximum_(&__counter_[routine]._max_time, elapsed);
+#ifdef __perf_events_
+if(start->_events && __read_perf_(__perf_group_(), value) == start->_events)
+{
+	__add_(__counter_[routine]._measured, 1);
+	for(i = 0; i < HARDWARE_EVENTS; i++)
+	{
+		if(start->_events & (1 << i)) __add_(__counter_[routine]._hardware[i], value[i] - start->_hardware[i]);
+	}
+}
+#endif
+}
+
+void iterations_instrument(int routine, unsigned long long count)
+{
+if(routine < 0 || routine >= INSTRUMENT_ROUTINES) return;
+__add_(__counter_[routine]._iterations, count);
+}
+
+void allocate_instrument(int matrix, size_t bytes)
+{
+__add_(__bytes_allocated_, (unsigned long long)bytes);
+if(matrix) __peak_(__atomic_add_fetch(&__live_matrices_, 1, __ATOMIC_RELAXED));
+}
+
+void free_instrument(int matrix, size_t bytes)
+{
+__add_(__bytes_freed_, (unsigned long long)bytes);
+if(matrix) __add_(__live_matrices_, -1);
+}
+
+/* END */
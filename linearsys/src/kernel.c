@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stddef.h>
+#include "kernel.h"
+#include "threadpool.h"
+#include "tuning.h"
+#include "trace.h"
+
+/*
+* The block sizes of the gemm kernel come from the Tuning of the library:
+* a KC x NC panel of B is reused by MC rows of A while it stays in cache.
+* Products bigger than the parallel threshold are split in blocks of MC rows of C run by the threads.
+*/
+
+/*
+* GemmJob type definition.
+*/
+typedef struct
+{
+int _transa;
+int _transb;
+int _m;
+int _n;
+int _k;
+int _mc;
+double _alpha;
+const double* _a;
+int _lda;
+const double* _b;
+int _ldb;
+double _beta;
+double* _c;
+int _ldc;
+}GemmJob;
+
+/*
+* Helper functions.
+*/
+
+static int __min_(int a, int b)
+{
+return (a <= b) ? a : b;
+}
+
+/*
+* Scales the m x n block C by beta.
+*/
+static void __scale_(int m, int n, double beta, double* c, int ldc)
+{
+int i, j;
+if(beta == 1.0) return;
+for(i = 0; i < m; i++)
+{
+	double* ci = c + (size_t)i*ldc;
+	if(beta == 0.0)
+	{
+		for(j = 0; j < n; j++) ci[j] = 0.0;
+	}
+	else
+	{
+		for(j = 0; j < n; j++) ci[j] *= beta;
+	}
+}
+}
+
+/*
+* C += alpha*op(A)*B where B is not transposed.
+* The innermost loop runs along a row of B and a row of C, both contiguous.
+*/
+static void __gemm_nn_(int transa, int m, int n, int k, double alpha,
+const double* a, int lda, const double* b, int ldb, double* c, int ldc)
+{
+int i, j, p;
+int ii, jj, pp;
+int mb, nb, kb;
+const Tuning* t = get_tuning();
+for(jj = 0; jj < n; jj += t->_gemm_nc)
+{
+	nb = __min_(t->_gemm_nc, n-jj);
+	for(pp = 0; pp < k; pp += t->_gemm_kc)
+	{
+		kb = __min_(t->_gemm_kc, k-pp);
+		for(ii = 0; ii < m; ii += t->_gemm_mc)
+		{
+			mb = __min_(t->_gemm_mc, m-ii);
+			for(i = ii; i < ii+mb; i++)
+			{
+				double* ci = c + (size_t)i*ldc + jj;
+				for(p = pp; p < pp+kb; p++)
+				{
+					const double* bp = b + (size_t)p*ldb + jj;
+					double aip = (transa == KERNEL_TRANS) ? a[(size_t)p*lda+i] : a[(size_t)i*lda+p];
+					aip *= alpha;
+					for(j = 0; j < nb; j++) ci[j] += aip * bp[j];
+				}
+			}
+		}
+	}
+}
+}
+
+/*
+* C += alpha*A*B^t.
+* Each entry is a dot product between a row of A and a row of B.
+*/
+static void __gemm_nt_(int m, int n, int k, double alpha,
+const double* a, int lda, const double* b, int ldb, double* c, int ldc)
+{
+int i, j, p;
+int pp, kb;
+double accum;
+const Tuning* t = get_tuning();
+for(pp = 0; pp < k; pp += t->_gemm_kc)
+{
+	kb = __min_(t->_gemm_kc, k-pp);
+	for(i = 0; i < m; i++)
+	{
+		const double* ai = a + (size_t)i*lda + pp;
+		for(j = 0; j < n; j++)
+		{
+			const double* bj = b + (size_t)j*ldb + pp;
+			accum = 0.0;
+			for(p = 0; p < kb; p++) accum += ai[p] * bj[p];
+			c[(size_t)i*ldc+j] += alpha * accum;
+		}
+	}
+}
+}
+
+/*
+* C += alpha*A^t*B^t.
+* Rarely used, so it is kept simple.
+*/
+static void __gemm_tt_(int m, int n, int k, double alpha,
+const double* a, int lda, const double* b, int ldb, double* c, int ldc)
+{
+int i, j, p;
+double accum;
+for(i = 0; i < m; i++)
+{
+	for(j = 0; j < n; j++)
+	{
+		accum = 0.0;
+		for(p = 0; p < k; p++) accum += a[(size_t)p*lda+i] * b[(size_t)j*ldb+p];
+		c[(size_t)i*ldc+j] += alpha * accum;
+	}
+}
+}
+
+/*
+* C = alpha*op(A)*op(B) + beta*C in the calling thread.
+*/
+static void __gemm_(int transa, int transb, int m, int n, int k, double alpha,
+const double* a, int lda, const double* b, int ldb, double beta, double* c, int ldc)
+{
+__scale_(m, n, beta, c, ldc);
+if(k < 1 || alpha == 0.0) return;
+if(transb == KERNEL_NO_TRANS)
+{
+	__gemm_nn_(transa, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+}
+else if(transa == KERNEL_NO_TRANS)
+{
+	__gemm_nt_(m, n, k, alpha, a, lda, b, ldb, c, ldc);
+}
+else
+{
+	__gemm_tt_(m, n, k, alpha, a, lda, b, ldb, c, ldc);
+}
+}
+
+/*
+* Runs the product for a block of rows of C; row i of op(A) is column i of A when A is transposed.
+*/
+static void __gemm_task_(int index, void* context)
+{
+GemmJob* job = (GemmJob*)context;
+int first = index * job->_mc;
+int rows = __min_(job->_mc, job->_m - first);
+const double* a = (job->_transa == KERNEL_TRANS) ? job->_a + first : job->_a + (size_t)first*job->_lda;
+TRACE_BEGIN;
+__gemm_(job->_transa, job->_transb, rows, job->_n, job->_k, job->_alpha, a, job->_lda,
+job->_b, job->_ldb, job->_beta, job->_c + (size_t)first*job->_ldc, job->_ldc);
+TRACE_END("gemm_block", index, -1);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+void kernel_gemm(int transa, int transb, int m, int n, int k, double alpha,
+const double* a, int lda, const double* b, int ldb, double beta, double* c, int ldc)
+{
+GemmJob job;
+const Tuning* t = get_tuning();
+if(m < 1 || n < 1) return;
+if(m <= t->_gemm_mc || (double)m*n*k < t->_parallel_gemm || threads_threadpool(NULL) == 1)
+{
+	TRACE_BEGIN;
+	__gemm_(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+	TRACE_END("gemm", -1, -1);
+	return;
+}
+job._transa = transa;
+job._transb = transb;
+job._m = m;
+job._n = n;
+job._k = k;
+job._mc = t->_gemm_mc;
+job._alpha = alpha;
+job._a = a;
+job._lda = lda;
+job._b = b;
+job._ldb = ldb;
+job._beta = beta;
+job._c = c;
+job._ldc = ldc;
+parallel_for(NULL, (m + job._mc - 1) / job._mc, __gemm_task_, &job);
+}
+
+/* END */
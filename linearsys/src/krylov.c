@@ -0,0 +1,852 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "kernel.h"
+#include "krylov.h"
+#include "allocator.h"
+#include "instrument.h"
+
+#define EPSILON 2.220446049250313E-16 /* double precision machine epsilon */
+#define DEFAULT_TOLERANCE 1E-10
+#define DEFAULT_MAX_RESTARTS 300
+#define HQR_MAX_ITERATIONS 60
+#define INVERSE_ITERATIONS 3
+
+/*
+* Helper functions.
+*/
+
+static int __min_(int a, int b)
+{
+return (a <= b) ? a : b;
+}
+
+static int __max_(int a, int b)
+{
+return (a >= b) ? a : b;
+}
+
+static double dot(const double* x, const double* y, int n)
+{
+int i;
+double d = 0.0;
+for(i = 0; i < n; i++) d += x[i] * y[i];
+return d;
+}
+
+/*
+* Operators over dense and sparse matrices.
+*/
+static void dense_apply(const double* x, double* y, void* context)
+{
+const Matrix* m = (const Matrix*)context;
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, rows_matrix(m), 1, columns_matrix(m),
+1.0, m->_data, columns_matrix(m), x, 1, 0.0, y, 1);
+}
+
+static void sparse_apply(const double* x, double* y, void* context)
+{
+int i, k;
+double accum;
+const SparseMatrix* s = (const SparseMatrix*)context;
+for(i = 0; i < s->_rows; i++)
+{
+	accum = 0.0;
+	for(k = s->_row_start[i]; k < s->_row_start[i+1]; k++) accum += s->_data[k] * x[s->_column_index[k]];
+	y[i] = accum;
+}
+}
+
+/*
+* Orthogonalizes w against the first count rows of v ( classical Gram-Schmidt applied twice ).
+* The coefficients are added to h, which is read with stride ldh.
+* returns: the norm of w after the orthogonalization.
+*/
+static double orthogonalize(const Matrix* v, int count, double* w, double* h, int ldh)
+{
+int i, t, pass;
+int n = columns_matrix(v);
+double c;
+const double* vi = NULL;
+for(pass = 0; pass < 2; pass++)
+{
+	for(i = 0; i < count; i++)
+	{
+		vi = v->_data + (size_t)i*n;
+		c = dot(vi, w, n);
+		if(h != NULL) h[i*ldh] += c;
+		for(t = 0; t < n; t++) w[t] -= c * vi[t];
+	}
+}
+return sqrt(dot(w, w, n));
+}
+
+/*
+* Sets row j of v to a random unit vector orthogonal to the previous rows.
+*/
+static void random_row(Matrix* v, int j, Random* rng)
+{
+int t, tries;
+int n = columns_matrix(v);
+double norm = 0.0;
+double* w = v->_data + (size_t)j*n;
+for(tries = 0; tries < 10 && norm == 0.0; tries++)
+{
+	for(t = 0; t < n; t++) w[t] = uniform_random(rng) - 0.5;
+	norm = orthogonalize(v, j, w, NULL, 0);
+}
+if(norm == 0.0) norm = 1.0;
+for(t = 0; t < n; t++) w[t] /= norm;
+}
+
+/*
+* Extends the Arnoldi relation A*V = V*H from column from to column to-1.
+* v has to+1 rows and h has to+1 rows and at least to columns.
+* When an invariant subspace is found the basis goes on with a random vector
+* and the corresponding subdiagonal entry is zero.
+*/
+static void expand_basis(const LinearOperator* op, Matrix* v, Matrix* h, int from, int to, Random* rng)
+{
+int j, t;
+int n = columns_matrix(v);
+int ldh = columns_matrix(h);
+double norm0, beta;
+double* w = NULL;
+for(j = from; j < to; j++)
+{
+	w = v->_data + (size_t)(j+1)*n;
+	op->_apply(v->_data + (size_t)j*n, w, op->_context);
+	norm0 = sqrt(dot(w, w, n));
+	beta = orthogonalize(v, j+1, w, h->_data + j, ldh);
+	if(norm0 == 0.0 || beta <= 1E-12 * norm0)
+	{
+		h->_data[(j+1)*ldh+j] = 0.0;
+		random_row(v, j+1, rng);
+		continue;
+	}
+	h->_data[(j+1)*ldh+j] = beta;
+	for(t = 0; t < n; t++) w[t] /= beta;
+}
+}
+
+/*
+* Returns 1 if the Ritz value (re1, im1) goes before (re2, im2) for the criterion.
+* Ties are broken putting the positive imaginary part first, so complex conjugates stay together.
+*/
+static int ritz_before(double re1, double im1, double re2, double im2, int which, double shift)
+{
+double k1, k2;
+switch(which)
+{
+	case EIGEN_SMALLEST:
+	k1 = re1;
+	k2 = re2;
+	break;
+	case EIGEN_LARGEST_MAGNITUDE:
+	k1 = -sqrt(re1*re1 + im1*im1);
+	k2 = -sqrt(re2*re2 + im2*im2);
+	break;
+	case EIGEN_CLOSEST:
+	k1 = sqrt((re1-shift)*(re1-shift) + im1*im1);
+	k2 = sqrt((re2-shift)*(re2-shift) + im2*im2);
+	break;
+	default:
+	k1 = -re1;
+	k2 = -re2;
+	break;
+}
+if(k1 != k2) return k1 < k2;
+return im1 > im2;
+}
+
+static void sort_ritz(int* order, int m, const double* re, const double* im, int which, double shift)
+{
+int i, j, t;
+for(i = 1; i < m; i++)
+{
+	t = order[i];
+	for(j = i-1; j >= 0 && ritz_before(re[t], im[t], re[order[j]], im[order[j]], which, shift); j--) order[j+1] = order[j];
+	order[j+1] = t;
+}
+}
+
+static int converged(double value, double residual, double tolerance)
+{
+double scale = fabs(value);
+if(scale < 3.6E-11) scale = 3.6E-11; /* epsilon^(2/3) */
+return residual <= tolerance * scale;
+}
+
+/*
+* Applies the reflection I - beta*u*u^t ( u having size elements ) to rows r0 .. r0+size-1
+* of columns c0 .. c1 of the n x n array a from the left, and to columns r0 .. r0+size-1
+* of rows lo .. r1 from the right.
+*/
+static void __reflect_(double* a, int n, const double* u, double beta, int size, int r0, int c0, int c1, int lo, int r1)
+{
+int i, j;
+double s;
+for(j = c0; j <= c1; j++)
+{
+	s = 0.0;
+	for(i = 0; i < size; i++) s += u[i] * a[(size_t)(r0+i)*n+j];
+	s *= beta;
+	for(i = 0; i < size; i++) a[(size_t)(r0+i)*n+j] -= s * u[i];
+}
+for(i = lo; i <= r1; i++)
+{
+	s = 0.0;
+	for(j = 0; j < size; j++) s += a[(size_t)i*n+r0+j] * u[j];
+	s *= beta;
+	for(j = 0; j < size; j++) a[(size_t)i*n+r0+j] -= s * u[j];
+}
+}
+
+/*
+* Builds a reflection u, beta mapping the vector x of size elements to a multiple of the first unit vector.
+* Returns 0 if x is zero.
+*/
+static int __householder_(const double* x, int size, double* u, double* beta)
+{
+int i;
+double scale = 0.0, norm = 0.0, alpha;
+/* scaled to avoid overflow, the reflection does not change */
+for(i = 0; i < size; i++) scale += fabs(x[i]);
+if(scale == 0.0) return 0;
+for(i = 0; i < size; i++)
+{
+	u[i] = x[i] / scale;
+	norm += u[i] * u[i];
+}
+alpha = (u[0] >= 0.0) ? -sqrt(norm) : sqrt(norm);
+/* |u - alpha e1|^2 = 2 ( norm - alpha u0 ) */
+*beta = 1.0 / (norm - alpha*u[0]);
+u[0] -= alpha;
+return 1;
+}
+
+/*
+* Reduces the n x n array a to upper Hessenberg form with Householder reflections,
+* applied on both sides so that the eigenvalues are kept. u is a work array of n elements.
+*/
+static void __hessenberg_(double* a, int n, double* u)
+{
+int i, k, len;
+double beta;
+for(k = 0; k < n-2; k++)
+{
+	/* reflection taking column k below the subdiagonal to a multiple of the first unit vector */
+	len = n-k-1;
+	for(i = 0; i < len; i++) u[i] = a[(size_t)(k+1+i)*n+k];
+	if(!__householder_(u, len, u, &beta)) continue;
+	__reflect_(a, n, u, beta, len, k+1, k, n-1, 0, n-1);
+	for(i = k+2; i < n; i++) a[(size_t)i*n+k] = 0.0;
+}
+}
+
+/*
+* One implicit double shift QR step ( Francis ) on the active block lo .. hi of the Hessenberg array h.
+* The shifts are the eigenvalues of the 2 x 2 matrix with trace s and determinant t; only the block is updated,
+* which is enough for the eigenvalues.
+*/
+static void __francis_(double* h, int n, int lo, int hi, double s, double t)
+{
+int k, last;
+double x[3], u[3], beta;
+double h00 = h[(size_t)lo*n+lo];
+double h10 = h[(size_t)(lo+1)*n+lo];
+/* first column of ( H - s1 I ) ( H - s2 I ) = H^2 - s H + t I */
+x[0] = h00*h00 + h[(size_t)lo*n+lo+1]*h10 - s*h00 + t;
+x[1] = h10 * (h00 + h[(size_t)(lo+1)*n+lo+1] - s);
+x[2] = h10 * h[(size_t)(lo+2)*n+lo+1];
+for(k = lo; k < hi-1; k++)
+{
+	/* chase the bulge one position down */
+	if(__householder_(x, 3, u, &beta))
+	{
+		last = (k+3 < hi) ? k+3 : hi;
+		__reflect_(h, n, u, beta, 3, k, (k > lo) ? k-1 : lo, hi, lo, last);
+	}
+	if(k > lo)
+	{
+		/* the bulge left column k-1, up to rounding */
+		h[(size_t)(k+1)*n+k-1] = 0.0;
+		h[(size_t)(k+2)*n+k-1] = 0.0;
+	}
+	x[0] = h[(size_t)(k+1)*n+k];
+	x[1] = h[(size_t)(k+2)*n+k];
+	if(k < hi-2) x[2] = h[(size_t)(k+3)*n+k];
+}
+/* last 2 x 2 reflection */
+if(__householder_(x, 2, u, &beta))
+{
+	__reflect_(h, n, u, beta, 2, hi-1, hi-2, hi, lo, hi);
+	h[(size_t)hi*n+hi-2] = 0.0;
+}
+}
+
+/*
+* Computes the eigenvalues of a general n x n matrix ( stored in a, which is destroyed ):
+* the matrix is reduced to upper Hessenberg form and the implicit double shift QR algorithm is run on it,
+* splitting the matrix where a subdiagonal entry becomes negligible.
+* A complex conjugate pair is stored in consecutive positions, the one with positive imaginary part first.
+* returns: 1 on success or 0 if the QR algorithm does not converge.
+*/
+static int __general_eigenvalues_(double* a, int n, double* wr, double* wi)
+{
+int i, j, lo, hi, iterations = 0;
+double norm = 0.0, scale, p, b, c, d, e, w;
+double* v = (double*)ALLOCATE((n > 0 ? n : 1) * sizeof(double));
+__hessenberg_(a, n, v);
+RELEASE(v);
+for(i = 0; i < n; i++)
+{
+	for(j = (i > 0) ? i-1 : 0; j < n; j++) norm += fabs(a[(size_t)i*n+j]);
+}
+hi = n-1;
+while(hi >= 0)
+{
+	/* look for a negligible subdiagonal entry splitting off the block lo .. hi */
+	for(lo = hi; lo > 0; lo--)
+	{
+		scale = fabs(a[(size_t)(lo-1)*n+lo-1]) + fabs(a[(size_t)lo*n+lo]);
+		if(scale == 0.0) scale = norm;
+		if(fabs(a[(size_t)lo*n+lo-1]) <= EPSILON * scale)
+		{
+			a[(size_t)lo*n+lo-1] = 0.0;
+			break;
+		}
+	}
+	if(lo == hi)
+	{
+		/* a real eigenvalue */
+		wr[hi] = a[(size_t)hi*n+hi];
+		wi[hi] = 0.0;
+		hi--;
+		iterations = 0;
+		continue;
+	}
+	if(lo == hi-1)
+	{
+		/* eigenvalues of a 2 x 2 block [ p b; c d ] */
+		p = a[(size_t)lo*n+lo];
+		b = a[(size_t)lo*n+hi];
+		c = a[(size_t)hi*n+lo];
+		d = a[(size_t)hi*n+hi];
+		e = 0.5 * (p - d);
+		w = e*e + b*c;
+		if(w >= 0.0)
+		{
+			/* the bigger root first, the other one from the product to avoid cancellation */
+			w = e + ((e >= 0.0) ? sqrt(w) : -sqrt(w));
+			wr[lo] = d + w;
+			wr[hi] = (w != 0.0) ? d - b*c / w : d + w;
+			wi[lo] = wi[hi] = 0.0;
+		}
+		else
+		{
+			wr[lo] = wr[hi] = d + e;
+			wi[lo] = sqrt(-w);
+			wi[hi] = -wi[lo];
+		}
+		hi -= 2;
+		iterations = 0;
+		continue;
+	}
+	if(iterations == HQR_MAX_ITERATIONS) return 0;
+	iterations++;
+	if(iterations % 11 == 0)
+	{
+		/* an ad hoc shift breaks the cycles the standard one can fall into */
+		w = fabs(a[(size_t)hi*n+hi-1]) + fabs(a[(size_t)(hi-1)*n+hi-2]);
+		__francis_(a, n, lo, hi, 1.5*w + a[(size_t)hi*n+hi], w*w);
+	}
+	else
+	{
+		/* the eigenvalues of the trailing 2 x 2 block */
+		p = a[(size_t)(hi-1)*n+hi-1];
+		d = a[(size_t)hi*n+hi];
+		__francis_(a, n, lo, hi, p + d, p*d - a[(size_t)(hi-1)*n+hi] * a[(size_t)hi*n+hi-1]);
+	}
+}
+return 1;
+}
+
+/*
+* LU factorization with partial pivoting of a small n x n matrix, in place.
+* Tiny pivots are replaced by a small value, so that singular matrices
+* ( as used by inverse iteration ) can still be solved.
+*/
+static void small_lu(double* b, int* piv, int n)
+{
+int i, j, k, p;
+double t, norm = 0.0;
+for(i = 0; i < n*n; i++) if(fabs(b[i]) > norm) norm = fabs(b[i]);
+if(norm == 0.0) norm = 1.0;
+for(k = 0; k < n; k++)
+{
+	p = k;
+	for(i = k+1; i < n; i++) if(fabs(b[i*n+k]) > fabs(b[p*n+k])) p = i;
+	piv[k] = p;
+	if(p != k) for(j = 0; j < n; j++) { t = b[k*n+j]; b[k*n+j] = b[p*n+j]; b[p*n+j] = t; }
+	if(fabs(b[k*n+k]) < EPSILON * norm) b[k*n+k] = EPSILON * norm;
+	for(i = k+1; i < n; i++)
+	{
+		t = b[i*n+k] / b[k*n+k];
+		b[i*n+k] = t;
+		for(j = k+1; j < n; j++) b[i*n+j] -= t * b[k*n+j];
+	}
+}
+}
+
+static void small_solve(const double* b, const int* piv, int n, double* x)
+{
+int i, j;
+double t;
+for(i = 0; i < n; i++)
+{
+	if(piv[i] != i) { t = x[i]; x[i] = x[piv[i]]; x[piv[i]] = t; }
+}
+for(i = 1; i < n; i++) for(j = 0; j < i; j++) x[i] -= b[i*n+j] * x[j];
+for(i = n-1; i >= 0; i--)
+{
+	for(j = i+1; j < n; j++) x[i] -= b[i*n+j] * x[j];
+	x[i] /= b[i*n+i];
+}
+}
+
+static void normalize(double* x, int n)
+{
+int i;
+double norm = sqrt(dot(x, x, n));
+if(norm == 0.0) return;
+for(i = 0; i < n; i++) x[i] /= norm;
+}
+
+/*
+* Computes an orthonormal basis of the invariant subspace of the m x m matrix h
+* associated to the eigenvalue re + i*im using inverse iteration.
+* For a real eigenvalue it is its eigenvector ( y1 ).
+* For a complex one, ( y1, y2 ) span the subspace of the conjugate pair,
+* which is the null space of the real matrix h^2 - 2*re*h + (re^2 + im^2)*I.
+*/
+static void invariant_subspace(const double* h, int m, double re, double im, double* y1, double* y2, Random* rng)
+{
+int i, j, t, it;
+int* piv = (int*)ALLOCATE(m * sizeof(int));
+double* b = (double*)ALLOCATE(m * m * sizeof(double));
+double c;
+if(im == 0.0)
+{
+	for(i = 0; i < m*m; i++) b[i] = h[i];
+	for(i = 0; i < m; i++) b[i*m+i] -= re;
+}
+else
+{
+	for(i = 0; i < m; i++)
+	{
+		for(j = 0; j < m; j++)
+		{
+			c = 0.0;
+			for(t = 0; t < m; t++) c += h[i*m+t] * h[t*m+j];
+			b[i*m+j] = c - 2.0 * re * h[i*m+j];
+		}
+		b[i*m+i] += re*re + im*im;
+	}
+}
+small_lu(b, piv, m);
+for(i = 0; i < m; i++) y1[i] = uniform_random(rng) - 0.5;
+if(im != 0.0) for(i = 0; i < m; i++) y2[i] = uniform_random(rng) - 0.5;
+for(it = 0; it < INVERSE_ITERATIONS; it++)
+{
+	small_solve(b, piv, m, y1);
+	normalize(y1, m);
+	if(im == 0.0) continue;
+	small_solve(b, piv, m, y2);
+	for(t = 0; t < 2; t++)
+	{
+		c = dot(y1, y2, m);
+		for(i = 0; i < m; i++) y2[i] -= c * y1[i];
+	}
+	normalize(y2, m);
+}
+RELEASE(piv);
+RELEASE(b);
+}
+
+/*
+* Builds the Ritz vectors x = Y^t * V for the rows of yt ( count x m ) into an EigenSystem.
+*/
+static EigenSystem* ritz_eigensystem(const Matrix* v, const double* yt, int count, int m, const double* values)
+{
+int i;
+double* data = NULL;
+Matrix* x = create_matrix((count > 0) ? count : 1, columns_matrix(v));
+Vector* e = create_vector(columns_matrix(v));
+EigenSystem* eigensys = create_eigensystem(count);
+data = e->_data;
+if(count > 0)
+{
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, count, columns_matrix(v), m,
+	1.0, yt, m, v->_data, columns_matrix(v), 0.0, x->_data, columns_matrix(x));
+}
+for(i = 0; i < count; i++)
+{
+	e->_data = x->_data + (size_t)i*columns_matrix(x);
+	normalize(e->_data, size_vector(e));
+	eigensys->_eigen[i] = create_eigen(values[i], e);
+}
+/* release previously allocated memory, e borrowed the rows of x */
+e->_data = data;
+destroy_vector(e);
+destroy_matrix(x);
+return eigensys;
+}
+
+/*
+* Replaces the first p rows of v by yt * V ( yt is p x m ), moves row m to row p
+* and clears h, leaving the thick restarted basis ready to be extended again.
+*/
+static void restart_basis(Matrix* v, Matrix* h, const double* yt, int p, int m)
+{
+int i;
+int n = columns_matrix(v);
+Matrix* x = create_matrix(p, n);
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, p, n, m, 1.0, yt, m, v->_data, n, 0.0, x->_data, n);
+for(i = 0; i < p*n; i++) v->_data[i] = x->_data[i];
+for(i = 0; i < n; i++) v->_data[(size_t)p*n+i] = v->_data[(size_t)m*n+i];
+for(i = 0; i < dimension_matrix(h); i++) h->_data[i] = 0.0;
+destroy_matrix(x);
+}
+
+/*
+* Checks the parameters common to both solvers and sets the defaults.
+* returns: 1 if the parameters are right or 0 otherwise.
+*/
+static int check_parameters(const LinearOperator* op, int k, int extra, int* ncv, double* tolerance, int* max_restarts)
+{
+int n;
+if(op == NULL || op->_apply == NULL) return 0;
+n = op->_size;
+if(k < 1 || k >= n) return 0;
+if(*ncv <= 0) *ncv = __max_(2*k + extra, 20);
+*ncv = __min_(*ncv, n);
+if(*ncv < k + extra && *ncv < n) return 0;
+if(*tolerance <= 0.0) *tolerance = DEFAULT_TOLERANCE;
+if(*max_restarts <= 0) *max_restarts = DEFAULT_MAX_RESTARTS;
+return 1;
+}
+
+/* end helper functions */
+
+/* implementation */
+
+LinearOperator* create_linear_operator(int size, OperatorFunction apply, void* context)
+{
+LinearOperator* op = NULL;
+if(size < 1 || apply == NULL) return NULL;
+op = (LinearOperator*)ALLOCATE(sizeof(LinearOperator));
+op->_size = size;
+op->_apply = apply;
+op->_context = context;
+return op;
+}
+
+LinearOperator* matrix_linear_operator(const Matrix* m)
+{
+if(m == NULL) return NULL;
+if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
+return create_linear_operator(rows_matrix(m), dense_apply, (void*)m);
+}
+
+LinearOperator* sparse_linear_operator(const SparseMatrix* s)
+{
+if(s == NULL) return NULL;
+if(rows_sparse_matrix(s) != columns_sparse_matrix(s)) return NULL; /* s must be square */
+return create_linear_operator(rows_sparse_matrix(s), sparse_apply, (void*)s);
+}
+
+void destroy_linear_operator(LinearOperator* op)
+{
+if(op == NULL) return;
+RELEASE(op);
+op = NULL;
+}
+
+EigenSystem* lanczos_eigen(const LinearOperator* op, int k, int which, double shift, int ncv, double tolerance, int max_restarts, Random* rng)
+{
+int i, j, m, p, n, restart, done;
+int* order = NULL;
+int* lock = NULL;
+double beta;
+double* theta = NULL;
+double* zero = NULL;
+double* residual = NULL;
+double* yt = NULL;
+Random state;
+Matrix* v = NULL;
+Matrix* h = NULL;
+Matrix* t = NULL;
+EigenSystem* ritz = NULL;
+EigenSystem* eigensys = NULL;
+if(!check_parameters(op, k, 2, &ncv, &tolerance, &max_restarts)) return NULL;
+INSTRUMENT_BEGIN;
+n = op->_size;
+m = ncv;
+v = create_matrix(m+1, n);
+h = create_matrix(m+1, m);
+t = create_matrix(m, m);
+order = (int*)ALLOCATE(m * sizeof(int));
+lock = (int*)ALLOCATE(m * sizeof(int));
+theta = (double*)ALLOCATE(m * sizeof(double));
+zero = (double*)ALLOCATE(m * sizeof(double));
+residual = (double*)ALLOCATE(m * sizeof(double));
+yt = (double*)ALLOCATE(m * m * sizeof(double));
+for(i = 0; i < m; i++) zero[i] = 0.0;
+if(rng == NULL)
+{
+	seed_random(&state, DEFAULT_SEED);
+	rng = &state;
+}
+random_row(v, 0, rng);
+p = 0;
+for(restart = 0; restart <= max_restarts; restart++)
+{
+	expand_basis(op, v, h, p, m, rng);
+	/* projected matrix: the lower triangle of h holds the Lanczos and restart couplings */
+	for(i = 0; i < m; i++)
+	{
+		for(j = 0; j <= i; j++)
+		{
+			t->_data[i*m+j] = h->_data[i*m+j];
+			t->_data[j*m+i] = h->_data[i*m+j];
+		}
+	}
+	ritz = symmetric_eigen_system(t);
+	beta = h->_data[m*m+m-1];
+	for(i = 0; i < m; i++)
+	{
+		order[i] = i;
+		theta[i] = eigen_value(ritz->_eigen[i]);
+		for(j = 0; j < m; j++) yt[i*m+j] = eigen_vector(ritz->_eigen[i])->_data[j];
+		residual[i] = fabs(beta * yt[i*m+m-1]);
+	}
+	destroy_eigensystem(ritz);
+	sort_ritz(order, m, theta, zero, which, shift);
+	done = 1;
+	for(i = 0; i < k; i++)
+	{
+		lock[i] = converged(theta[order[i]], residual[order[i]], tolerance);
+		if(!lock[i]) done = 0;
+	}
+	if(done || restart == max_restarts || m == n) break;
+	/* thick restart keeping the wanted Ritz vectors and some more */
+	p = __min_(k + (m-k)/2, m-1);
+	for(i = k; i < p; i++) lock[i] = 0;
+	for(i = 0; i < p; i++)
+	{
+		for(j = 0; j < m; j++) t->_data[i*m+j] = yt[order[i]*m+j];
+	}
+	restart_basis(v, h, t->_data, p, m);
+	for(i = 0; i < p; i++)
+	{
+		h->_data[i*m+i] = theta[order[i]];
+		/* locked Ritz pairs are decoupled from the new vector */
+		h->_data[p*m+i] = (lock[i]) ? 0.0 : beta * yt[order[i]*m+m-1];
+	}
+}
+if(done || m == n)
+{
+	/* build eigensystem from the k wanted Ritz pairs */
+	for(i = 0; i < k; i++)
+	{
+		zero[i] = theta[order[i]];
+		for(j = 0; j < m; j++) t->_data[i*m+j] = yt[order[i]*m+j];
+	}
+	eigensys = ritz_eigensystem(v, t->_data, k, m, zero);
+}
+
+/* release previously allocated memory */
+RELEASE(order);
+RELEASE(lock);
+RELEASE(theta);
+RELEASE(zero);
+RELEASE(residual);
+RELEASE(yt);
+destroy_matrix(v);
+destroy_matrix(h);
+destroy_matrix(t);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_LANCZOS_EIGEN, restart);
+INSTRUMENT_END(INSTRUMENT_LANCZOS_EIGEN, 4.0*n*m*m*(restart+1)); /* orthogonalization of the basis */
+return eigensys;
+}
+
+EigenSystem* arnoldi_eigen(const LinearOperator* op, int k, int which, double shift, int ncv, double tolerance, int max_restarts, Random* rng)
+{
+int i, j, c, m, n, p, q, count, want, pass, restart, done, ok;
+int* order = NULL;
+int* good = NULL;
+int* lock = NULL;
+double beta, norm;
+double* wr = NULL;
+double* wi = NULL;
+double* values = NULL;
+double* hm = NULL;
+double* qt = NULL;
+double* tmp = NULL;
+Random state;
+Matrix* v = NULL;
+Matrix* h = NULL;
+EigenSystem* eigensys = NULL;
+if(!check_parameters(op, k, 3, &ncv, &tolerance, &max_restarts)) return NULL;
+INSTRUMENT_BEGIN;
+n = op->_size;
+m = ncv;
+v = create_matrix(m+1, n);
+h = create_matrix(m+1, m);
+order = (int*)ALLOCATE(m * sizeof(int));
+good = (int*)ALLOCATE(m * sizeof(int));
+lock = (int*)ALLOCATE((m+1) * sizeof(int));
+wr = (double*)ALLOCATE(m * sizeof(double));
+wi = (double*)ALLOCATE(m * sizeof(double));
+values = (double*)ALLOCATE(m * sizeof(double));
+hm = (double*)ALLOCATE(m * m * sizeof(double));
+qt = (double*)ALLOCATE((m+1) * m * sizeof(double));
+tmp = (double*)ALLOCATE(m * m * sizeof(double));
+if(rng == NULL)
+{
+	seed_random(&state, DEFAULT_SEED);
+	rng = &state;
+}
+random_row(v, 0, rng);
+p = 0;
+done = 0;
+ok = 1;
+for(restart = 0; restart <= max_restarts; restart++)
+{
+	expand_basis(op, v, h, p, m, rng);
+	beta = h->_data[m*m+m-1];
+	for(i = 0; i < m*m; i++) hm[i] = h->_data[i];
+	ok = __general_eigenvalues_(hm, m, wr, wi);
+	if(!ok) break;
+	for(i = 0; i < m; i++) order[i] = i;
+	sort_ritz(order, m, wr, wi, which, shift);
+	/* number of wanted Ritz values, without splitting a complex conjugate pair */
+	want = k;
+	if(wi[order[k-1]] > 0.0) want = k+1;
+	/* number of Ritz values to keep in the restart */
+	count = __max_(want, __min_(k + (m-k)/2, m-2));
+	if(count < m && wi[order[count-1]] > 0.0) count++;
+	if(count > m-1) count = want;
+	/* check convergence of the wanted Ritz values */
+	done = 1;
+	for(i = 0; i < count; i++)
+	{
+		c = order[i];
+		good[i] = 0;
+		if(wi[c] < 0.0) continue; /* handled with its conjugate */
+		invariant_subspace(h->_data, m, wr[c], wi[c], qt, qt + m, rng);
+		norm = qt[m-1] * qt[m-1];
+		if(wi[c] != 0.0) norm += qt[2*m-1] * qt[2*m-1];
+		good[i] = (i < want) && converged(sqrt(wr[c]*wr[c] + wi[c]*wi[c]), fabs(beta) * sqrt(norm), tolerance);
+		if(i < want && !good[i]) done = 0;
+	}
+	if(done || restart == max_restarts || m == n) break;
+	/*
+	* orthonormal basis ( rows of qt ) of the invariant subspace of the kept Ritz values,
+	* with the converged ones first so that they can be locked.
+	*/
+	q = 0;
+	for(pass = 1; pass >= 0; pass--)
+	{
+		for(i = 0; i < count; i++)
+		{
+			c = order[i];
+			if(wi[c] < 0.0 || good[i] != pass) continue;
+			invariant_subspace(h->_data, m, wr[c], wi[c], qt + q*m, qt + (q+1)*m, rng);
+			lock[q++] = pass;
+			if(wi[c] != 0.0) lock[q++] = pass;
+		}
+	}
+	p = 0;
+	for(j = 0; j < q; j++)
+	{
+		for(pass = 0; pass < 2; pass++)
+		{
+			for(i = 0; i < p; i++)
+			{
+				norm = dot(qt + i*m, qt + j*m, m);
+				for(c = 0; c < m; c++) qt[j*m+c] -= norm * qt[i*m+c];
+			}
+		}
+		norm = sqrt(dot(qt + j*m, qt + j*m, m));
+		if(norm <= 1E-10) continue; /* dependent vector, drop it */
+		for(c = 0; c < m; c++) qt[p*m+c] = qt[j*m+c] / norm;
+		lock[p] = lock[j] && (p == 0 || lock[p-1]);
+		p++;
+	}
+	/* tmp = qt * hm * qt^t is the new projected matrix */
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, p, m, m, 1.0, qt, m, h->_data, m, 0.0, hm, m);
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_TRANS, p, p, m, 1.0, hm, m, qt, m, 0.0, tmp, p);
+	restart_basis(v, h, qt, p, m);
+	for(i = 0; i < p; i++)
+	{
+		for(j = 0; j < p; j++) h->_data[i*m+j] = tmp[i*p+j];
+		/* the converged leading block is locked, it is decoupled from the new vector */
+		h->_data[p*m+i] = (lock[i]) ? 0.0 : beta * qt[i*m+m-1];
+	}
+}
+if(ok && (done || m == n))
+{
+	/* build eigensystem from the real wanted Ritz pairs */
+	count = 0;
+	for(i = 0; i < k; i++)
+	{
+		c = order[i];
+		if(wi[c] != 0.0) continue;
+		invariant_subspace(h->_data, m, wr[c], 0.0, qt + count*m, NULL, rng);
+		values[count++] = wr[c];
+	}
+	eigensys = ritz_eigensystem(v, qt, count, m, values);
+}
+
+/* release previously allocated memory */
+RELEASE(order);
+RELEASE(good);
+RELEASE(lock);
+RELEASE(wr);
+RELEASE(wi);
+RELEASE(values);
+RELEASE(hm);
+RELEASE(qt);
+RELEASE(tmp);
+destroy_matrix(v);
+destroy_matrix(h);
+
+INSTRUMENT_ITERATIONS(INSTRUMENT_ARNOLDI_EIGEN, restart);
+INSTRUMENT_END(INSTRUMENT_ARNOLDI_EIGEN, 4.0*n*m*m*(restart+1)); /* orthogonalization of the basis */
+return eigensys;
+}
+
+/* END */
@@ -20,6 +20,7 @@
 
 #include <stddef.h>
 #include "linearsys.h"
+#include "instrument.h"
 
 /*
 * Declaration of determination system threshold.
@@ -40,12 +41,15 @@ return (x < 0) ? -x : x;
 static double __k_det_(const Matrix* m, const Vector* v, int k)
 {
 	int i;
+double d;
 Matrix* a = clone_matrix(m);
 for(i = 0; i < a->_rows; i++)
 {
 	*(a->_data + i*a->_columns + k) = v->_data[i];
 }
-return det_matrix(a);
+d = det_matrix(a);
+destroy_matrix(a);
+return d;
 }
 
 /*
@@ -64,14 +68,18 @@ i = 0;
   row = i;
   for(k = i+1; k < u->_rows; k++)
    {
-   if(__abs_(*(u->_data + k*m->_columns)) > pivot)
+   if(__abs_(*(u->_data + k*u->_columns + i)) > pivot)
    {
-    pivot = __abs_(*(u->_data + k*m->_columns));
+    pivot = __abs_(*(u->_data + k*u->_columns + i));
     row = k;
    }
 }
    /* check for determination */
-   if(pivot < __threshold__) return NULL;
+   if(pivot < __threshold__)
+   {
+    destroy_matrix(u);
+    return NULL;
+   }
    if(i != row) /* swap rows if necessary */
   {
     for(j = 0; j < u->_columns; j++)
@@ -101,8 +109,11 @@ return u;
 static Vector* __triangular_system_solver_(const Matrix* m)
 {
 int i, j;
-int dim = dimension_matrix(m);
-Vector* x = create_vector(m->_rows);
+int dim;
+Vector* x = NULL;
+if(m == NULL) return NULL; /* singular system */
+dim = dimension_matrix(m);
+x = create_vector(m->_rows);
 /*
 * compute xn.
 */
@@ -123,7 +134,7 @@ return x;
 /*
 * Function to handle permutation.
 */
-static Vector* handle_permutation(int* p, Vector* v)
+static Vector* handle_permutation(const int* p, const Vector* v)
 {
 	int i;
 	Vector* x = clone_vector(v);
@@ -188,6 +199,7 @@ Matrix* a = NULL;
 Vector* x = NULL;
 Vector* s = NULL;
 if(m->_rows+1 != m->_columns) return NULL;
+INSTRUMENT_BEGIN;
 a = create_matrix(m->_rows, m->_rows);
 for(i = 0; i < a->_rows; i++)
 {
@@ -197,7 +209,12 @@ for(j = 0; j < a->_columns; j++)
 }
 }
 d = det_matrix(a);
-if(!d) return NULL;
+if(!d)
+{
+destroy_matrix(a);
+INSTRUMENT_END(INSTRUMENT_SMCRAMER_SYSTEM_SOLVER, 0.0);
+return NULL;
+}
 x = create_vector(m->_rows);
 for(i = 0; i < x->_size; i++)
 {
@@ -211,6 +228,7 @@ s->_data[i] = __k_det_(a, x, i) / d;
 }
 destroy_matrix(a);
 destroy_vector(x);
+INSTRUMENT_END(INSTRUMENT_SMCRAMER_SYSTEM_SOLVER, 0.0);
 return s;
 }
 
@@ -220,27 +238,44 @@ Vector* mvcramer_system_solver(const Matrix* m, const Vector* v)
 	double d;
 Vector* x = NULL;
 if(m->_rows != m->_columns || v->_size != m->_rows) return NULL;
+INSTRUMENT_BEGIN;
 d = det_matrix(m);
-if(!d) return NULL;
+if(!d)
+{
+INSTRUMENT_END(INSTRUMENT_MVCRAMER_SYSTEM_SOLVER, 0.0);
+return NULL;
+}
 x = create_vector(v->_size);
 for(i = 0; i < x->_size; i++)
 {
 x->_data[i] = __k_det_(m, v, i) / d;
 }
+INSTRUMENT_END(INSTRUMENT_MVCRAMER_SYSTEM_SOLVER, 0.0);
 return x;
 }
 
 Vector* smgauss_system_solver(const Matrix* m)
 {
+Matrix* u = NULL;
+Vector* x = NULL;
 if(m->_rows+1 != m->_columns) return NULL;
-return __triangular_system_solver_(__gaussian_elimination_(m));
+INSTRUMENT_BEGIN;
+u = __gaussian_elimination_(m);
+x = __triangular_system_solver_(u);
+/* release previously allocated memory */
+destroy_matrix(u);
+INSTRUMENT_END(INSTRUMENT_SMGAUSS_SYSTEM_SOLVER, 2.0/3.0*m->_rows*m->_rows*m->_rows);
+return x;
 }
 
 Vector* mvgauss_system_solver(const Matrix* m, const Vector* v)
 {
 	int i, j;
 Matrix* s = NULL;
+Matrix* u = NULL;
+Vector* x = NULL;
 if(m->_rows != m->_columns || v->_size != m->_rows) return NULL;
+INSTRUMENT_BEGIN;
 s = create_matrix(m->_rows, m->_rows+1);
 /*
 * Build extended system's matrix.
@@ -257,33 +292,64 @@ for(i = 0; i < s->_rows; i++)
 {
 	*(s->_data + i*s->_columns + j) = v->_data[i];
 }
-return __triangular_system_solver_(__gaussian_elimination_(s));
+u = __gaussian_elimination_(s);
+x = __triangular_system_solver_(u);
+/* release previously allocated memory */
+destroy_matrix(s);
+destroy_matrix(u);
+INSTRUMENT_END(INSTRUMENT_MVGAUSS_SYSTEM_SOLVER, 2.0/3.0*m->_rows*m->_rows*m->_rows);
+return x;
 }
 
 Vector* lu_system_solver(const LU* lu, const Vector* v)
 {
 int i, pivoting = 0;
 Vector* x = NULL;
+Vector* y = NULL;
+Vector* z = NULL;
+if(lu == NULL || v == NULL) return NULL;
 if(rows_matrix(lu->_lower) != v->_size) return NULL;
-x = clone_vector(v);
-for(i = 0; i < x->_size; i++)
+INSTRUMENT_BEGIN;
+for(i = 0; i < v->_size; i++)
 {
-if(x->_data[i] != lu->_permutation[i])
+if(lu->_permutation[i] != i)
 {
 	pivoting = 1;
 	break;
 }
 }
-if(pivoting) x = handle_permutation(lu->_permutation, x);
-return upper_system_solver(lu->_upper, lower_system_solver(lu->_lower, x));
+x = (pivoting) ? handle_permutation(lu->_permutation, v) : clone_vector(v);
+y = lower_system_solver(lu->_lower, x);
+z = upper_system_solver(lu->_upper, y);
+/* release previously allocated memory */
+destroy_vector(x);
+destroy_vector(y);
+INSTRUMENT_END(INSTRUMENT_LU_SYSTEM_SOLVER, 2.0*v->_size*v->_size);
+return z;
 }
 
 Vector* qr_system_solver(const QR* qr, const Vector* v)
 {
 	int i;
-	Matrix* _q = create_matrix(rows_matrix(qr_q(qr)), 1);
+	Matrix* _q = NULL;
+	Matrix* qt = NULL;
+	Matrix* b = NULL;
+	Vector* y = NULL;
+	Vector* x = NULL;
+	INSTRUMENT_BEGIN;
+	_q = create_matrix(rows_matrix(qr_q(qr)), 1);
 	for(i = 0; i < rows_matrix(_q); i++) _q->_data[i] = v->_data[i];
-	return upper_system_solver(qr_r(qr), get_column_vector(mul_matrix(transpose_matrix(qr_q(qr)), _q), 0));
+	qt = transpose_matrix(qr_q(qr));
+	b = mul_matrix(qt, _q);
+	y = get_column_vector(b, 0);
+	x = upper_system_solver(qr_r(qr), y);
+	/* release previously allocated memory */
+	destroy_matrix(_q);
+	destroy_matrix(qt);
+	destroy_matrix(b);
+	destroy_vector(y);
+	INSTRUMENT_END(INSTRUMENT_QR_SYSTEM_SOLVER, 3.0*v->_size*v->_size);
+	return x;
 }
 
 /* END */
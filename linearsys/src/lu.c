@@ -21,6 +21,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "lu.h"
+#include "allocator.h"
+#include "kernel.h"
+#include "tuning.h"
+#include "instrument.h"
+#include "trace.h"
 
 /* declare a threshold constant to check for determination */
 static const double __threshold_ = 1E-6;
@@ -33,6 +38,95 @@ static double __abs_(double x)
 return (x < 0.0) ? -x : x;
 }
 
+/*
+* Factorizes the panel of columns k0 .. end-1 of the n x n array w with partial pivoting,
+* swapping whole rows and leaving the multipliers below the diagonal.
+* Returns end on success or the column whose pivot is too small.
+*/
+static int __panel_(double* w, int* permutation, int n, int k0, int end)
+{
+int i, j, k, r, row;
+double pivot, tmp, l;
+TRACE_BEGIN;
+for(i = k0; i < end; i++)
+{
+	pivot = __abs_(w[(size_t)i*n+i]);
+	row = i;
+	for(k = i+1; k < n; k++)
+	{
+		if(__abs_(w[(size_t)k*n+i]) > pivot)
+		{
+			pivot = __abs_(w[(size_t)k*n+i]);
+			row = k;
+		}
+	}
+	if(pivot < __threshold_) return i;
+	if(i != row)
+	{
+		for(j = 0; j < n; j++)
+		{
+			tmp = w[(size_t)i*n+j];
+			w[(size_t)i*n+j] = w[(size_t)row*n+j];
+			w[(size_t)row*n+j] = tmp;
+		}
+		k = permutation[i];
+		permutation[i] = permutation[row];
+		permutation[row] = k;
+	}
+	for(r = i+1; r < n; r++)
+	{
+		l = w[(size_t)r*n+i] / w[(size_t)i*n+i];
+		w[(size_t)r*n+i] = l;
+		for(j = i+1; j < end; j++) w[(size_t)r*n+j] -= l * w[(size_t)i*n+j];
+	}
+}
+TRACE_END("lu_panel", k0, k0);
+return end;
+}
+
+/*
+* Solves the block row of U on the right of the panel: U12 = L11^-1 * A12.
+*/
+static void __solve_row_(double* w, int n, int k0, int end)
+{
+int i, j, r;
+double l;
+TRACE_BEGIN;
+for(i = k0; i < end; i++)
+{
+	for(r = i+1; r < end; r++)
+	{
+		l = w[(size_t)r*n+i];
+		if(l == 0.0) continue;
+		for(j = end; j < n; j++) w[(size_t)r*n+j] -= l * w[(size_t)i*n+j];
+	}
+}
+TRACE_END("lu_solve_row", k0, end);
+}
+
+/*
+* Right looking blocked LU decomposition with partial pivoting, in place in the n x n array w.
+* Each panel of block columns is factorized, then the block row of U on its right is solved
+* and the trailing matrix is updated with a matrix product: A22 = A22 - L21 * U12.
+* Returns n on success or the column whose pivot is too small.
+*/
+static int __blocked_(double* w, int* permutation, int n, int block)
+{
+int k0, kb, end, i;
+for(k0 = 0; k0 < n; k0 += block)
+{
+	kb = (n-k0 < block) ? n-k0 : block;
+	end = k0+kb;
+	i = __panel_(w, permutation, n, k0, end);
+	if(i < end) return i;
+	if(end == n) break;
+	__solve_row_(w, n, k0, end);
+	kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, n-end, n-end, kb, -1.0,
+	w + (size_t)end*n + k0, n, w + (size_t)k0*n + end, n, 1.0, w + (size_t)end*n + end, n);
+}
+return n;
+}
+
 /* Implementation */
 
 void destroy_lu(LU* lu)
@@ -40,12 +134,12 @@ void destroy_lu(LU* lu)
 if(lu == NULL) return;
 if(lu_permutation(lu) != NULL)
 {
-free(lu->_permutation);
+RELEASE(lu->_permutation);
 lu->_permutation = NULL;
 }
 if(lu->_lower != NULL) destroy_matrix(lu_lower(lu));
 if(lu->_upper != NULL) destroy_matrix(lu_upper(lu));
-free(lu);
+RELEASE(lu);
 lu = NULL;
 }
 
@@ -56,42 +150,80 @@ int i, j, k;
 double pivot, tmp, remove, t;
 LU* lu = NULL;
 if(rows_matrix(m) != columns_matrix(m)) return NULL;
-lu = (LU*)malloc(sizeof(LU));
+INSTRUMENT_BEGIN;
+lu = (LU*)ALLOCATE(sizeof(LU));
 lu->_upper = clone_matrix(m);
 n = rows_matrix(lu->_upper);
 lu->_lower = identity_matrix(n);
-lu->_permutation = (int*)malloc(n*sizeof(int));
+lu->_permutation = (int*)ALLOCATE(n*sizeof(int));
 for(i = 0; i < n; i++) lu->_permutation[i] = i;
+if(n > get_tuning()->_lu_block)
+{
+	i = __blocked_(lu->_upper->_data, lu->_permutation, n, get_tuning()->_lu_block);
+	if(i < n)
+	{
+		/* release previously allocated memory */
+		destroy_lu(lu);
+		INSTRUMENT_END(INSTRUMENT_LU_DECOMPOSITION, 2.0/3.0*((double)n*n*n - (double)(n-i)*(n-i)*(n-i)));
+		return NULL;
+	}
+	/* move the multipliers to lower */
+	for(i = 1; i < n; i++)
+	{
+		for(j = 0; j < i; j++)
+		{
+			lu->_lower->_data[(size_t)i*n+j] = lu->_upper->_data[(size_t)i*n+j];
+			lu->_upper->_data[(size_t)i*n+j] = 0.0;
+		}
+	}
+	INSTRUMENT_END(INSTRUMENT_LU_DECOMPOSITION, 2.0/3.0*n*n*n);
+	return lu;
+}
 i = 0;
 while(i < n)
 {
+/* find the largest pivot in column i */
 pivot = __abs_(lu->_upper->_data[i*n+i]);
 row = i;
 for(k = i+1; k < n; k++)
 {
-if(__abs_(lu->_upper->_data[k*n]) > pivot)
+if(__abs_(lu->_upper->_data[k*n+i]) > pivot)
 {
-	pivot = __abs_(lu->_upper->_data[k*n]);
+	pivot = __abs_(lu->_upper->_data[k*n+i]);
 	row = k;
 }
 }
-if(pivot < __threshold_) return NULL;
+if(pivot < __threshold_)
+{
+/* release previously allocated memory */
+destroy_lu(lu);
+INSTRUMENT_END(INSTRUMENT_LU_DECOMPOSITION, 2.0/3.0*((double)n*n*n - (double)(n-i)*(n-i)*(n-i)));
+return NULL;
+}
 if(i != row)
 {
+/* swap rows in upper and the multipliers already stored in lower */
 for(j = 0; j < n; j++)
 {
 	tmp = lu->_upper->_data[i*n+j];
 	lu->_upper->_data[i*n+j] = lu->_upper->_data[row*n+j];
 	lu->_upper->_data[row*n+j] = tmp;
-	lu->_permutation[i] = row;
-	lu->_permutation[row] = i;
 }
+for(j = 0; j < i; j++)
+{
+	tmp = lu->_lower->_data[i*n+j];
+	lu->_lower->_data[i*n+j] = lu->_lower->_data[row*n+j];
+	lu->_lower->_data[row*n+j] = tmp;
+}
+k = lu->_permutation[i];
+lu->_permutation[i] = lu->_permutation[row];
+lu->_permutation[row] = k;
 }
 for(j = i+1; j < n; j++)
 {
 remove = -(lu->_upper->_data[j*n+i]) / lu->_upper->_data[i*n+i];
 lu->_lower->_data[j*n+i] = -remove;
-for(k = 0; k < n; k++)
+for(k = i; k < n; k++)
 {
 t = lu->_upper->_data[j*n+k]+remove*lu->_upper->_data[i*n+k];
 lu->_upper->_data[j*n+k] = t;
@@ -99,6 +231,7 @@ lu->_upper->_data[j*n+k] = t;
 }
 i++;
 }
+INSTRUMENT_END(INSTRUMENT_LU_DECOMPOSITION, 2.0/3.0*n*n*n);
 return lu;
 }
 
@@ -21,10 +21,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 #include "numio.h"
 #include "matrix.h"
+#include "allocator.h"
+#include "numa.h"
 #include "linearsys.h"
 #include "svd.h"
+#include "kernel.h"
+#include "instrument.h"
 
 #define THRESHOLD 1E-6
 
@@ -77,6 +82,7 @@ if(i != k) ai++;
 		d+=sign * *(m->_data + k*m->_columns) * __det_(adj, n-1);
 		sign *= -1.0;
 	}
+	destroy_matrix(adj);
 }
 return d;
 }
@@ -112,92 +118,100 @@ static double _square_(double x)
 return x*x;
 }
 
-/* end helper functions */
-
-/* implementation */
-Matrix* create_matrix(int r, int c)
+/*
+* Helper function to allocate a matrix leaving its entries untouched,
+* so that initialize_numa places their pages.
+*/
+static Matrix* __allocate_matrix_(int r, int c)
 {
-int i, j, dim;
-Matrix* m = (Matrix*)malloc(sizeof(Matrix));
+int dim;
+Matrix* m = (Matrix*)ALLOCATE(sizeof(Matrix));
 m->_rows = r;
 m->_columns = c;
 dim = m->_rows * m->_columns;
-m->_data = (double*)malloc(dim*sizeof(double));
-for(i = 0; i < m->_rows; i++)
-{
-for(j = 0; j < m->_columns; j++)
-{
-	*(m->_data + i*m->_columns + j) = 0.0;
-}
+m->_data = (double*)ALLOCATE_ALIGNED(dim*sizeof(double));
+INSTRUMENT_ALLOCATE(1, (size_t)dim*sizeof(double));
+return m;
 }
+
+/* end helper functions */
+
+/* implementation */
+Matrix* create_matrix(int r, int c)
+{
+Matrix* m = __allocate_matrix_(r, c);
+initialize_numa(m->_data, NULL, m->_rows, m->_columns);
 return m;
 }
 
 void destroy_matrix(Matrix* m)
 {
 if(!m) return;
-if(m->_data) free(m->_data);
+INSTRUMENT_FREE(1, (m->_data) ? (size_t)m->_rows*m->_columns*sizeof(double) : 0);
+if(m->_data) RELEASE_ALIGNED(m->_data);
 m->_data = NULL;
-free(m);
+RELEASE(m);
 m = NULL;
 }
 
 Matrix* clone_matrix(const Matrix* m)
 {
-	int i, j;
 	Matrix* result = NULL;
 if(!m || m->_rows < 1 || m->_columns <1) return NULL;
-result = create_matrix(m->_rows, m->_columns);
-for(i = 0; i < result->_rows; i++)
-{
-for(j = 0; j < result->_columns; j++)
-{
-	*(result->_data + i*result->_columns + j) = *(m->_data + i*m->_columns + j);
-}
-}
+result = __allocate_matrix_(m->_rows, m->_columns);
+initialize_numa(result->_data, m->_data, result->_rows, result->_columns);
 return result;
 }
 
 Matrix* load_matrix(const char* filename)
 {
-	double d;
-	int i, j, r, c;
+	long r, c;
+	size_t length;
+	char* text = NULL;
+	char* p = NULL;
 	Matrix* result = NULL;
-FILE* file = fopen_read(filename);
-fread_int(file, &r);
-fread_int(file, &c);
-if(r < 1 || c < 1) return NULL;
-result = create_matrix(r, c);
-for(i = 0; i < result->_rows; i++)
-{
-for(j = 0; j < result->_columns; j++)
+/* read the whole file at once and parse it in memory */
+text = read_text_file(filename, &length);
+if(text == NULL) return NULL;
+r = strtol(text, &p, 10);
+c = strtol(p, &p, 10);
+if(r < 1 || c < 1 || r > INT_MAX / c)
 {
-	fread_double(file, &d);
-	*(result->_data + i*result->_columns + j) = d;
+	RELEASE(text);
+	return NULL;
 }
+result = create_matrix((int)r, (int)c);
+/* a file with less entries than announced ( truncated or with a bad number ) is rejected */
+if(parse_doubles(p, length - (size_t)(p - text), result->_data, result->_rows * result->_columns) != result->_rows * result->_columns)
+{
+	destroy_matrix(result);
+	result = NULL;
 }
-fclose(file);
+RELEASE(text);
 return result;
 }
 
 void store_matrix(const Matrix* m, const char* filename)
 {
 int i, j;
-FILE* file = fopen_write(filename);
-fwrite_int(file, m->_rows);
-fprintf(file, " ");
-fwrite_int(file, m->_columns);
-fprintf(file, "\n");
+const double* row = NULL;
+TextOutput* out = open_text_output(filename);
+if(out == NULL) return;
+write_text_int(out, m->_rows);
+write_text_char(out, ' ');
+write_text_int(out, m->_columns);
+write_text_char(out, '\n');
 for(i = 0; i < m->_rows; i++)
 {
+	row = m->_data + (size_t)i*m->_columns;
 	for(j = 0; j < m->_columns; j++)
 	{
-		if(j > 0) fprintf(file, " ");
-		fwrite_double(file, *(m->_data + i*m->_columns +j));
+		if(j > 0) write_text_char(out, ' ');
+		write_text_double(out, row[j]);
 	}
-	fprintf(file, "\n");
+	write_text_char(out, '\n');
 }
-fclose(file);
+close_text_output(out);
 }
 
 void print_matrix(const Matrix* m)
@@ -292,6 +306,7 @@ Matrix* add_matrix(const Matrix* m1, const Matrix* m2)
 int i, j;
 Matrix* m = NULL;
 if(m1->_rows!=m2->_rows || m1->_columns!=m2->_columns) return NULL;
+INSTRUMENT_BEGIN;
 m = create_matrix(m1->_rows, m1->_columns);
 for(i = 0; i < m->_rows; i++)
 {
@@ -300,6 +315,7 @@ for(j = 0; j < m->_columns; j++)
 	*(m->_data + i*m->_columns + j) = *(m1->_data + i*m1->_columns + j) + *(m2->_data + i*m2->_columns + j);
 }
 }
+INSTRUMENT_END(INSTRUMENT_ADD_MATRIX, (double)m->_rows*m->_columns);
 return m;
 }
 
@@ -308,6 +324,7 @@ Matrix* sub_matrix(const Matrix* m1, const Matrix* m2)
 int i, j;
 Matrix* m = NULL;
 if(m1->_rows!=m2->_rows || m1->_columns!=m2->_columns) return NULL;
+INSTRUMENT_BEGIN;
 m = create_matrix(m1->_rows, m1->_columns);
 for(i = 0; i < m->_rows; i++)
 {
@@ -316,36 +333,44 @@ for(j = 0; j < m->_columns; j++)
 	*(m->_data + i*m->_columns + j) = *(m1->_data + i*m1->_columns + j) - *(m2->_data + i*m2->_columns + j);
 }
 }
+INSTRUMENT_END(INSTRUMENT_SUB_MATRIX, (double)m->_rows*m->_columns);
 return m;
 }
 
 Matrix* mul_matrix(const Matrix* m1, const Matrix* m2)
 {
-	double accum = 0.0;
-int i, j, k;
 Matrix* m = NULL;
 if(m1->_columns != m2->_rows) return NULL;
+INSTRUMENT_BEGIN;
 m = create_matrix(m1->_rows, m2->_columns);
-for(i = 0; i < m->_rows; i++)
-{
-for(j = 0; j < m->_columns; j++)
-{
-	accum = 0.0;
-	for(k = 0; k < m1->_columns; k++)
-	{
-		accum += *(m1->_data + i*m1->_columns + k) * *(m2->_data + k*m2->_columns + j);
-	}
-	*(m->_data + i*m->_columns + j) = accum;
-}
-}
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, m->_rows, m->_columns, m1->_columns,
+1.0, m1->_data, m1->_columns, m2->_data, m2->_columns, 0.0, m->_data, m->_columns);
+INSTRUMENT_END(INSTRUMENT_MUL_MATRIX, 2.0*m->_rows*m->_columns*m1->_columns);
 return m;
 }
 
+int gemm_matrix(double alpha, const Matrix* a, int transa, const Matrix* b, int transb, double beta, Matrix* c)
+{
+int m, n, k;
+if(a == NULL || b == NULL || c == NULL) return 0;
+m = (transa) ? columns_matrix(a) : rows_matrix(a);
+k = (transa) ? rows_matrix(a) : columns_matrix(a);
+n = (transb) ? rows_matrix(b) : columns_matrix(b);
+if(k != ((transb) ? columns_matrix(b) : rows_matrix(b))) return 0;
+if(rows_matrix(c) != m || columns_matrix(c) != n) return 0;
+INSTRUMENT_BEGIN;
+kernel_gemm((transa) ? KERNEL_TRANS : KERNEL_NO_TRANS, (transb) ? KERNEL_TRANS : KERNEL_NO_TRANS,
+m, n, k, alpha, a->_data, a->_columns, b->_data, b->_columns, beta, c->_data, c->_columns);
+INSTRUMENT_END(INSTRUMENT_GEMM_MATRIX, 2.0*m*n*k);
+return 1;
+}
+
 Matrix* scale_matrix(const Matrix* m, double value)
 {
 	int i, j;
 Matrix* out = NULL;
 if(m == NULL) return NULL;
+INSTRUMENT_BEGIN;
 out = clone_matrix(m);
 for(i = 0; i < rows_matrix(out); i++)
 {
@@ -354,6 +379,7 @@ for(i = 0; i < rows_matrix(out); i++)
 		out->_data[i*columns_matrix(out)+j] *= value;
 	}
 }
+INSTRUMENT_END(INSTRUMENT_SCALE_MATRIX, (double)rows_matrix(out)*columns_matrix(out));
 return out;
 }
 
@@ -371,7 +397,9 @@ return m;
 Matrix* transpose_matrix(const Matrix* m)
 {
 int i, j;
-Matrix* t = create_matrix(m->_columns, m->_rows);
+Matrix* t = NULL;
+INSTRUMENT_BEGIN;
+t = create_matrix(m->_columns, m->_rows);
 for(i = 0; i < t->_rows; i++)
 {
 for(j = 0; j < t->_columns; j++)
@@ -379,6 +407,7 @@ for(j = 0; j < t->_columns; j++)
 	*(t->_data + i*t->_columns +j) = *(m->_data + j*m->_columns +i);
 }
 }
+INSTRUMENT_END(INSTRUMENT_TRANSPOSE_MATRIX, 0.0);
 return t;
 }
 
@@ -417,9 +446,14 @@ Vector* v = NULL;
 Vector* x = NULL;
 LU* lu = NULL;
 if(rows_matrix(m) != columns_matrix(m)) return NULL;
+INSTRUMENT_BEGIN;
 lu = lu_decomposition(m);
+if(lu == NULL)
+{
+INSTRUMENT_END(INSTRUMENT_INVERSE_MATRIX, 0.0);
+return NULL; /* singular matrix */
+}
 v = create_vector(rows_matrix(m));
-x = create_vector(rows_matrix(m));
 out = create_matrix(rows_matrix(m), rows_matrix(m));
 
 for(i = 0; i < rows_matrix(m); i++)
@@ -431,21 +465,25 @@ for(j = 0; j < out->_columns; j++)
 {
 	out->_data[j*out->_columns+i] = x->_data[j];
 }
+destroy_vector(x);
 }
 
 destroy_lu(lu);
 destroy_vector(v);
-destroy_vector(x);
 
+INSTRUMENT_END(INSTRUMENT_INVERSE_MATRIX, 2.0*rows_matrix(m)*rows_matrix(m)*rows_matrix(m));
 return out;
 }
 
 double det_matrix(const Matrix* m)
 {
 Matrix* t = NULL;
+double d;
 if(m->_rows != m->_columns) return 0.0;
 t = clone_matrix(m);
-return __det_(t, t->_rows);
+d = __det_(t, t->_rows);
+destroy_matrix(t);
+return d;
 }
 
 Matrix* rotation_matrix(double x,double y,double z,double w)
@@ -540,13 +578,25 @@ return v;
 int is_orthogonal_matrix(const Matrix* m)
 {
 	int i, j;
+double d;
+Vector* u = NULL;
+Vector* v = NULL;
 if(rows_matrix(m) != columns_matrix(m)) return 0;
 for(i= 0; i < columns_matrix(m)-1; i++)
 {
+u = get_column_vector(m, i);
 for(j = i+1; j < columns_matrix(m); j++)
 {
-if(dot_product_vector(get_column_vector(m, i), get_column_vector(m, j)) > THRESHOLD) return 0;
+v = get_column_vector(m, j);
+d = dot_product_vector(u, v);
+destroy_vector(v);
+if(d > THRESHOLD)
+{
+destroy_vector(u);
+return 0;
+}
 }
+destroy_vector(u);
 }
 return 1;
 }
@@ -554,11 +604,16 @@ return 1;
 int is_orthonormal_matrix(const Matrix* m)
 {
 	int j;
+	double d;
+	Vector* v = NULL;
 	if(m == NULL) return 0;
 	if(!is_orthogonal_matrix(m)) return 0;
 	for(j = 0; j < columns_matrix(m); j++)
 	{
-		if(round(module_vector(get_column_vector(m, j))) != 1) return 0;
+		v = get_column_vector(m, j);
+		d = module_vector(v);
+		destroy_vector(v);
+		if(round(d) != 1) return 0;
 		}
 	return 1;
 }
@@ -598,8 +653,11 @@ Matrix* pseudoinverse_matrix(const Matrix* m)
 int i, k;
 SVD* svd = NULL;
 Matrix* sigma_t = NULL;
+Matrix* vs = NULL;
+Matrix* ut = NULL;
 Matrix* out = NULL;
 if(m == NULL) return NULL;
+INSTRUMENT_BEGIN;
 svd = svd_factorization(m);
 k = (rows_matrix(m) <= columns_matrix(m)) ? rows_matrix(m) : columns_matrix(m);
 sigma_t = transpose_matrix(svd_sigma(svd));
@@ -607,12 +665,17 @@ for(i = 0; i < k; i++)
 {
 set_matrix(sigma_t, 1.0 / get_matrix(sigma_t, i, i), i, i);
 }
-out = mul_matrix(mul_matrix(svd_v(svd), sigma_t), transpose_matrix(svd_u(svd)));
+vs = mul_matrix(svd_v(svd), sigma_t);
+ut = transpose_matrix(svd_u(svd));
+out = mul_matrix(vs, ut);
 
 /* release previously alocated memory */
 destroy_svd(svd);
 destroy_matrix(sigma_t);
+destroy_matrix(vs);
+destroy_matrix(ut);
 
+INSTRUMENT_END(INSTRUMENT_PSEUDOINVERSE_MATRIX, 0.0);
 /* return pseudoinverse matrix */
 return out;
 }
@@ -620,13 +683,16 @@ return out;
 Matrix* nearest_orthogonal_matrix(const Matrix* m)
 {
 Matrix* out = NULL;
+Matrix* vt = NULL;
 SVD* svd = NULL;
 if(rows_matrix(m) != columns_matrix(m) || m == NULL) return NULL;
 svd = svd_factorization(m);
-out = mul_matrix(svd_u(svd), transpose_matrix(svd_v(svd)));
+vt = transpose_matrix(svd_v(svd));
+out = mul_matrix(svd_u(svd), vt);
 
 /* release previously allocated memory */
 destroy_svd(svd);
+destroy_matrix(vt);
 
 /* return nearest orthogonal matrix of 'm' */
 return out;
@@ -729,9 +795,17 @@ if(n != rows_matrix(m)) return NULL; /* m must be square */
 Matrix* _m = cofactor_matrix(m);
 if(_m == NULL) return NULL;
 double d = det_matrix(m);
-if(abs(d) < THRESHOLD) return NULL; /* d is too close to zero */
+if(fabs(d) < THRESHOLD)
+{
+	destroy_matrix(_m);
+	return NULL; /* d is too close to zero */
+}
 double t = 1.0/d;
-return scale_matrix(transpose_matrix(_m), t);
+Matrix* _t = transpose_matrix(_m);
+Matrix* out = scale_matrix(_t, t);
+destroy_matrix(_m);
+destroy_matrix(_t);
+return out;
 }
 
 double determinant(const Matrix* m)
@@ -776,6 +850,7 @@ int rank_matrix(const Matrix* m)
 int row, i, j, k;
 double pivot, elim, tmp;
 if(m == NULL) return -1;
+INSTRUMENT_BEGIN;
 u = (columns_matrix(m) < rows_matrix(m)) ? transpose_matrix(m) : clone_matrix(m);
 i = 0;
  while(i < u->_rows)
@@ -818,6 +893,7 @@ for(i = 0; i < rows_matrix(u); i++)
 }
 /* release previously allocated memory */
 destroy_matrix(u);
+INSTRUMENT_END(INSTRUMENT_RANK_MATRIX, (double)rows_matrix(m)*rows_matrix(m)*columns_matrix(m));
 return _rank;
 }
 
@@ -857,6 +933,7 @@ Matrix* pow_matrix(const Matrix* m, int k)
 {
 	int i, q;
 	Matrix* _m = NULL;
+	Matrix* p = NULL;
 if(m == NULL) return NULL;
 if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
 if(k == 0) return identity_matrix(rows_matrix(m));
@@ -864,9 +941,17 @@ _m = clone_matrix(m);
 q = abs(k);
 for(i = 1; i < q; i++)
 {
-	_m = mul_matrix(_m, m);
+	p = mul_matrix(_m, m);
+	destroy_matrix(_m);
+	_m = p;
 }
-return (k < 0) ? inverse_matrix(_m) : _m;
+if(k < 0)
+{
+	p = inverse_matrix(_m);
+	destroy_matrix(_m);
+	_m = p;
+}
+return _m;
 }
 
 Matrix* div_matrix(const Matrix* m1, const Matrix* m2)
@@ -874,8 +959,11 @@ Matrix* div_matrix(const Matrix* m1, const Matrix* m2)
 if(m1 == NULL || m2 == NULL) return NULL;
 if(rows_matrix(m1) != columns_matrix(m1) || rows_matrix(m2) != columns_matrix(m2)) return NULL;
 if(rows_matrix(m1) != rows_matrix(m2)) return NULL;
-if(abs(det_matrix(m2)) < THRESHOLD) return NULL; /* det m2 is too close to zero */
-return mul_matrix(m1, inverse_matrix(m2));
+if(fabs(det_matrix(m2)) < THRESHOLD) return NULL; /* det m2 is too close to zero */
+Matrix* _m = inverse_matrix(m2);
+Matrix* out = mul_matrix(m1, _m);
+destroy_matrix(_m);
+return out;
 }
 
 
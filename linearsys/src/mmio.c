@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include "mmio.h"
+#include "allocator.h"
+#include "numio.h"
+
+#define MM_BANNER "%%MatrixMarket"
+
+/*
+* Symmetry of a Matrix Market file.
+*/
+#define MM_GENERAL 0
+#define MM_SYMMETRIC 1
+#define MM_SKEW 2
+
+/*
+* Helper functions.
+*/
+
+/*
+* Compares the next word of a line with a word, ignoring the case, and moves past it.
+*
+* returns: 1 if the word matches.
+*/
+static int __word_(const char** p, const char* word)
+{
+size_t k, n = strlen(word);
+while(**p == ' ' || **p == '\t') (*p)++;
+for(k = 0; k < n; k++) if(tolower((unsigned char)(*p)[k]) != word[k]) return 0;
+if((*p)[n] != ' ' && (*p)[n] != '\t' && (*p)[n] != '\n' && (*p)[n] != '\r' && (*p)[n] != '\0') return 0;
+*p += n;
+return 1;
+}
+
+/*
+* Moves to the start of the next line.
+*/
+static const char* __next_line_(const char* p, const char* end)
+{
+while(p < end && *p != '\n') p++;
+return (p < end) ? p + 1 : end;
+}
+
+/* end helper functions */
+
+/* implementation */
+
+SparseMatrix* load_sparse_matrix_market(const char* filename)
+{
+char* text = NULL;
+char* next = NULL;
+const char* p = NULL;
+const char* end = NULL;
+size_t length;
+long size[3];
+int k, e, n, rows, columns, entries, fields, pattern, symmetry, count;
+double* values = NULL;
+int* row_index = NULL;
+int* column_index = NULL;
+double* data = NULL;
+SparseMatrix* s = NULL;
+text = read_text_file(filename, &length);
+if(text == NULL) return NULL;
+end = text + length;
+/* banner: %%MatrixMarket matrix coordinate field symmetry */
+p = text;
+if(strncmp(p, MM_BANNER, strlen(MM_BANNER)) != 0)
+{
+	RELEASE(text);
+	return NULL;
+}
+p += strlen(MM_BANNER);
+pattern = 0;
+symmetry = MM_GENERAL;
+k = __word_(&p, "matrix") && __word_(&p, "coordinate");
+if(k)
+{
+	if(__word_(&p, "pattern")) pattern = 1;
+	else if(!__word_(&p, "real") && !__word_(&p, "integer")) k = 0;
+}
+if(k)
+{
+	if(__word_(&p, "symmetric")) symmetry = MM_SYMMETRIC;
+	else if(__word_(&p, "skew-symmetric")) symmetry = MM_SKEW;
+	else if(!__word_(&p, "general")) k = 0;
+}
+/* skip the comments */
+p = __next_line_(p, end);
+while(p < end && (*p == '%' || *p == '\n' || *p == '\r')) p = __next_line_(p, end);
+/* size line */
+for(e = 0; k && e < 3; e++)
+{
+	size[e] = strtol(p, &next, 10);
+	if(next == p) k = 0;
+	p = next;
+}
+if(!k || size[0] < 1 || size[1] < 1 || size[2] < 0 || size[2] > INT_MAX / 3)
+{
+	RELEASE(text);
+	return NULL;
+}
+rows = (int)size[0];
+columns = (int)size[1];
+entries = (int)size[2];
+/* every entry is parsed as two or three doubles, which hold the indices exactly */
+fields = pattern ? 2 : 3;
+values = (double*)ALLOCATE(((entries > 0) ? entries : 1) * fields * sizeof(double));
+n = (entries > 0) ? parse_doubles(p, (size_t)(end - p), values, entries * fields) : 0;
+RELEASE(text);
+if(n < entries * fields)
+{
+	RELEASE(values);
+	return NULL;
+}
+/* the stored triangle of a symmetric matrix gives the other one too */
+count = (symmetry == MM_GENERAL) ? entries : 2 * entries;
+row_index = (int*)ALLOCATE(((count > 0) ? count : 1) * sizeof(int));
+column_index = (int*)ALLOCATE(((count > 0) ? count : 1) * sizeof(int));
+data = (double*)ALLOCATE(((count > 0) ? count : 1) * sizeof(double));
+count = 0;
+k = 1;
+for(e = 0; e < entries; e++)
+{
+	const double* v = values + (size_t)e * fields;
+	if(v[0] < 1 || v[0] > rows || v[1] < 1 || v[1] > columns || v[0] != (int)v[0] || v[1] != (int)v[1])
+	{
+		k = 0;
+		break;
+	}
+	row_index[count] = (int)v[0] - 1;
+	column_index[count] = (int)v[1] - 1;
+	data[count] = pattern ? 1.0 : v[2];
+	count++;
+	if(symmetry != MM_GENERAL && v[0] != v[1])
+	{
+		row_index[count] = (int)v[1] - 1;
+		column_index[count] = (int)v[0] - 1;
+		data[count] = (symmetry == MM_SKEW) ? -data[count-1] : data[count-1];
+		count++;
+	}
+}
+if(k) s = triplets_sparse_matrix(rows, columns, count, row_index, column_index, data);
+
+/* release previously allocated memory */
+RELEASE(values);
+RELEASE(row_index);
+RELEASE(column_index);
+RELEASE(data);
+
+return s;
+}
+
+int store_sparse_matrix_market(const SparseMatrix* s, const char* filename)
+{
+int i, k;
+const char* banner = MM_BANNER " matrix coordinate real general\n";
+TextOutput* out = NULL;
+if(s == NULL || filename == NULL) return 0;
+out = open_text_output(filename);
+if(out == NULL) return 0;
+for(k = 0; banner[k] != '\0'; k++) write_text_char(out, banner[k]);
+write_text_int(out, s->_rows);
+write_text_char(out, ' ');
+write_text_int(out, s->_columns);
+write_text_char(out, ' ');
+write_text_int(out, s->_nonzeros);
+write_text_char(out, '\n');
+for(i = 0; i < s->_rows; i++)
+{
+	for(k = s->_row_start[i]; k < s->_row_start[i+1]; k++)
+	{
+		write_text_int(out, i+1);
+		write_text_char(out, ' ');
+		write_text_int(out, s->_column_index[k]+1);
+		write_text_char(out, ' ');
+		write_text_double(out, s->_data[k]);
+		write_text_char(out, '\n');
+	}
+}
+return close_text_output(out);
+}
+
+/* END */
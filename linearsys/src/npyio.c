@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "npyio.h"
+#include "allocator.h"
+#include "binio.h"
+
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_ALIGNMENT 64 /* the header is padded so that the data starts at a multiple of this */
+#define NPY_HEADER_MAX 65536 /* longest header accepted */
+
+/*
+* NpyArray type definition: what the header of a .npy file says about its array.
+*/
+typedef struct
+{
+char _kind; /* 'f' float, 'i' signed integer */
+int _size; /* bytes per entry */
+int _swap; /* the entries have the byte order of the other kind of host */
+int _fortran; /* column major order */
+int _dimensions; /* 1 or 2 */
+long _shape[2];
+long _offset; /* byte offset of the first entry */
+}NpyArray;
+
+/*
+* Helper functions.
+*/
+
+static int __little_endian_(void)
+{
+uint16_t one = 1;
+return *(unsigned char*)&one == 1;
+}
+
+/*
+* Finds the value of a key in the header dictionary.
+*
+* returns: pointer to the first character after the colon, or NULL if the key is missing.
+*/
+static const char* __value_(const char* header, const char* key)
+{
+const char* p = strstr(header, key);
+if(p == NULL) return NULL;
+p = strchr(p + strlen(key), ':');
+if(p == NULL) return NULL;
+p++;
+while(*p == ' ') p++;
+return p;
+}
+
+/*
+* Reads and parses the header of a .npy file.
+*
+* returns: 1 if the array is supported.
+*/
+static int __read_header_(FILE* file, NpyArray* a)
+{
+unsigned char prefix[12];
+char* header = NULL;
+char* next = NULL;
+const char* p = NULL;
+long length;
+int ok, prefix_length;
+char order;
+if(fread(prefix, 1, 10, file) != 10 || memcmp(prefix, NPY_MAGIC, 6) != 0) return 0;
+/* version 1 has a 16 bits header length, versions 2 and 3 a 32 bits one; both little endian */
+if(prefix[6] == 1)
+{
+	prefix_length = 10;
+	length = prefix[8] | (prefix[9] << 8);
+}
+else if(prefix[6] == 2 || prefix[6] == 3)
+{
+	prefix_length = 12;
+	if(fread(prefix + 10, 1, 2, file) != 2) return 0;
+	length = (long)prefix[8] | ((long)prefix[9] << 8) | ((long)prefix[10] << 16) | ((long)prefix[11] << 24);
+}
+else return 0;
+if(length < 1 || length > NPY_HEADER_MAX) return 0;
+header = (char*)ALLOCATE(length + 1);
+ok = (fread(header, 1, length, file) == (size_t)length);
+header[ok ? length : 0] = '\0';
+a->_offset = prefix_length + length;
+/* 'descr': '<f8' */
+p = __value_(header, "'descr'");
+ok = ok && p != NULL && (*p == '\'' || *p == '"');
+if(ok)
+{
+	order = p[1];
+	a->_kind = p[2];
+	a->_size = (int)strtol(p + 3, &next, 10);
+	ok = (order == '<' || order == '>' || order == '=' || order == '|') && (a->_kind == 'f' || a->_kind == 'i') &&
+	((a->_kind == 'f' && (a->_size == 8 || a->_size == 4)) || (a->_kind == 'i' && (a->_size == 8 || a->_size == 4)));
+	a->_swap = (order == '<' && !__little_endian_()) || (order == '>' && __little_endian_());
+}
+/* 'fortran_order': False */
+p = ok ? __value_(header, "'fortran_order'") : NULL;
+ok = ok && p != NULL && (strncmp(p, "True", 4) == 0 || strncmp(p, "False", 5) == 0);
+if(ok) a->_fortran = (*p == 'T');
+/* 'shape': (rows, columns) */
+p = ok ? __value_(header, "'shape'") : NULL;
+ok = ok && p != NULL && *p == '(';
+if(ok)
+{
+	p++;
+	a->_dimensions = 0;
+	for(;;)
+	{
+		while(*p == ' ' || *p == ',') p++;
+		if(*p == ')' || a->_dimensions == 2) break;
+		a->_shape[a->_dimensions] = strtol(p, &next, 10);
+		if(next == p || a->_shape[a->_dimensions] < 1) break;
+		a->_dimensions++;
+		p = next;
+	}
+	ok = (*p == ')' && a->_dimensions >= 1);
+	if(ok && a->_dimensions == 1) a->_shape[1] = 1;
+	ok = ok && a->_shape[0] <= INT_MAX && a->_shape[1] <= INT_MAX && a->_shape[0] * a->_shape[1] <= INT_MAX;
+}
+RELEASE(header);
+return ok;
+}
+
+/*
+* Reads the entries of an array, converting them to doubles in row major order.
+* param: out array of rows*columns doubles.
+*/
+static int __read_entries_(FILE* file, const NpyArray* a, double* out)
+{
+size_t k, b, count = (size_t)a->_shape[0] * a->_shape[1];
+unsigned char* raw = NULL;
+unsigned char* e = NULL;
+unsigned char c;
+double* t = NULL;
+int i, j, ok;
+if(fseek(file, a->_offset, SEEK_SET) != 0) return 0;
+if(a->_kind == 'f' && a->_size == 8 && !a->_swap) ok = (fread(out, sizeof(double), count, file) == count);
+else
+{
+	raw = (unsigned char*)ALLOCATE(count * a->_size);
+	ok = (fread(raw, a->_size, count, file) == count);
+	for(k = 0; ok && k < count; k++)
+	{
+		e = raw + k * a->_size;
+		if(a->_swap)
+		{
+			for(b = 0; b < (size_t)a->_size / 2; b++)
+			{
+				c = e[b];
+				e[b] = e[a->_size - 1 - b];
+				e[a->_size - 1 - b] = c;
+			}
+		}
+		if(a->_kind == 'f' && a->_size == 8) memcpy(out + k, e, 8);
+		else if(a->_kind == 'f')
+		{
+			float f;
+			memcpy(&f, e, 4);
+			out[k] = f;
+		}
+		else if(a->_size == 8)
+		{
+			int64_t n;
+			memcpy(&n, e, 8);
+			out[k] = (double)n;
+		}
+		else
+		{
+			int32_t n;
+			memcpy(&n, e, 4);
+			out[k] = n;
+		}
+	}
+	RELEASE(raw);
+}
+if(ok && a->_fortran && a->_shape[1] > 1 && a->_shape[0] > 1)
+{
+	/* the entries were read as the transpose */
+	t = (double*)ALLOCATE(count * sizeof(double));
+	memcpy(t, out, count * sizeof(double));
+	for(i = 0; i < a->_shape[0]; i++)
+	{
+		for(j = 0; j < a->_shape[1]; j++) out[(size_t)i*a->_shape[1]+j] = t[(size_t)j*a->_shape[0]+i];
+	}
+	RELEASE(t);
+}
+return ok;
+}
+
+/*
+* Writes a .npy file with a C ordered float64 array.
+*/
+static int __store_(const double* data, int rows, int columns, int dimensions, const char* filename)
+{
+char header[160];
+unsigned char prefix[10];
+int length, ok;
+size_t count = (size_t)rows * columns;
+FILE* file = NULL;
+if(dimensions == 1) length = sprintf(header, "{'descr': '%cf8', 'fortran_order': False, 'shape': (%d,), }", __little_endian_() ? '<' : '>', rows);
+else length = sprintf(header, "{'descr': '%cf8', 'fortran_order': False, 'shape': (%d, %d), }", __little_endian_() ? '<' : '>', rows, columns);
+/* pad with spaces and end with a newline, so that the data is aligned */
+while((10 + length + 1) % NPY_ALIGNMENT != 0) header[length++] = ' ';
+header[length++] = '\n';
+memcpy(prefix, NPY_MAGIC, 6);
+prefix[6] = 1;
+prefix[7] = 0;
+prefix[8] = (unsigned char)(length & 0xFF);
+prefix[9] = (unsigned char)(length >> 8);
+file = fopen(filename, "wb");
+if(file == NULL) return 0;
+ok = fwrite(prefix, 1, 10, file) == 10 && fwrite(header, 1, length, file) == (size_t)length &&
+fwrite(data, sizeof(double), count, file) == count;
+if(fclose(file) != 0) ok = 0;
+return ok;
+}
+
+/* end helper functions */
+
+/* implementation */
+
+Matrix* load_matrix_npy(const char* filename)
+{
+NpyArray a;
+Matrix* m = NULL;
+FILE* file = NULL;
+if(filename == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+if(__read_header_(file, &a))
+{
+	m = create_matrix((int)a._shape[0], (int)a._shape[1]);
+	if(!__read_entries_(file, &a, m->_data))
+	{
+		destroy_matrix(m);
+		m = NULL;
+	}
+}
+fclose(file);
+return m;
+}
+
+const Matrix* map_matrix_npy(const char* filename)
+{
+NpyArray a;
+int ok;
+FILE* file = NULL;
+if(filename == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+ok = __read_header_(file, &a);
+fclose(file);
+/* a Fortran ordered array with one column or row has the same layout as a C ordered one */
+if(!ok || a._kind != 'f' || a._size != 8 || a._swap || (a._fortran && a._shape[0] > 1 && a._shape[1] > 1)) return NULL;
+return map_array_matrix(filename, (uint64_t)a._offset, (int)a._shape[0], (int)a._shape[1]);
+}
+
+int store_matrix_npy(const Matrix* m, const char* filename)
+{
+if(m == NULL || filename == NULL) return 0;
+return __store_(m->_data, rows_matrix(m), columns_matrix(m), 2, filename);
+}
+
+Vector* load_vector_npy(const char* filename)
+{
+NpyArray a;
+Vector* v = NULL;
+FILE* file = NULL;
+if(filename == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+if(__read_header_(file, &a) && (a._shape[0] == 1 || a._shape[1] == 1))
+{
+	v = create_vector((int)(a._shape[0] * a._shape[1]));
+	if(!__read_entries_(file, &a, v->_data))
+	{
+		destroy_vector(v);
+		v = NULL;
+	}
+}
+fclose(file);
+return v;
+}
+
+int store_vector_npy(const Vector* v, const char* filename)
+{
+if(v == NULL || filename == NULL) return 0;
+return __store_(v->_data, size_vector(v), 1, 1, filename);
+}
+
+/* END */
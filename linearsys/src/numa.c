@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* syscall, sched_getaffinity */
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* sysconf */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+#include "numa.h"
+#include "threadpool.h"
+
+#define MAX_CPUS 1024
+#define LINE_SIZE 4096
+#define NODE_PATH "/sys/devices/system/node"
+
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+
+/*
+* Topology type definition: the nodes and the processors of the computer, read once.
+*/
+typedef struct
+{
+int _nodes;
+unsigned char _online[NUMA_MAX_NODES]; /* 1 for the online nodes */
+int _cpus[MAX_CPUS]; /* processors, those of the first node first */
+int _cpu_count;
+}Topology;
+
+/*
+* NumaContext type definition: a matrix initialized by the threads of a pool.
+*/
+typedef struct
+{
+double* _data;
+const double* _source;
+int _rows;
+int _columns;
+int _threads;
+}NumaContext;
+
+static Topology __topology_;
+static pthread_once_t __topology_once_ = PTHREAD_ONCE_INIT;
+static int __policy_ = NUMA_FIRST_TOUCH;
+static pthread_once_t __policy_once_ = PTHREAD_ONCE_INIT;
+
+/*
+* Helper functions.
+*/
+
+/*
+* Reads the first line of a file.
+*/
+static int __read_line_(const char* filename, char* line, int size)
+{
+FILE* fp = fopen(filename, "r");
+if(fp == NULL) return 0;
+if(fgets(line, size, fp) == NULL)
+{
+	fclose(fp);
+	return 0;
+}
+fclose(fp);
+return 1;
+}
+
+/*
+* Parses a list of ranges as "0-3,8,10-11" setting their elements of a set.
+* Returns the number of elements set.
+*/
+static int __parse_list_(const char* text, unsigned char* set, int size)
+{
+int first, last, i, count = 0;
+char* end = NULL;
+const char* p = text;
+while(*p >= '0' && *p <= '9')
+{
+	first = (int)strtol(p, &end, 10);
+	last = first;
+	p = end;
+	if(*p == '-')
+	{
+		last = (int)strtol(p+1, &end, 10);
+		p = end;
+	}
+	for(i = first; i <= last && i < size; i++)
+	{
+		if(!set[i]) count++;
+		set[i] = 1;
+	}
+	if(*p != ',') break;
+	p++;
+}
+return count;
+}
+
+/*
+* Reads the nodes and the processors of each node, keeping the ones the process can run on.
+*/
+static void __load_topology_(void)
+{
+Topology* t = &__topology_;
+unsigned char allowed[MAX_CPUS];
+unsigned char cpus[MAX_CPUS];
+char line[LINE_SIZE];
+char filename[FILENAME_MAX];
+int i, j, n;
+memset(t, 0, sizeof(Topology));
+memset(allowed, 1, sizeof(allowed));
+#ifdef __linux__
+cpu_set_t set;
+if(sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0)
+{
+	for(i = 0; i < MAX_CPUS; i++) allowed[i] = (i < CPU_SETSIZE && CPU_ISSET(i, &set)) ? 1 : 0;
+}
+#endif
+if(__read_line_(NODE_PATH "/online", line, LINE_SIZE)) t->_nodes = __parse_list_(line, t->_online, NUMA_MAX_NODES);
+if(t->_nodes == 0)
+{
+	/* no NUMA information: a single node with the processors online */
+	t->_nodes = 1;
+	t->_online[0] = 1;
+#ifdef _WIN32
+	n = 0;
+#else
+	n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	for(i = 0; i < n && i < MAX_CPUS; i++) if(allowed[i]) t->_cpus[t->_cpu_count++] = i;
+	return;
+}
+for(j = 0; j < NUMA_MAX_NODES; j++)
+{
+	if(!t->_online[j]) continue;
+	sprintf(filename, NODE_PATH "/node%d/cpulist", j);
+	if(!__read_line_(filename, line, LINE_SIZE)) continue;
+	memset(cpus, 0, sizeof(cpus));
+	__parse_list_(line, cpus, MAX_CPUS);
+	for(i = 0; i < MAX_CPUS; i++) if(cpus[i] && allowed[i]) t->_cpus[t->_cpu_count++] = i;
+}
+}
+
+static void __load_policy_(void)
+{
+const char* env = getenv("LINEARSYS_NUMA");
+if(env == NULL) return;
+if(strcmp(env, "interleave") == 0) __policy_ = NUMA_INTERLEAVE;
+else if(strcmp(env, "off") == 0) __policy_ = NUMA_OFF;
+}
+
+/*
+* Interleaves among the online nodes the pages of a block of memory not touched yet.
+* The pages shared with other blocks at its ends are left as they are.
+*/
+static void __interleave_(void* p, size_t size)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+unsigned long mask = 0;
+long page = sysconf(_SC_PAGESIZE);
+uintptr_t start, end;
+int i;
+if(page <= 0) return;
+for(i = 0; i < NUMA_MAX_NODES; i++) if(__topology_._online[i]) mask |= 1UL << i;
+start = ((uintptr_t)p + page-1) / page * page;
+end = ((uintptr_t)p + size) / page * page;
+if(end <= start) return;
+/* as libnuma does, maxnode is one more than the bits of the mask */
+syscall(SYS_mbind, (void*)start, (unsigned long)(end-start), MPOL_INTERLEAVE, &mask, (unsigned long)NUMA_MAX_NODES+1, 0);
+#endif
+}
+
+/*
+* Initializes the block of rows of thread index.
+*/
+static void __initialize_(int index, void* context)
+{
+NumaContext* c = (NumaContext*)context;
+/* rows r with r * threads / rows == index */
+size_t first = ((size_t)index*c->_rows + c->_threads-1) / c->_threads;
+size_t last = ((size_t)(index+1)*c->_rows + c->_threads-1) / c->_threads;
+size_t offset = first * c->_columns;
+size_t count = (last-first) * c->_columns;
+if(count == 0) return;
+if(c->_source != NULL) memcpy(c->_data + offset, c->_source + offset, count * sizeof(double));
+else memset(c->_data + offset, 0, count * sizeof(double));
+}
+
+/* end helper functions */
+
+/* implementation */
+
+int nodes_numa(void)
+{
+pthread_once(&__topology_once_, __load_topology_);
+return __topology_._nodes;
+}
+
+int cpus_numa(int* cpus, int count)
+{
+int i;
+pthread_once(&__topology_once_, __load_topology_);
+if(cpus != NULL)
+{
+	for(i = 0; i < count && i < __topology_._cpu_count; i++) cpus[i] = __topology_._cpus[i];
+}
+return __topology_._cpu_count;
+}
+
+void set_numa_policy(int policy)
+{
+if(policy < NUMA_FIRST_TOUCH || policy > NUMA_OFF) return;
+pthread_once(&__policy_once_, __load_policy_);
+__policy_ = policy;
+}
+
+int get_numa_policy(void)
+{
+pthread_once(&__policy_once_, __load_policy_);
+return __policy_;
+}
+
+int owner_numa(int row, int rows, int threads)
+{
+if(rows < 1 || threads < 1 || row < 0) return 0;
+if(row >= rows) return threads-1;
+return (int)((long long)row * threads / rows);
+}
+
+void initialize_numa(double* data, const double* source, int rows, int columns)
+{
+NumaContext c;
+size_t count = (size_t)rows * columns;
+int policy = get_numa_policy();
+if(data == NULL || count == 0) return;
+if(policy == NUMA_OFF || count * sizeof(double) < NUMA_PARALLEL_SIZE || threads_threadpool(NULL) == 1)
+{
+	if(source != NULL) memcpy(data, source, count * sizeof(double));
+	else memset(data, 0, count * sizeof(double));
+	return;
+}
+if(policy == NUMA_INTERLEAVE && nodes_numa() > 1) __interleave_(data, count * sizeof(double));
+c._data = data;
+c._source = source;
+c._rows = rows;
+c._columns = columns;
+c._threads = threads_threadpool(NULL);
+parallel_threads(NULL, __initialize_, &c);
+}
+
+/* END */
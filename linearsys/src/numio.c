@@ -18,7 +18,461 @@
  *
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
 #include "numio.h"
+#include "allocator.h"
+#include "threadpool.h"
+#include "tuning.h"
+#include "trace.h"
+
+#define READ_BLOCK 1048576 /* bytes read from a file at once */
+#define TOKEN_SIZE 64 /* longest token read by fread_double */
+#define CHUNKS_PER_THREAD 4
+#define MAX_FAST_MANTISSA 9007199254740992ULL /* 2^53, integers up to this are exact doubles */
+#define OUTPUT_BUFFER 1048576 /* bytes collected by a TextOutput before writing them */
+#define HIDDEN_BIT 0x0010000000000000ULL /* implicit leading bit of a double significand */
+#define SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define EXPONENT_MASK 0x7FF0000000000000ULL
+#define EXPONENT_BIAS 1075 /* 1023 + 52 */
+
+/* powers of ten which are exact doubles */
+static const double __pow10_[23] =
+{
+1E0, 1E1, 1E2, 1E3, 1E4, 1E5, 1E6, 1E7, 1E8, 1E9, 1E10, 1E11,
+1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22
+};
+
+/*
+* Cached powers of ten for Grisu3: 10^k for k = -348, -340, ... 340 as a 64 bits significand f
+* and a binary exponent e, so that 10^k ~ f * 2^e.
+*/
+static const uint64_t __cached_f_[87] =
+{
+0xFA8FD5A0081C0288ULL, 0xBAAEE17FA23EBF76ULL, 0x8B16FB203055AC76ULL,
+0xCF42894A5DCE35EAULL, 0x9A6BB0AA55653B2DULL, 0xE61ACF033D1A45DFULL,
+0xAB70FE17C79AC6CAULL, 0xFF77B1FCBEBCDC4FULL, 0xBE5691EF416BD60CULL,
+0x8DD01FAD907FFC3CULL, 0xD3515C2831559A83ULL, 0x9D71AC8FADA6C9B5ULL,
+0xEA9C227723EE8BCBULL, 0xAECC49914078536DULL, 0x823C12795DB6CE57ULL,
+0xC21094364DFB5637ULL, 0x9096EA6F3848984FULL, 0xD77485CB25823AC7ULL,
+0xA086CFCD97BF97F4ULL, 0xEF340A98172AACE5ULL, 0xB23867FB2A35B28EULL,
+0x84C8D4DFD2C63F3BULL, 0xC5DD44271AD3CDBAULL, 0x936B9FCEBB25C996ULL,
+0xDBAC6C247D62A584ULL, 0xA3AB66580D5FDAF6ULL, 0xF3E2F893DEC3F126ULL,
+0xB5B5ADA8AAFF80B8ULL, 0x87625F056C7C4A8BULL, 0xC9BCFF6034C13053ULL,
+0x964E858C91BA2655ULL, 0xDFF9772470297EBDULL, 0xA6DFBD9FB8E5B88FULL,
+0xF8A95FCF88747D94ULL, 0xB94470938FA89BCFULL, 0x8A08F0F8BF0F156BULL,
+0xCDB02555653131B6ULL, 0x993FE2C6D07B7FACULL, 0xE45C10C42A2B3B06ULL,
+0xAA242499697392D3ULL, 0xFD87B5F28300CA0EULL, 0xBCE5086492111AEBULL,
+0x8CBCCC096F5088CCULL, 0xD1B71758E219652CULL, 0x9C40000000000000ULL,
+0xE8D4A51000000000ULL, 0xAD78EBC5AC620000ULL, 0x813F3978F8940984ULL,
+0xC097CE7BC90715B3ULL, 0x8F7E32CE7BEA5C70ULL, 0xD5D238A4ABE98068ULL,
+0x9F4F2726179A2245ULL, 0xED63A231D4C4FB27ULL, 0xB0DE65388CC8ADA8ULL,
+0x83C7088E1AAB65DBULL, 0xC45D1DF942711D9AULL, 0x924D692CA61BE758ULL,
+0xDA01EE641A708DEAULL, 0xA26DA3999AEF774AULL, 0xF209787BB47D6B85ULL,
+0xB454E4A179DD1877ULL, 0x865B86925B9BC5C2ULL, 0xC83553C5C8965D3DULL,
+0x952AB45CFA97A0B3ULL, 0xDE469FBD99A05FE3ULL, 0xA59BC234DB398C25ULL,
+0xF6C69A72A3989F5CULL, 0xB7DCBF5354E9BECEULL, 0x88FCF317F22241E2ULL,
+0xCC20CE9BD35C78A5ULL, 0x98165AF37B2153DFULL, 0xE2A0B5DC971F303AULL,
+0xA8D9D1535CE3B396ULL, 0xFB9B7CD9A4A7443CULL, 0xBB764C4CA7A44410ULL,
+0x8BAB8EEFB6409C1AULL, 0xD01FEF10A657842CULL, 0x9B10A4E5E9913129ULL,
+0xE7109BFBA19C0C9DULL, 0xAC2820D9623BF429ULL, 0x80444B5E7AA7CF85ULL,
+0xBF21E44003ACDD2DULL, 0x8E679C2F5E44FF8FULL, 0xD433179D9C8CB841ULL,
+0x9E19DB92B4E31BA9ULL, 0xEB96BF6EBADF77D9ULL, 0xAF87023B9BF0EE6BULL
+};
+
+static const int16_t __cached_e_[87] =
+{
+-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+1013, 1039, 1066
+};
+
+static const uint64_t __pow10_u_[20] =
+{
+1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/*
+* A floating point number f * 2^e with a 64 bits significand ( "do it yourself" floating point ).
+*/
+typedef struct
+{
+uint64_t _f;
+int _e;
+}DiyFp;
+
+/*
+* A piece of text parsed by one task of parse_doubles.
+*/
+typedef struct
+{
+const char* _begin;
+const char* _end;
+int _tokens; /* number of values in the piece */
+int _offset; /* index of its first value */
+int _parsed; /* number of values parsed */
+}Chunk;
+
+typedef struct
+{
+Chunk* _chunks;
+double* _values;
+int _count;
+}ParseJob;
+
+/*
+* Helper functions.
+*/
+
+static int __is_space_(char c)
+{
+return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/*
+* Parses the values between begin and end into values, up to count values.
+*
+* returns: number of values parsed.
+*/
+static int __parse_range_(const char* begin, const char* end, double* values, int count)
+{
+int n = 0;
+char* next = NULL;
+const char* p = begin;
+while(n < count)
+{
+	while(p < end && __is_space_(*p)) p++;
+	if(p >= end) break;
+	values[n] = parse_double(p, &next);
+	if(next == p) break; /* not a number */
+	p = next;
+	n++;
+}
+return n;
+}
+
+static void __count_task_(int index, void* context)
+{
+ParseJob* job = (ParseJob*)context;
+Chunk* chunk = job->_chunks + index;
+const char* p;
+int n = 0, in = 0;
+TRACE_BEGIN;
+for(p = chunk->_begin; p < chunk->_end; p++)
+{
+	if(__is_space_(*p)) in = 0;
+	else if(!in)
+	{
+		in = 1;
+		n++;
+	}
+}
+chunk->_tokens = n;
+TRACE_END("parse_count", index, -1);
+}
+
+static void __parse_task_(int index, void* context)
+{
+ParseJob* job = (ParseJob*)context;
+Chunk* chunk = job->_chunks + index;
+int count;
+chunk->_parsed = 0;
+if(chunk->_offset >= job->_count) return;
+count = job->_count - chunk->_offset;
+if(count > chunk->_tokens) count = chunk->_tokens;
+TRACE_BEGIN;
+chunk->_parsed = __parse_range_(chunk->_begin, chunk->_end, job->_values + chunk->_offset, count);
+TRACE_END("parse_chunk", index, -1);
+}
+
+/*
+* Product of two DiyFp, rounding the 128 bits result to its upper 64 bits.
+*/
+static DiyFp __diy_mul_(DiyFp x, DiyFp y)
+{
+DiyFp r;
+uint64_t a = x._f >> 32, b = x._f & 0xFFFFFFFFULL, c = y._f >> 32, d = y._f & 0xFFFFFFFFULL;
+uint64_t ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+uint64_t t = (bd >> 32) + (ad & 0xFFFFFFFFULL) + (bc & 0xFFFFFFFFULL);
+t += 1ULL << 31; /* round */
+r._f = ac + (ad >> 32) + (bc >> 32) + (t >> 32);
+r._e = x._e + y._e + 64;
+return r;
+}
+
+static DiyFp __diy_normalize_(DiyFp x)
+{
+while(!(x._f & 0x8000000000000000ULL))
+{
+	x._f <<= 1;
+	x._e--;
+}
+return x;
+}
+
+/*
+* Gets the normalized boundaries m- and m+ of a positive double v = f * 2^e:
+* the numbers halfway to its neighbours, so any number between them reads back as v.
+*/
+static void __diy_boundaries_(DiyFp v, DiyFp* minus, DiyFp* plus)
+{
+DiyFp p, m;
+p._f = (v._f << 1) + 1;
+p._e = v._e - 1;
+while(!(p._f & (HIDDEN_BIT << 1)))
+{
+	p._f <<= 1;
+	p._e--;
+}
+p._f <<= 10; /* 64 - 52 - 2 */
+p._e -= 10;
+if(v._f == HIDDEN_BIT && v._e > 1 - EXPONENT_BIAS)
+{
+	/* the gap to the lower neighbour is half as big at a power of two, but not at the smallest normal number */
+	m._f = (v._f << 2) - 1;
+	m._e = v._e - 2;
+}
+else
+{
+	m._f = (v._f << 1) - 1;
+	m._e = v._e - 1;
+}
+m._f <<= m._e - p._e;
+m._e = p._e;
+*minus = m;
+*plus = p;
+}
+
+/*
+* Gets a cached power of ten c = 10^-k such that the product by a number with binary exponent e
+* has its binary exponent in [-60, -32].
+*/
+static DiyFp __cached_power_(int e, int* k)
+{
+int index;
+DiyFp c;
+double dk = (-61 - e) * 0.30102999566398114 + 347; /* log10(2) */
+int ik = (int)dk;
+if(dk - ik > 0.0) ik++;
+index = (ik >> 3) + 1;
+*k = -(-348 + index * 8);
+c._f = __cached_f_[index];
+c._e = __cached_e_[index];
+return c;
+}
+
+/*
+* Moves the last digit down while the number gets closer to w and stays inside the unsafe interval,
+* then checks that the digits are the closest shortest ones in spite of the rounding errors of the products ( unit ).
+*
+* returns: 1 if the digits are surely right, 0 if they may not be.
+*/
+static int __round_weed_(char* buffer, int length, uint64_t distance_too_high_w, uint64_t unsafe_interval, uint64_t rest, uint64_t ten_kappa, uint64_t unit)
+{
+uint64_t small_distance = distance_too_high_w - unit;
+uint64_t big_distance = distance_too_high_w + unit;
+while(rest < small_distance && unsafe_interval - rest >= ten_kappa && (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance))
+{
+	buffer[length-1]--;
+	rest += ten_kappa;
+}
+/* a lower last digit may still be closer, it cannot be decided */
+if(rest < big_distance && unsafe_interval - rest >= ten_kappa && (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) return 0;
+/* the digits must be inside the boundaries even with the largest errors */
+return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+static int __count_digits_(uint32_t n)
+{
+int d = 1;
+while(d < 10 && n >= __pow10_u_[d]) d++;
+return d;
+}
+
+/*
+* Generates the shortest digits of a number between the boundaries low and high, widened by the rounding errors
+* ( the unsafe interval ), and checks them with __round_weed_.
+*
+* returns: 1 if the digits are the shortest and closest ones, 0 if this cannot be decided.
+*/
+static int __digit_gen_(DiyFp low, DiyFp w, DiyFp high, char* buffer, int* length, int* k)
+{
+int kappa;
+uint32_t p1, d;
+uint64_t p2, one_f, too_high, unsafe_interval, unit = 1;
+int shift = -w._e;
+one_f = 1ULL << shift;
+too_high = high._f + unit;
+unsafe_interval = too_high - (low._f - unit);
+p1 = (uint32_t)(too_high >> shift);
+p2 = too_high & (one_f - 1);
+kappa = __count_digits_(p1);
+*length = 0;
+/* integer part, p1 is not zero since too_high is normalized */
+while(kappa > 0)
+{
+	d = p1 / (uint32_t)__pow10_u_[kappa-1];
+	p1 %= (uint32_t)__pow10_u_[kappa-1];
+	buffer[(*length)++] = (char)('0' + d);
+	kappa--;
+	if((((uint64_t)p1 << shift) + p2) < unsafe_interval)
+	{
+		*k += kappa;
+		return __round_weed_(buffer, *length, too_high - w._f, unsafe_interval, ((uint64_t)p1 << shift) + p2, __pow10_u_[kappa] << shift, unit);
+	}
+}
+/* fraction part */
+while(1)
+{
+	p2 *= 10;
+	unit *= 10;
+	unsafe_interval *= 10;
+	d = (uint32_t)(p2 >> shift);
+	buffer[(*length)++] = (char)('0' + d);
+	p2 &= one_f - 1;
+	kappa--;
+	if(p2 < unsafe_interval)
+	{
+		*k += kappa;
+		return __round_weed_(buffer, *length, (too_high - w._f) * unit, unsafe_interval, p2, one_f, unit);
+	}
+}
+}
+
+/*
+* Writes the digits of a positive finite double into buffer, so that value = digits * 10^k ( Grisu3 ).
+*
+* returns: 1 if the digits are the shortest ones, 0 for the few numbers where this cannot be decided.
+*/
+static int __grisu3_(double value, char* buffer, int* length, int* k)
+{
+uint64_t bits;
+int biased;
+DiyFp v, w, minus, plus, c, wm, wp;
+memcpy(&bits, &value, sizeof(bits));
+biased = (int)((bits & EXPONENT_MASK) >> 52);
+if(biased != 0)
+{
+	v._f = (bits & SIGNIFICAND_MASK) + HIDDEN_BIT;
+	v._e = biased - EXPONENT_BIAS;
+}
+else
+{
+	/* subnormal */
+	v._f = bits & SIGNIFICAND_MASK;
+	v._e = 1 - EXPONENT_BIAS;
+}
+__diy_boundaries_(v, &minus, &plus);
+c = __cached_power_(plus._e, k);
+w = __diy_mul_(__diy_normalize_(v), c);
+wp = __diy_mul_(plus, c);
+wm = __diy_mul_(minus, c);
+return __digit_gen_(wm, w, wp, buffer, length, k);
+}
+
+/*
+* Writes the shortest digits which read back as value with the C library, so that value = digits * 10^k;
+* it is slow, but only needed for the numbers Grisu3 cannot decide.
+*/
+static void __shortest_(double value, char* buffer, int* length, int* k)
+{
+char text[FORMAT_DOUBLE_SIZE];
+int precision, i;
+for(precision = 1; precision <= 17; precision++)
+{
+	sprintf(text, "%.*e", precision - 1, value); /* d.ddde+XX */
+	if(precision == 17 || strtod(text, NULL) == value) break;
+}
+*length = 0;
+for(i = 0; text[i] != 'e'; i++) if(text[i] != '.') buffer[(*length)++] = text[i];
+while(*length > 1 && buffer[*length-1] == '0') (*length)--;
+*k = atoi(text + i + 1) - (*length - 1);
+}
+
+static int __write_exponent_(int k, char* buffer)
+{
+int n = 0, d = 100;
+if(k < 0)
+{
+	buffer[n++] = '-';
+	k = -k;
+}
+while(d > 1 && k < d) d /= 10;
+for(; d > 0; d /= 10)
+{
+	buffer[n++] = (char)('0' + k / d);
+	k %= d;
+}
+return n;
+}
+
+/*
+* Places the decimal point ( or an exponent ) in the digits of a number digits * 10^k.
+*
+* returns: number of characters of the result.
+*/
+static int __prettify_(char* buffer, int length, int k)
+{
+int i, offset;
+int kk = length + k; /* 10^(kk-1) <= v < 10^kk */
+if(k >= 0 && kk <= 21)
+{
+	/* integer: 1234e7 -> 12340000000 */
+	for(i = length; i < kk; i++) buffer[i] = '0';
+	return kk;
+}
+if(kk > 0 && kk <= 21)
+{
+	/* 1234e-2 -> 12.34 */
+	memmove(buffer + kk + 1, buffer + kk, (size_t)(length - kk));
+	buffer[kk] = '.';
+	return length + 1;
+}
+if(kk > -6 && kk <= 0)
+{
+	/* 1234e-6 -> 0.001234 */
+	offset = 2 - kk;
+	memmove(buffer + offset, buffer, (size_t)length);
+	buffer[0] = '0';
+	buffer[1] = '.';
+	for(i = 2; i < offset; i++) buffer[i] = '0';
+	return length + offset;
+}
+if(length == 1)
+{
+	/* 1e30 */
+	buffer[1] = 'e';
+	return 2 + __write_exponent_(kk - 1, buffer + 2);
+}
+/* 1234e30 -> 1.234e33 */
+memmove(buffer + 2, buffer + 1, (size_t)(length - 1));
+buffer[1] = '.';
+buffer[length + 1] = 'e';
+return length + 2 + __write_exponent_(kk - 1, buffer + length + 2);
+}
+
+/*
+* Writes the buffer of a TextOutput to its file.
+*/
+static void __flush_output_(TextOutput* out)
+{
+if(out->_length > 0 && fwrite(out->_buffer, 1, out->_length, out->_file) != out->_length) out->_error = 1;
+out->_length = 0;
+}
+
+/* end helper functions */
+
+/* implementation */
+
 
 FILE* fopen_read(const char* filename)
 {
@@ -44,14 +498,261 @@ fprintf(pf, "%d", value);
 
 void fread_double(FILE* pf, double* value)
 {
-double d = 0.0;
-fscanf(pf, "%lf", &d);
-*value = d;
+int c, n = 0;
+char token[TOKEN_SIZE];
+/* read the next token and parse it */
+do
+{
+	c = getc(pf);
+}while(c != EOF && isspace(c));
+while(c != EOF && !isspace(c) && n < TOKEN_SIZE-1)
+{
+	token[n++] = (char)c;
+	c = getc(pf);
+}
+if(c != EOF) ungetc(c, pf);
+token[n] = '\0';
+*value = parse_double(token, NULL);
 }
 
 void fwrite_double(FILE* pf, double value)
 {
-fprintf(pf, "%lf", value);
+char buffer[FORMAT_DOUBLE_SIZE];
+format_double(value, buffer);
+fputs(buffer, pf);
+}
+
+char* read_text_file(const char* filename, size_t* length)
+{
+size_t size = 0, capacity = READ_BLOCK, n;
+char* text = NULL;
+char* bigger = NULL;
+FILE* file = NULL;
+if(filename == NULL) return NULL;
+file = fopen(filename, "rb");
+if(file == NULL) return NULL;
+text = (char*)ALLOCATE(capacity + 1);
+while(text != NULL)
+{
+	n = fread(text + size, 1, capacity - size, file);
+	size += n;
+	if(size < capacity) break; /* end of file */
+	/* the buffer is full, double it */
+	bigger = (char*)REALLOCATE(text, size + 1, 2*capacity + 1);
+	capacity *= 2;
+	if(bigger == NULL) RELEASE(text);
+	text = bigger;
+}
+fclose(file);
+if(text == NULL) return NULL;
+text[size] = '\0';
+if(length != NULL) *length = size;
+return text;
+}
+
+double parse_double(const char* s, char** end)
+{
+const char* p = s;
+unsigned long long mantissa = 0;
+int negative = 0, digits = 0, any = 0, exponent = 0, e = 0, eneg = 0;
+double value;
+while(__is_space_(*p)) p++;
+if(*p == '-' || *p == '+')
+{
+	negative = (*p == '-');
+	p++;
+}
+/* integer part */
+while(*p >= '0' && *p <= '9')
+{
+	if(mantissa > 0 || *p != '0') digits++;
+	mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+	any = 1;
+	p++;
+}
+/* fraction */
+if(*p == '.')
+{
+	p++;
+	while(*p >= '0' && *p <= '9')
+	{
+		if(mantissa > 0 || *p != '0') digits++;
+		mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+		exponent--;
+		any = 1;
+		p++;
+	}
+}
+if(any && (*p == 'e' || *p == 'E'))
+{
+	const char* q = p + 1;
+	if(*q == '-' || *q == '+')
+	{
+		eneg = (*q == '-');
+		q++;
+	}
+	if(*q >= '0' && *q <= '9')
+	{
+		while(*q >= '0' && *q <= '9')
+		{
+			if(e < 10000) e = e * 10 + (*q - '0');
+			q++;
+		}
+		exponent += (eneg) ? -e : e;
+		p = q;
+	}
+}
+/* fast path: the mantissa and the power of ten are exact, so one operation rounds correctly */
+if(any && digits <= 19 && mantissa <= MAX_FAST_MANTISSA && exponent >= -22 && exponent <= 22 && *p != 'x' && *p != 'X')
+{
+	value = (double)mantissa;
+	if(exponent < 0) value /= __pow10_[-exponent];
+	else value *= __pow10_[exponent];
+	if(end != NULL) *end = (char*)p;
+	return (negative) ? -value : value;
+}
+/* anything else: many digits, big exponents, hexadecimal, inf, nan or no number */
+return strtod(s, end);
+}
+
+int parse_doubles(const char* text, size_t length, double* values, int count)
+{
+int i, chunks, total, parsed;
+size_t step;
+const char* p = NULL;
+const char* end = text + length;
+ParseJob job;
+if(text == NULL || values == NULL || count <= 0) return 0;
+chunks = threads_threadpool(NULL) * CHUNKS_PER_THREAD;
+if(length < get_tuning()->_parallel_parse || chunks <= CHUNKS_PER_THREAD) return __parse_range_(text, end, values, count);
+/* split the text in pieces ending at a space, so no number is cut; a vector file has all its values in one line */
+job._chunks = (Chunk*)ALLOCATE(chunks * sizeof(Chunk));
+job._values = values;
+job._count = count;
+step = length / chunks;
+p = text;
+for(i = 0; i < chunks; i++)
+{
+	job._chunks[i]._begin = p;
+	if(i == chunks-1) p = end;
+	else
+	{
+		p = (p + step < end) ? p + step : end;
+		while(p < end && !__is_space_(*p)) p++;
+	}
+	job._chunks[i]._end = p;
+}
+/* count the values of each piece to know where its values go */
+parallel_for(NULL, chunks, __count_task_, &job);
+total = 0;
+for(i = 0; i < chunks; i++)
+{
+	job._chunks[i]._offset = total;
+	total += job._chunks[i]._tokens;
+}
+parallel_for(NULL, chunks, __parse_task_, &job);
+/* values are valid up to the first piece which stopped at a text which is not a number */
+parsed = 0;
+for(i = 0; i < chunks && job._chunks[i]._offset < count; i++)
+{
+	total = count - job._chunks[i]._offset;
+	if(total > job._chunks[i]._tokens) total = job._chunks[i]._tokens;
+	parsed += job._chunks[i]._parsed;
+	if(job._chunks[i]._parsed < total)
+	{
+		for(total = parsed; total < count; total++) values[total] = 0.0;
+		break;
+	}
+}
+
+/* release previously allocated memory */
+RELEASE(job._chunks);
+
+return parsed;
+}
+
+int format_double(double value, char* buffer)
+{
+int n = 0, length, k;
+if(value != value)
+{
+	strcpy(buffer, "nan");
+	return 3;
+}
+if(value < 0.0 || (value == 0.0 && 1.0 / value < 0.0))
+{
+	buffer[n++] = '-';
+	value = -value;
+}
+if(value == 0.0)
+{
+	buffer[n++] = '0';
+	buffer[n] = '\0';
+	return n;
+}
+if(value > 1.7976931348623157E308)
+{
+	strcpy(buffer + n, "inf");
+	return n + 3;
+}
+if(!__grisu3_(value, buffer + n, &length, &k)) __shortest_(value, buffer + n, &length, &k);
+n += __prettify_(buffer + n, length, k);
+buffer[n] = '\0';
+return n;
+}
+
+TextOutput* open_text_output(const char* filename)
+{
+FILE* file = NULL;
+TextOutput* out = NULL;
+if(filename == NULL) return NULL;
+file = fopen_write(filename);
+if(file == NULL) return NULL;
+out = (TextOutput*)ALLOCATE(sizeof(TextOutput));
+out->_file = file;
+out->_buffer = (char*)ALLOCATE(OUTPUT_BUFFER);
+out->_length = 0;
+out->_error = 0;
+return out;
+}
+
+void write_text_double(TextOutput* out, double value)
+{
+if(out->_length + FORMAT_DOUBLE_SIZE > OUTPUT_BUFFER) __flush_output_(out);
+out->_length += (size_t)format_double(value, out->_buffer + out->_length);
+}
+
+void write_text_int(TextOutput* out, int value)
+{
+char digits[12];
+int n = 0;
+unsigned int u = (value < 0) ? 0U - (unsigned int)value : (unsigned int)value;
+if(out->_length + sizeof(digits) > OUTPUT_BUFFER) __flush_output_(out);
+if(value < 0) out->_buffer[out->_length++] = '-';
+do
+{
+	digits[n++] = (char)('0' + u % 10);
+	u /= 10;
+}while(u > 0);
+while(n > 0) out->_buffer[out->_length++] = digits[--n];
+}
+
+void write_text_char(TextOutput* out, char c)
+{
+if(out->_length + 1 > OUTPUT_BUFFER) __flush_output_(out);
+out->_buffer[out->_length++] = c;
+}
+
+int close_text_output(TextOutput* out)
+{
+int ok;
+if(out == NULL) return 0;
+__flush_output_(out);
+if(fclose(out->_file) != 0) out->_error = 1;
+ok = !out->_error;
+RELEASE(out->_buffer);
+RELEASE(out);
+return ok;
 }
 
 /* END */
@@ -22,15 +22,17 @@
 #include <stdlib.h>
 #include <math.h>
 #include "qr.h"
+#include "allocator.h"
+#include "instrument.h"
 
 /* implementation */
 
 void destroy_qr(QR* qr)
 {
 if(qr == NULL) return;
-if(qr_q(qr) != NULL) free(qr_q(qr));
-if(qr_r(qr) != NULL) free(qr_r(qr));
-if(qr != NULL) free(qr);
+if(qr_q(qr) != NULL) destroy_matrix(qr_q(qr));
+if(qr_r(qr) != NULL) destroy_matrix(qr_r(qr));
+if(qr != NULL) RELEASE(qr);
 }
 
 QR* qr_factorization(const Matrix* m)
@@ -39,11 +41,13 @@ QR* qr = NULL;
 Matrix* q = NULL;
 Matrix* q1 = NULL;
 Matrix* r = NULL;
+Matrix* t = NULL;
 double w;
 int i, j, k, n;
 
 if(rows_matrix(m) < 2) return NULL; /* order must be at least 2 */
 if(rows_matrix(m) != columns_matrix(m)) return NULL; /* m must be square */
+INSTRUMENT_BEGIN;
 r = clone_matrix(m);
 n = columns_matrix(m);
 q = identity_matrix(n);
@@ -62,22 +66,26 @@ set_matrix(q1, -sin(w), i, j);
 set_matrix(q1, sin(w), j, i);
 set_matrix(q1, cos(w), j, j);
 /* update r */
-r = mul_matrix(q1, clone_matrix(r));
+t = mul_matrix(q1, r);
+destroy_matrix(r);
+r = t;
 /* update q */
-q = (k == 0) ? clone_matrix(q1) : mul_matrix(q1, clone_matrix(q));
+t = (k == 0) ? clone_matrix(q1) : mul_matrix(q1, q);
+destroy_matrix(q);
+q = t;
+destroy_matrix(q1);
 k++;
 }
 }
 /* create and build QR */
-qr = (QR*)malloc(sizeof(QR));
+qr = (QR*)ALLOCATE(sizeof(QR));
 qr_q(qr) = transpose_matrix(q);
-qr_r(qr) = clone_matrix(r);
+qr_r(qr) = r;
 
 /* release previously allocated memory */
 destroy_matrix(q);
-if(q1 != NULL) destroy_matrix(q1);
-destroy_matrix(r);
 
+INSTRUMENT_END(INSTRUMENT_QR_FACTORIZATION, 4.0/3.0*n*n*n);
 return qr;
 }
 
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L /* shm_open, sendmsg with SCM_RIGHTS */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#include "remote.h"
+#include "allocator.h"
+
+#define MIN_SHARED 1048576 /* smallest block of shared memory */
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/*
+* RemoteSolver type definition.
+*/
+struct RemoteSolver
+{
+int _socket;
+void* _shared; /* shared memory, which the daemon reads and writes */
+size_t _size;
+pthread_mutex_t _lock; /* one request at a time */
+};
+
+static unsigned long __shared_count_ = 0; /* blocks of shared memory created, to name them */
+
+/*
+* Helper functions.
+*/
+
+/*
+* Adds bytes to a FNV-1a hash.
+*/
+static unsigned long long __hash_(unsigned long long h, const void* data, size_t size)
+{
+const unsigned char* p = (const unsigned char*)data;
+size_t i;
+for(i = 0; i < size; i++)
+{
+	h ^= p[i];
+	h *= 1099511628211ULL;
+}
+return h;
+}
+
+#ifndef _WIN32
+/*
+* Sends a request and receives its reply.
+* id is sent with the request, if it is not NULL, and gets the id of the reply.
+*/
+static int __request_(RemoteSolver* r, int command, int order, int count, unsigned long long* id, int fd)
+{
+RemoteRequest request;
+RemoteReply reply;
+memset(&request, 0, sizeof(RemoteRequest));
+request._command = command;
+request._order = order;
+request._count = count;
+request._id = (id != NULL) ? *id : 0;
+request._size = r->_size;
+if(!send_remote(r->_socket, &request, sizeof(RemoteRequest), fd)) return REMOTE_ERROR;
+if(!receive_remote(r->_socket, &reply, sizeof(RemoteReply), NULL)) return REMOTE_ERROR;
+if(reply._status == REMOTE_OK && id != NULL) *id = reply._id;
+return reply._status;
+}
+
+/*
+* Makes the shared memory at least size bytes, replacing it by a bigger block which the daemon keeps.
+*/
+static int __reserve_(RemoteSolver* r, size_t size)
+{
+char name[64];
+int fd, status;
+void* p = NULL;
+size_t old = r->_size;
+void* previous = r->_shared;
+if(size <= r->_size) return 1;
+if(size < MIN_SHARED) size = MIN_SHARED;
+if(size < 2*r->_size) size = 2*r->_size;
+sprintf(name, "/linearsys-%ld-%lu", (long)getpid(), __atomic_add_fetch(&__shared_count_, 1, __ATOMIC_SEQ_CST));
+fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+if(fd < 0) return 0;
+/* the name is not needed once both processes have the descriptor */
+shm_unlink(name);
+if(ftruncate(fd, (off_t)size) != 0 || (p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+{
+	close(fd);
+	return 0;
+}
+r->_shared = p;
+r->_size = size;
+status = __request_(r, REMOTE_ATTACH, 0, 0, NULL, fd);
+close(fd);
+if(status != REMOTE_OK)
+{
+	munmap(p, size);
+	r->_shared = previous;
+	r->_size = old;
+	return 0;
+}
+/* release previously allocated memory */
+if(previous != NULL) munmap(previous, old);
+return 1;
+}
+
+/*
+* Passes a matrix to the daemon, which finds its factorization or makes it; r->_lock must be held.
+*/
+static int __factorization_(RemoteSolver* r, const Matrix* m, unsigned long long* id)
+{
+int n = rows_matrix(m);
+int status;
+if(!__reserve_(r, (size_t)n*n*sizeof(double))) return REMOTE_ERROR;
+memcpy(r->_shared, m->_data, (size_t)n*n*sizeof(double));
+status = __request_(r, REMOTE_LOOKUP, n, 0, id, -1);
+/* the daemon does not have it: factorize it there */
+if(status == REMOTE_MISSING) status = __request_(r, REMOTE_FACTORIZE, n, 0, id, -1);
+return status;
+}
+#endif
+
+/* end helper functions */
+
+/* implementation */
+
+#ifndef _WIN32
+
+int send_remote(int socket, const void* data, size_t size, int fd)
+{
+struct msghdr message;
+struct iovec io;
+struct cmsghdr* control = NULL;
+char buffer[CMSG_SPACE(sizeof(int))];
+const char* p = (const char*)data;
+ssize_t sent;
+int first = 1;
+while(size > 0)
+{
+	memset(&message, 0, sizeof(struct msghdr));
+	io.iov_base = (void*)p;
+	io.iov_len = size;
+	message.msg_iov = &io;
+	message.msg_iovlen = 1;
+	if(first && fd >= 0)
+	{
+		/* the descriptor goes with the first byte */
+		memset(buffer, 0, sizeof(buffer));
+		message.msg_control = buffer;
+		message.msg_controllen = sizeof(buffer);
+		control = CMSG_FIRSTHDR(&message);
+		control->cmsg_level = SOL_SOCKET;
+		control->cmsg_type = SCM_RIGHTS;
+		control->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(control), &fd, sizeof(int));
+	}
+	sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+	if(sent <= 0) return 0;
+	first = 0;
+	p += sent;
+	size -= (size_t)sent;
+}
+return 1;
+}
+
+int receive_remote(int socket, void* data, size_t size, int* fd)
+{
+struct msghdr message;
+struct iovec io;
+struct cmsghdr* control = NULL;
+char buffer[CMSG_SPACE(sizeof(int))];
+char* p = (char*)data;
+ssize_t received;
+int passed = -1;
+while(size > 0)
+{
+	memset(&message, 0, sizeof(struct msghdr));
+	io.iov_base = p;
+	io.iov_len = size;
+	message.msg_iov = &io;
+	message.msg_iovlen = 1;
+	message.msg_control = buffer;
+	message.msg_controllen = sizeof(buffer);
+	received = recvmsg(socket, &message, 0);
+	if(received <= 0)
+	{
+		if(passed >= 0) close(passed);
+		return 0;
+	}
+	for(control = CMSG_FIRSTHDR(&message); control != NULL; control = CMSG_NXTHDR(&message, control))
+	{
+		if(control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_RIGHTS && passed < 0) memcpy(&passed, CMSG_DATA(control), sizeof(int));
+	}
+	p += received;
+	size -= (size_t)received;
+}
+if(fd != NULL) *fd = passed;
+else if(passed >= 0) close(passed);
+return 1;
+}
+
+RemoteSolver* connect_remote(const char* path)
+{
+struct sockaddr_un address;
+RemoteSolver* r = NULL;
+int s;
+if(path == NULL) path = getenv("LINEARSYS_SOCKET");
+if(path == NULL) path = REMOTE_SOCKET;
+if(strlen(path) >= sizeof(address.sun_path)) return NULL;
+s = socket(AF_UNIX, SOCK_STREAM, 0);
+if(s < 0) return NULL;
+memset(&address, 0, sizeof(struct sockaddr_un));
+address.sun_family = AF_UNIX;
+strcpy(address.sun_path, path);
+if(connect(s, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) != 0)
+{
+	close(s);
+	return NULL;
+}
+r = (RemoteSolver*)ALLOCATE(sizeof(RemoteSolver));
+r->_socket = s;
+r->_shared = NULL;
+r->_size = 0;
+pthread_mutex_init(&r->_lock, NULL);
+return r;
+}
+
+void disconnect_remote(RemoteSolver* r)
+{
+if(r == NULL) return;
+close(r->_socket);
+if(r->_shared != NULL) munmap(r->_shared, r->_size);
+pthread_mutex_destroy(&r->_lock);
+RELEASE(r);
+r = NULL;
+}
+
+RemoteLU* remote_lu_decomposition(RemoteSolver* r, const Matrix* m)
+{
+int status;
+unsigned long long id = 0;
+RemoteLU* lu = NULL;
+if(r == NULL || m == NULL || rows_matrix(m) != columns_matrix(m) || rows_matrix(m) < 1) return NULL;
+pthread_mutex_lock(&r->_lock);
+status = __factorization_(r, m, &id);
+pthread_mutex_unlock(&r->_lock);
+if(status != REMOTE_OK) return NULL;
+lu = (RemoteLU*)ALLOCATE(sizeof(RemoteLU));
+lu->_solver = r;
+lu->_id = id;
+lu->_matrix = clone_matrix(m);
+return lu;
+}
+
+Vector* remote_lu_system_solver(RemoteLU* lu, const Vector* v)
+{
+int n, status = REMOTE_ERROR, attempt;
+RemoteSolver* r = NULL;
+Vector* x = NULL;
+if(lu == NULL || v == NULL || v->_size != rows_matrix(lu->_matrix)) return NULL;
+r = lu->_solver;
+n = v->_size;
+pthread_mutex_lock(&r->_lock);
+/* a second attempt if the daemon dropped the factorization, after making it again */
+for(attempt = 0; attempt < 2; attempt++)
+{
+	if(attempt > 0 && __factorization_(r, lu->_matrix, &lu->_id) != REMOTE_OK) break;
+	if(!__reserve_(r, (size_t)n*sizeof(double))) break;
+	memcpy(r->_shared, v->_data, (size_t)n*sizeof(double));
+	status = __request_(r, REMOTE_SOLVE, n, 1, &lu->_id, -1);
+	if(status != REMOTE_MISSING) break;
+}
+if(status == REMOTE_OK)
+{
+	x = create_vector(n);
+	memcpy(x->_data, r->_shared, (size_t)n*sizeof(double));
+}
+pthread_mutex_unlock(&r->_lock);
+return x;
+}
+
+#else
+
+int send_remote(int socket, const void* data, size_t size, int fd)
+{
+return 0;
+}
+
+int receive_remote(int socket, void* data, size_t size, int* fd)
+{
+return 0;
+}
+
+RemoteSolver* connect_remote(const char* path)
+{
+return NULL;
+}
+
+void disconnect_remote(RemoteSolver* r)
+{
+}
+
+RemoteLU* remote_lu_decomposition(RemoteSolver* r, const Matrix* m)
+{
+return NULL;
+}
+
+Vector* remote_lu_system_solver(RemoteLU* lu, const Vector* v)
+{
+return NULL;
+}
+
+#endif
+
+void destroy_remote_lu(RemoteLU* lu)
+{
+if(lu == NULL) return;
+destroy_matrix(lu->_matrix);
+RELEASE(lu);
+lu = NULL;
+}
+
+unsigned long long key_remote(const Matrix* m)
+{
+unsigned long long h = 14695981039346656037ULL;
+int r, c;
+if(m == NULL) return 0;
+r = rows_matrix(m);
+c = columns_matrix(m);
+h = __hash_(h, &r, sizeof(int));
+h = __hash_(h, &c, sizeof(int));
+return __hash_(h, m->_data, (size_t)r*c*sizeof(double));
+}
+
+/* END */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "rng.h"
+#include "allocator.h"
+
+#define PI 3.14159265358979323846
+
+/*
+* Helper functions.
+*/
+
+/*
+* splitmix64 step, used to spread a seed over the whole state.
+*/
+static unsigned long long __splitmix_(unsigned long long* x)
+{
+unsigned long long z;
+*x += 0x9E3779B97F4A7C15ULL;
+z = *x;
+z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+return z ^ (z >> 31);
+}
+
+static unsigned long long __rotl_(unsigned long long x, int k)
+{
+return (x << k) | (x >> (64 - k));
+}
+
+/* end helper functions */
+
+/* implementation */
+
+Random* create_random(unsigned long long seed)
+{
+Random* r = (Random*)ALLOCATE(sizeof(Random));
+seed_random(r, seed);
+return r;
+}
+
+Random* stream_random(unsigned long long seed, int stream)
+{
+int i;
+Random* r = NULL;
+if(stream < 0) return NULL;
+r = create_random(seed);
+for(i = 0; i < stream; i++) jump_random(r);
+return r;
+}
+
+void destroy_random(Random* r)
+{
+if(r == NULL) return;
+RELEASE(r);
+r = NULL;
+}
+
+Random* clone_random(const Random* r)
+{
+int i;
+Random* c = NULL;
+if(r == NULL) return NULL;
+c = (Random*)ALLOCATE(sizeof(Random));
+for(i = 0; i < 4; i++) c->_state[i] = r->_state[i];
+return c;
+}
+
+void seed_random(Random* r, unsigned long long seed)
+{
+int i;
+for(i = 0; i < 4; i++) r->_state[i] = __splitmix_(&seed);
+}
+
+void jump_random(Random* r)
+{
+static const unsigned long long jump[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+unsigned long long s[4] = { 0, 0, 0, 0 };
+int i, b, j;
+for(i = 0; i < 4; i++)
+{
+	for(b = 0; b < 64; b++)
+	{
+		if(jump[i] & (1ULL << b))
+		{
+			for(j = 0; j < 4; j++) s[j] ^= r->_state[j];
+		}
+		next_random(r);
+	}
+}
+for(j = 0; j < 4; j++) r->_state[j] = s[j];
+}
+
+unsigned long long next_random(Random* r)
+{
+unsigned long long* s = r->_state;
+unsigned long long result = __rotl_(s[1] * 5, 7) * 9;
+unsigned long long t = s[1] << 17;
+s[2] ^= s[0];
+s[3] ^= s[1];
+s[1] ^= s[2];
+s[0] ^= s[3];
+s[2] ^= t;
+s[3] = __rotl_(s[3], 45);
+return result;
+}
+
+double uniform_random(Random* r)
+{
+/* 53 random bits, centered in their interval so that 0 and 1 never come out */
+return ((double)(next_random(r) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+double gaussian_random(Random* r)
+{
+/* Box-Muller transform */
+double u1 = uniform_random(r);
+double u2 = uniform_random(r);
+return sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+}
+
+/* END */
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sparse.h"
+#include "allocator.h"
+#include "instrument.h"
+
+/*
+* Helper function to sort the entries of a row by column index ( insertion sort, rows are short ).
+*/
+static void sort_row(int* column_index, double* data, int n)
+{
+int i, j, c;
+double d;
+for(i = 1; i < n; i++)
+{
+	c = column_index[i];
+	d = data[i];
+	for(j = i-1; j >= 0 && column_index[j] > c; j--)
+	{
+		column_index[j+1] = column_index[j];
+		data[j+1] = data[j];
+	}
+	column_index[j+1] = c;
+	data[j+1] = d;
+}
+}
+
+/* end helper functions */
+
+/* implementation */
+
+SparseMatrix* create_sparse_matrix(int rows, int columns, int nonzeros)
+{
+int i;
+SparseMatrix* s = NULL;
+if(rows < 1 || columns < 1 || nonzeros < 0) return NULL;
+s = (SparseMatrix*)ALLOCATE(sizeof(SparseMatrix));
+s->_rows = rows;
+s->_columns = columns;
+s->_nonzeros = nonzeros;
+s->_row_start = (int*)ALLOCATE((rows+1) * sizeof(int));
+for(i = 0; i <= rows; i++) s->_row_start[i] = 0;
+s->_column_index = (int*)ALLOCATE(((nonzeros > 0) ? nonzeros : 1) * sizeof(int));
+s->_data = (double*)ALLOCATE(((nonzeros > 0) ? nonzeros : 1) * sizeof(double));
+return s;
+}
+
+void destroy_sparse_matrix(SparseMatrix* s)
+{
+if(s == NULL) return;
+if(s->_row_start != NULL) RELEASE(s->_row_start);
+if(s->_column_index != NULL) RELEASE(s->_column_index);
+if(s->_data != NULL) RELEASE(s->_data);
+RELEASE(s);
+s = NULL;
+}
+
+SparseMatrix* triplets_sparse_matrix(int rows, int columns, int count, const int* row_index, const int* column_index, const double* values)
+{
+int i, j, k, start, end;
+int* next = NULL;
+SparseMatrix* s = NULL;
+SparseMatrix* out = NULL;
+for(k = 0; k < count; k++)
+{
+	if(row_index[k] < 0 || row_index[k] >= rows || column_index[k] < 0 || column_index[k] >= columns) return NULL;
+}
+s = create_sparse_matrix(rows, columns, count);
+if(s == NULL) return NULL;
+/* count the entries of each row and compute the row offsets */
+for(k = 0; k < count; k++) s->_row_start[row_index[k]+1]++;
+for(i = 0; i < rows; i++) s->_row_start[i+1] += s->_row_start[i];
+/* scatter the triplets into their rows */
+next = (int*)ALLOCATE(rows * sizeof(int));
+for(i = 0; i < rows; i++) next[i] = s->_row_start[i];
+for(k = 0; k < count; k++)
+{
+	j = next[row_index[k]]++;
+	s->_column_index[j] = column_index[k];
+	s->_data[j] = values[k];
+}
+RELEASE(next);
+/* sort each row and add up duplicated entries */
+out = create_sparse_matrix(rows, columns, count);
+k = 0;
+for(i = 0; i < rows; i++)
+{
+	start = s->_row_start[i];
+	end = s->_row_start[i+1];
+	sort_row(s->_column_index + start, s->_data + start, end - start);
+	out->_row_start[i] = k;
+	for(j = start; j < end; j++)
+	{
+		if(k > out->_row_start[i] && out->_column_index[k-1] == s->_column_index[j])
+		{
+			out->_data[k-1] += s->_data[j];
+		}
+		else
+		{
+			out->_column_index[k] = s->_column_index[j];
+			out->_data[k] = s->_data[j];
+			k++;
+		}
+	}
+}
+out->_row_start[rows] = k;
+out->_nonzeros = k;
+
+/* release previously allocated memory */
+destroy_sparse_matrix(s);
+
+return out;
+}
+
+SparseMatrix* to_sparse_matrix(const Matrix* m)
+{
+int i, j, k, count;
+SparseMatrix* s = NULL;
+if(m == NULL) return NULL;
+count = 0;
+for(i = 0; i < dimension_matrix(m); i++) if(m->_data[i] != 0.0) count++;
+s = create_sparse_matrix(rows_matrix(m), columns_matrix(m), count);
+k = 0;
+for(i = 0; i < rows_matrix(m); i++)
+{
+	s->_row_start[i] = k;
+	for(j = 0; j < columns_matrix(m); j++)
+	{
+		if(m->_data[(size_t)i*columns_matrix(m)+j] == 0.0) continue;
+		s->_column_index[k] = j;
+		s->_data[k] = m->_data[(size_t)i*columns_matrix(m)+j];
+		k++;
+	}
+}
+s->_row_start[rows_matrix(m)] = k;
+return s;
+}
+
+Matrix* to_dense_matrix(const SparseMatrix* s)
+{
+int i, k;
+Matrix* m = NULL;
+if(s == NULL) return NULL;
+m = create_matrix(s->_rows, s->_columns);
+for(i = 0; i < s->_rows; i++)
+{
+	for(k = s->_row_start[i]; k < s->_row_start[i+1]; k++)
+	{
+		m->_data[(size_t)i*s->_columns+s->_column_index[k]] = s->_data[k];
+	}
+}
+return m;
+}
+
+double get_sparse_matrix(const SparseMatrix* s, int i, int j)
+{
+int low, high, middle;
+if(i < 0 || i > s->_rows-1 || j < 0 || j > s->_columns-1) return NaN;
+/* binary search in the ith row */
+low = s->_row_start[i];
+high = s->_row_start[i+1] - 1;
+while(low <= high)
+{
+	middle = (low + high) / 2;
+	if(s->_column_index[middle] == j) return s->_data[middle];
+	if(s->_column_index[middle] < j) low = middle + 1;
+	else high = middle - 1;
+}
+return 0.0;
+}
+
+Vector* mul_sparse_matrix_vector(const SparseMatrix* s, const Vector* v)
+{
+int i, k;
+double accum;
+Vector* out = NULL;
+if(s == NULL || v == NULL) return NULL;
+if(size_vector(v) != s->_columns) return NULL;
+INSTRUMENT_BEGIN;
+out = create_vector(s->_rows);
+for(i = 0; i < s->_rows; i++)
+{
+	accum = 0.0;
+	for(k = s->_row_start[i]; k < s->_row_start[i+1]; k++) accum += s->_data[k] * v->_data[s->_column_index[k]];
+	out->_data[i] = accum;
+}
+INSTRUMENT_END(INSTRUMENT_MUL_SPARSE_MATRIX_VECTOR, 2.0*s->_row_start[s->_rows]);
+return out;
+}
+
+void print_sparse_matrix(const SparseMatrix* s)
+{
+int i, k;
+if(s == NULL)
+{
+printf("[]\n");
+return;
+}
+for(i = 0; i < s->_rows; i++)
+{
+	for(k = s->_row_start[i]; k < s->_row_start[i+1]; k++)
+	{
+		printf("(%d, %d) %.2lf\n", i, s->_column_index[k], s->_data[k]);
+	}
+}
+}
+
+/* END */
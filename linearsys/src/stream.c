@@ -0,0 +1,493 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "stream.h"
+#include "allocator.h"
+#include "binio.h"
+#include "numio.h"
+
+#define TEXT_BUFFER (1 << 20) /* bytes read at once from a text file */
+#define TOKEN_SIZE 64 /* the buffer is refilled when less than this is left, so a token is never split */
+
+/*
+* RowReader type definition.
+* Two buffers of block_rows rows are used: the background thread fills one
+* while the caller copies the other; a buffer is full from the time it is filled until it is copied.
+* A buffer holding 0 rows ( end of file ) or -1 ( error ) stays full, so every later read returns the same.
+*/
+struct RowReader
+{
+FILE* _file;
+int _binary;
+long long _rows;
+int _columns;
+int _block_rows;
+long long _produced; /* rows read from the file by the background thread */
+/* text format */
+char* _text;
+size_t _length;
+size_t _position;
+int _end;
+/* binary format */
+Checksum _sum;
+uint64_t _checksum;
+int _checked; /* the file keeps its checksum */
+/* compressed binary format */
+int _compressed;
+ChunkHeader _chunk_header;
+uint64_t* _positions; /* position of each chunk in the file */
+uint64_t _chunk; /* next chunk to decode */
+double* _decoded; /* rows of the last chunk decoded */
+long long _decoded_rows;
+long long _decoded_next; /* first of them not copied yet */
+unsigned char* _raw; /* bytes of the last chunk read */
+size_t _raw_capacity;
+/* read ahead */
+double* _buffer[2];
+int _count[2];
+int _full[2];
+int _current; /* buffer the caller reads next */
+int _stop;
+int _started; /* the background thread is running */
+pthread_t _thread;
+pthread_mutex_t _lock;
+pthread_cond_t _filled;
+pthread_cond_t _emptied;
+};
+
+/*
+* RowWriter type definition.
+*/
+struct RowWriter
+{
+int _binary;
+long long _rows;
+int _columns;
+long long _written;
+int _error;
+FILE* _file; /* binary format */
+TextOutput* _text; /* text format */
+Checksum _sum;
+};
+
+/*
+* Helper functions.
+*/
+
+/*
+* Moves the pending text to the front of the buffer and reads more when less than TOKEN_SIZE bytes are left.
+* The text is always terminated with a zero.
+*/
+static void __refill_text_(RowReader* r)
+{
+size_t left, n;
+if(r->_end || r->_length - r->_position >= TOKEN_SIZE) return;
+left = r->_length - r->_position;
+memmove(r->_text, r->_text + r->_position, left);
+n = fread(r->_text + left, 1, TEXT_BUFFER - left, r->_file);
+if(n == 0) r->_end = 1;
+r->_length = left + n;
+r->_position = 0;
+r->_text[r->_length] = '\0';
+}
+
+/*
+* Skips blanks in the text.
+*/
+static void __skip_blanks_(RowReader* r)
+{
+for(;;)
+{
+	__refill_text_(r);
+	while(r->_position < r->_length && (r->_text[r->_position] == ' ' || r->_text[r->_position] == '\t' ||
+	r->_text[r->_position] == '\n' || r->_text[r->_position] == '\r')) r->_position++;
+	if(r->_position < r->_length || r->_end) return;
+}
+}
+
+/*
+* Reads a number of rows from a text file.
+* returns: 1 on success or 0 if a value is missing or malformed.
+*/
+static int __read_text_rows_(RowReader* r, double* rows, int count)
+{
+size_t k, n = (size_t)count * r->_columns;
+char* end = NULL;
+for(k = 0; k < n; k++)
+{
+	__skip_blanks_(r);
+	if(r->_position >= r->_length) return 0;
+	rows[k] = parse_double(r->_text + r->_position, &end);
+	if(end == r->_text + r->_position) return 0;
+	r->_position = (size_t)(end - r->_text);
+}
+return 1;
+}
+
+/*
+* Reads a number of rows from a binary file and verifies the checksum after the last row.
+* returns: 1 on success or 0 if the file is short or corrupt.
+*/
+static int __read_binary_rows_(RowReader* r, double* rows, int count)
+{
+size_t n = (size_t)count * r->_columns;
+size_t size;
+long long k, done;
+unsigned char* raw = NULL;
+if(!r->_compressed)
+{
+	if(fread(rows, sizeof(double), n, r->_file) != n) return 0;
+}
+else
+{
+	/* copy rows from the decoded chunk, decoding the next one when it is used up */
+	for(done = 0; done < count; done += k)
+	{
+		if(r->_decoded_next == r->_decoded_rows)
+		{
+			if(r->_chunk >= r->_chunk_header._chunks) return 0;
+			size = (size_t)(r->_positions[r->_chunk+1] - r->_positions[r->_chunk]);
+			if(size > r->_raw_capacity)
+			{
+				raw = (unsigned char*)REALLOCATE(r->_raw, r->_raw_capacity, size);
+				if(raw == NULL) return 0;
+				r->_raw = raw;
+				r->_raw_capacity = size;
+			}
+			r->_decoded_rows = r->_rows - (long long)(r->_chunk * r->_chunk_header._chunk_rows);
+			if(r->_decoded_rows > (long long)r->_chunk_header._chunk_rows) r->_decoded_rows = (long long)r->_chunk_header._chunk_rows;
+			if(fread(r->_raw, 1, size, r->_file) != size ||
+			!decode_chunk_binary(r->_raw, size, r->_decoded, (size_t)r->_decoded_rows * r->_columns)) return 0;
+			r->_decoded_next = 0;
+			r->_chunk++;
+		}
+		k = r->_decoded_rows - r->_decoded_next;
+		if(k > count - done) k = count - done;
+		memcpy(rows + (size_t)done * r->_columns, r->_decoded + (size_t)r->_decoded_next * r->_columns, (size_t)k * r->_columns * sizeof(double));
+		r->_decoded_next += k;
+	}
+}
+update_checksum(&r->_sum, rows, n);
+if(r->_checked && r->_produced + count == r->_rows && value_checksum(&r->_sum) != r->_checksum) return 0;
+return 1;
+}
+
+/*
+* Reads the chunk table of a compressed file ( see read_chunk_table_binary ), leaving the file at the first chunk.
+*/
+static int __chunk_table_(RowReader* r, const BinaryHeader* header)
+{
+r->_compressed = 1;
+r->_positions = read_chunk_table_binary(r->_file, header, &r->_chunk_header);
+if(r->_positions == NULL) return 0;
+/* the table bounds chunk_rows, so this is at most COMPRESSED_CHUNK bytes or a row */
+r->_decoded = (double*)ALLOCATE((size_t)r->_chunk_header._chunk_rows * r->_columns * sizeof(double));
+return r->_decoded != NULL;
+}
+
+/*
+* Background thread: fills the free buffer until the end of the file, an error or a stop request.
+*/
+static void* __read_ahead_(void* arg)
+{
+int n, slot = 0;
+RowReader* r = (RowReader*)arg;
+for(;;)
+{
+	pthread_mutex_lock(&r->_lock);
+	while(r->_full[slot] && !r->_stop) pthread_cond_wait(&r->_emptied, &r->_lock);
+	if(r->_stop)
+	{
+		pthread_mutex_unlock(&r->_lock);
+		break;
+	}
+	pthread_mutex_unlock(&r->_lock);
+	n = (r->_rows - r->_produced < r->_block_rows) ? (int)(r->_rows - r->_produced) : r->_block_rows;
+	if(n > 0)
+	{
+		if(r->_binary ? !__read_binary_rows_(r, r->_buffer[slot], n) : !__read_text_rows_(r, r->_buffer[slot], n)) n = -1;
+		else r->_produced += n;
+	}
+	pthread_mutex_lock(&r->_lock);
+	r->_count[slot] = n;
+	r->_full[slot] = 1;
+	pthread_cond_signal(&r->_filled);
+	pthread_mutex_unlock(&r->_lock);
+	if(n <= 0) break;
+	slot ^= 1;
+}
+return NULL;
+}
+
+/*
+* Reads the header of a text file: number of rows and columns.
+*/
+static int __text_header_(RowReader* r)
+{
+char* end = NULL;
+long long value[2];
+int k;
+for(k = 0; k < 2; k++)
+{
+	__skip_blanks_(r);
+	value[k] = strtoll(r->_text + r->_position, &end, 10);
+	if(end == r->_text + r->_position) return 0;
+	r->_position = (size_t)(end - r->_text);
+}
+if(value[0] < 1 || value[1] < 1 || value[1] > INT_MAX) return 0;
+r->_rows = value[0];
+r->_columns = (int)value[1];
+return 1;
+}
+
+/*
+* Writes a long long value to a TextOutput.
+*/
+static void __write_text_long_(TextOutput* out, long long value)
+{
+char digits[24];
+int k, n = sprintf(digits, "%lld", value);
+for(k = 0; k < n; k++) write_text_char(out, digits[k]);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+RowReader* open_row_reader(const char* filename, int block_rows)
+{
+int k, ok;
+BinaryHeader header;
+RowReader* r = NULL;
+if(filename == NULL || block_rows < 1) return NULL;
+r = (RowReader*)ALLOCATE(sizeof(RowReader));
+memset(r, 0, sizeof(RowReader));
+r->_block_rows = block_rows;
+r->_file = fopen(filename, "rb");
+if(r->_file == NULL)
+{
+	RELEASE(r);
+	return NULL;
+}
+if(fread(&header, sizeof(header), 1, r->_file) == 1 && memcmp(header._magic, BINARY_MAGIC, 8) == 0)
+{
+	/* a column major file cannot be read by rows */
+	ok = valid_header_binary(&header) && header._layout == BINARY_ROW_MAJOR &&
+	fseek(r->_file, (long)header._offset, SEEK_SET) == 0;
+	r->_binary = 1;
+	r->_rows = (long long)header._rows;
+	r->_columns = (int)header._columns;
+	r->_checksum = header._checksum;
+	r->_checked = !(header._flags & BINARY_UNCHECKED);
+	start_checksum(&r->_sum);
+	if(ok && (header._flags & BINARY_COMPRESSED)) ok = __chunk_table_(r, &header);
+}
+else
+{
+	rewind(r->_file);
+	r->_text = (char*)ALLOCATE(TEXT_BUFFER + 1);
+	r->_text[0] = '\0';
+	ok = __text_header_(r);
+}
+if(ok && (size_t)block_rows * r->_columns > INT_MAX) ok = 0; /* a block must fit in a Matrix */
+if(!ok)
+{
+	/* release previously allocated memory */
+	fclose(r->_file);
+	if(r->_text != NULL) RELEASE(r->_text);
+	if(r->_positions != NULL) RELEASE(r->_positions);
+	if(r->_decoded != NULL) RELEASE(r->_decoded);
+	RELEASE(r);
+	return NULL;
+}
+pthread_mutex_init(&r->_lock, NULL);
+pthread_cond_init(&r->_filled, NULL);
+pthread_cond_init(&r->_emptied, NULL);
+for(k = 0; k < 2; k++) r->_buffer[k] = (double*)ALLOCATE((size_t)block_rows * r->_columns * sizeof(double));
+if(r->_buffer[0] == NULL || r->_buffer[1] == NULL || pthread_create(&r->_thread, NULL, __read_ahead_, r) != 0)
+{
+	close_row_reader(r);
+	return NULL;
+}
+r->_started = 1;
+return r;
+}
+
+int read_row_block(RowReader* r, Matrix* block)
+{
+int n, slot;
+if(r == NULL || block == NULL) return -1;
+if(columns_matrix(block) != r->_columns || rows_matrix(block) < r->_block_rows) return -1;
+slot = r->_current;
+pthread_mutex_lock(&r->_lock);
+while(!r->_full[slot]) pthread_cond_wait(&r->_filled, &r->_lock);
+n = r->_count[slot];
+pthread_mutex_unlock(&r->_lock);
+if(n <= 0) return n;
+/* the background thread does not touch a full buffer, so it is copied without the lock */
+memcpy(block->_data, r->_buffer[slot], (size_t)n * r->_columns * sizeof(double));
+pthread_mutex_lock(&r->_lock);
+r->_full[slot] = 0;
+r->_current = slot ^ 1;
+pthread_cond_signal(&r->_emptied);
+pthread_mutex_unlock(&r->_lock);
+return n;
+}
+
+void close_row_reader(RowReader* r)
+{
+if(r == NULL) return;
+if(r->_started)
+{
+	pthread_mutex_lock(&r->_lock);
+	r->_stop = 1;
+	pthread_cond_signal(&r->_emptied);
+	pthread_mutex_unlock(&r->_lock);
+	pthread_join(r->_thread, NULL);
+}
+/* release previously allocated memory */
+pthread_mutex_destroy(&r->_lock);
+pthread_cond_destroy(&r->_filled);
+pthread_cond_destroy(&r->_emptied);
+RELEASE(r->_buffer[0]);
+RELEASE(r->_buffer[1]);
+if(r->_text != NULL) RELEASE(r->_text);
+if(r->_positions != NULL) RELEASE(r->_positions);
+if(r->_decoded != NULL) RELEASE(r->_decoded);
+if(r->_raw != NULL) RELEASE(r->_raw);
+fclose(r->_file);
+RELEASE(r);
+}
+
+long long rows_row_reader(const RowReader* r)
+{
+return r->_rows;
+}
+
+int columns_row_reader(const RowReader* r)
+{
+return r->_columns;
+}
+
+int block_rows_row_reader(const RowReader* r)
+{
+return r->_block_rows;
+}
+
+RowWriter* open_row_writer(const char* filename, long long rows, int columns, int binary)
+{
+BinaryHeader header;
+RowWriter* w = NULL;
+if(filename == NULL || rows < 1 || columns < 1) return NULL;
+w = (RowWriter*)ALLOCATE(sizeof(RowWriter));
+memset(w, 0, sizeof(RowWriter));
+w->_binary = binary;
+w->_rows = rows;
+w->_columns = columns;
+if(binary)
+{
+	w->_file = fopen(filename, "wb");
+	if(w->_file == NULL)
+	{
+		RELEASE(w);
+		return NULL;
+	}
+	/* the checksum is not known yet, the header is written again when the file is closed */
+	make_header_binary(&header, (uint64_t)rows, (uint64_t)columns, 0);
+	if(fwrite(&header, sizeof(header), 1, w->_file) != 1) w->_error = 1;
+	start_checksum(&w->_sum);
+}
+else
+{
+	w->_text = open_text_output(filename);
+	if(w->_text == NULL)
+	{
+		RELEASE(w);
+		return NULL;
+	}
+	__write_text_long_(w->_text, rows);
+	write_text_char(w->_text, ' ');
+	write_text_int(w->_text, columns);
+	write_text_char(w->_text, '\n');
+}
+return w;
+}
+
+int write_row_block(RowWriter* w, const Matrix* block, int count)
+{
+int i, j;
+size_t n;
+const double* row = NULL;
+if(w == NULL || block == NULL) return 0;
+if(columns_matrix(block) != w->_columns || count < 0 || count > rows_matrix(block)) return 0;
+if(w->_written + count > w->_rows) return 0;
+if(w->_binary)
+{
+	n = (size_t)count * w->_columns;
+	if(fwrite(block->_data, sizeof(double), n, w->_file) != n)
+	{
+		w->_error = 1;
+		return 0;
+	}
+	update_checksum(&w->_sum, block->_data, n);
+}
+else
+{
+	for(i = 0; i < count; i++)
+	{
+		row = block->_data + (size_t)i*w->_columns;
+		for(j = 0; j < w->_columns; j++)
+		{
+			if(j > 0) write_text_char(w->_text, ' ');
+			write_text_double(w->_text, row[j]);
+		}
+		write_text_char(w->_text, '\n');
+	}
+}
+w->_written += count;
+return 1;
+}
+
+int close_row_writer(RowWriter* w)
+{
+int ok;
+BinaryHeader header;
+if(w == NULL) return 0;
+ok = !w->_error && w->_written == w->_rows;
+if(w->_binary)
+{
+	make_header_binary(&header, (uint64_t)w->_rows, (uint64_t)w->_columns, value_checksum(&w->_sum));
+	if(ok) ok = (fseek(w->_file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, w->_file) == 1);
+	if(fclose(w->_file) != 0) ok = 0;
+}
+else
+{
+	if(!close_text_output(w->_text)) ok = 0;
+}
+RELEASE(w);
+return ok;
+}
+
+/* END */
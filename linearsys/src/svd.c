@@ -23,10 +23,15 @@
 #include <math.h>
 #include "eigen.h"
 #include "svd.h"
+#include "allocator.h"
+#include "instrument.h"
 
 #define LEFT_SIDE 0 /* left side */
 #define RIGHT_SIDE 1 /* right side */
 
+#define JACOBI_MAX_SWEEPS 60 /* maximum number of one sided Jacobi sweeps */
+#define EPSILON 2.220446049250313E-16 /* double precision machine epsilon */
+
 /*
 * Helper functions.
 */
@@ -37,6 +42,252 @@ static int get_min(int m, int n)
 return (m <= n) ? LEFT_SIDE : RIGHT_SIDE;
 }
 
+static double dot_rows(const double* x, const double* y, int n)
+{
+int i;
+double d = 0.0;
+for(i = 0; i < n; i++) d += x[i] * y[i];
+return d;
+}
+
+/*
+* Orthonormalizes the rows of a matrix using modified Gram-Schmidt.
+* Each row is orthogonalized twice to keep orthogonality to working precision.
+* Rows which turn out to be linearly dependent on the previous ones are set to zero.
+*/
+static void orthonormalize_rows(Matrix* q)
+{
+int i, j, t, pass;
+int l = rows_matrix(q);
+int n = columns_matrix(q);
+double norm0, norm, d;
+double* qi = NULL;
+double* qj = NULL;
+for(i = 0; i < l; i++)
+{
+	qi = q->_data + (size_t)i*n;
+	norm0 = sqrt(dot_rows(qi, qi, n));
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(j = 0; j < i; j++)
+		{
+			qj = q->_data + (size_t)j*n;
+			d = dot_rows(qj, qi, n);
+			for(t = 0; t < n; t++) qi[t] -= d * qj[t];
+		}
+	}
+	norm = sqrt(dot_rows(qi, qi, n));
+	if(norm <= 1E-12 * norm0 || norm == 0.0)
+	{
+		for(t = 0; t < n; t++) qi[t] = 0.0;
+	}
+	else
+	{
+		for(t = 0; t < n; t++) qi[t] /= norm;
+	}
+}
+}
+
+/*
+* Computes x = q*a - (q*1)*mean^t for the rows of q.
+* That is, the product q*a of the rows of q times the data matrix a centered by the column means.
+*/
+static void mul_rows_matrix(const Matrix* q, const Matrix* a, const double* mean, Matrix* x)
+{
+int i, j;
+double s;
+gemm_matrix(1.0, q, 0, a, 0, 0.0, x);
+if(mean == NULL) return;
+for(i = 0; i < rows_matrix(q); i++)
+{
+	s = 0.0;
+	for(j = 0; j < columns_matrix(q); j++) s += q->_data[(size_t)i*columns_matrix(q)+j];
+	for(j = 0; j < columns_matrix(x); j++) x->_data[(size_t)i*columns_matrix(x)+j] -= s * mean[j];
+}
+}
+
+/*
+* Computes x = q*a^t - (q*mean)*1^t for the rows of q.
+* That is, the product q*a^t of the rows of q times the transpose of the centered data matrix a.
+*/
+static void mul_rows_transpose(const Matrix* q, const Matrix* a, const double* mean, Matrix* x)
+{
+int i, j;
+double s;
+gemm_matrix(1.0, q, 0, a, 1, 0.0, x);
+if(mean == NULL) return;
+for(i = 0; i < rows_matrix(q); i++)
+{
+	s = dot_rows(q->_data + (size_t)i*columns_matrix(q), mean, columns_matrix(q));
+	for(j = 0; j < columns_matrix(x); j++) x->_data[(size_t)i*columns_matrix(x)+j] -= s;
+}
+}
+
+/*
+* One sided Jacobi SVD applied to the rows of b.
+* Rotations are applied to pairs of rows of b until all of them are orthogonal,
+* and they are accumulated in g, which must be the identity on entry.
+* On exit b = g*b0 where b0 is the original matrix,
+* so b0 = g^t*b and the norms of the rows of b are the singular values of b0.
+*/
+static void jacobi_rows(Matrix* b, Matrix* g)
+{
+int p, q, t, sweep, rotated;
+int l = rows_matrix(b);
+int n = columns_matrix(b);
+double alpha, beta, gamma, zeta, tg, c, s, x, y;
+double *bp, *bq, *gp, *gq;
+for(sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++)
+{
+	rotated = 0;
+	for(p = 0; p < l-1; p++)
+	{
+		for(q = p+1; q < l; q++)
+		{
+			bp = b->_data + (size_t)p*n;
+			bq = b->_data + (size_t)q*n;
+			alpha = dot_rows(bp, bp, n);
+			beta = dot_rows(bq, bq, n);
+			gamma = dot_rows(bp, bq, n);
+			if(gamma == 0.0 || fabs(gamma) <= EPSILON * sqrt(alpha * beta)) continue;
+			rotated = 1;
+			zeta = (beta - alpha) / (2.0 * gamma);
+			tg = ((zeta >= 0.0) ? 1.0 : -1.0) / (fabs(zeta) + sqrt(1.0 + zeta*zeta));
+			c = 1.0 / sqrt(1.0 + tg*tg);
+			s = c * tg;
+			for(t = 0; t < n; t++)
+			{
+				x = bp[t];
+				y = bq[t];
+				bp[t] = c*x - s*y;
+				bq[t] = s*x + c*y;
+			}
+			gp = g->_data + (size_t)p*l;
+			gq = g->_data + (size_t)q*l;
+			for(t = 0; t < l; t++)
+			{
+				x = gp[t];
+				y = gq[t];
+				gp[t] = c*x - s*y;
+				gq[t] = s*x + c*y;
+			}
+		}
+	}
+	if(!rotated) break;
+}
+}
+
+/*
+* Randomized SVD.
+* All the tall and wide matrices are kept transposed ( one basis vector per row ),
+* so that orthonormalization and the Jacobi sweeps work on contiguous memory.
+* If mean is not NULL the columns of m are centered by it on the fly.
+* If want_u is zero, U is not computed and it is left as NULL.
+*/
+static SVD* randomized_svd_core(const Matrix* m, const double* mean, int k, int oversampling, int power_iterations, Random* rng, int want_u)
+{
+int i, j, l, r, c, best;
+int* order = NULL;
+double tmp;
+double* sv = NULL;
+Random state;
+Matrix* omega = NULL;
+Matrix* y = NULL;
+Matrix* z = NULL;
+Matrix* g = NULL;
+Matrix* ut = NULL;
+SVD* svd = NULL;
+if(m == NULL) return NULL;
+r = rows_matrix(m);
+c = columns_matrix(m);
+l = (r <= c) ? r : c;
+if(k < 1 || k > l) return NULL;
+if(oversampling < 0) oversampling = 0;
+if(power_iterations < 0) power_iterations = 0;
+if(k + oversampling < l) l = k + oversampling;
+INSTRUMENT_BEGIN;
+
+/* sketch the range of m: y = omega*m^t */
+if(rng == NULL)
+{
+	seed_random(&state, DEFAULT_SEED);
+	rng = &state;
+}
+z = create_matrix(l, c);
+for(i = 0; i < l*c; i++) z->_data[i] = gaussian_random(rng);
+omega = z;
+y = create_matrix(l, r);
+mul_rows_transpose(omega, m, mean, y);
+orthonormalize_rows(y);
+
+/* power iterations */
+for(i = 0; i < power_iterations; i++)
+{
+	mul_rows_matrix(y, m, mean, z);
+	orthonormalize_rows(z);
+	mul_rows_transpose(z, m, mean, y);
+	orthonormalize_rows(y);
+}
+
+/* project m onto the sketch, b = q^t*m ( stored in z ), and factorize it */
+mul_rows_matrix(y, m, mean, z);
+g = identity_matrix(l);
+jacobi_rows(z, g);
+
+/* sort the singular values in decreasing order */
+sv = (double*)ALLOCATE(l * sizeof(double));
+order = (int*)ALLOCATE(l * sizeof(int));
+for(i = 0; i < l; i++)
+{
+	sv[i] = sqrt(dot_rows(z->_data + (size_t)i*c, z->_data + (size_t)i*c, c));
+	order[i] = i;
+}
+for(i = 0; i < k; i++)
+{
+	best = i;
+	for(j = i+1; j < l; j++) if(sv[order[j]] > sv[order[best]]) best = j;
+	j = order[i];
+	order[i] = order[best];
+	order[best] = j;
+}
+
+/* build SVD */
+svd = (SVD*)ALLOCATE(sizeof(SVD));
+svd_u(svd) = NULL;
+svd_sigma(svd) = create_matrix(k, k);
+svd_v(svd) = create_matrix(c, k);
+for(j = 0; j < k; j++)
+{
+	tmp = sv[order[j]];
+	set_matrix(svd_sigma(svd), tmp, j, j);
+	if(tmp == 0.0) continue;
+	for(i = 0; i < c; i++) svd_v(svd)->_data[(size_t)i*k+j] = z->_data[(size_t)order[j]*c+i] / tmp;
+}
+if(want_u)
+{
+	/* u^t = g*q^t */
+	ut = create_matrix(l, r);
+	gemm_matrix(1.0, g, 0, y, 0, 0.0, ut);
+	svd_u(svd) = create_matrix(r, k);
+	for(j = 0; j < k; j++)
+	{
+		for(i = 0; i < r; i++) svd_u(svd)->_data[(size_t)i*k+j] = ut->_data[(size_t)order[j]*r+i];
+	}
+	destroy_matrix(ut);
+}
+
+/* release previously allocated memory */
+RELEASE(sv);
+RELEASE(order);
+destroy_matrix(g);
+destroy_matrix(y);
+destroy_matrix(z);
+
+INSTRUMENT_ITERATIONS((want_u) ? INSTRUMENT_RANDOMIZED_SVD : INSTRUMENT_PCA_FACTORIZATION, power_iterations);
+INSTRUMENT_END((want_u) ? INSTRUMENT_RANDOMIZED_SVD : INSTRUMENT_PCA_FACTORIZATION, 4.0*r*c*l*(power_iterations+1));
+return svd;
+}
+
 /* end helper functions */
 
 
@@ -48,7 +299,7 @@ if(svd == NULL) return;
 if(svd_u(svd) != NULL) destroy_matrix(svd_u(svd));
 if(svd_sigma(svd) != NULL) destroy_matrix(svd_sigma(svd));
 if(svd_v(svd) != NULL) destroy_matrix(svd_v(svd));
-free(svd);
+RELEASE(svd);
 svd = NULL;
 }
 
@@ -79,24 +330,43 @@ EigenSystem* right = NULL;
 Matrix* u = NULL;
 Matrix* sigma = NULL;
 Matrix* v = NULL;
+Matrix* t = NULL;
+Matrix* mt = NULL;
+Matrix* a = NULL;
+Vector* w = NULL;
 if(m == NULL) return NULL;
+INSTRUMENT_BEGIN;
 u = create_matrix(rows_matrix(m), rows_matrix(m));
 sigma = create_matrix(rows_matrix(m), columns_matrix(m));
 v = create_matrix(columns_matrix(m), columns_matrix(m));
 /* compute left and right eigen */
-left = eigen_system(mul_matrix(m, transpose_matrix(m)));
-right = eigen_system(mul_matrix(transpose_matrix(m), m));
+mt = transpose_matrix(m);
+a = mul_matrix(m, mt);
+left = eigen_system(a);
+destroy_matrix(a);
+a = mul_matrix(mt, m);
+right = eigen_system(a);
+destroy_matrix(a);
+destroy_matrix(mt);
 
 /* compute UDV */
 n = size_eigensystem(left);
 for(i = 0; i < n; i++)
 {
-u = set_column_matrix(u, normalize_vector(eigen_vector(left->_eigen[i])), i);
+w = normalize_vector(eigen_vector(left->_eigen[i]));
+t = set_column_matrix(u, w, i);
+destroy_vector(w);
+destroy_matrix(u);
+u = t;
 }
 n = size_eigensystem(right);
 for(i = 0; i < n; i++)
 {
-v = set_column_matrix(v, normalize_vector(eigen_vector(right->_eigen[i])), i);
+w = normalize_vector(eigen_vector(right->_eigen[i]));
+t = set_column_matrix(v, w, i);
+destroy_vector(w);
+destroy_matrix(v);
+v = t;
 }
 min = get_min(rows_matrix(m), columns_matrix(m));
 if(min == LEFT_SIDE)
@@ -116,20 +386,207 @@ else
 	}
 }
 /* build SVD */
-svd = (SVD*)malloc(sizeof(SVD));
-svd_u(svd) = clone_matrix(u);
-svd_sigma(svd) = clone_matrix(sigma);
-svd_v(svd) = clone_matrix(v);
+svd = (SVD*)ALLOCATE(sizeof(SVD));
+svd_u(svd) = u;
+svd_sigma(svd) = sigma;
+svd_v(svd) = v;
 
 /* release previously allocated memory */
 destroy_eigensystem(left);
 destroy_eigensystem(right);
-destroy_matrix(u);
-destroy_matrix(sigma);
-destroy_matrix(v);
 
+INSTRUMENT_END(INSTRUMENT_SVD_FACTORIZATION, 0.0);
 return svd;
 }
 
+SVD* randomized_svd(const Matrix* m, int k, int oversampling, int power_iterations, Random* rng)
+{
+return randomized_svd_core(m, NULL, k, oversampling, power_iterations, rng, 1);
+}
+
+void destroy_pca(PCA* pca)
+{
+if(pca == NULL) return;
+if(pca_mean(pca) != NULL) destroy_vector(pca_mean(pca));
+if(pca_components(pca) != NULL) destroy_matrix(pca_components(pca));
+if(pca_variance(pca) != NULL) destroy_vector(pca_variance(pca));
+RELEASE(pca);
+pca = NULL;
+}
+
+void print_pca(const PCA* pca)
+{
+if(pca == NULL)
+{
+printf("[]");
+return;
+}
+printf("Mean:\n");
+print_vector(pca_mean(pca));
+printf("\n");
+printf("Components:\n");
+print_matrix(pca_components(pca));
+printf("\n");
+printf("Variance:\n");
+print_vector(pca_variance(pca));
+printf("\n");
+}
+
+PCA* pca_factorization(const Matrix* m, int k, int oversampling, int power_iterations, Random* rng)
+{
+int i, j, r, c;
+double d;
+PCA* pca = NULL;
+SVD* svd = NULL;
+Vector* mean = NULL;
+if(m == NULL) return NULL;
+r = rows_matrix(m);
+c = columns_matrix(m);
+/* compute the mean of each column */
+mean = create_vector(c);
+for(i = 0; i < r; i++)
+{
+	for(j = 0; j < c; j++) mean->_data[j] += m->_data[(size_t)i*c+j];
+}
+for(j = 0; j < c; j++) mean->_data[j] /= (double)r;
+svd = randomized_svd_core(m, mean->_data, k, oversampling, power_iterations, rng, 0);
+if(svd == NULL)
+{
+destroy_vector(mean);
+return NULL;
+}
+/* build PCA */
+pca = (PCA*)ALLOCATE(sizeof(PCA));
+pca_mean(pca) = mean;
+pca_components(pca) = svd_v(svd);
+pca_variance(pca) = create_vector(k);
+d = (r > 1) ? (double)(r-1) : 1.0;
+for(i = 0; i < k; i++)
+{
+	set_vector(pca_variance(pca), get_matrix(svd_sigma(svd), i, i) * get_matrix(svd_sigma(svd), i, i) / d, i);
+}
+
+/* release previously allocated memory, the components are now owned by the PCA */
+svd_v(svd) = NULL;
+destroy_svd(svd);
+
+return pca;
+}
+
+PCA* pca_row_reader(RowReader* r, int k, int oversampling, int power_iterations, Random* rng)
+{
+int i, j, n, c, l, rows, rank = 0;
+long long total = 0;
+double w;
+double* block_mean = NULL;
+double* p = NULL;
+Random state;
+Matrix stack;
+Matrix* block = NULL;
+Matrix* data = NULL;
+Vector* mean = NULL;
+SVD* svd = NULL;
+PCA* pca = NULL;
+if(r == NULL) return NULL;
+c = columns_row_reader(r);
+if(k < 1 || k > c) return NULL;
+if(oversampling < 0) oversampling = 0;
+/* rank of the summary kept between blocks */
+l = (k + oversampling < c) ? k + oversampling : c;
+if(rng == NULL)
+{
+	seed_random(&state, DEFAULT_SEED);
+	rng = &state;
+}
+block = create_matrix(block_rows_row_reader(r), c);
+data = create_matrix(l + rows_matrix(block) + 1, c);
+mean = create_vector(c);
+block_mean = (double*)ALLOCATE(c * sizeof(double));
+while((n = read_row_block(r, block)) > 0)
+{
+	for(j = 0; j < c; j++) block_mean[j] = 0.0;
+	for(i = 0; i < n; i++)
+	{
+		for(j = 0; j < c; j++) block_mean[j] += block->_data[(size_t)i*c+j];
+	}
+	for(j = 0; j < c; j++) block_mean[j] /= (double)n;
+	/* the summary of the previous rows, Sigma*V^t */
+	rows = 0;
+	for(j = 0; j < rank; j++, rows++)
+	{
+		p = data->_data + (size_t)rows*c;
+		for(i = 0; i < c; i++) p[i] = get_matrix(svd_sigma(svd), j, j) * svd_v(svd)->_data[(size_t)i*rank+j];
+	}
+	/* the block centered on its own mean */
+	for(i = 0; i < n; i++, rows++)
+	{
+		p = data->_data + (size_t)rows*c;
+		for(j = 0; j < c; j++) p[j] = block->_data[(size_t)i*c+j] - block_mean[j];
+	}
+	/* a row for the difference of the means, which moves the previous rows to the new mean */
+	if(total > 0)
+	{
+		p = data->_data + (size_t)rows*c;
+		w = sqrt((double)total * n / (double)(total + n));
+		for(j = 0; j < c; j++) p[j] = w * (mean->_data[j] - block_mean[j]);
+		rows++;
+	}
+	total += n;
+	for(j = 0; j < c; j++) mean->_data[j] += (block_mean[j] - mean->_data[j]) * n / (double)total;
+	/* the leading right singular vectors of the stacked rows summarize all the rows read so far */
+	stack._rows = rows;
+	stack._columns = c;
+	stack._data = data->_data;
+	rank = (rows < l) ? rows : l;
+	destroy_svd(svd);
+	svd = randomized_svd_core(&stack, NULL, rank, oversampling, power_iterations, rng, 0);
+	if(svd == NULL) break;
+}
+if(n == 0 && svd != NULL && rank >= k)
+{
+	pca = (PCA*)ALLOCATE(sizeof(PCA));
+	pca_mean(pca) = mean;
+	pca_components(pca) = create_matrix(c, k);
+	pca_variance(pca) = create_vector(k);
+	w = (total > 1) ? (double)(total-1) : 1.0;
+	for(j = 0; j < k; j++)
+	{
+		for(i = 0; i < c; i++) pca_components(pca)->_data[(size_t)i*k+j] = svd_v(svd)->_data[(size_t)i*rank+j];
+		set_vector(pca_variance(pca), get_matrix(svd_sigma(svd), j, j) * get_matrix(svd_sigma(svd), j, j) / w, j);
+	}
+	mean = NULL;
+}
+
+/* release previously allocated memory */
+RELEASE(block_mean);
+destroy_matrix(block);
+destroy_matrix(data);
+destroy_vector(mean);
+destroy_svd(svd);
+
+return pca;
+}
+
+Matrix* pca_transform(const PCA* pca, const Matrix* m)
+{
+int i, j, c, k;
+double s;
+Matrix* out = NULL;
+if(pca == NULL || m == NULL) return NULL;
+c = rows_matrix(pca_components(pca));
+k = columns_matrix(pca_components(pca));
+if(columns_matrix(m) != c) return NULL;
+out = create_matrix(rows_matrix(m), k);
+gemm_matrix(1.0, m, 0, pca_components(pca), 0, 0.0, out);
+/* subtract the projection of the mean */
+for(j = 0; j < k; j++)
+{
+	s = 0.0;
+	for(i = 0; i < c; i++) s += pca_mean(pca)->_data[i] * pca_components(pca)->_data[(size_t)i*k+j];
+	for(i = 0; i < rows_matrix(out); i++) out->_data[(size_t)i*k+j] -= s;
+}
+return out;
+}
+
 /* END */
 
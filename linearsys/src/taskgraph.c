@@ -0,0 +1,1144 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "taskgraph.h"
+#include "allocator.h"
+#include "numa.h"
+#include "kernel.h"
+#include "tuning.h"
+#include "instrument.h"
+#include "trace.h"
+
+/* smallest pivot accepted by the LU decomposition, as in lu.c */
+static const double __threshold_ = 1E-6;
+
+/*
+* Task type definition.
+*/
+typedef struct
+{
+KernelFunction _kernel;
+void* _arguments;
+int _critical;
+int _pending; /* tasks which must finish before this one runs */
+int _row; /* first row of the data written, -1 if not given */
+int _rows;
+int* _successors;
+int _successor_count;
+int _successor_capacity;
+}Task;
+
+/*
+* Tile type definition: the last tasks using a tile while the graph is built.
+*/
+typedef struct
+{
+int _writer; /* last task writing the tile, -1 if none */
+int* _readers; /* tasks reading the tile since its last writer */
+int _reader_count;
+int _reader_capacity;
+}Tile;
+
+/*
+* Queue type definition: the ready tasks of a thread.
+* Its thread takes the last one added and the other threads steal the first one.
+*/
+typedef struct
+{
+pthread_mutex_t _lock;
+int* _tasks;
+int _top; /* next task to steal */
+int _bottom; /* next free slot */
+}Queue;
+
+/*
+* TaskGraph type definition.
+*/
+struct TaskGraph
+{
+Task* _tasks;
+int _count;
+int _capacity;
+Tile* _tiles;
+int _tile_count;
+int _run; /* the graph was run */
+/* fields used while the graph runs */
+Queue* _queues;
+int _queue_count;
+int _affine; /* the tasks go to the thread owning their rows */
+pthread_mutex_t _lock; /* protects the heap and the sleeping threads */
+pthread_cond_t _wake; /* signaled when a task is ready or the graph is done */
+int* _heap; /* critical ready tasks, the first one added on top */
+int _heap_count;
+int _queued; /* ready tasks in the queues and the heap */
+int _finished; /* tasks done */
+int _sleeping; /* threads waiting for a ready task */
+};
+
+/*
+* TileContext type definition: the matrices factorized by the tasks of a tile algorithm.
+*/
+typedef struct
+{
+double* _a; /* n x n matrix factorized in place */
+double* _q; /* Q^t built by the QR factorization */
+double* _tau; /* scalars of the Householder reflections, tile elements per tile */
+int* _pivot; /* row swapped with each row by the LU decomposition */
+int* _permutation;
+int _n;
+int _tile;
+int _tiles; /* tiles per row and column */
+int _failed; /* set by a task when the matrix is singular or not positive definite */
+}TileContext;
+
+/*
+* TileTask type definition: the arguments of a tile kernel, tile ( m, j ) at step k.
+*/
+typedef struct
+{
+TileContext* _context;
+int _k;
+int _m;
+int _j;
+int _q; /* 1 when the kernel updates Q^t instead of the matrix */
+}TileTask;
+
+/*
+* Helper functions.
+*/
+
+/*
+* Grows an array of ints to hold at least needed elements.
+*/
+static void __grow_(int** a, int* capacity, int needed)
+{
+int size;
+if(needed <= *capacity) return;
+size = (*capacity > 0) ? 2 * *capacity : 4;
+if(size < needed) size = needed;
+*a = (int*)REALLOCATE(*a, *capacity * sizeof(int), size * sizeof(int));
+*capacity = size;
+}
+
+/*
+* Makes task to wait for task from.
+*/
+static void __depend_(TaskGraph* g, int from, int to)
+{
+Task* t = &g->_tasks[from];
+if(from == to) return;
+if(t->_successor_count > 0 && t->_successors[t->_successor_count-1] == to) return;
+__grow_(&t->_successors, &t->_successor_capacity, t->_successor_count+1);
+t->_successors[t->_successor_count++] = to;
+g->_tasks[to]._pending++;
+}
+
+/*
+* Adds a critical ready task to the heap, the one added first is on top; g->_lock must be held.
+*/
+static void __push_heap_(TaskGraph* g, int t)
+{
+int i = g->_heap_count;
+int parent;
+__atomic_store_n(&g->_heap_count, i+1, __ATOMIC_SEQ_CST); /* read with no lock by __take_ */
+while(i > 0)
+{
+	parent = (i-1) / 2;
+	if(g->_heap[parent] <= t) break;
+	g->_heap[i] = g->_heap[parent];
+	i = parent;
+}
+g->_heap[i] = t;
+}
+
+/*
+* Takes the task on top of the heap; g->_lock must be held and the heap must not be empty.
+*/
+static int __pop_heap_(TaskGraph* g)
+{
+int top = g->_heap[0];
+int last = g->_heap[g->_heap_count-1];
+int i = 0;
+int child;
+__atomic_store_n(&g->_heap_count, g->_heap_count-1, __ATOMIC_SEQ_CST);
+while(1)
+{
+	child = 2*i+1;
+	if(child >= g->_heap_count) break;
+	if(child+1 < g->_heap_count && g->_heap[child+1] < g->_heap[child]) child++;
+	if(last <= g->_heap[child]) break;
+	g->_heap[i] = g->_heap[child];
+	i = child;
+}
+g->_heap[i] = last;
+return top;
+}
+
+/*
+* Gets the queue of a task which is not critical: the one of the thread owning its rows,
+* or the one of the thread which made it ready.
+*/
+static int __queue_(const TaskGraph* g, int t, int worker)
+{
+const Task* task = &g->_tasks[t];
+if(g->_affine && task->_row >= 0) return owner_numa(task->_row, task->_rows, g->_queue_count);
+return worker;
+}
+
+/*
+* Makes a task ready to run, in the heap if it is critical or in the queue of __queue_.
+*/
+static void __ready_(TaskGraph* g, int t, int worker)
+{
+Queue* q = &g->_queues[__queue_(g, t, worker)];
+if(g->_tasks[t]._critical)
+{
+	pthread_mutex_lock(&g->_lock);
+	__push_heap_(g, t);
+	pthread_mutex_unlock(&g->_lock);
+}
+else
+{
+	pthread_mutex_lock(&q->_lock);
+	q->_tasks[q->_bottom++] = t;
+	pthread_mutex_unlock(&q->_lock);
+}
+__atomic_add_fetch(&g->_queued, 1, __ATOMIC_SEQ_CST);
+if(__atomic_load_n(&g->_sleeping, __ATOMIC_SEQ_CST) > 0)
+{
+	pthread_mutex_lock(&g->_lock);
+	pthread_cond_broadcast(&g->_wake);
+	pthread_mutex_unlock(&g->_lock);
+}
+}
+
+/*
+* Takes a ready task: a critical one, else the last one of the own queue, else the first one of another queue.
+* Returns -1 if there is none.
+*/
+static int __take_(TaskGraph* g, int worker)
+{
+int i, t = -1;
+Queue* q = NULL;
+if(__atomic_load_n(&g->_heap_count, __ATOMIC_SEQ_CST) > 0)
+{
+	pthread_mutex_lock(&g->_lock);
+	if(g->_heap_count > 0) t = __pop_heap_(g);
+	pthread_mutex_unlock(&g->_lock);
+}
+for(i = 0; t < 0 && i < g->_queue_count; i++)
+{
+	q = &g->_queues[(worker+i) % g->_queue_count];
+	pthread_mutex_lock(&q->_lock);
+	if(q->_bottom > q->_top) t = (i == 0) ? q->_tasks[--q->_bottom] : q->_tasks[q->_top++];
+	if(q->_bottom == q->_top) q->_bottom = q->_top = 0;
+	pthread_mutex_unlock(&q->_lock);
+}
+if(t >= 0) __atomic_sub_fetch(&g->_queued, 1, __ATOMIC_SEQ_CST);
+return t;
+}
+
+/*
+* Runs a task and makes ready the tasks which were only waiting for it.
+*/
+static void __execute_(TaskGraph* g, int t, int worker)
+{
+int i, s;
+Task* task = &g->_tasks[t];
+task->_kernel(task->_arguments);
+for(i = 0; i < task->_successor_count; i++)
+{
+	s = task->_successors[i];
+	if(__atomic_sub_fetch(&g->_tasks[s]._pending, 1, __ATOMIC_ACQ_REL) == 0) __ready_(g, s, worker);
+}
+if(__atomic_add_fetch(&g->_finished, 1, __ATOMIC_SEQ_CST) == g->_count)
+{
+	pthread_mutex_lock(&g->_lock);
+	pthread_cond_broadcast(&g->_wake);
+	pthread_mutex_unlock(&g->_lock);
+}
+}
+
+/*
+* Body of each thread running a graph: it runs ready tasks until all of them are done.
+*/
+static void __worker_(int index, void* context)
+{
+TaskGraph* g = (TaskGraph*)context;
+int t;
+while(1)
+{
+	t = __take_(g, index);
+	if(t >= 0)
+	{
+		__execute_(g, t, index);
+		continue;
+	}
+	if(__atomic_load_n(&g->_finished, __ATOMIC_SEQ_CST) == g->_count) break;
+	pthread_mutex_lock(&g->_lock);
+	__atomic_add_fetch(&g->_sleeping, 1, __ATOMIC_SEQ_CST);
+	while(__atomic_load_n(&g->_queued, __ATOMIC_SEQ_CST) == 0 && __atomic_load_n(&g->_finished, __ATOMIC_SEQ_CST) < g->_count)
+	{
+		pthread_cond_wait(&g->_wake, &g->_lock);
+	}
+	__atomic_sub_fetch(&g->_sleeping, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&g->_lock);
+}
+}
+
+/*
+* Gets the order of the tile row or column i.
+*/
+static int __order_(const TileContext* c, int i)
+{
+return (i == c->_tiles-1) ? c->_n - i*c->_tile : c->_tile;
+}
+
+/*
+* Gets the first element of tile ( i, j ) of an n x n array.
+*/
+static double* __tile_(const TileContext* c, double* a, int i, int j)
+{
+return a + (size_t)i*c->_tile*c->_n + (size_t)j*c->_tile;
+}
+
+static int __failed_(TileContext* c)
+{
+return __atomic_load_n(&c->_failed, __ATOMIC_ACQUIRE);
+}
+
+/*
+* Adds a tile task using count tiles, writing the tiles of tile row m.
+*/
+static void __insert_(TaskGraph* g, KernelFunction kernel, TileContext* c, int k, int m, int j, int q, int critical, int count, const int* tiles, const int* access)
+{
+int t;
+TileTask task;
+task._context = c;
+task._k = k;
+task._m = m;
+task._j = j;
+task._q = q;
+t = insert_task_graph(g, kernel, &task, sizeof(TileTask), critical, count, tiles, access);
+affinity_task_graph(g, t, m*c->_tile, c->_n);
+}
+
+/*
+* LU panel: factorizes tile column k with partial pivoting, swapping the rows of that column only.
+*/
+static void __lu_panel_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* a = c->_a;
+int n = c->_n;
+int c0 = t->_k * c->_tile;
+int c1 = c0 + __order_(c, t->_k);
+int i, j, r, row;
+double pivot, tmp, l;
+if(__failed_(c)) return;
+TRACE_BEGIN;
+for(i = c0; i < c1; i++)
+{
+	pivot = fabs(a[(size_t)i*n+i]);
+	row = i;
+	for(r = i+1; r < n; r++)
+	{
+		if(fabs(a[(size_t)r*n+i]) > pivot)
+		{
+			pivot = fabs(a[(size_t)r*n+i]);
+			row = r;
+		}
+	}
+	if(pivot < __threshold_)
+	{
+		__atomic_store_n(&c->_failed, 1, __ATOMIC_RELEASE);
+		break;
+	}
+	c->_pivot[i] = row;
+	if(row != i)
+	{
+		for(j = c0; j < c1; j++)
+		{
+			tmp = a[(size_t)i*n+j];
+			a[(size_t)i*n+j] = a[(size_t)row*n+j];
+			a[(size_t)row*n+j] = tmp;
+		}
+		r = c->_permutation[i];
+		c->_permutation[i] = c->_permutation[row];
+		c->_permutation[row] = r;
+	}
+	for(r = i+1; r < n; r++)
+	{
+		l = a[(size_t)r*n+i] / a[(size_t)i*n+i];
+		a[(size_t)r*n+i] = l;
+		for(j = i+1; j < c1; j++) a[(size_t)r*n+j] -= l * a[(size_t)i*n+j];
+	}
+}
+TRACE_END("dag_lu_panel", t->_k, t->_k);
+}
+
+/*
+* LU row: applies the row swaps of panel k to tile column j and, on the right of the panel,
+* solves its tile of U: U_kj = L_kk^-1 * A_kj.
+*/
+static void __lu_row_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* a = c->_a;
+int n = c->_n;
+int c0 = t->_k * c->_tile;
+int c1 = c0 + __order_(c, t->_k);
+int j0 = t->_j * c->_tile;
+int j1 = j0 + __order_(c, t->_j);
+int i, j, r;
+double tmp, l;
+if(__failed_(c)) return;
+TRACE_BEGIN;
+for(i = c0; i < c1; i++)
+{
+	r = c->_pivot[i];
+	if(r == i) continue;
+	for(j = j0; j < j1; j++)
+	{
+		tmp = a[(size_t)i*n+j];
+		a[(size_t)i*n+j] = a[(size_t)r*n+j];
+		a[(size_t)r*n+j] = tmp;
+	}
+}
+if(t->_j > t->_k)
+{
+	for(i = c0; i < c1; i++)
+	{
+		for(r = i+1; r < c1; r++)
+		{
+			l = a[(size_t)r*n+i];
+			if(l == 0.0) continue;
+			for(j = j0; j < j1; j++) a[(size_t)r*n+j] -= l * a[(size_t)i*n+j];
+		}
+	}
+}
+TRACE_END("dag_lu_row", t->_k, t->_j);
+}
+
+/*
+* LU update: A_mj = A_mj - L_mk * U_kj.
+*/
+static void __lu_update_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+if(__failed_(c)) return;
+TRACE_BEGIN;
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, __order_(c, t->_m), __order_(c, t->_j), __order_(c, t->_k), -1.0,
+__tile_(c, c->_a, t->_m, t->_k), c->_n, __tile_(c, c->_a, t->_k, t->_j), c->_n, 1.0, __tile_(c, c->_a, t->_m, t->_j), c->_n);
+TRACE_END("dag_lu_update", t->_m, t->_j);
+}
+
+/*
+* Cholesky of the diagonal tile k: A_kk = L_kk * L_kk^t.
+*/
+static void __potrf_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* a = NULL;
+int n = c->_n;
+int kb = __order_(c, t->_k);
+int i, j, p;
+double d;
+if(__failed_(c)) return;
+TRACE_BEGIN;
+a = __tile_(c, c->_a, t->_k, t->_k);
+for(j = 0; j < kb; j++)
+{
+	d = a[(size_t)j*n+j];
+	for(p = 0; p < j; p++) d -= a[(size_t)j*n+p] * a[(size_t)j*n+p];
+	if(d <= 0.0)
+	{
+		__atomic_store_n(&c->_failed, 1, __ATOMIC_RELEASE);
+		break;
+	}
+	d = sqrt(d);
+	a[(size_t)j*n+j] = d;
+	for(i = j+1; i < kb; i++)
+	{
+		for(p = 0; p < j; p++) a[(size_t)i*n+j] -= a[(size_t)i*n+p] * a[(size_t)j*n+p];
+		a[(size_t)i*n+j] /= d;
+	}
+}
+TRACE_END("dag_potrf", t->_k, t->_k);
+}
+
+/*
+* Cholesky panel: L_mk = A_mk * L_kk^-t.
+*/
+static void __trsm_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* l = NULL;
+double* a = NULL;
+int n = c->_n;
+int kb = __order_(c, t->_k);
+int mb = __order_(c, t->_m);
+int i, j, p;
+if(__failed_(c)) return;
+TRACE_BEGIN;
+l = __tile_(c, c->_a, t->_k, t->_k);
+a = __tile_(c, c->_a, t->_m, t->_k);
+for(i = 0; i < mb; i++)
+{
+	for(j = 0; j < kb; j++)
+	{
+		for(p = 0; p < j; p++) a[(size_t)i*n+j] -= a[(size_t)i*n+p] * l[(size_t)j*n+p];
+		a[(size_t)i*n+j] /= l[(size_t)j*n+j];
+	}
+}
+TRACE_END("dag_trsm", t->_m, t->_k);
+}
+
+/*
+* Cholesky update: A_mj = A_mj - L_mk * L_jk^t ( a diagonal tile when m == j ).
+*/
+static void __cholesky_update_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+if(__failed_(c)) return;
+TRACE_BEGIN;
+kernel_gemm(KERNEL_NO_TRANS, KERNEL_TRANS, __order_(c, t->_m), __order_(c, t->_j), __order_(c, t->_k), -1.0,
+__tile_(c, c->_a, t->_m, t->_k), c->_n, __tile_(c, c->_a, t->_j, t->_k), c->_n, 1.0, __tile_(c, c->_a, t->_m, t->_j), c->_n);
+TRACE_END((t->_m == t->_j) ? "dag_syrk" : "dag_gemm", t->_m, t->_j);
+}
+
+/*
+* Builds a Householder reflection H = I - tau*v*v^t with H*[alpha; x] = [beta; 0],
+* given alpha and the squared norm of x; v is [1; x/scale] and the function returns beta.
+*/
+static double __reflection_(double alpha, double sigma, double* tau, double* scale)
+{
+double beta;
+if(sigma == 0.0)
+{
+	*tau = 0.0;
+	*scale = 1.0;
+	return alpha;
+}
+beta = sqrt(alpha*alpha + sigma);
+if(alpha > 0.0) beta = -beta;
+*tau = (beta - alpha) / beta;
+*scale = alpha - beta;
+return beta;
+}
+
+/*
+* QR of the diagonal tile k: R_kk and the reflections below its diagonal.
+*/
+static void __geqrt_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* a = NULL;
+double* tau = NULL;
+int n = c->_n;
+int kb = __order_(c, t->_k);
+int i, j, p;
+double sigma, scale, w;
+TRACE_BEGIN;
+a = __tile_(c, c->_a, t->_k, t->_k);
+tau = c->_tau + ((size_t)t->_k*c->_tiles + t->_k) * c->_tile;
+for(p = 0; p < kb; p++)
+{
+	sigma = 0.0;
+	for(i = p+1; i < kb; i++) sigma += a[(size_t)i*n+p] * a[(size_t)i*n+p];
+	a[(size_t)p*n+p] = __reflection_(a[(size_t)p*n+p], sigma, &tau[p], &scale);
+	for(i = p+1; i < kb; i++) a[(size_t)i*n+p] /= scale;
+	if(tau[p] == 0.0) continue;
+	for(j = p+1; j < kb; j++)
+	{
+		w = a[(size_t)p*n+j];
+		for(i = p+1; i < kb; i++) w += a[(size_t)i*n+p] * a[(size_t)i*n+j];
+		w *= tau[p];
+		a[(size_t)p*n+j] -= w;
+		for(i = p+1; i < kb; i++) a[(size_t)i*n+j] -= w * a[(size_t)i*n+p];
+	}
+}
+TRACE_END("dag_geqrt", t->_k, t->_k);
+}
+
+/*
+* Applies the reflections of the diagonal tile k to tile ( k, j ) of the matrix or of Q^t.
+*/
+static void __unmqr_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* v = NULL;
+double* b = NULL;
+double* tau = NULL;
+int n = c->_n;
+int kb = __order_(c, t->_k);
+int jb = __order_(c, t->_j);
+int i, j, p;
+double w;
+TRACE_BEGIN;
+v = __tile_(c, c->_a, t->_k, t->_k);
+b = __tile_(c, (t->_q) ? c->_q : c->_a, t->_k, t->_j);
+tau = c->_tau + ((size_t)t->_k*c->_tiles + t->_k) * c->_tile;
+for(p = 0; p < kb; p++)
+{
+	if(tau[p] == 0.0) continue;
+	for(j = 0; j < jb; j++)
+	{
+		w = b[(size_t)p*n+j];
+		for(i = p+1; i < kb; i++) w += v[(size_t)i*n+p] * b[(size_t)i*n+j];
+		w *= tau[p];
+		b[(size_t)p*n+j] -= w;
+		for(i = p+1; i < kb; i++) b[(size_t)i*n+j] -= w * v[(size_t)i*n+p];
+	}
+}
+TRACE_END("dag_unmqr", t->_k, t->_j);
+}
+
+/*
+* Annihilates tile ( m, k ) against R_kk, leaving the reflections in it.
+*/
+static void __tsqrt_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* r = NULL;
+double* a = NULL;
+double* tau = NULL;
+int n = c->_n;
+int kb = __order_(c, t->_k);
+int mb = __order_(c, t->_m);
+int i, j, p;
+double sigma, scale, w;
+TRACE_BEGIN;
+r = __tile_(c, c->_a, t->_k, t->_k);
+a = __tile_(c, c->_a, t->_m, t->_k);
+tau = c->_tau + ((size_t)t->_m*c->_tiles + t->_k) * c->_tile;
+for(p = 0; p < kb; p++)
+{
+	sigma = 0.0;
+	for(i = 0; i < mb; i++) sigma += a[(size_t)i*n+p] * a[(size_t)i*n+p];
+	r[(size_t)p*n+p] = __reflection_(r[(size_t)p*n+p], sigma, &tau[p], &scale);
+	for(i = 0; i < mb; i++) a[(size_t)i*n+p] /= scale;
+	if(tau[p] == 0.0) continue;
+	for(j = p+1; j < kb; j++)
+	{
+		w = r[(size_t)p*n+j];
+		for(i = 0; i < mb; i++) w += a[(size_t)i*n+p] * a[(size_t)i*n+j];
+		w *= tau[p];
+		r[(size_t)p*n+j] -= w;
+		for(i = 0; i < mb; i++) a[(size_t)i*n+j] -= w * a[(size_t)i*n+p];
+	}
+}
+TRACE_END("dag_tsqrt", t->_m, t->_k);
+}
+
+/*
+* Applies the reflections of tile ( m, k ) to tiles ( k, j ) and ( m, j ) of the matrix or of Q^t.
+*/
+static void __tsmqr_(void* arguments)
+{
+TileTask* t = (TileTask*)arguments;
+TileContext* c = t->_context;
+double* target = (t->_q) ? c->_q : c->_a;
+double* v = NULL;
+double* top = NULL;
+double* b = NULL;
+double* tau = NULL;
+int n = c->_n;
+int kb = __order_(c, t->_k);
+int mb = __order_(c, t->_m);
+int jb = __order_(c, t->_j);
+int i, j, p;
+double w;
+TRACE_BEGIN;
+v = __tile_(c, c->_a, t->_m, t->_k);
+top = __tile_(c, target, t->_k, t->_j);
+b = __tile_(c, target, t->_m, t->_j);
+tau = c->_tau + ((size_t)t->_m*c->_tiles + t->_k) * c->_tile;
+for(p = 0; p < kb; p++)
+{
+	if(tau[p] == 0.0) continue;
+	for(j = 0; j < jb; j++)
+	{
+		w = top[(size_t)p*n+j];
+		for(i = 0; i < mb; i++) w += v[(size_t)i*n+p] * b[(size_t)i*n+j];
+		w *= tau[p];
+		top[(size_t)p*n+j] -= w;
+		for(i = 0; i < mb; i++) b[(size_t)i*n+j] -= w * v[(size_t)i*n+p];
+	}
+}
+TRACE_END("dag_tsmqr", t->_m, t->_j);
+}
+
+/*
+* Fills a TileContext for an n x n array.
+*/
+static void __context_(TileContext* c, double* a, int n, int tile)
+{
+memset(c, 0, sizeof(TileContext));
+if(tile <= 0) tile = get_tuning()->_lu_block;
+if(tile > n) tile = n;
+c->_a = a;
+c->_n = n;
+c->_tile = tile;
+c->_tiles = (n + tile - 1) / tile;
+}
+
+static int __lookahead_(int lookahead)
+{
+return (lookahead <= 0) ? DEFAULT_LOOKAHEAD : lookahead;
+}
+
+/* end helper functions */
+
+/* implementation */
+
+TaskGraph* create_task_graph(int tiles)
+{
+int i;
+TaskGraph* g = NULL;
+if(tiles < 1) return NULL;
+g = (TaskGraph*)ALLOCATE(sizeof(TaskGraph));
+memset(g, 0, sizeof(TaskGraph));
+g->_tiles = (Tile*)ALLOCATE(tiles * sizeof(Tile));
+g->_tile_count = tiles;
+for(i = 0; i < tiles; i++)
+{
+	g->_tiles[i]._writer = -1;
+	g->_tiles[i]._readers = NULL;
+	g->_tiles[i]._reader_count = 0;
+	g->_tiles[i]._reader_capacity = 0;
+}
+return g;
+}
+
+void destroy_task_graph(TaskGraph* g)
+{
+int i;
+if(g == NULL) return;
+/* release previously allocated memory */
+for(i = 0; i < g->_count; i++)
+{
+	if(g->_tasks[i]._arguments != NULL) RELEASE(g->_tasks[i]._arguments);
+	if(g->_tasks[i]._successors != NULL) RELEASE(g->_tasks[i]._successors);
+}
+for(i = 0; i < g->_tile_count; i++)
+{
+	if(g->_tiles[i]._readers != NULL) RELEASE(g->_tiles[i]._readers);
+}
+if(g->_tasks != NULL) RELEASE(g->_tasks);
+RELEASE(g->_tiles);
+RELEASE(g);
+g = NULL;
+}
+
+int insert_task_graph(TaskGraph* g, KernelFunction kernel, const void* arguments, size_t size, int critical, int count, const int* tiles, const int* access)
+{
+int i, r, t;
+Task* task = NULL;
+Tile* tile = NULL;
+if(g == NULL || kernel == NULL || g->_run || count < 0) return -1;
+for(i = 0; i < count; i++)
+{
+	if(tiles[i] < 0 || tiles[i] >= g->_tile_count) return -1;
+	if(access[i] < ACCESS_READ || access[i] > ACCESS_READWRITE) return -1;
+}
+if(g->_count == g->_capacity)
+{
+	i = (g->_capacity > 0) ? 2*g->_capacity : 64;
+	g->_tasks = (Task*)REALLOCATE(g->_tasks, g->_capacity * sizeof(Task), i * sizeof(Task));
+	g->_capacity = i;
+}
+t = g->_count;
+task = &g->_tasks[t];
+task->_kernel = kernel;
+task->_arguments = NULL;
+if(size > 0)
+{
+	task->_arguments = ALLOCATE(size);
+	memcpy(task->_arguments, arguments, size);
+}
+task->_critical = critical;
+task->_pending = 0;
+task->_row = -1;
+task->_rows = 0;
+task->_successors = NULL;
+task->_successor_count = 0;
+task->_successor_capacity = 0;
+for(i = 0; i < count; i++)
+{
+	tile = &g->_tiles[tiles[i]];
+	if(access[i] & ACCESS_WRITE)
+	{
+		/* wait for the readers since the last writer, or for the last writer if there are none */
+		if(tile->_reader_count > 0)
+		{
+			for(r = 0; r < tile->_reader_count; r++) __depend_(g, tile->_readers[r], t);
+			tile->_reader_count = 0;
+		}
+		else if(tile->_writer >= 0) __depend_(g, tile->_writer, t);
+		tile->_writer = t;
+	}
+	else
+	{
+		if(tile->_writer >= 0) __depend_(g, tile->_writer, t);
+		__grow_(&tile->_readers, &tile->_reader_capacity, tile->_reader_count+1);
+		tile->_readers[tile->_reader_count++] = t;
+	}
+}
+g->_count++;
+return t;
+}
+
+void affinity_task_graph(TaskGraph* g, int task, int row, int rows)
+{
+if(g == NULL || task < 0 || task >= g->_count || row < 0 || row >= rows) return;
+g->_tasks[task]._row = row;
+g->_tasks[task]._rows = rows;
+}
+
+int run_task_graph(TaskGraph* g, ThreadPool* pool)
+{
+int i, q, next = 0;
+if(g == NULL || g->_run) return 0;
+g->_run = 1;
+if(g->_count == 0) return 1;
+g->_queue_count = threads_threadpool(pool);
+/* with interleaved pages no thread is closer to the data, so the tasks stay where they were made ready */
+g->_affine = (nodes_numa() > 1 && get_numa_policy() == NUMA_FIRST_TOUCH);
+g->_queues = (Queue*)ALLOCATE(g->_queue_count * sizeof(Queue));
+for(i = 0; i < g->_queue_count; i++)
+{
+	pthread_mutex_init(&g->_queues[i]._lock, NULL);
+	g->_queues[i]._tasks = (int*)ALLOCATE(g->_count * sizeof(int));
+	g->_queues[i]._top = 0;
+	g->_queues[i]._bottom = 0;
+}
+pthread_mutex_init(&g->_lock, NULL);
+pthread_cond_init(&g->_wake, NULL);
+g->_heap = (int*)ALLOCATE(g->_count * sizeof(int));
+g->_heap_count = 0;
+g->_queued = 0;
+g->_finished = 0;
+g->_sleeping = 0;
+/* the tasks with no dependencies are ready, the ones which are not critical are dealt among the threads */
+for(i = 0; i < g->_count; i++)
+{
+	if(g->_tasks[i]._pending > 0) continue;
+	if(g->_tasks[i]._critical) __push_heap_(g, i);
+	else
+	{
+		q = __queue_(g, i, next);
+		g->_queues[q]._tasks[g->_queues[q]._bottom++] = i;
+		next = (next+1) % g->_queue_count;
+	}
+	g->_queued++;
+}
+/* each thread keeps its queue, so the tasks of its rows stay in it */
+parallel_threads(pool, __worker_, g);
+/* release previously allocated memory */
+for(i = 0; i < g->_queue_count; i++)
+{
+	pthread_mutex_destroy(&g->_queues[i]._lock);
+	RELEASE(g->_queues[i]._tasks);
+}
+RELEASE(g->_queues);
+RELEASE(g->_heap);
+g->_queues = NULL;
+g->_heap = NULL;
+pthread_mutex_destroy(&g->_lock);
+pthread_cond_destroy(&g->_wake);
+return 1;
+}
+
+int size_task_graph(const TaskGraph* g)
+{
+return (g == NULL) ? 0 : g->_count;
+}
+
+LU* lu_task_graph(const Matrix* m, int tile, int lookahead, ThreadPool* pool)
+{
+int i, j, k, r, n, nt, count;
+int* tiles = NULL;
+int* access = NULL;
+TileContext c;
+TaskGraph* g = NULL;
+LU* lu = NULL;
+if(m == NULL || rows_matrix(m) != columns_matrix(m)) return NULL;
+INSTRUMENT_BEGIN;
+n = rows_matrix(m);
+lookahead = __lookahead_(lookahead);
+lu = (LU*)ALLOCATE(sizeof(LU));
+lu->_upper = clone_matrix(m);
+lu->_lower = identity_matrix(n);
+lu->_permutation = (int*)ALLOCATE(n * sizeof(int));
+for(i = 0; i < n; i++) lu->_permutation[i] = i;
+__context_(&c, lu->_upper->_data, n, tile);
+c._pivot = (int*)ALLOCATE(n * sizeof(int));
+c._permutation = lu->_permutation;
+nt = c._tiles;
+tiles = (int*)ALLOCATE((nt+1) * sizeof(int));
+access = (int*)ALLOCATE((nt+1) * sizeof(int));
+g = create_task_graph(nt*nt);
+for(k = 0; k < nt; k++)
+{
+	/* the panel writes its whole tile column */
+	for(r = k; r < nt; r++)
+	{
+		tiles[r-k] = r*nt+k;
+		access[r-k] = ACCESS_READWRITE;
+	}
+	__insert_(g, __lu_panel_, &c, k, k, k, 0, 1, nt-k, tiles, access);
+	/* each tile column swaps its rows below the panel, the ones on the right solve their tile of U */
+	for(j = 0; j < nt; j++)
+	{
+		if(j == k) continue;
+		count = 0;
+		tiles[count] = k*nt+k;
+		access[count++] = ACCESS_READ;
+		for(r = k; r < nt; r++)
+		{
+			tiles[count] = r*nt+j;
+			access[count++] = ACCESS_READWRITE;
+		}
+		__insert_(g, __lu_row_, &c, k, k, j, 0, (j > k && j <= k+lookahead), count, tiles, access);
+	}
+	/* trailing updates, the next tile columns first */
+	for(j = k+1; j < nt; j++)
+	{
+		for(i = k+1; i < nt; i++)
+		{
+			tiles[0] = i*nt+k;
+			access[0] = ACCESS_READ;
+			tiles[1] = k*nt+j;
+			access[1] = ACCESS_READ;
+			tiles[2] = i*nt+j;
+			access[2] = ACCESS_READWRITE;
+			__insert_(g, __lu_update_, &c, k, i, j, 0, (j <= k+lookahead), 3, tiles, access);
+		}
+	}
+}
+run_task_graph(g, pool);
+/* release previously allocated memory */
+destroy_task_graph(g);
+RELEASE(tiles);
+RELEASE(access);
+RELEASE(c._pivot);
+if(c._failed)
+{
+	destroy_lu(lu);
+	INSTRUMENT_END(INSTRUMENT_LU_TASK_GRAPH, 0.0);
+	return NULL;
+}
+/* move the multipliers to lower */
+for(i = 1; i < n; i++)
+{
+	for(j = 0; j < i; j++)
+	{
+		lu->_lower->_data[(size_t)i*n+j] = lu->_upper->_data[(size_t)i*n+j];
+		lu->_upper->_data[(size_t)i*n+j] = 0.0;
+	}
+}
+INSTRUMENT_END(INSTRUMENT_LU_TASK_GRAPH, 2.0/3.0*n*n*n);
+return lu;
+}
+
+Matrix* cholesky_task_graph(const Matrix* m, int tile, int lookahead, ThreadPool* pool)
+{
+int i, j, k, n, nt, count;
+int tiles[3];
+int access[3];
+TileContext c;
+TaskGraph* g = NULL;
+Matrix* l = NULL;
+if(m == NULL || rows_matrix(m) != columns_matrix(m)) return NULL;
+INSTRUMENT_BEGIN;
+n = rows_matrix(m);
+lookahead = __lookahead_(lookahead);
+l = clone_matrix(m);
+__context_(&c, l->_data, n, tile);
+nt = c._tiles;
+g = create_task_graph(nt*nt);
+for(k = 0; k < nt; k++)
+{
+	tiles[0] = k*nt+k;
+	access[0] = ACCESS_READWRITE;
+	__insert_(g, __potrf_, &c, k, k, k, 0, 1, 1, tiles, access);
+	for(i = k+1; i < nt; i++)
+	{
+		tiles[0] = k*nt+k;
+		access[0] = ACCESS_READ;
+		tiles[1] = i*nt+k;
+		access[1] = ACCESS_READWRITE;
+		__insert_(g, __trsm_, &c, k, i, k, 0, 1, 2, tiles, access);
+	}
+	/* update the lower triangle of the trailing matrix, the next tile columns first */
+	for(j = k+1; j < nt; j++)
+	{
+		for(i = j; i < nt; i++)
+		{
+			count = 0;
+			tiles[count] = i*nt+k;
+			access[count++] = ACCESS_READ;
+			if(i != j)
+			{
+				tiles[count] = j*nt+k;
+				access[count++] = ACCESS_READ;
+			}
+			tiles[count] = i*nt+j;
+			access[count++] = ACCESS_READWRITE;
+			__insert_(g, __cholesky_update_, &c, k, i, j, 0, (j <= k+lookahead), count, tiles, access);
+		}
+	}
+}
+run_task_graph(g, pool);
+/* release previously allocated memory */
+destroy_task_graph(g);
+if(c._failed)
+{
+	destroy_matrix(l);
+	INSTRUMENT_END(INSTRUMENT_CHOLESKY_TASK_GRAPH, 0.0);
+	return NULL;
+}
+/* clear the upper triangle */
+for(i = 0; i < n; i++)
+{
+	for(j = i+1; j < n; j++) l->_data[(size_t)i*n+j] = 0.0;
+}
+INSTRUMENT_END(INSTRUMENT_CHOLESKY_TASK_GRAPH, 1.0/3.0*n*n*n);
+return l;
+}
+
+QR* qr_task_graph(const Matrix* m, int tile, int lookahead, ThreadPool* pool)
+{
+int i, j, k, n, nt;
+int tiles[4];
+int access[4];
+int vt, qt; /* first handles of the reflections of the diagonal tiles and of the tiles of Q^t */
+TileContext c;
+TaskGraph* g = NULL;
+Matrix* a = NULL;
+Matrix* q = NULL;
+QR* qr = NULL;
+if(m == NULL || rows_matrix(m) != columns_matrix(m)) return NULL;
+INSTRUMENT_BEGIN;
+n = rows_matrix(m);
+lookahead = __lookahead_(lookahead);
+a = clone_matrix(m);
+q = identity_matrix(n);
+__context_(&c, a->_data, n, tile);
+c._q = q->_data;
+nt = c._tiles;
+c._tau = (double*)ALLOCATE((size_t)nt*nt*c._tile * sizeof(double));
+/*
+* The reflections below the diagonal of a diagonal tile have their own handle,
+* so annihilating the tiles below it ( which changes R only ) does not wait for the tasks applying them.
+*/
+vt = nt*nt;
+qt = vt + nt;
+g = create_task_graph(qt + nt*nt);
+for(k = 0; k < nt; k++)
+{
+	tiles[0] = k*nt+k;
+	access[0] = ACCESS_READWRITE;
+	tiles[1] = vt+k;
+	access[1] = ACCESS_WRITE;
+	__insert_(g, __geqrt_, &c, k, k, k, 0, 1, 2, tiles, access);
+	for(j = k+1; j < nt; j++)
+	{
+		tiles[0] = vt+k;
+		access[0] = ACCESS_READ;
+		tiles[1] = k*nt+j;
+		access[1] = ACCESS_READWRITE;
+		__insert_(g, __unmqr_, &c, k, k, j, 0, (j <= k+lookahead), 2, tiles, access);
+	}
+	for(j = 0; j < nt; j++)
+	{
+		tiles[0] = vt+k;
+		access[0] = ACCESS_READ;
+		tiles[1] = qt+k*nt+j;
+		access[1] = ACCESS_READWRITE;
+		__insert_(g, __unmqr_, &c, k, k, j, 1, 0, 2, tiles, access);
+	}
+	for(i = k+1; i < nt; i++)
+	{
+		tiles[0] = k*nt+k;
+		access[0] = ACCESS_READWRITE;
+		tiles[1] = i*nt+k;
+		access[1] = ACCESS_READWRITE;
+		__insert_(g, __tsqrt_, &c, k, i, k, 0, 1, 2, tiles, access);
+		for(j = k+1; j < nt; j++)
+		{
+			tiles[0] = i*nt+k;
+			access[0] = ACCESS_READ;
+			tiles[1] = k*nt+j;
+			access[1] = ACCESS_READWRITE;
+			tiles[2] = i*nt+j;
+			access[2] = ACCESS_READWRITE;
+			__insert_(g, __tsmqr_, &c, k, i, j, 0, (j <= k+lookahead), 3, tiles, access);
+		}
+		for(j = 0; j < nt; j++)
+		{
+			tiles[0] = i*nt+k;
+			access[0] = ACCESS_READ;
+			tiles[1] = qt+k*nt+j;
+			access[1] = ACCESS_READWRITE;
+			tiles[2] = qt+i*nt+j;
+			access[2] = ACCESS_READWRITE;
+			__insert_(g, __tsmqr_, &c, k, i, j, 1, 0, 3, tiles, access);
+		}
+	}
+}
+run_task_graph(g, pool);
+/* release previously allocated memory */
+destroy_task_graph(g);
+RELEASE(c._tau);
+/* R is the upper triangle, Q the transpose of the product of the reflections */
+for(i = 1; i < n; i++)
+{
+	for(j = 0; j < i; j++) a->_data[(size_t)i*n+j] = 0.0;
+}
+qr = (QR*)ALLOCATE(sizeof(QR));
+qr_q(qr) = transpose_matrix(q);
+qr_r(qr) = a;
+destroy_matrix(q);
+INSTRUMENT_END(INSTRUMENT_QR_TASK_GRAPH, 4.0/3.0*n*n*n);
+return qr;
+}
+
+/* END */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity */
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* sysconf */
+#endif
+#endif
+
+#include <stdlib.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "threadpool.h"
+#include "numa.h"
+#include "allocator.h"
+
+#define MAX_THREADS 256
+
+/*
+* ThreadPool type definition.
+* A loop is published by setting task, context and count and increasing generation;
+* the workers take iterations from next until there are no more, or run their own index once if the loop is bound.
+*/
+struct ThreadPool
+{
+int _threads; /* workers + the calling thread */
+pthread_t* _workers;
+pthread_mutex_t _lock; /* protects the fields below */
+pthread_cond_t _wake; /* signaled when a loop is published or the pool stops */
+pthread_cond_t _finished; /* signaled when the last worker leaves a loop */
+pthread_mutex_t _busy; /* held while a loop runs */
+unsigned long _generation;
+int _stop;
+int _active; /* workers still inside the current loop */
+TaskFunction _task;
+void* _context;
+int _count;
+int _next; /* next iteration to run */
+int _bound; /* the loop runs once in each thread */
+int _started; /* workers which took their index */
+};
+
+/*
+* PinContext type definition: the processors for pin_threadpool.
+*/
+typedef struct
+{
+int* _cpus;
+int _count;
+int _pinned; /* threads pinned */
+}PinContext;
+
+static ThreadPool* __default_ = NULL;
+static pthread_once_t __default_once_ = PTHREAD_ONCE_INIT;
+
+/*
+* Helper functions.
+*/
+
+static int __processors_(void)
+{
+#ifdef _WIN32
+SYSTEM_INFO info;
+GetSystemInfo(&info);
+return (int)info.dwNumberOfProcessors;
+#else
+long n = sysconf(_SC_NPROCESSORS_ONLN);
+return (n > 0) ? (int)n : 1;
+#endif
+}
+
+/*
+* Runs iterations of the current loop until there are no more.
+*/
+static void __run_(ThreadPool* pool, TaskFunction task, void* context, int count)
+{
+int i;
+while(1)
+{
+	pthread_mutex_lock(&pool->_lock);
+	i = pool->_next++;
+	pthread_mutex_unlock(&pool->_lock);
+	if(i >= count) break;
+	task(i, context);
+}
+}
+
+static void* __worker_(void* arg)
+{
+ThreadPool* pool = (ThreadPool*)arg;
+unsigned long seen = 0;
+TaskFunction task;
+void* context;
+int count, bound, index;
+pthread_mutex_lock(&pool->_lock);
+index = ++pool->_started;
+pthread_mutex_unlock(&pool->_lock);
+while(1)
+{
+	pthread_mutex_lock(&pool->_lock);
+	while(pool->_generation == seen && !pool->_stop) pthread_cond_wait(&pool->_wake, &pool->_lock);
+	if(pool->_stop)
+	{
+		pthread_mutex_unlock(&pool->_lock);
+		break;
+	}
+	seen = pool->_generation;
+	task = pool->_task;
+	context = pool->_context;
+	count = pool->_count;
+	bound = pool->_bound;
+	pthread_mutex_unlock(&pool->_lock);
+	if(bound) task(index, context);
+	else __run_(pool, task, context, count);
+	pthread_mutex_lock(&pool->_lock);
+	if(--pool->_active == 0) pthread_cond_signal(&pool->_finished);
+	pthread_mutex_unlock(&pool->_lock);
+}
+return NULL;
+}
+
+static void __create_default_(void)
+{
+int threads = 0;
+const char* env = getenv("LINEARSYS_THREADS");
+if(env != NULL) threads = atoi(env);
+__default_ = create_threadpool(threads);
+if(__default_ == NULL) __default_ = create_threadpool(1);
+env = getenv("LINEARSYS_PIN");
+if(env != NULL && atoi(env) == 1) pin_threadpool(__default_);
+}
+
+/*
+* Pins the calling thread, which is thread index of a pool; thread 0, the caller of the loop, is left as it is.
+*/
+static void __pin_(int index, void* context)
+{
+PinContext* p = (PinContext*)context;
+#ifdef __linux__
+cpu_set_t set;
+if(index == 0) return;
+CPU_ZERO(&set);
+CPU_SET(p->_cpus[index % p->_count], &set);
+if(sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0) __atomic_add_fetch(&p->_pinned, 1, __ATOMIC_SEQ_CST);
+#else
+(void)index;
+(void)p;
+#endif
+}
+
+/*
+* Publishes a loop and runs it with the workers; pool->_busy must be held.
+*/
+static void __publish_(ThreadPool* pool, int count, TaskFunction task, void* context, int bound)
+{
+pthread_mutex_lock(&pool->_lock);
+pool->_task = task;
+pool->_context = context;
+pool->_count = count;
+pool->_next = 0;
+pool->_bound = bound;
+pool->_active = pool->_threads-1;
+pool->_generation++;
+pthread_cond_broadcast(&pool->_wake);
+pthread_mutex_unlock(&pool->_lock);
+/* the calling thread works too */
+if(bound) task(0, context);
+else __run_(pool, task, context, count);
+pthread_mutex_lock(&pool->_lock);
+while(pool->_active > 0) pthread_cond_wait(&pool->_finished, &pool->_lock);
+pthread_mutex_unlock(&pool->_lock);
+pthread_mutex_unlock(&pool->_busy);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+ThreadPool* create_threadpool(int threads)
+{
+int i;
+ThreadPool* pool = NULL;
+if(threads <= 0) threads = __processors_();
+if(threads > MAX_THREADS) threads = MAX_THREADS;
+pool = (ThreadPool*)ALLOCATE(sizeof(ThreadPool));
+pool->_threads = threads;
+pool->_workers = (threads > 1) ? (pthread_t*)ALLOCATE((threads-1) * sizeof(pthread_t)) : NULL;
+pthread_mutex_init(&pool->_lock, NULL);
+pthread_mutex_init(&pool->_busy, NULL);
+pthread_cond_init(&pool->_wake, NULL);
+pthread_cond_init(&pool->_finished, NULL);
+pool->_generation = 0;
+pool->_stop = 0;
+pool->_active = 0;
+pool->_task = NULL;
+pool->_context = NULL;
+pool->_count = 0;
+pool->_next = 0;
+pool->_bound = 0;
+pool->_started = 0;
+for(i = 0; i < threads-1; i++)
+{
+	if(pthread_create(&pool->_workers[i], NULL, __worker_, pool) != 0)
+	{
+		/* keep the threads already running */
+		pool->_threads = i+1;
+		break;
+	}
+}
+return pool;
+}
+
+void destroy_threadpool(ThreadPool* pool)
+{
+int i;
+if(pool == NULL) return;
+pthread_mutex_lock(&pool->_lock);
+pool->_stop = 1;
+pthread_cond_broadcast(&pool->_wake);
+pthread_mutex_unlock(&pool->_lock);
+for(i = 0; i < pool->_threads-1; i++) pthread_join(pool->_workers[i], NULL);
+pthread_mutex_destroy(&pool->_lock);
+pthread_mutex_destroy(&pool->_busy);
+pthread_cond_destroy(&pool->_wake);
+pthread_cond_destroy(&pool->_finished);
+if(pool->_workers != NULL) RELEASE(pool->_workers);
+if(pool == __default_) __default_ = NULL;
+RELEASE(pool);
+pool = NULL;
+}
+
+ThreadPool* default_threadpool(void)
+{
+pthread_once(&__default_once_, __create_default_);
+return __default_;
+}
+
+int threads_threadpool(ThreadPool* pool)
+{
+if(pool == NULL) pool = default_threadpool();
+return pool->_threads;
+}
+
+void parallel_for(ThreadPool* pool, int count, TaskFunction task, void* context)
+{
+int i;
+if(count <= 0 || task == NULL) return;
+if(pool == NULL) pool = default_threadpool();
+if(pool->_threads == 1 || count == 1 || pthread_mutex_trylock(&pool->_busy) != 0)
+{
+	/* nothing to share or the pool is running another loop */
+	for(i = 0; i < count; i++) task(i, context);
+	return;
+}
+__publish_(pool, count, task, context, 0);
+}
+
+void parallel_threads(ThreadPool* pool, TaskFunction task, void* context)
+{
+int i;
+if(task == NULL) return;
+if(pool == NULL) pool = default_threadpool();
+if(pool->_threads == 1 || pthread_mutex_trylock(&pool->_busy) != 0)
+{
+	for(i = 0; i < pool->_threads; i++) task(i, context);
+	return;
+}
+__publish_(pool, pool->_threads, task, context, 1);
+}
+
+int pin_threadpool(ThreadPool* pool)
+{
+PinContext p;
+if(pool == NULL) pool = default_threadpool();
+if(pool->_threads == 1) return 0; /* no workers */
+p._count = cpus_numa(NULL, 0);
+if(p._count <= 0) return 0;
+p._cpus = (int*)ALLOCATE(p._count * sizeof(int));
+cpus_numa(p._cpus, p._count);
+p._pinned = 0;
+/* unlike parallel_threads, a busy pool is not run in the calling thread: its workers cannot be reached */
+if(pthread_mutex_trylock(&pool->_busy) == 0) __publish_(pool, pool->_threads, __pin_, &p, 1);
+/* release previously allocated memory */
+RELEASE(p._cpus);
+return p._pinned;
+}
+
+/* END */
@@ -0,0 +1,887 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L /* pread, pwrite, ftruncate */
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64 /* files bigger than 2 GB in 32 bits systems */
+#endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#include "tiled.h"
+#include "allocator.h"
+#include "binio.h"
+#include "kernel.h"
+#include "trace.h"
+
+#define MIN_CACHE_TILES 4
+#define PREFETCH_QUEUE 64 /* pending prefetch requests */
+#define PREFETCH_DEPTH 2 /* tiles requested ahead of the one in use */
+
+/*
+* States of a cache slot.
+*/
+#define TILE_EMPTY 0
+#define TILE_LOADING 1 /* a thread is writing back the old tile and reading the new one */
+#define TILE_READY 2
+
+/*
+* Tile type definition: a slot of the cache.
+*/
+typedef struct
+{
+Matrix _matrix; /* the tile; its data has room for a full tile */
+int _i;
+int _j;
+int _state;
+int _pins; /* get_tile calls not released yet */
+int _dirty;
+int _flushing; /* the old tile ( _old_i, _old_j ) is being written back */
+int _old_i;
+int _old_j;
+unsigned long _used; /* clock of the last use, for LRU replacement */
+}Tile;
+
+/*
+* TiledMatrix type definition.
+*/
+struct TiledMatrix
+{
+#ifdef _WIN32
+HANDLE _file;
+#else
+int _file;
+#endif
+BinaryHeader _header;
+int _rows;
+int _columns;
+int _tile;
+int _tile_rows; /* number of tiles in a column */
+int _tile_columns; /* number of tiles in a row */
+int _modified; /* some tile was written */
+int _error; /* some read or write failed */
+Tile* _cache;
+int _cache_tiles;
+unsigned long _clock;
+int _queue[PREFETCH_QUEUE][2];
+int _head;
+int _pending;
+int _stop;
+pthread_t _thread;
+pthread_mutex_t _lock;
+pthread_cond_t _changed; /* signaled when a slot becomes ready or a tile is released */
+pthread_cond_t _queued; /* signaled when a prefetch is requested or the matrix is closed */
+};
+
+/*
+* Helper functions.
+*/
+
+/*
+* Positioned reads and writes, which can be done by several threads on the same file.
+*/
+static int __read_at_(TiledMatrix* t, void* buffer, size_t length, uint64_t position)
+{
+#ifdef _WIN32
+DWORD n;
+OVERLAPPED o;
+memset(&o, 0, sizeof(o));
+o.Offset = (DWORD)position;
+o.OffsetHigh = (DWORD)(position >> 32);
+return ReadFile(t->_file, buffer, (DWORD)length, &n, &o) && n == length;
+#else
+ssize_t n;
+char* p = (char*)buffer;
+while(length > 0)
+{
+	n = pread(t->_file, p, length, (off_t)position);
+	if(n <= 0) return 0;
+	p += n;
+	length -= (size_t)n;
+	position += (uint64_t)n;
+}
+return 1;
+#endif
+}
+
+static int __write_at_(TiledMatrix* t, const void* buffer, size_t length, uint64_t position)
+{
+#ifdef _WIN32
+DWORD n;
+OVERLAPPED o;
+memset(&o, 0, sizeof(o));
+o.Offset = (DWORD)position;
+o.OffsetHigh = (DWORD)(position >> 32);
+return WriteFile(t->_file, buffer, (DWORD)length, &n, &o) && n == length;
+#else
+ssize_t n;
+const char* p = (const char*)buffer;
+while(length > 0)
+{
+	n = pwrite(t->_file, p, length, (off_t)position);
+	if(n <= 0) return 0;
+	p += n;
+	length -= (size_t)n;
+	position += (uint64_t)n;
+}
+return 1;
+#endif
+}
+
+/*
+* Number of rows and columns of tile ( i, j ).
+*/
+static int __tile_rows_(const TiledMatrix* t, int i)
+{
+return (t->_rows - i*t->_tile < t->_tile) ? t->_rows - i*t->_tile : t->_tile;
+}
+
+static int __tile_columns_(const TiledMatrix* t, int j)
+{
+return (t->_columns - j*t->_tile < t->_tile) ? t->_columns - j*t->_tile : t->_tile;
+}
+
+/*
+* Reads or writes tile ( i, j ) from or to its rows in the file.
+*/
+static int __transfer_tile_(TiledMatrix* t, double* data, int i, int j, int write)
+{
+int r, rows = __tile_rows_(t, i), columns = __tile_columns_(t, j);
+uint64_t position = t->_header._offset + ((uint64_t)i*t->_tile*t->_columns + (uint64_t)j*t->_tile) * sizeof(double);
+/* a tile as wide as the matrix is contiguous in the file */
+if(columns == t->_columns)
+{
+	return write ? __write_at_(t, data, (size_t)rows*columns*sizeof(double), position) :
+	__read_at_(t, data, (size_t)rows*columns*sizeof(double), position);
+}
+for(r = 0; r < rows; r++)
+{
+	if(write ? !__write_at_(t, data + (size_t)r*columns, columns*sizeof(double), position) :
+	!__read_at_(t, data + (size_t)r*columns, columns*sizeof(double), position)) return 0;
+	position += (uint64_t)t->_columns * sizeof(double);
+}
+return 1;
+}
+
+/*
+* Finds the slot holding tile ( i, j ) or -1.
+*/
+static int __find_(const TiledMatrix* t, int i, int j)
+{
+int s;
+for(s = 0; s < t->_cache_tiles; s++)
+{
+	if(t->_cache[s]._state != TILE_EMPTY && t->_cache[s]._i == i && t->_cache[s]._j == j) return s;
+}
+return -1;
+}
+
+/*
+* Tells if tile ( i, j ) is being written back.
+*/
+static int __flushing_(const TiledMatrix* t, int i, int j)
+{
+int s;
+for(s = 0; s < t->_cache_tiles; s++)
+{
+	if(t->_cache[s]._flushing && t->_cache[s]._old_i == i && t->_cache[s]._old_j == j) return 1;
+}
+return 0;
+}
+
+/*
+* Chooses a slot to load a tile: an empty one or the least recently used ready and unused one; -1 if there is none.
+*/
+static int __victim_(const TiledMatrix* t)
+{
+int s, best = -1;
+for(s = 0; s < t->_cache_tiles; s++)
+{
+	if(t->_cache[s]._state == TILE_EMPTY) return s;
+	if(t->_cache[s]._state == TILE_READY && t->_cache[s]._pins == 0 &&
+	(best < 0 || t->_cache[s]._used < t->_cache[best]._used)) best = s;
+}
+return best;
+}
+
+/*
+* Loads tile ( i, j ) into slot s, writing back the tile it held if it was changed.
+* It is called with the lock held, which is released during the transfers.
+*/
+static void __load_slot_(TiledMatrix* t, int s, int i, int j)
+{
+int ok = 1;
+Tile* slot = t->_cache + s;
+int dirty = (slot->_state == TILE_READY && slot->_dirty);
+slot->_flushing = dirty;
+slot->_old_i = slot->_i;
+slot->_old_j = slot->_j;
+slot->_i = i;
+slot->_j = j;
+slot->_state = TILE_LOADING;
+slot->_dirty = 0;
+slot->_used = ++t->_clock;
+pthread_mutex_unlock(&t->_lock);
+TRACE_BEGIN;
+if(dirty) ok = __transfer_tile_(t, slot->_matrix._data, slot->_old_i, slot->_old_j, 1);
+if(ok) ok = __transfer_tile_(t, slot->_matrix._data, i, j, 0);
+TRACE_END("tile_load", i, j);
+pthread_mutex_lock(&t->_lock);
+slot->_flushing = 0;
+if(ok)
+{
+	slot->_matrix._rows = __tile_rows_(t, i);
+	slot->_matrix._columns = __tile_columns_(t, j);
+	slot->_state = TILE_READY;
+}
+else
+{
+	t->_error = 1;
+	slot->_state = TILE_EMPTY;
+}
+pthread_cond_broadcast(&t->_changed);
+}
+
+/*
+* Background thread: loads the requested tiles.
+*/
+static void* __prefetch_(void* arg)
+{
+int i, j, s;
+TiledMatrix* t = (TiledMatrix*)arg;
+pthread_mutex_lock(&t->_lock);
+for(;;)
+{
+	while(t->_pending == 0 && !t->_stop) pthread_cond_wait(&t->_queued, &t->_lock);
+	if(t->_stop) break;
+	i = t->_queue[t->_head][0];
+	j = t->_queue[t->_head][1];
+	t->_head = (t->_head + 1) % PREFETCH_QUEUE;
+	t->_pending--;
+	if(__find_(t, i, j) >= 0 || __flushing_(t, i, j)) continue;
+	s = __victim_(t);
+	if(s >= 0) __load_slot_(t, s, i, j);
+}
+pthread_mutex_unlock(&t->_lock);
+return NULL;
+}
+
+/*
+* Initializes the cache and starts the background thread of a TiledMatrix whose file and header are set.
+*/
+static TiledMatrix* __start_(TiledMatrix* t, int tile, int cache_tiles)
+{
+int s;
+t->_rows = (int)t->_header._rows;
+t->_columns = (int)t->_header._columns;
+t->_tile = (tile > 0) ? tile : DEFAULT_TILE;
+t->_tile_rows = (t->_rows + t->_tile - 1) / t->_tile;
+t->_tile_columns = (t->_columns + t->_tile - 1) / t->_tile;
+t->_cache_tiles = (cache_tiles > 0) ? cache_tiles : DEFAULT_CACHE_TILES;
+if(t->_cache_tiles < MIN_CACHE_TILES) t->_cache_tiles = MIN_CACHE_TILES;
+t->_cache = (Tile*)ALLOCATE(t->_cache_tiles * sizeof(Tile));
+memset(t->_cache, 0, t->_cache_tiles * sizeof(Tile));
+for(s = 0; s < t->_cache_tiles; s++) t->_cache[s]._matrix._data = (double*)ALLOCATE((size_t)t->_tile * t->_tile * sizeof(double));
+pthread_mutex_init(&t->_lock, NULL);
+pthread_cond_init(&t->_changed, NULL);
+pthread_cond_init(&t->_queued, NULL);
+if(pthread_create(&t->_thread, NULL, __prefetch_, t) != 0)
+{
+	/* release previously allocated memory */
+	for(s = 0; s < t->_cache_tiles; s++) RELEASE(t->_cache[s]._matrix._data);
+	RELEASE(t->_cache);
+	pthread_mutex_destroy(&t->_lock);
+	pthread_cond_destroy(&t->_changed);
+	pthread_cond_destroy(&t->_queued);
+	#ifdef _WIN32
+	CloseHandle(t->_file);
+	#else
+	close(t->_file);
+	#endif
+	RELEASE(t);
+	return NULL;
+}
+return t;
+}
+
+/*
+* Reads tiles ( first, j ) .. ( last tile row, j ) into a buffer with ld columns, asking for the next ones in advance.
+* When the column ends, the first tiles of column ( next_first, next ) are asked for; next is -1 if there are none.
+*/
+static int __read_column_(TiledMatrix* t, int j, int first, double* buffer, int ld, int next, int next_first)
+{
+int i, k, r, ahead;
+Matrix* tile = NULL;
+for(i = first; i < t->_tile_rows; i++)
+{
+	ahead = i + PREFETCH_DEPTH;
+	if(ahead < t->_tile_rows) prefetch_tile(t, ahead, j);
+	else if(next >= 0 && next_first + ahead - t->_tile_rows < t->_tile_rows) prefetch_tile(t, next_first + ahead - t->_tile_rows, next);
+	tile = get_tile(t, i, j);
+	if(tile == NULL) return 0;
+	for(r = 0; r < rows_matrix(tile); r++)
+	{
+		for(k = 0; k < columns_matrix(tile); k++) buffer[((size_t)(i-first)*t->_tile + r)*ld + k] = tile->_data[(size_t)r*columns_matrix(tile) + k];
+	}
+	release_tile(t, tile, 0);
+}
+return 1;
+}
+
+/*
+* Writes a buffer with ld columns to tiles ( first, j ) .. ( last tile row, j ).
+*/
+static int __write_column_(TiledMatrix* t, int j, int first, const double* buffer, int ld)
+{
+int i, k, r;
+Matrix* tile = NULL;
+for(i = first; i < t->_tile_rows; i++)
+{
+	tile = get_tile(t, i, j);
+	if(tile == NULL) return 0;
+	for(r = 0; r < rows_matrix(tile); r++)
+	{
+		for(k = 0; k < columns_matrix(tile); k++) tile->_data[(size_t)r*columns_matrix(tile) + k] = buffer[((size_t)(i-first)*t->_tile + r)*ld + k];
+	}
+	release_tile(t, tile, 1);
+}
+return 1;
+}
+
+/*
+* Swaps two rows of a buffer with ld columns.
+*/
+static void __swap_rows_(double* buffer, int ld, int a, int b)
+{
+int k;
+double d;
+if(a == b) return;
+for(k = 0; k < ld; k++)
+{
+	d = buffer[(size_t)a*ld + k];
+	buffer[(size_t)a*ld + k] = buffer[(size_t)b*ld + k];
+	buffer[(size_t)b*ld + k] = d;
+}
+}
+
+/* end helper functions */
+
+/* implementation */
+
+TiledMatrix* create_tiled_matrix(const char* filename, int rows, int columns, int tile, int cache_tiles)
+{
+uint64_t size;
+TiledMatrix* t = NULL;
+int ok;
+if(filename == NULL || rows < 1 || columns < 1) return NULL;
+t = (TiledMatrix*)ALLOCATE(sizeof(TiledMatrix));
+memset(t, 0, sizeof(TiledMatrix));
+make_header_binary(&t->_header, (uint64_t)rows, (uint64_t)columns, 0);
+t->_header._flags = BINARY_UNCHECKED;
+size = t->_header._offset + (uint64_t)rows * columns * sizeof(double);
+#ifdef _WIN32
+{
+	LARGE_INTEGER end;
+	t->_file = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(t->_file == INVALID_HANDLE_VALUE)
+	{
+		RELEASE(t);
+		return NULL;
+	}
+	end.QuadPart = (LONGLONG)size;
+	ok = SetFilePointerEx(t->_file, end, NULL, FILE_BEGIN) && SetEndOfFile(t->_file);
+	if(!ok) CloseHandle(t->_file);
+}
+#else
+t->_file = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+if(t->_file < 0)
+{
+	RELEASE(t);
+	return NULL;
+}
+/* the file gets its size at once, the entries read as zero until they are written */
+ok = (ftruncate(t->_file, (off_t)size) == 0);
+if(!ok) close(t->_file);
+#endif
+if(ok && !__write_at_(t, &t->_header, sizeof(BinaryHeader), 0))
+{
+	ok = 0;
+	#ifdef _WIN32
+	CloseHandle(t->_file);
+	#else
+	close(t->_file);
+	#endif
+}
+if(!ok)
+{
+	RELEASE(t);
+	return NULL;
+}
+return __start_(t, tile, cache_tiles);
+}
+
+TiledMatrix* open_tiled_matrix(const char* filename, int tile, int cache_tiles)
+{
+uint64_t size;
+int ok;
+TiledMatrix* t = NULL;
+if(filename == NULL) return NULL;
+t = (TiledMatrix*)ALLOCATE(sizeof(TiledMatrix));
+memset(t, 0, sizeof(TiledMatrix));
+#ifdef _WIN32
+{
+	LARGE_INTEGER length;
+	t->_file = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(t->_file == INVALID_HANDLE_VALUE)
+	{
+		RELEASE(t);
+		return NULL;
+	}
+	size = GetFileSizeEx(t->_file, &length) ? (uint64_t)length.QuadPart : 0;
+}
+#else
+{
+	struct stat st;
+	t->_file = open(filename, O_RDWR);
+	if(t->_file < 0)
+	{
+		RELEASE(t);
+		return NULL;
+	}
+	size = (fstat(t->_file, &st) == 0) ? (uint64_t)st.st_size : 0;
+}
+#endif
+ok = __read_at_(t, &t->_header, sizeof(BinaryHeader), 0) && valid_header_binary(&t->_header) &&
+t->_header._layout == BINARY_ROW_MAJOR && !(t->_header._flags & BINARY_COMPRESSED) && size >= t->_header._offset + t->_header._rows * t->_header._columns * sizeof(double);
+if(!ok)
+{
+	/* release previously allocated memory */
+	#ifdef _WIN32
+	CloseHandle(t->_file);
+	#else
+	close(t->_file);
+	#endif
+	RELEASE(t);
+	return NULL;
+}
+return __start_(t, tile, cache_tiles);
+}
+
+int flush_tiled_matrix(TiledMatrix* t)
+{
+int s;
+Tile* slot = NULL;
+if(t == NULL) return 0;
+pthread_mutex_lock(&t->_lock);
+/* wait for the loads in progress, they may be writing back a tile */
+for(s = 0; s < t->_cache_tiles; s++)
+{
+	while(t->_cache[s]._state == TILE_LOADING) pthread_cond_wait(&t->_changed, &t->_lock);
+}
+for(s = 0; s < t->_cache_tiles; s++)
+{
+	slot = t->_cache + s;
+	if(slot->_state != TILE_READY || !slot->_dirty) continue;
+	if(!__transfer_tile_(t, slot->_matrix._data, slot->_i, slot->_j, 1)) t->_error = 1;
+	slot->_dirty = 0;
+}
+if(t->_modified && !(t->_header._flags & BINARY_UNCHECKED))
+{
+	t->_header._flags |= BINARY_UNCHECKED;
+	t->_header._checksum = 0;
+	if(!__write_at_(t, &t->_header, sizeof(BinaryHeader), 0)) t->_error = 1;
+}
+s = !t->_error;
+pthread_mutex_unlock(&t->_lock);
+return s;
+}
+
+int close_tiled_matrix(TiledMatrix* t)
+{
+int s, ok;
+if(t == NULL) return 0;
+ok = flush_tiled_matrix(t);
+pthread_mutex_lock(&t->_lock);
+t->_stop = 1;
+pthread_cond_signal(&t->_queued);
+pthread_mutex_unlock(&t->_lock);
+pthread_join(t->_thread, NULL);
+/* release previously allocated memory */
+for(s = 0; s < t->_cache_tiles; s++) RELEASE(t->_cache[s]._matrix._data);
+RELEASE(t->_cache);
+pthread_mutex_destroy(&t->_lock);
+pthread_cond_destroy(&t->_changed);
+pthread_cond_destroy(&t->_queued);
+#ifdef _WIN32
+if(!CloseHandle(t->_file)) ok = 0;
+#else
+if(close(t->_file) != 0) ok = 0;
+#endif
+RELEASE(t);
+return ok;
+}
+
+Matrix* get_tile(TiledMatrix* t, int i, int j)
+{
+int s, k, loading;
+Matrix* tile = NULL;
+if(t == NULL || i < 0 || i >= t->_tile_rows || j < 0 || j >= t->_tile_columns) return NULL;
+pthread_mutex_lock(&t->_lock);
+for(;;)
+{
+	s = __find_(t, i, j);
+	if(s >= 0)
+	{
+		if(t->_cache[s]._state == TILE_LOADING)
+		{
+			pthread_cond_wait(&t->_changed, &t->_lock);
+			continue;
+		}
+		t->_cache[s]._pins++;
+		t->_cache[s]._used = ++t->_clock;
+		tile = &t->_cache[s]._matrix;
+		break;
+	}
+	/* a tile being written back is read again after the write */
+	if(__flushing_(t, i, j))
+	{
+		pthread_cond_wait(&t->_changed, &t->_lock);
+		continue;
+	}
+	s = __victim_(t);
+	if(s < 0)
+	{
+		/* every slot is in use; wait only if some of them will be free soon */
+		loading = 0;
+		for(k = 0; k < t->_cache_tiles; k++) if(t->_cache[k]._state == TILE_LOADING) loading = 1;
+		if(!loading) break;
+		pthread_cond_wait(&t->_changed, &t->_lock);
+		continue;
+	}
+	__load_slot_(t, s, i, j);
+	/* the load may fail, or another thread may take the tile meanwhile, so look again */
+	if(t->_cache[s]._state == TILE_EMPTY) break;
+}
+pthread_mutex_unlock(&t->_lock);
+return tile;
+}
+
+void release_tile(TiledMatrix* t, Matrix* tile, int modified)
+{
+int s;
+if(t == NULL || tile == NULL) return;
+pthread_mutex_lock(&t->_lock);
+for(s = 0; s < t->_cache_tiles; s++)
+{
+	if(&t->_cache[s]._matrix != tile) continue;
+	if(t->_cache[s]._pins > 0) t->_cache[s]._pins--;
+	if(modified)
+	{
+		t->_cache[s]._dirty = 1;
+		t->_modified = 1;
+	}
+	break;
+}
+pthread_cond_broadcast(&t->_changed);
+pthread_mutex_unlock(&t->_lock);
+}
+
+void prefetch_tile(TiledMatrix* t, int i, int j)
+{
+if(t == NULL || i < 0 || i >= t->_tile_rows || j < 0 || j >= t->_tile_columns) return;
+pthread_mutex_lock(&t->_lock);
+if(t->_pending < PREFETCH_QUEUE && __find_(t, i, j) < 0)
+{
+	t->_queue[(t->_head + t->_pending) % PREFETCH_QUEUE][0] = i;
+	t->_queue[(t->_head + t->_pending) % PREFETCH_QUEUE][1] = j;
+	t->_pending++;
+	pthread_cond_signal(&t->_queued);
+}
+pthread_mutex_unlock(&t->_lock);
+}
+
+int rows_tiled_matrix(const TiledMatrix* t)
+{
+return t->_rows;
+}
+
+int columns_tiled_matrix(const TiledMatrix* t)
+{
+return t->_columns;
+}
+
+int tile_tiled_matrix(const TiledMatrix* t)
+{
+return t->_tile;
+}
+
+int gemm_tiled_matrix(double alpha, TiledMatrix* a, TiledMatrix* b, double beta, TiledMatrix* c)
+{
+int i, j, k, n, ok = 1;
+Matrix* ta = NULL;
+Matrix* tb = NULL;
+Matrix* tc = NULL;
+if(a == NULL || b == NULL || c == NULL || c == a || c == b) return 0;
+if(a->_columns != b->_rows || a->_rows != c->_rows || b->_columns != c->_columns) return 0;
+if(a->_tile != b->_tile || a->_tile != c->_tile) return 0;
+for(i = 0; ok && i < c->_tile_rows; i++)
+{
+	for(j = 0; ok && j < c->_tile_columns; j++)
+	{
+		TRACE_BEGIN;
+		if(beta != 0.0) prefetch_tile(c, i, j);
+		prefetch_tile(a, i, 0);
+		prefetch_tile(b, 0, j);
+		tc = get_tile(c, i, j);
+		if(tc == NULL)
+		{
+			ok = 0;
+			break;
+		}
+		n = dimension_matrix(tc);
+		if(beta == 0.0) for(k = 0; k < n; k++) tc->_data[k] = 0.0;
+		else if(beta != 1.0) for(k = 0; k < n; k++) tc->_data[k] *= beta;
+		for(k = 0; k < a->_tile_columns; k++)
+		{
+			/* the next pair of tiles is read while this one is multiplied */
+			if(k+1 < a->_tile_columns)
+			{
+				prefetch_tile(a, i, k+1);
+				prefetch_tile(b, k+1, j);
+			}
+			ta = get_tile(a, i, k);
+			tb = get_tile(b, k, j);
+			if(ta == NULL || tb == NULL) ok = 0;
+			else
+			{
+				kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, rows_matrix(tc), columns_matrix(tc), columns_matrix(ta), alpha,
+				ta->_data, columns_matrix(ta), tb->_data, columns_matrix(tb), 1.0, tc->_data, columns_matrix(tc));
+			}
+			release_tile(a, ta, 0);
+			release_tile(b, tb, 0);
+			if(!ok) break;
+		}
+		release_tile(c, tc, 1);
+		TRACE_END("tiled_gemm", i, j);
+	}
+}
+if(!flush_tiled_matrix(c)) ok = 0;
+return ok;
+}
+
+int* lu_tiled_matrix(TiledMatrix* a)
+{
+int n, nb, tiles, i, j, k, r, q, p, jb, kb, first, ok = 1;
+int* pivot = NULL;
+int* permutation = NULL;
+double* panel = NULL;
+double* left = NULL;
+double d, big;
+if(a == NULL || a->_rows != a->_columns) return NULL;
+n = a->_rows;
+nb = a->_tile;
+tiles = a->_tile_rows;
+/* row i was swapped with row pivot[i] ( >= i ) when column i was factored */
+pivot = (int*)ALLOCATE(n * sizeof(int));
+panel = (double*)ALLOCATE((size_t)n * nb * sizeof(double));
+left = (double*)ALLOCATE((size_t)n * nb * sizeof(double));
+for(j = 0; ok && j < tiles; j++)
+{
+	TRACE_BEGIN;
+	jb = __tile_columns_(a, j);
+	/* column j of tiles with all the previous row swaps */
+	ok = __read_column_(a, j, 0, panel, nb, (j > 0) ? 0 : -1, 0);
+	for(r = 0; ok && r < j*nb; r++) __swap_rows_(panel, nb, r, pivot[r]);
+	for(k = 0; ok && k < j; k++)
+	{
+		TRACE_BEGIN;
+		/* L of column k of tiles, from its diagonal tile down; it lacks the swaps done after it was written */
+		kb = __tile_columns_(a, k);
+		first = k*nb;
+		ok = __read_column_(a, k, k, left, nb, (k+1 < j) ? k+1 : -1, k+1);
+		if(!ok) break;
+		for(r = (k+1)*nb; r < j*nb; r++) __swap_rows_(left, nb, r - first, pivot[r] - first);
+		/* U( k, j ) = L( k, k )^-1 * A( k, j ) */
+		for(r = 1; r < kb; r++)
+		{
+			for(q = 0; q < r; q++)
+			{
+				d = left[(size_t)r*nb + q];
+				for(p = 0; p < jb; p++) panel[(size_t)(first+r)*nb + p] -= d * panel[(size_t)(first+q)*nb + p];
+			}
+		}
+		/* A( k+1:, j ) -= L( k+1:, k ) * U( k, j ) */
+		if(n - first - kb > 0)
+		{
+			kernel_gemm(KERNEL_NO_TRANS, KERNEL_NO_TRANS, n - first - kb, jb, kb, -1.0, left + (size_t)kb*nb, nb,
+			panel + (size_t)first*nb, nb, 1.0, panel + (size_t)(first+kb)*nb, nb);
+		}
+		TRACE_END("tiled_lu_update", k, j);
+	}
+	/* factor the panel below the diagonal with partial pivoting */
+	first = j*nb;
+	for(q = 0; ok && q < jb; q++)
+	{
+		p = first + q;
+		big = fabs(panel[(size_t)p*nb + q]);
+		for(r = first + q + 1; r < n; r++)
+		{
+			if(fabs(panel[(size_t)r*nb + q]) > big)
+			{
+				big = fabs(panel[(size_t)r*nb + q]);
+				p = r;
+			}
+		}
+		if(big == 0.0)
+		{
+			ok = 0;
+			break;
+		}
+		pivot[first + q] = p;
+		__swap_rows_(panel, nb, first + q, p);
+		d = panel[(size_t)(first+q)*nb + q];
+		for(r = first + q + 1; r < n; r++)
+		{
+			panel[(size_t)r*nb + q] /= d;
+			for(p = q + 1; p < jb; p++) panel[(size_t)r*nb + p] -= panel[(size_t)r*nb + q] * panel[(size_t)(first+q)*nb + p];
+		}
+	}
+	if(ok) ok = __write_column_(a, j, 0, panel, nb);
+	TRACE_END("tiled_lu_column", j, j);
+}
+/* apply the later swaps to L, one column of tiles at a time */
+for(k = 0; ok && k+1 < tiles; k++)
+{
+	first = (k+1)*nb;
+	ok = __read_column_(a, k, k+1, left, nb, k+1, k+2);
+	for(r = first; ok && r < n; r++) __swap_rows_(left, nb, r - first, pivot[r] - first);
+	if(ok) ok = __write_column_(a, k, k+1, left, nb);
+}
+if(ok) ok = flush_tiled_matrix(a);
+if(ok)
+{
+	permutation = (int*)ALLOCATE(n * sizeof(int));
+	for(i = 0; i < n; i++) permutation[i] = i;
+	for(i = 0; i < n; i++)
+	{
+		r = permutation[i];
+		permutation[i] = permutation[pivot[i]];
+		permutation[pivot[i]] = r;
+	}
+}
+
+/* release previously allocated memory */
+RELEASE(pivot);
+RELEASE(panel);
+RELEASE(left);
+
+return permutation;
+}
+
+Vector* lu_tiled_solver(TiledMatrix* lu, const int* permutation, const Vector* b)
+{
+int i, k, r, q, n, first, ok = 1;
+double accum;
+Matrix* tile = NULL;
+Vector* x = NULL;
+if(lu == NULL || permutation == NULL || b == NULL) return NULL;
+n = lu->_rows;
+if(lu->_columns != n || size_vector(b) != n) return NULL;
+x = create_vector(n);
+for(i = 0; i < n; i++) x->_data[i] = b->_data[permutation[i]];
+/* forward substitution with L, one row of tiles at a time */
+for(i = 0; ok && i < lu->_tile_rows; i++)
+{
+	first = i*lu->_tile;
+	for(k = 0; k <= i; k++)
+	{
+		prefetch_tile(lu, (k < i) ? i : i+1, (k < i) ? k+1 : 0);
+		tile = get_tile(lu, i, k);
+		if(tile == NULL)
+		{
+			ok = 0;
+			break;
+		}
+		for(r = 0; r < rows_matrix(tile); r++)
+		{
+			accum = 0.0;
+			/* the diagonal tile holds L below its diagonal */
+			for(q = 0; q < ((k < i) ? columns_matrix(tile) : r); q++) accum += tile->_data[(size_t)r*columns_matrix(tile) + q] * x->_data[k*lu->_tile + q];
+			x->_data[first + r] -= accum;
+		}
+		release_tile(lu, tile, 0);
+	}
+}
+/* backward substitution with U */
+for(i = lu->_tile_rows - 1; ok && i >= 0; i--)
+{
+	first = i*lu->_tile;
+	for(k = lu->_tile_columns - 1; k >= i; k--)
+	{
+		prefetch_tile(lu, (k > i) ? i : i-1, (k > i) ? k-1 : lu->_tile_columns-1);
+		tile = get_tile(lu, i, k);
+		if(tile == NULL)
+		{
+			ok = 0;
+			break;
+		}
+		if(k > i)
+		{
+			for(r = 0; r < rows_matrix(tile); r++)
+			{
+				accum = 0.0;
+				for(q = 0; q < columns_matrix(tile); q++) accum += tile->_data[(size_t)r*columns_matrix(tile) + q] * x->_data[k*lu->_tile + q];
+				x->_data[first + r] -= accum;
+			}
+		}
+		else
+		{
+			for(r = rows_matrix(tile) - 1; r >= 0; r--)
+			{
+				accum = x->_data[first + r];
+				for(q = r + 1; q < columns_matrix(tile); q++) accum -= tile->_data[(size_t)r*columns_matrix(tile) + q] * x->_data[first + q];
+				x->_data[first + r] = accum / tile->_data[(size_t)r*columns_matrix(tile) + r];
+			}
+		}
+		release_tile(lu, tile, 0);
+	}
+}
+if(!ok)
+{
+	destroy_vector(x);
+	return NULL;
+}
+return x;
+}
+
+/* END */
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef LINEARSYS_TRACE
+#include <pthread.h>
+#endif
+#include "trace.h"
+#include "instrument.h"
+
+#ifdef LINEARSYS_TRACE
+
+#define MIN_TRACE_EVENTS 16
+
+/*
+* TraceEvent type definition: a task run by a thread.
+*/
+typedef struct
+{
+const char* _name;
+unsigned long long _begin;
+unsigned long long _end;
+int _i;
+int _j;
+}TraceEvent;
+
+/*
+* TraceBuffer type definition: the ring buffer of a thread.
+* Only the thread owning it writes to it; the buffer of a finished thread is taken by the next new thread,
+* so the buffers are kept in a list which only grows, and they live until the program ends.
+*/
+typedef struct TraceBuffer
+{
+struct TraceBuffer* _next;
+int _thread; /* thread number, from 1 */
+int _owned; /* a running thread writes to it */
+unsigned long _generation; /* trace the events belong to */
+unsigned long long _head; /* events written to the current trace */
+unsigned long long _mask; /* capacity - 1 */
+TraceEvent* _events;
+}TraceBuffer;
+
+static TraceBuffer* __buffers_ = NULL;
+static int __threads_ = 0;
+static int __recording_ = 0;
+static unsigned long __generation_ = 0;
+static unsigned long long __capacity_ = DEFAULT_TRACE_EVENTS;
+static unsigned long long __origin_ = 0; /* clock when the trace started */
+static pthread_key_t __buffer_key_;
+static pthread_once_t __buffer_once_ = PTHREAD_ONCE_INIT;
+
+/*
+* Helper functions.
+*/
+
+/*
+* Called when a thread ends, to let another thread take its buffer.
+*/
+static void __release_(void* buffer)
+{
+__atomic_store_n(&((TraceBuffer*)buffer)->_owned, 0, __ATOMIC_RELEASE);
+}
+
+static void __create_key_(void)
+{
+pthread_key_create(&__buffer_key_, __release_);
+}
+
+/*
+* Gets the buffer of the calling thread, taking a free one or adding a new one to the list.
+*/
+static TraceBuffer* __buffer_(void)
+{
+int owned;
+TraceBuffer* b = NULL;
+pthread_once(&__buffer_once_, __create_key_);
+b = (TraceBuffer*)pthread_getspecific(__buffer_key_);
+if(b != NULL) return b;
+for(b = __atomic_load_n(&__buffers_, __ATOMIC_ACQUIRE); b != NULL; b = b->_next)
+{
+	owned = 0;
+	if(__atomic_compare_exchange_n(&b->_owned, &owned, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) break;
+}
+if(b == NULL)
+{
+	b = (TraceBuffer*)calloc(1, sizeof(TraceBuffer));
+	if(b == NULL) return NULL;
+	b->_owned = 1;
+	b->_thread = __atomic_add_fetch(&__threads_, 1, __ATOMIC_RELAXED);
+	b->_next = __atomic_load_n(&__buffers_, __ATOMIC_RELAXED);
+	while(!__atomic_compare_exchange_n(&__buffers_, &b->_next, b, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+pthread_setspecific(__buffer_key_, b);
+return b;
+}
+
+/* end helper functions */
+
+#endif
+
+/* implementation */
+
+int start_trace(int capacity)
+{
+#ifdef LINEARSYS_TRACE
+unsigned long long c = MIN_TRACE_EVENTS;
+if(capacity <= 0) capacity = DEFAULT_TRACE_EVENTS;
+while(c < (unsigned long long)capacity) c <<= 1;
+__capacity_ = c;
+__origin_ = clock_instrument();
+__atomic_add_fetch(&__generation_, 1, __ATOMIC_RELEASE);
+__atomic_store_n(&__recording_, 1, __ATOMIC_RELEASE);
+return 1;
+#else
+(void)capacity;
+return 0;
+#endif
+}
+
+void stop_trace(void)
+{
+#ifdef LINEARSYS_TRACE
+__atomic_store_n(&__recording_, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+int export_trace(const char* filename)
+{
+int ok;
+unsigned long long dropped = 0;
+FILE* fp = NULL;
+#ifdef LINEARSYS_TRACE
+int first = 1;
+unsigned long long k, count, begin;
+unsigned long generation = __atomic_load_n(&__generation_, __ATOMIC_ACQUIRE);
+const TraceEvent* e = NULL;
+const TraceBuffer* b = NULL;
+#endif
+if(filename == NULL) return 0;
+fp = fopen(filename, "w");
+if(fp == NULL) return 0;
+fprintf(fp, "{\"traceEvents\":[");
+#ifdef LINEARSYS_TRACE
+for(b = __atomic_load_n(&__buffers_, __ATOMIC_ACQUIRE); b != NULL; b = b->_next)
+{
+	if(__atomic_load_n(&b->_generation, __ATOMIC_ACQUIRE) != generation || b->_events == NULL) continue;
+	count = __atomic_load_n(&b->_head, __ATOMIC_ACQUIRE);
+	if(count == 0) continue;
+	fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+	(first) ? "" : ",", b->_thread, b->_thread);
+	first = 0;
+	/* the ring keeps the last mask+1 events */
+	k = (count > b->_mask + 1) ? count - (b->_mask + 1) : 0;
+	dropped += k;
+	for(; k < count; k++)
+	{
+		e = &b->_events[k & b->_mask];
+		begin = (e->_begin > __origin_) ? e->_begin : __origin_;
+		fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"linearsys\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+		e->_name, b->_thread, 1E-3 * (double)(begin - __origin_), 1E-3 * (double)(e->_end - begin));
+		if(e->_i >= 0 || e->_j >= 0) fprintf(fp, ",\"args\":{\"i\":%d,\"j\":%d}", e->_i, e->_j);
+		fprintf(fp, "}");
+	}
+}
+#endif
+fprintf(fp, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":%llu}}\n", dropped);
+ok = !ferror(fp);
+if(fclose(fp) != 0) ok = 0;
+return ok;
+}
+
+unsigned long long begin_trace(void)
+{
+#ifdef LINEARSYS_TRACE
+if(__atomic_load_n(&__recording_, __ATOMIC_RELAXED)) return clock_instrument();
+#endif
+return 0;
+}
+
+void end_trace(const char* name, unsigned long long begin, int i, int j)
+{
+#ifdef LINEARSYS_TRACE
+unsigned long long end, head, capacity;
+unsigned long generation;
+TraceEvent* e = NULL;
+TraceBuffer* b = NULL;
+if(begin == 0 || !__atomic_load_n(&__recording_, __ATOMIC_RELAXED)) return;
+end = clock_instrument();
+b = __buffer_();
+if(b == NULL) return;
+generation = __atomic_load_n(&__generation_, __ATOMIC_ACQUIRE);
+if(b->_generation != generation)
+{
+	/* first event of this thread in a new trace */
+	capacity = __capacity_;
+	if(b->_events == NULL || b->_mask + 1 != capacity)
+	{
+		free(b->_events);
+		b->_events = (TraceEvent*)malloc(capacity * sizeof(TraceEvent));
+		b->_mask = capacity - 1;
+	}
+	__atomic_store_n(&b->_head, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&b->_generation, generation, __ATOMIC_RELEASE);
+}
+if(b->_events == NULL) return;
+head = b->_head;
+e = &b->_events[head & b->_mask];
+e->_name = name;
+e->_begin = begin;
+e->_end = end;
+e->_i = i;
+e->_j = j;
+__atomic_store_n(&b->_head, head + 1, __ATOMIC_RELEASE);
+#else
+(void)name;
+(void)begin;
+(void)i;
+(void)j;
+#endif
+}
+
+/* END */
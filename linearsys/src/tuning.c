@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2026 Ismael Mosquera Rivera
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* gethostname */
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "tuning.h"
+
+#define LINE_SIZE 256
+#define HOST_SIZE 128
+#define MAX_PARALLEL_PARSE ((size_t)-1 >> 1) /* largest parse threshold read from a file */
+
+static Tuning __tuning_;
+static pthread_once_t __tuning_once_ = PTHREAD_ONCE_INIT;
+
+/*
+* Helper functions.
+*/
+
+/*
+* Copies the values in range from one Tuning to another.
+*/
+static void __update_(Tuning* t, const Tuning* from)
+{
+if(from->_gemm_mc >= 1) t->_gemm_mc = (from->_gemm_mc < MAX_TUNING_BLOCK) ? from->_gemm_mc : MAX_TUNING_BLOCK;
+if(from->_gemm_kc >= 1) t->_gemm_kc = (from->_gemm_kc < MAX_TUNING_BLOCK) ? from->_gemm_kc : MAX_TUNING_BLOCK;
+if(from->_gemm_nc >= 1) t->_gemm_nc = (from->_gemm_nc < MAX_TUNING_BLOCK) ? from->_gemm_nc : MAX_TUNING_BLOCK;
+if(from->_lu_block >= 1) t->_lu_block = (from->_lu_block < MAX_TUNING_BLOCK) ? from->_lu_block : MAX_TUNING_BLOCK;
+if(from->_parallel_gemm >= 0.0) t->_parallel_gemm = from->_parallel_gemm;
+t->_parallel_parse = from->_parallel_parse;
+}
+
+/*
+* Converts a block size read from a file, clamped to MAX_TUNING_BLOCK so that the conversion is defined.
+*/
+static int __block_(double value)
+{
+return (value < MAX_TUNING_BLOCK) ? (int)value : MAX_TUNING_BLOCK;
+}
+
+/*
+* Gets the name of this computer.
+*/
+static int __host_(char* buffer, int size)
+{
+#ifdef _WIN32
+const char* name = getenv("COMPUTERNAME");
+if(name == NULL || (int)strlen(name) >= size) return 0;
+strcpy(buffer, name);
+#else
+if(gethostname(buffer, size) != 0) return 0;
+buffer[size-1] = '\0';
+#endif
+return (buffer[0] != '\0');
+}
+
+static void __load_default_(void)
+{
+char filename[FILENAME_MAX];
+default_tuning(&__tuning_);
+if(filename_tuning(filename, FILENAME_MAX)) load_tuning(filename, &__tuning_);
+}
+
+/* end helper functions */
+
+/* implementation */
+
+void default_tuning(Tuning* t)
+{
+if(t == NULL) return;
+t->_gemm_mc = 64;
+t->_gemm_kc = 256;
+t->_gemm_nc = 1024;
+t->_lu_block = 64;
+t->_parallel_gemm = 2097152.0; /* a 128 x 128 product */
+t->_parallel_parse = 1048576;
+}
+
+const Tuning* get_tuning(void)
+{
+pthread_once(&__tuning_once_, __load_default_);
+return &__tuning_;
+}
+
+void set_tuning(const Tuning* t)
+{
+if(t == NULL) return;
+pthread_once(&__tuning_once_, __load_default_);
+__update_(&__tuning_, t);
+}
+
+int load_tuning(const char* filename, Tuning* t)
+{
+char line[LINE_SIZE];
+char key[LINE_SIZE];
+double value;
+Tuning read;
+FILE* fp = NULL;
+if(filename == NULL || t == NULL) return 0;
+fp = fopen(filename, "r");
+if(fp == NULL) return 0;
+read = *t;
+while(fgets(line, LINE_SIZE, fp) != NULL)
+{
+	if(line[0] == '#') continue;
+	if(sscanf(line, "%255s %lf", key, &value) != 2) continue;
+	if(!(value >= 0.0)) continue; /* negative or not a number */
+	if(strcmp(key, "gemm_mc") == 0) read._gemm_mc = __block_(value);
+	else if(strcmp(key, "gemm_kc") == 0) read._gemm_kc = __block_(value);
+	else if(strcmp(key, "gemm_nc") == 0) read._gemm_nc = __block_(value);
+	else if(strcmp(key, "lu_block") == 0) read._lu_block = __block_(value);
+	else if(strcmp(key, "parallel_gemm") == 0) read._parallel_gemm = value;
+	else if(strcmp(key, "parallel_parse") == 0) read._parallel_parse = (value < (double)MAX_PARALLEL_PARSE) ? (size_t)value : MAX_PARALLEL_PARSE;
+}
+fclose(fp);
+__update_(t, &read);
+return 1;
+}
+
+int store_tuning(const char* filename, const Tuning* t)
+{
+char host[HOST_SIZE];
+FILE* fp = NULL;
+if(filename == NULL || t == NULL) return 0;
+fp = fopen(filename, "w");
+if(fp == NULL) return 0;
+if(__host_(host, HOST_SIZE)) fprintf(fp, "# linearsys tuning for %s\n", host);
+fprintf(fp, "gemm_mc %d\n", t->_gemm_mc);
+fprintf(fp, "gemm_kc %d\n", t->_gemm_kc);
+fprintf(fp, "gemm_nc %d\n", t->_gemm_nc);
+fprintf(fp, "lu_block %d\n", t->_lu_block);
+fprintf(fp, "parallel_gemm %.0f\n", t->_parallel_gemm);
+fprintf(fp, "parallel_parse %lu\n", (unsigned long)t->_parallel_parse);
+if(fclose(fp) != 0) return 0;
+return 1;
+}
+
+int filename_tuning(char* buffer, int size)
+{
+char host[HOST_SIZE];
+const char* home = NULL;
+const char* env = getenv("LINEARSYS_TUNING");
+if(buffer == NULL || size < 1) return 0;
+if(env != NULL && env[0] != '\0')
+{
+	if((int)strlen(env) >= size) return 0;
+	strcpy(buffer, env);
+	return 1;
+}
+#ifdef _WIN32
+home = getenv("USERPROFILE");
+#else
+home = getenv("HOME");
+#endif
+if(home == NULL || !__host_(host, HOST_SIZE)) return 0;
+if(snprintf(buffer, size, "%s/.linearsys-%s.tune", home, host) >= size) return 0;
+return 1;
+}
+
+/* END */
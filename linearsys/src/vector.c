@@ -21,8 +21,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 #include "numio.h"
 #include "vector.h"
+#include "allocator.h"
+#include "instrument.h"
 
 /* Declare a Not a Number constant */
 static const double __NaN__ = 1E-9;
@@ -39,9 +42,10 @@ return x*x;
 Vector* create_vector(int size)
 {
 	int i;
-Vector* v = (Vector*)malloc(sizeof(Vector));
+Vector* v = (Vector*)ALLOCATE(sizeof(Vector));
 v->_size = size;
-v->_data = (double*)malloc(v->_size * sizeof(double));
+v->_data = (double*)ALLOCATE_ALIGNED(v->_size * sizeof(double));
+INSTRUMENT_ALLOCATE(0, (size_t)v->_size * sizeof(double));
 for(i = 0; i < v->_size; i++) v->_data[i] = 0.0;
 return v;
 }
@@ -49,9 +53,10 @@ return v;
 void destroy_vector(Vector* v)
 {
 if(!v) return;
-if(v->_data) free(v->_data);
+INSTRUMENT_FREE(0, (v->_data) ? (size_t)v->_size * sizeof(double) : 0);
+if(v->_data) RELEASE_ALIGNED(v->_data);
 v->_data = NULL;
-free(v);
+RELEASE(v);
 v = NULL;
 }
 
@@ -93,34 +98,45 @@ return t;
 
 Vector* load_vector(const char* filename)
 {
-int i, size;
-double d;
+long size;
+size_t length;
+char* text = NULL;
+char* p = NULL;
 Vector* v = NULL;
-FILE* file = fopen_read(filename);
-fread_int(file, &size);
-v = create_vector(size);
-for(i = 0; i < v->_size; i++)
+/* read the whole file at once and parse it in memory */
+text = read_text_file(filename, &length);
+if(text == NULL) return NULL;
+size = strtol(text, &p, 10);
+if(size < 1 || size > INT_MAX)
+{
+	RELEASE(text);
+	return NULL;
+}
+v = create_vector((int)size);
+/* a file with less components than announced ( truncated or with a bad number ) is rejected */
+if(parse_doubles(p, length - (size_t)(p - text), v->_data, v->_size) != v->_size)
 {
-fread_double(file, &d);
-v->_data[i] = d;
+	destroy_vector(v);
+	v = NULL;
 }
-fclose(file);
+RELEASE(text);
 return v;
 }
 
 void store_vector(const Vector* v, const char* filename)
 {
 int i;
-FILE* file = fopen_write(filename);
-fwrite_int(file, v->_size);
-fprintf(file, "\n");
+TextOutput* out = open_text_output(filename);
+if(out == NULL) return;
+write_text_int(out, v->_size);
+write_text_char(out, '\n');
 for(i = 0; i < v->_size; i++)
 {
-if(i > 0) fprintf(file, " ");
-fwrite_double(file, v->_data[i]);
+if(i > 0) write_text_char(out, ' ');
+write_text_double(out, v->_data[i]);
 }
-fprintf(file, "\n");
-fclose(file);
+write_text_char(out, '\n');
+close_text_output(out);
 }
 
 void print_vector(const Vector* v)